@@ -46,6 +46,8 @@ inline const char* errToString(SHT3x::Err err) {
     case SHT3x::Err::I2C_NACK_READ: return "I2C_NACK_READ";
     case SHT3x::Err::I2C_TIMEOUT: return "I2C_TIMEOUT";
     case SHT3x::Err::I2C_BUS: return "I2C_BUS";
+    case SHT3x::Err::CANCELLED: return "CANCELLED";
+    case SHT3x::Err::DEADLINE_INFEASIBLE: return "DEADLINE_INFEASIBLE";
     default: return "UNKNOWN";
   }
 }
@@ -1,5 +1,8 @@
 #include "Sht3xCli.h"
 
+#include "SHT3x/AllanDeviation.h"
+#include "SHT3x/Energy.h"
+
 #include <cctype>
 #include <cstdarg>
 #include <cstdio>
@@ -14,6 +17,8 @@ static constexpr size_t MAX_STRING_LEN = 160U;
 static constexpr uint32_t STRESS_PROGRESS_UPDATES = 10U;
 static constexpr uint32_t I2C_SOAK_MAX_SECONDS = 24UL * 60UL * 60UL;
 static constexpr uint32_t MEASUREMENT_JOB_TIMEOUT_MS = 500U;
+static constexpr uint32_t ALLAN_DEFAULT_SAMPLES = 256U;
+static constexpr uint32_t ALLAN_MAX_SAMPLES = 100000U;
 
 static constexpr const char* LOG_COLOR_RESET = "\033[0m";
 static constexpr const char* LOG_COLOR_RED = "\033[31m";
@@ -197,6 +202,7 @@ uint32_t pendingRequestId = 0;
 uint32_t nextRequestId = 1;
 int stressRemaining = 0;
 StressStats stressStats;
+SHT3x::AllanDeviation allanStats;
 
 uint32_t millis() {
   return platform.nowMs != nullptr ? platform.nowMs(platform.user) : 0U;
@@ -249,6 +255,7 @@ const char* errToStr(SHT3x::Err err) {
     case Err::I2C_TIMEOUT: return "I2C_TIMEOUT";
     case Err::I2C_BUS: return "I2C_BUS";
     case Err::CANCELLED: return "CANCELLED";
+    case Err::DEADLINE_INFEASIBLE: return "DEADLINE_INFEASIBLE";
     default: return "UNKNOWN";
   }
 }
@@ -637,6 +644,42 @@ void printRuntimeStats() {
   }
 }
 
+void printEnergy() {
+  SHT3x::ActivityCounters activity;
+  const SHT3x::Status st = deviceInstance.getActivity(millis(), activity);
+  if (!st.ok()) {
+    printStatus(st);
+    return;
+  }
+  const SHT3x::EnergyModel model;
+  SHT3x::EnergyEstimate estimate;
+  (void)SHT3x::estimateEnergy(activity, model, estimate);
+  Serial.println("=== Energy Estimate (datasheet typical, 3.3 V) ===");
+  Serial.printf("  elapsed_ms=%lu samples=%lu callbacks=%lu\n",
+                static_cast<unsigned long>(activity.elapsedMs),
+                static_cast<unsigned long>(activity.samples),
+                static_cast<unsigned long>(activity.transportCallbacks));
+  Serial.printf("  single_shot low/med/high=%lu/%lu/%lu\n",
+                static_cast<unsigned long>(activity.singleShotConversions[0]),
+                static_cast<unsigned long>(activity.singleShotConversions[1]),
+                static_cast<unsigned long>(activity.singleShotConversions[2]));
+  Serial.printf("  periodic low/med/high=%lu/%lu/%lu uptime_ms=%lu heater_ms=%lu\n",
+                static_cast<unsigned long>(activity.periodicConversions[0]),
+                static_cast<unsigned long>(activity.periodicConversions[1]),
+                static_cast<unsigned long>(activity.periodicConversions[2]),
+                static_cast<unsigned long>(activity.periodicUptimeMs),
+                static_cast<unsigned long>(activity.heaterOnMs));
+  Serial.printf("  uJ: idle=%.1f conversion=%.1f heater=%.1f bus=%.1f total=%.1f\n",
+                static_cast<double>(estimate.idleMicrojoules),
+                static_cast<double>(estimate.conversionMicrojoules),
+                static_cast<double>(estimate.heaterMicrojoules),
+                static_cast<double>(estimate.busMicrojoules),
+                static_cast<double>(estimate.totalMicrojoules));
+  Serial.printf("  uJ_per_sample=%.2f average_uA=%.2f\n",
+                static_cast<double>(estimate.microjoulesPerSample),
+                static_cast<double>(estimate.averageMicroamps));
+}
+
 void printMeasurement(const SHT3x::Measurement& m) {
   Serial.printf("Temp: %.2f C, Humidity: %.2f %%\n",
                 static_cast<double>(m.temperatureC),
@@ -1002,6 +1045,103 @@ void runI2cSoak(uint32_t durationS) {
       static_cast<unsigned>(deviceInstance.consecutiveFailures()));
 }
 
+uint32_t periodMsForRate(SHT3x::PeriodicRate rate) {
+  switch (rate) {
+    case SHT3x::PeriodicRate::MPS_0_5: return 2000U;
+    case SHT3x::PeriodicRate::MPS_1: return 1000U;
+    case SHT3x::PeriodicRate::MPS_2: return 500U;
+    case SHT3x::PeriodicRate::MPS_4: return 250U;
+    case SHT3x::PeriodicRate::MPS_10: return 100U;
+  }
+  return 1000U;
+}
+
+SHT3x::Status collectAllanSeries(SHT3x::PeriodicRate rate, SHT3x::Repeatability rep,
+                                 uint32_t count, uint32_t& lost) {
+  lost = 0;
+  allanStats.reset();
+  SHT3x::Status st = deviceInstance.startPeriodic(rate, rep);
+  if (!st.ok()) {
+    return st;
+  }
+  SHT3x::JobRequest request;
+  request.requestId = allocateRequestId();
+  st = deviceInstance.requestContinuous(request);
+  if (st.code != SHT3x::Err::IN_PROGRESS) {
+    return st;
+  }
+
+  // One continuous job yields every sample slot; lostSamples() counts the
+  // slots it could not fetch in time, which would bias the estimate.
+  const uint32_t lostBefore = deviceInstance.lostSamples();
+  const uint32_t stallMs = 3U * periodMsForRate(rate) + MEASUREMENT_JOB_TIMEOUT_MS;
+  uint32_t lastSampleMs = millis();
+  SHT3x::PollJobResult result;
+  while (allanStats.samples() < count) {
+    const uint32_t nowMs = millis();
+    st = deviceInstance.pollJob(nowMs, 1, result);
+    if (result.completed) {
+      SHT3x::RawSample raw;
+      (void)deviceInstance.getRawSample(raw);
+      allanStats.add(raw);
+      lastSampleMs = nowMs;
+    } else if (result.terminal) {
+      return st;
+    } else if ((nowMs - lastSampleMs) > stallMs) {
+      (void)deviceInstance.cancelJob(SHT3x::CancelReason::DEADLINE_EXPIRED, result);
+      return SHT3x::Status::Error(SHT3x::Err::TIMEOUT, "Allan series stalled");
+    }
+    yield();
+  }
+  lost = deviceInstance.lostSamples() - lostBefore;
+  return deviceInstance.cancelJob(SHT3x::CancelReason::REQUESTED, result).code ==
+                 SHT3x::Err::CANCELLED
+             ? SHT3x::Status::Ok()
+             : SHT3x::Status::Error(SHT3x::Err::BUSY, "Allan job did not cancel");
+}
+
+void runAllan(SHT3x::PeriodicRate rate, uint32_t count) {
+  const SHT3x::Status prepareStatus = cancelPending();
+  if (!prepareStatus.ok()) {
+    printStatus(prepareStatus);
+    return;
+  }
+  static const SHT3x::Repeatability REPS[] = {
+      SHT3x::Repeatability::LOW_REPEATABILITY,
+      SHT3x::Repeatability::MEDIUM_REPEATABILITY,
+      SHT3x::Repeatability::HIGH_REPEATABILITY,
+  };
+  const uint32_t tau0Ms = periodMsForRate(rate);
+  Serial.printf("allan: tau0_ms=%lu samples=%lu per repeatability\n",
+                static_cast<unsigned long>(tau0Ms), static_cast<unsigned long>(count));
+  Serial.println("allan: rep     tau_ms  terms   adev_T_mC  adev_RH_m%");
+  for (const SHT3x::Repeatability rep : REPS) {
+    uint32_t lost = 0;
+    const uint32_t startMs = millis();
+    const SHT3x::Status st = collectAllanSeries(rate, rep, count, lost);
+    if (!st.ok()) {
+      printLabeledStatus(repToStr(rep), st);
+      break;
+    }
+    for (uint8_t octave = 0; octave < SHT3x::ALLAN_OCTAVES; ++octave) {
+      SHT3x::AllanPoint point;
+      if (!allanStats.getPoint(octave, point).ok()) {
+        break;
+      }
+      Serial.printf("allan: %-6s %7lu %6lu %11.2f %11.2f\n", repToStr(rep),
+                    static_cast<unsigned long>(point.averagingFactor * tau0Ms),
+                    static_cast<unsigned long>(point.terms),
+                    static_cast<double>(point.temperatureC * 1000.0f),
+                    static_cast<double>(point.humidityPct * 1000.0f));
+    }
+    Serial.printf("allan: rep=%s lost=%lu duration_ms=%lu%s\n", repToStr(rep),
+                  static_cast<unsigned long>(lost),
+                  static_cast<unsigned long>(millis() - startMs),
+                  lost != 0U ? " (gaps bias this row; rerun)" : "");
+  }
+  printLabeledStatus("stop periodic", deviceInstance.stopPeriodic());
+}
+
 void runStressMix(int count) {
   struct OpStats {
     const char* name;
@@ -2251,6 +2391,11 @@ void processCommandString(const CliString& cmdLine) {
     return;
   }
 
+  if (cmd == "energy") {
+    printEnergy();
+    return;
+  }
+
   if (cmd == "begin") {
     if (!configIsReady) {
       logWarn("Config not ready");
@@ -2345,6 +2490,28 @@ void processCommandString(const CliString& cmdLine) {
     return;
   }
 
+  if (cmd.startsWith("allan ")) {
+    CliString args = cmd.substring(6);
+    args.trim();
+    const int split = args.indexOf(' ');
+    const CliString rateStr = split < 0 ? args : args.substring(0, split);
+    SHT3x::PeriodicRate rate;
+    if (!parseRate(rateStr, rate)) {
+      logWarn("Usage: allan <rate> [N]");
+      return;
+    }
+    long count = ALLAN_DEFAULT_SAMPLES;
+    if (split >= 0) {
+      count = args.substring(split + 1).toInt();
+    }
+    if (count < 2 || count > static_cast<long>(ALLAN_MAX_SAMPLES)) {
+      logWarn("Invalid allan sample count");
+      return;
+    }
+    runAllan(rate, static_cast<uint32_t>(count));
+    return;
+  }
+
   if (cmd == "stress_mix") {
     runStressMix(50);
     return;
@@ -2456,6 +2623,7 @@ void printHelp() {
   cli::printHelpItem("iface_reset", "Interface reset (SCL pulse)");
   cli::printHelpItem("greset", "General-call reset (bus-wide)");
   cli::printHelpItem("stats", "Runtime counters and cached settings");
+  cli::printHelpItem("energy", "Activity totals and energy-per-sample estimate");
   cli::printHelpItem("cfg / settings", "Show current config");
   cli::printHelpItem("drv", "Show driver state and health");
   cli::printHelpItem("online", "Show online state");
@@ -2466,6 +2634,7 @@ void printHelp() {
   cli::printHelpItem("recover", "Manual recovery attempt");
   cli::printHelpItem("verbose [0|1]", "Enable/disable verbose output");
   cli::printHelpItem("i2c_soak <seconds>", "Run low-USB I2C measurement soak");
+  cli::printHelpItem("allan <rate> [N]", "Allan deviation table per repeatability");
   cli::printHelpItem("stress [N]", "Run N measurement cycles");
   cli::printHelpItem("stress_mix [N]", "Run N mixed-operation cycles");
   cli::printHelpItem("selftest", "Run safe command self-test report");
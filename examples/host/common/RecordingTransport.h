@@ -0,0 +1,108 @@
+/// @file RecordingTransport.h
+/// @brief Transport decorator that timestamps every driver I2C callback
+/// @note NOT part of the library API. Example-only. Linux/POSIX host builds.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "SHT3x/Config.h"
+#include "SHT3x/Status.h"
+#include "host/common/VirtualSht3x.h"
+
+namespace sim {
+
+/// One recorded transport callback.
+struct TransportEvent {
+  uint64_t startUs = 0;  ///< Clock time when the callback was entered
+  uint64_t endUs = 0;    ///< Clock time when it returned (after the modeled transfer)
+  uint8_t address = 0;   ///< 7-bit target address
+  bool read = false;     ///< Receive-only read (true) or command write (false)
+  uint16_t command = 0;  ///< First two written bytes; 0 for reads
+  uint8_t length = 0;    ///< Bytes written or requested
+  Err result = Err::OK;  ///< Status returned to the driver
+};
+
+/// Wraps the i2cWrite/i2cWriteRead callbacks already set in a Config and
+/// records each call. With a virtual clock the wrapper also advances time by
+/// the modeled wire time of the transfer, so bus occupancy shows up in
+/// timelines and delays later polls the way a real blocking transfer would.
+class RecordingTransport {
+ public:
+  uint32_t busHz = 400000; ///< SCL rate for the wire-time model; 0 records zero-length transfers
+
+  /// Install the wrapper. Call after the inner transport is configured.
+  void wrap(SHT3x::Config& cfg, Clock& clock) {
+    _clock = &clock;
+    _innerWrite = cfg.i2cWrite;
+    _innerWriteRead = cfg.i2cWriteRead;
+    _innerUser = cfg.i2cUser;
+    cfg.i2cWrite = recordWrite;
+    cfg.i2cWriteRead = recordWriteRead;
+    cfg.i2cUser = this;
+  }
+
+  const std::vector<TransportEvent>& events() const { return _events; }
+  void clear() { _events.clear(); }
+
+  /// Wire time of one transfer: start, address byte, payload bytes (9 clocks
+  /// each including ACK), and stop.
+  uint32_t transferUs(size_t bytes) const {
+    if (busHz == 0) {
+      return 0;
+    }
+    const uint64_t clocks = 2U + 9U * (static_cast<uint64_t>(bytes) + 1U);
+    return static_cast<uint32_t>((clocks * 1000000ULL + busHz - 1U) / busHz);
+  }
+
+ private:
+  Clock* _clock = nullptr;
+  SHT3x::I2cWriteFn _innerWrite = nullptr;
+  SHT3x::I2cWriteReadFn _innerWriteRead = nullptr;
+  void* _innerUser = nullptr;
+  std::vector<TransportEvent> _events;
+
+  TransportEvent& _begin(uint8_t addr, bool read, size_t len) {
+    TransportEvent event;
+    event.startUs = _clock->nowUs();
+    event.address = addr;
+    event.read = read;
+    event.length = static_cast<uint8_t>(len);
+    _events.push_back(event);
+    return _events.back();
+  }
+
+  void _end(TransportEvent& event, const Status& st) {
+    if (_clock->virtualTime) {
+      _clock->advanceUs(transferUs(event.length));
+    }
+    event.endUs = _clock->nowUs();
+    event.result = st.code;
+  }
+
+  static Status recordWrite(uint8_t addr, const uint8_t* data, size_t len,
+                            uint32_t timeoutMs, void* user) {
+    auto* self = static_cast<RecordingTransport*>(user);
+    TransportEvent& event = self->_begin(addr, false, len);
+    if (data != nullptr && len >= 2) {
+      event.command = static_cast<uint16_t>((data[0] << 8) | data[1]);
+    }
+    const Status st = self->_innerWrite(addr, data, len, timeoutMs, self->_innerUser);
+    self->_end(event, st);
+    return st;
+  }
+
+  static Status recordWriteRead(uint8_t addr, const uint8_t* txData, size_t txLen,
+                                uint8_t* rxData, size_t rxLen, uint32_t timeoutMs,
+                                void* user) {
+    auto* self = static_cast<RecordingTransport*>(user);
+    TransportEvent& event = self->_begin(addr, true, rxLen);
+    const Status st = self->_innerWriteRead(addr, txData, txLen, rxData, rxLen, timeoutMs,
+                                            self->_innerUser);
+    self->_end(event, st);
+    return st;
+  }
+};
+
+} // namespace sim
@@ -0,0 +1,205 @@
+/// @file ScenarioGenerator.h
+/// @brief Deterministic environmental scenarios as raw SHT3x codes over virtual time
+/// @note NOT part of the library API. Example-only. Host builds.
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "SHT3x/CommandTable.h"
+#include "SHT3x/Config.h"
+#include "host/common/VirtualSht3x.h"
+
+namespace sim {
+
+/// Door opened for openMs: the room steps by the deltas at once, then
+/// relaxes back exponentially with recoveryTauMs after the door closes.
+struct DoorEvent {
+  uint64_t startUs = 0;
+  uint32_t openMs = 60000;
+  int32_t deltaTemperatureMilli = -4000;
+  int32_t deltaHumidityMilli = 15000;
+  uint32_t recoveryTauMs = 300000;
+};
+
+/// Condensation: over rampMs relative humidity rises to saturation (100 %RH)
+/// while the surface cools by deltaTemperatureMilli, holds for holdMs, then
+/// dries over another rampMs.
+struct CondensationEvent {
+  uint64_t startUs = 0;
+  uint32_t rampMs = 600000;
+  uint32_t holdMs = 1800000;
+  int32_t deltaTemperatureMilli = -2000;
+};
+
+/// Scenario description. Event arrays are caller storage.
+struct ScenarioConfig {
+  uint64_t seed = 1;                            ///< Noise seed
+  int32_t baseTemperatureMilli = 22000;         ///< Daily mean temperature
+  int32_t baseHumidityMilli = 45000;            ///< Daily mean relative humidity
+  int32_t diurnalTemperatureAmplitudeMilli = 3000; ///< Half peak-to-peak daily swing
+  int32_t diurnalHumidityAmplitudeMilli = 8000;    ///< RH swings opposite to temperature
+  uint64_t diurnalPeriodUs = 86400ULL * 1000000ULL; ///< One day
+  uint64_t coldestAtUs = 5ULL * 3600ULL * 1000000ULL; ///< Time of the daily minimum
+  const DoorEvent* doors = nullptr;
+  size_t doorCount = 0;
+  const CondensationEvent* condensation = nullptr;
+  size_t condensationCount = 0;
+  bool noise = true;                            ///< Add repeatability noise to samples
+};
+
+/// One generated reading.
+struct ScenarioSample {
+  int32_t temperatureMilliCelsius = 0; ///< Value before quantization
+  int32_t humidityMilliPercent = 0;    ///< Value before quantization
+  uint16_t rawTemperature = 0;         ///< Sensor code, saturated to 0..65535
+  uint16_t rawHumidity = 0;            ///< Sensor code, saturated to 0..65535
+};
+
+/// Produces the same readings for the same configuration and sample times,
+/// independent of call order: noise is a hash of (seed, time, channel)
+/// shaped to a Gaussian whose 3-sigma is the datasheet repeatability
+/// (0.04/0.08/0.15 C and 0.08/0.15/0.21 %RH, high to low).
+class ScenarioGenerator {
+ public:
+  explicit ScenarioGenerator(const ScenarioConfig& config) : _config(config) {}
+
+  /// Noise-free environment at atUs.
+  void truth(uint64_t atUs, int32_t& temperatureMilli, int32_t& humidityMilli) const {
+    const double pi = 3.14159265358979323846;
+    const double cycle = 2.0 * pi *
+                         static_cast<double>((atUs + _config.diurnalPeriodUs -
+                                              _config.coldestAtUs % _config.diurnalPeriodUs) %
+                                             _config.diurnalPeriodUs) /
+                         static_cast<double>(_config.diurnalPeriodUs);
+    // -cos puts the minimum at coldestAtUs.
+    const double swing = -std::cos(cycle);
+    double t = _config.baseTemperatureMilli + _config.diurnalTemperatureAmplitudeMilli * swing;
+    double rh = _config.baseHumidityMilli - _config.diurnalHumidityAmplitudeMilli * swing;
+
+    for (size_t i = 0; i < _config.doorCount; ++i) {
+      const double weight = _doorWeight(_config.doors[i], atUs);
+      t += _config.doors[i].deltaTemperatureMilli * weight;
+      rh += _config.doors[i].deltaHumidityMilli * weight;
+    }
+    for (size_t i = 0; i < _config.condensationCount; ++i) {
+      const double weight = _condensationWeight(_config.condensation[i], atUs);
+      t += _config.condensation[i].deltaTemperatureMilli * weight;
+      rh += (100000.0 - rh) * weight;
+    }
+    temperatureMilli = static_cast<int32_t>(std::lround(t));
+    rh = rh < 0.0 ? 0.0 : (rh > 100000.0 ? 100000.0 : rh);
+    humidityMilli = static_cast<int32_t>(std::lround(rh));
+  }
+
+  /// Reading as the sensor reports it at the given repeatability.
+  ScenarioSample sample(uint64_t atUs, SHT3x::Repeatability repeatability) const {
+    ScenarioSample s;
+    truth(atUs, s.temperatureMilliCelsius, s.humidityMilliPercent);
+    if (_config.noise) {
+      const uint8_t r = static_cast<uint8_t>(repeatability) > 2
+                            ? 2
+                            : static_cast<uint8_t>(repeatability);
+      // Indexed by Repeatability: low, medium, high.
+      static constexpr double T_SIGMA[3] = {150.0 / 3.0, 80.0 / 3.0, 40.0 / 3.0};
+      static constexpr double RH_SIGMA[3] = {210.0 / 3.0, 150.0 / 3.0, 80.0 / 3.0};
+      s.temperatureMilliCelsius +=
+          static_cast<int32_t>(std::lround(T_SIGMA[r] * _gaussian(atUs, 0)));
+      s.humidityMilliPercent +=
+          static_cast<int32_t>(std::lround(RH_SIGMA[r] * _gaussian(atUs, 1)));
+    }
+    s.rawTemperature = _code((s.temperatureMilliCelsius + 45000.0) / 175000.0);
+    s.rawHumidity = _code(s.humidityMilliPercent / 100000.0);
+    return s;
+  }
+
+  /// Six-byte measurement frame (T, CRC, RH, CRC) for scripted read responses.
+  void frame(uint64_t atUs, SHT3x::Repeatability repeatability,
+             uint8_t out[SHT3x::cmd::MEASUREMENT_DATA_LEN]) const {
+    const ScenarioSample s = sample(atUs, repeatability);
+    out[0] = static_cast<uint8_t>(s.rawTemperature >> 8);
+    out[1] = static_cast<uint8_t>(s.rawTemperature & 0xFFU);
+    out[2] = crc8(&out[0], 2);
+    out[3] = static_cast<uint8_t>(s.rawHumidity >> 8);
+    out[4] = static_cast<uint8_t>(s.rawHumidity & 0xFFU);
+    out[5] = crc8(&out[3], 2);
+  }
+
+  /// Feed a virtual sensor: each conversion samples the scenario at its
+  /// completion time with the repeatability of the command that started it.
+  void attach(VirtualSht3x& device) {
+    device.source = _sourceThunk;
+    device.sourceUser = this;
+    _device = &device;
+  }
+
+ private:
+  ScenarioConfig _config;
+  const VirtualSht3x* _device = nullptr;
+
+  static void _sourceThunk(uint64_t nowUs, uint16_t& rawTemperature, uint16_t& rawHumidity,
+                           void* user) {
+    const ScenarioGenerator* self = static_cast<const ScenarioGenerator*>(user);
+    const ScenarioSample s = self->sample(nowUs, self->_device->repeatability);
+    rawTemperature = s.rawTemperature;
+    rawHumidity = s.rawHumidity;
+  }
+
+  static double _doorWeight(const DoorEvent& e, uint64_t atUs) {
+    if (atUs < e.startUs) {
+      return 0.0;
+    }
+    const uint64_t closeUs = e.startUs + static_cast<uint64_t>(e.openMs) * 1000ULL;
+    if (atUs < closeUs) {
+      return 1.0;
+    }
+    if (e.recoveryTauMs == 0) {
+      return 0.0;
+    }
+    return std::exp(-static_cast<double>(atUs - closeUs) / (e.recoveryTauMs * 1000.0));
+  }
+
+  static double _condensationWeight(const CondensationEvent& e, uint64_t atUs) {
+    if (atUs < e.startUs) {
+      return 0.0;
+    }
+    const double ms = static_cast<double>(atUs - e.startUs) / 1000.0;
+    const double ramp = e.rampMs > 0 ? static_cast<double>(e.rampMs) : 1.0;
+    if (ms < ramp) {
+      return ms / ramp;
+    }
+    if (ms < ramp + e.holdMs) {
+      return 1.0;
+    }
+    const double drying = ms - ramp - e.holdMs;
+    return drying < ramp ? 1.0 - drying / ramp : 0.0;
+  }
+
+  /// SplitMix64 finalizer.
+  static uint64_t _mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+  }
+
+  /// Standard normal deviate from (seed, time, channel) via Box-Muller.
+  double _gaussian(uint64_t atUs, uint64_t channel) const {
+    const uint64_t h1 = _mix(_config.seed ^ _mix(atUs * 2U + channel));
+    const uint64_t h2 = _mix(h1);
+    const double u1 = (static_cast<double>(h1 >> 11) + 1.0) / 9007199254740993.0;
+    const double u2 = static_cast<double>(h2 >> 11) / 9007199254740992.0;
+    return std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+  }
+
+  static uint16_t _code(double fraction) {
+    const double code = std::round(fraction * 65535.0);
+    if (code <= 0.0) {
+      return 0;
+    }
+    return code >= 65535.0 ? 65535U : static_cast<uint16_t>(code);
+  }
+};
+
+} // namespace sim
@@ -0,0 +1,286 @@
+/// @file ShmSampleRing.h
+/// @brief Single-writer/multi-reader sample broadcast ring in POSIX shared memory
+/// @note NOT part of the library API. Example-only. Linux/POSIX host builds
+///       (link with -lrt on older glibc).
+///
+/// The writer never waits for readers. Every slot carries the sequence number
+/// it holds; a reader that falls more than one ring behind, or that observes a
+/// slot being rewritten while copying it, detects the overrun from the
+/// sequence numbers, counts the lost samples, and resynchronizes to the oldest
+/// sample still present. Readers map the segment read-only.
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "SHT3x/SHT3x.h"
+
+namespace shm_ring {
+
+static constexpr uint32_t MAGIC = 0x53485452; // "SHTR"
+static constexpr uint16_t VERSION = 1;
+
+/// One broadcast sample.
+struct Sample {
+  uint64_t seq = 0;                 ///< Ring sequence number (assigned by publish)
+  uint32_t sensorId = 0;            ///< Writer-assigned sensor index
+  uint32_t requestId = 0;           ///< Job identity that produced the sample
+  uint32_t timestampMs = 0;         ///< Driver sample timestamp
+  uint16_t rawTemperature = 0;      ///< Raw temperature word
+  uint16_t rawHumidity = 0;         ///< Raw humidity word
+  int32_t temperatureMilliC = 0;    ///< Converted temperature, milli-degrees C
+  int32_t humidityMilliPct = 0;     ///< Converted humidity, milli-percent RH
+};
+
+/// Payload words per slot (everything except seq).
+static constexpr size_t PAYLOAD_WORDS = 6;
+
+struct Slot {
+  std::atomic<uint64_t> tag;                       ///< seq + 1 when complete, 0 while writing
+  std::atomic<uint32_t> words[PAYLOAD_WORDS];
+};
+
+struct Header {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t slotBytes;
+  uint32_t capacity;                               ///< Power of two
+  uint32_t reserved;
+  alignas(64) std::atomic<uint64_t> head;          ///< Next sequence to publish
+  std::atomic<uint32_t> closed;                    ///< Writer finished
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "shared-memory ring requires lock-free 64-bit atomics");
+
+inline size_t segmentBytes(uint32_t capacity) {
+  return sizeof(Header) + static_cast<size_t>(capacity) * sizeof(Slot);
+}
+
+inline Slot* slotsOf(Header* header) {
+  return reinterpret_cast<Slot*>(reinterpret_cast<uint8_t*>(header) + sizeof(Header));
+}
+
+/// Writer side. Creates (or truncates) the named segment.
+class Writer {
+ public:
+  ~Writer() { close(); }
+
+  /// @param name POSIX shm name, e.g. "/sht3x_samples"
+  /// @param capacity Slot count, rounded up to a power of two
+  bool create(const char* name, uint32_t capacity) {
+    uint32_t cap = 1;
+    while (cap < capacity) {
+      cap <<= 1;
+    }
+    const int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+      return false;
+    }
+    _bytes = segmentBytes(cap);
+    if (ftruncate(fd, static_cast<off_t>(_bytes)) != 0) {
+      ::close(fd);
+      return false;
+    }
+    void* mem = mmap(nullptr, _bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mem == MAP_FAILED) {
+      return false;
+    }
+    _header = static_cast<Header*>(mem);
+    _slots = slotsOf(_header);
+    _mask = cap - 1U;
+    for (uint32_t i = 0; i < cap; ++i) {
+      _slots[i].tag.store(0, std::memory_order_relaxed);
+    }
+    _header->head.store(0, std::memory_order_relaxed);
+    _header->closed.store(0, std::memory_order_relaxed);
+    _header->capacity = cap;
+    _header->slotBytes = static_cast<uint16_t>(sizeof(Slot));
+    _header->version = VERSION;
+    _header->reserved = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+    _header->magic = MAGIC;
+    return true;
+  }
+
+  /// Publish one sample; never blocks. Returns the assigned sequence number.
+  uint64_t publish(const Sample& sample) {
+    const uint64_t seq = _header->head.load(std::memory_order_relaxed);
+    Slot& slot = _slots[seq & _mask];
+    slot.tag.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.words[0].store(sample.sensorId, std::memory_order_relaxed);
+    slot.words[1].store(sample.requestId, std::memory_order_relaxed);
+    slot.words[2].store(sample.timestampMs, std::memory_order_relaxed);
+    slot.words[3].store(static_cast<uint32_t>(sample.rawTemperature) << 16 |
+                            sample.rawHumidity,
+                        std::memory_order_relaxed);
+    slot.words[4].store(static_cast<uint32_t>(sample.temperatureMilliC),
+                        std::memory_order_relaxed);
+    slot.words[5].store(static_cast<uint32_t>(sample.humidityMilliPct),
+                        std::memory_order_relaxed);
+    slot.tag.store(seq + 1, std::memory_order_release);
+    _header->head.store(seq + 1, std::memory_order_release);
+    return seq;
+  }
+
+  /// Publish the driver's newly captured sample when a poll completed one.
+  /// @return true when a sample was published
+  bool publishCompleted(const SHT3x::SHT3x& driver, const SHT3x::PollJobResult& result,
+                        uint32_t sensorId) {
+    if (!result.completed) {
+      return false;
+    }
+    SHT3x::RawSample raw;
+    SHT3x::MeasurementMilli milli;
+    if (!driver.getRawSample(raw).ok() || !driver.getMeasurementMilli(milli).ok()) {
+      return false;
+    }
+    Sample sample;
+    sample.sensorId = sensorId;
+    sample.requestId = result.requestId;
+    sample.timestampMs = driver.sampleTimestampMs();
+    sample.rawTemperature = raw.rawTemperature;
+    sample.rawHumidity = raw.rawHumidity;
+    sample.temperatureMilliC = milli.temperatureMilliCelsius;
+    sample.humidityMilliPct = milli.humidityMilliPercent;
+    publish(sample);
+    return true;
+  }
+
+  void markClosed() { _header->closed.store(1, std::memory_order_release); }
+
+  void close() {
+    if (_header != nullptr) {
+      munmap(_header, _bytes);
+      _header = nullptr;
+    }
+  }
+
+ private:
+  Header* _header = nullptr;
+  Slot* _slots = nullptr;
+  size_t _bytes = 0;
+  uint64_t _mask = 0;
+};
+
+/// Reader side. Maps the segment read-only; any number of readers may attach.
+class Reader {
+ public:
+  ~Reader() { close(); }
+
+  /// Attach to an existing segment and start at the oldest retained sample.
+  bool open(const char* name) {
+    const int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+      return false;
+    }
+    void* mem = mmap(nullptr, sizeof(Header), PROT_READ, MAP_SHARED, fd, 0);
+    if (mem == MAP_FAILED) {
+      ::close(fd);
+      return false;
+    }
+    const Header* probe = static_cast<const Header*>(mem);
+    const bool valid = probe->magic == MAGIC && probe->version == VERSION &&
+                       probe->slotBytes == sizeof(Slot) && probe->capacity != 0 &&
+                       (probe->capacity & (probe->capacity - 1U)) == 0;
+    const uint32_t capacity = probe->capacity;
+    munmap(mem, sizeof(Header));
+    if (!valid) {
+      ::close(fd);
+      return false;
+    }
+    _bytes = segmentBytes(capacity);
+    mem = mmap(nullptr, _bytes, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mem == MAP_FAILED) {
+      return false;
+    }
+    _header = static_cast<const Header*>(mem);
+    _slots = reinterpret_cast<const Slot*>(reinterpret_cast<const uint8_t*>(_header) +
+                                           sizeof(Header));
+    _capacity = _header->capacity;
+    const uint64_t head = _header->head.load(std::memory_order_acquire);
+    _cursor = head > _capacity ? head - _capacity : 0;
+    return true;
+  }
+
+  /// Try to read the next sample without blocking.
+  /// @return true when out holds the next sample; false when caught up
+  bool next(Sample& out) {
+    for (;;) {
+      const uint64_t head = _header->head.load(std::memory_order_acquire);
+      if (_cursor >= head) {
+        return false;
+      }
+      if (head - _cursor > _capacity) {
+        _resync(head);
+        continue;
+      }
+      const Slot& slot = _slots[_cursor & (_capacity - 1U)];
+      const uint64_t before = slot.tag.load(std::memory_order_acquire);
+      uint32_t words[PAYLOAD_WORDS];
+      for (size_t i = 0; i < PAYLOAD_WORDS; ++i) {
+        words[i] = slot.words[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      const uint64_t after = slot.tag.load(std::memory_order_relaxed);
+      if (before != _cursor + 1 || after != before) {
+        // The writer lapped this slot while we were copying it.
+        _resync(_header->head.load(std::memory_order_acquire));
+        continue;
+      }
+      out.seq = _cursor;
+      out.sensorId = words[0];
+      out.requestId = words[1];
+      out.timestampMs = words[2];
+      out.rawTemperature = static_cast<uint16_t>(words[3] >> 16);
+      out.rawHumidity = static_cast<uint16_t>(words[3] & 0xFFFFU);
+      out.temperatureMilliC = static_cast<int32_t>(words[4]);
+      out.humidityMilliPct = static_cast<int32_t>(words[5]);
+      _cursor++;
+      _received++;
+      return true;
+    }
+  }
+
+  bool writerClosed() const { return _header->closed.load(std::memory_order_acquire) != 0; }
+  uint64_t received() const { return _received; }
+  uint64_t lost() const { return _lost; }
+  uint64_t overruns() const { return _overruns; }
+
+  void close() {
+    if (_header != nullptr) {
+      munmap(const_cast<Header*>(_header), _bytes);
+      _header = nullptr;
+    }
+  }
+
+ private:
+  const Header* _header = nullptr;
+  const Slot* _slots = nullptr;
+  size_t _bytes = 0;
+  uint64_t _capacity = 0;
+  uint64_t _cursor = 0;
+  uint64_t _received = 0;
+  uint64_t _lost = 0;
+  uint64_t _overruns = 0;
+
+  void _resync(uint64_t head) {
+    // Skip to the oldest slot that cannot be overwritten by the next publish.
+    const uint64_t oldest = head > _capacity ? head - _capacity + 1U : 0;
+    if (oldest > _cursor) {
+      _lost += oldest - _cursor;
+      _cursor = oldest;
+    }
+    _overruns++;
+  }
+};
+
+} // namespace shm_ring
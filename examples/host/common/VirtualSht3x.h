@@ -0,0 +1,437 @@
+/// @file VirtualSht3x.h
+/// @brief Host-side virtual SHT3x device, clock, and transport callbacks
+/// @note NOT part of the library API. Example-only. Linux/POSIX host builds.
+#pragma once
+
+#include <time.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "SHT3x/CommandTable.h"
+#include "SHT3x/Config.h"
+#include "SHT3x/Status.h"
+
+namespace sim {
+
+using SHT3x::Err;
+using SHT3x::Status;
+
+/// Read CLOCK_MONOTONIC in microseconds.
+inline uint64_t monotonicUs() {
+  timespec ts{};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000ULL +
+         static_cast<uint64_t>(ts.tv_nsec) / 1000ULL;
+}
+
+/// Shared time source for virtual devices and driver timing hooks.
+/// Real-time clocks follow CLOCK_MONOTONIC; virtual clocks only move when the
+/// host advances them (or when the driver yields inside a synchronous wait).
+struct Clock {
+  bool virtualTime = false;
+  uint64_t virtualUs = 0;
+  uint32_t yieldStepUs = 10; ///< Virtual time consumed by one cooperative yield
+
+  uint64_t nowUs() const { return virtualTime ? virtualUs : monotonicUs(); }
+  void advanceUs(uint64_t us) { virtualUs += us; }
+};
+
+inline uint32_t clockNowMs(void* user) {
+  return static_cast<uint32_t>(static_cast<Clock*>(user)->nowUs() / 1000ULL);
+}
+
+inline uint32_t clockNowUs(void* user) {
+  return static_cast<uint32_t>(static_cast<Clock*>(user)->nowUs());
+}
+
+inline void clockYield(void* user) {
+  Clock* clock = static_cast<Clock*>(user);
+  if (clock->virtualTime) {
+    clock->advanceUs(clock->yieldStepUs);
+  }
+}
+
+/// Config::sleepUntilUs for host clocks: virtual clocks jump to the target,
+/// real-time clocks block in nanosleep instead of spinning.
+inline void clockSleepUntilUs(uint32_t targetUs, void* user) {
+  Clock* clock = static_cast<Clock*>(user);
+  const int32_t remainingUs =
+      static_cast<int32_t>(targetUs - static_cast<uint32_t>(clock->nowUs()));
+  if (remainingUs <= 0) {
+    return;
+  }
+  if (clock->virtualTime) {
+    clock->advanceUs(static_cast<uint64_t>(remainingUs));
+    return;
+  }
+  timespec ts{};
+  ts.tv_sec = remainingUs / 1000000;
+  ts.tv_nsec = static_cast<long>(remainingUs % 1000000) * 1000L;
+  nanosleep(&ts, nullptr);
+}
+
+/// Optional raw sample source.
+/// @param nowUs Conversion completion time on the device clock
+/// @param rawTemperature [out] Raw temperature word
+/// @param rawHumidity [out] Raw humidity word
+/// @param user Source context
+using SampleSourceFn = void (*)(uint64_t nowUs, uint16_t& rawTemperature,
+                                uint16_t& rawHumidity, void* user);
+
+/// SHT3x CRC-8 (poly 0x31, init 0xFF).
+inline uint8_t crc8(const uint8_t* data, size_t len) {
+  uint8_t crc = SHT3x::cmd::CRC_INIT;
+  for (size_t i = 0; i < len; ++i) {
+    crc ^= data[i];
+    for (uint8_t bit = 0; bit < 8; ++bit) {
+      crc = (crc & 0x80U) ? static_cast<uint8_t>((crc << 1) ^ SHT3x::cmd::CRC_POLY)
+                          : static_cast<uint8_t>(crc << 1);
+    }
+  }
+  return crc;
+}
+
+/// Behavioral model of one SHT3x on a virtual bus.
+/// Models single-shot conversion time, periodic/ART slots with read-header
+/// NACK before data is ready, Break, soft reset, status/heater/alert/serial
+/// commands, and command-error status for unknown commands.
+class VirtualSht3x {
+ public:
+  Clock* clock = nullptr;
+  uint8_t address = SHT3x::cmd::I2C_ADDR_LOW;
+  uint16_t rawTemperature = 0x6666; ///< About 25 C when no source is set
+  uint16_t rawHumidity = 0x8000;    ///< About 50 %RH when no source is set
+  SampleSourceFn source = nullptr;
+  void* sourceUser = nullptr;
+  uint32_t serial = 0x12345678;
+  /// Repeatability of the last measurement command (single-shot or periodic).
+  SHT3x::Repeatability repeatability = SHT3x::Repeatability::HIGH_REPEATABILITY;
+  /// Periodic/ART oscillator error in parts per million; positive runs slow.
+  int32_t periodErrorPpm = 0;
+
+  // Bus activity counters.
+  uint32_t writes = 0;
+  uint32_t reads = 0;
+  uint32_t bytesWritten = 0;
+  uint32_t bytesRead = 0;
+  uint32_t readNacks = 0;
+  uint32_t conversions = 0;
+  uint32_t overwrittenSlots = 0; ///< Periodic slots replaced before any fetch
+
+  bool periodicActive() const { return _periodic; }
+  uint16_t statusRegister() const { return _status; }
+
+  Status write(uint8_t addr, const uint8_t* data, size_t len) {
+    if (addr != address) {
+      return Status::Error(Err::I2C_NACK_ADDR, "Virtual address NACK", addr);
+    }
+    if (data == nullptr || len < 2) {
+      return Status::Error(Err::I2C_NACK_DATA, "Virtual short write", static_cast<int32_t>(len));
+    }
+    writes++;
+    bytesWritten += static_cast<uint32_t>(len);
+    const uint64_t now = clock->nowUs();
+    const uint16_t command = static_cast<uint16_t>((data[0] << 8) | data[1]);
+    _pending = Pending::NONE;
+    _status &= static_cast<uint16_t>(~SHT3x::cmd::STATUS_COMMAND_ERROR);
+
+    if (len == 5) {
+      return _writeAlert(command, data);
+    }
+    if (len != 2) {
+      _status |= SHT3x::cmd::STATUS_COMMAND_ERROR;
+      return Status::Ok();
+    }
+
+    const uint32_t singleShotUs = _singleShotUs(command);
+    if (singleShotUs != 0) {
+      if (_periodic) {
+        _status |= SHT3x::cmd::STATUS_COMMAND_ERROR;
+        return Status::Ok();
+      }
+      _pending = Pending::MEASUREMENT;
+      _readyUs = now + singleShotUs;
+      repeatability = _repeatabilityFor(command);
+      return Status::Ok();
+    }
+    const uint32_t periodUs = _periodUs(command);
+    if (periodUs != 0) {
+      repeatability = _repeatabilityFor(command);
+      _periodic = true;
+      // The first slot completes one conversion after the mode command.
+      _firstSlotUs = now + _conversionUs(repeatability);
+      _slotPeriodUs = static_cast<uint64_t>(
+          static_cast<int64_t>(periodUs) +
+          static_cast<int64_t>(periodUs) * periodErrorPpm / 1000000);
+      _lastFetchedSlot = 0;
+      return Status::Ok();
+    }
+
+    switch (command) {
+      case SHT3x::cmd::CMD_FETCH_DATA:
+        if (_periodic) {
+          _pending = Pending::FETCH;
+        }
+        return Status::Ok();
+      case SHT3x::cmd::CMD_BREAK:
+        _periodic = false;
+        return Status::Ok();
+      case SHT3x::cmd::CMD_SOFT_RESET:
+        _periodic = false;
+        _heater = false;
+        _status = SHT3x::cmd::STATUS_RESET_DETECTED;
+        return Status::Ok();
+      case SHT3x::cmd::CMD_READ_STATUS:
+        _pending = Pending::STATUS;
+        return Status::Ok();
+      case SHT3x::cmd::CMD_CLEAR_STATUS:
+        _status &= static_cast<uint16_t>(~(SHT3x::cmd::STATUS_ALERT_PENDING |
+                                           SHT3x::cmd::STATUS_RH_ALERT |
+                                           SHT3x::cmd::STATUS_T_ALERT |
+                                           SHT3x::cmd::STATUS_RESET_DETECTED));
+        return Status::Ok();
+      case SHT3x::cmd::CMD_HEATER_ENABLE:
+        _heater = true;
+        _status |= SHT3x::cmd::STATUS_HEATER_ON;
+        return Status::Ok();
+      case SHT3x::cmd::CMD_HEATER_DISABLE:
+        _heater = false;
+        _status &= static_cast<uint16_t>(~SHT3x::cmd::STATUS_HEATER_ON);
+        return Status::Ok();
+      case SHT3x::cmd::CMD_SERIAL_STRETCH:
+      case SHT3x::cmd::CMD_SERIAL_NO_STRETCH:
+        _pending = Pending::SERIAL;
+        return Status::Ok();
+      case SHT3x::cmd::CMD_ALERT_READ_HIGH_SET:
+      case SHT3x::cmd::CMD_ALERT_READ_HIGH_CLEAR:
+      case SHT3x::cmd::CMD_ALERT_READ_LOW_CLEAR:
+      case SHT3x::cmd::CMD_ALERT_READ_LOW_SET:
+        _pending = Pending::ALERT;
+        _alertIndex = _alertIndexFor(command);
+        return Status::Ok();
+      default:
+        _status |= SHT3x::cmd::STATUS_COMMAND_ERROR;
+        return Status::Ok();
+    }
+  }
+
+  Status read(uint8_t addr, uint8_t* rx, size_t rxLen) {
+    if (addr != address) {
+      return Status::Error(Err::I2C_NACK_ADDR, "Virtual address NACK", addr);
+    }
+    if (rx == nullptr || rxLen == 0) {
+      return Status::Error(Err::INVALID_PARAM, "Virtual read buffer invalid");
+    }
+    const uint64_t now = clock->nowUs();
+    const Pending pending = _pending;
+    _pending = Pending::NONE;
+
+    uint16_t words[2] = {0, 0};
+    size_t wordCount = 1;
+    switch (pending) {
+      case Pending::MEASUREMENT:
+        if (now < _readyUs) {
+          return _nack();
+        }
+        _sample(_readyUs, words[0], words[1]);
+        wordCount = 2;
+        break;
+      case Pending::FETCH: {
+        const uint64_t slot =
+            now < _firstSlotUs ? 0 : (now - _firstSlotUs) / _slotPeriodUs + 1U;
+        if (slot == 0 || slot <= _lastFetchedSlot) {
+          return _nack();
+        }
+        overwrittenSlots += static_cast<uint32_t>(slot - _lastFetchedSlot - 1U);
+        _lastFetchedSlot = slot;
+        _sample(_firstSlotUs + (slot - 1U) * _slotPeriodUs, words[0], words[1]);
+        wordCount = 2;
+        break;
+      }
+      case Pending::STATUS:
+        words[0] = _status;
+        break;
+      case Pending::SERIAL:
+        words[0] = static_cast<uint16_t>(serial >> 16);
+        words[1] = static_cast<uint16_t>(serial & 0xFFFFU);
+        wordCount = 2;
+        break;
+      case Pending::ALERT:
+        words[0] = _alert[_alertIndex];
+        break;
+      case Pending::NONE:
+      default:
+        return _nack();
+    }
+
+    uint8_t frame[SHT3x::cmd::MEASUREMENT_DATA_LEN] = {};
+    for (size_t i = 0; i < wordCount; ++i) {
+      frame[i * 3] = static_cast<uint8_t>(words[i] >> 8);
+      frame[i * 3 + 1] = static_cast<uint8_t>(words[i] & 0xFFU);
+      frame[i * 3 + 2] = crc8(&frame[i * 3], 2);
+    }
+    const size_t available = wordCount * SHT3x::cmd::DATA_WORD_WITH_CRC;
+    for (size_t i = 0; i < rxLen; ++i) {
+      rx[i] = (i < available) ? frame[i] : 0xFF;
+    }
+    reads++;
+    bytesRead += static_cast<uint32_t>(rxLen);
+    return Status::Ok();
+  }
+
+ private:
+  enum class Pending : uint8_t { NONE, MEASUREMENT, FETCH, STATUS, SERIAL, ALERT };
+
+  Pending _pending = Pending::NONE;
+  uint64_t _readyUs = 0;
+  bool _periodic = false;
+  uint64_t _firstSlotUs = 0;
+  uint64_t _slotPeriodUs = 1000000;
+  uint64_t _lastFetchedSlot = 0;
+  bool _heater = false;
+  uint16_t _status = 0;
+  uint16_t _alert[4] = {0xCD33, 0xC92D, 0x3869, 0x3466};
+  uint8_t _alertIndex = 0;
+
+  Status _nack() {
+    readNacks++;
+    return Status::Error(Err::I2C_NACK_READ, "Virtual read-header NACK");
+  }
+
+  void _sample(uint64_t atUs, uint16_t& t, uint16_t& rh) {
+    conversions++;
+    t = rawTemperature;
+    rh = rawHumidity;
+    if (source != nullptr) {
+      source(atUs, t, rh, sourceUser);
+    }
+  }
+
+  Status _writeAlert(uint16_t command, const uint8_t* data) {
+    uint8_t index = 0;
+    switch (command) {
+      case SHT3x::cmd::CMD_ALERT_WRITE_HIGH_SET: index = 0; break;
+      case SHT3x::cmd::CMD_ALERT_WRITE_HIGH_CLEAR: index = 1; break;
+      case SHT3x::cmd::CMD_ALERT_WRITE_LOW_CLEAR: index = 2; break;
+      case SHT3x::cmd::CMD_ALERT_WRITE_LOW_SET: index = 3; break;
+      default:
+        _status |= SHT3x::cmd::STATUS_COMMAND_ERROR;
+        return Status::Ok();
+    }
+    if (crc8(&data[2], 2) != data[4]) {
+      _status |= SHT3x::cmd::STATUS_WRITE_CRC_ERROR;
+      return Status::Ok();
+    }
+    _status &= static_cast<uint16_t>(~SHT3x::cmd::STATUS_WRITE_CRC_ERROR);
+    _alert[index] = static_cast<uint16_t>((data[2] << 8) | data[3]);
+    return Status::Ok();
+  }
+
+  static uint8_t _alertIndexFor(uint16_t command) {
+    switch (command) {
+      case SHT3x::cmd::CMD_ALERT_READ_HIGH_CLEAR: return 1;
+      case SHT3x::cmd::CMD_ALERT_READ_LOW_CLEAR: return 2;
+      case SHT3x::cmd::CMD_ALERT_READ_LOW_SET: return 3;
+      case SHT3x::cmd::CMD_ALERT_READ_HIGH_SET:
+      default: return 0;
+    }
+  }
+
+  static SHT3x::Repeatability _repeatabilityFor(uint16_t command) {
+    switch (command) {
+      case SHT3x::cmd::CMD_SINGLE_SHOT_STRETCH_MED:
+      case SHT3x::cmd::CMD_SINGLE_SHOT_NO_STRETCH_MED:
+      case SHT3x::cmd::CMD_PERIODIC_0_5_MED:
+      case SHT3x::cmd::CMD_PERIODIC_1_MED:
+      case SHT3x::cmd::CMD_PERIODIC_2_MED:
+      case SHT3x::cmd::CMD_PERIODIC_4_MED:
+      case SHT3x::cmd::CMD_PERIODIC_10_MED: return SHT3x::Repeatability::MEDIUM_REPEATABILITY;
+      case SHT3x::cmd::CMD_SINGLE_SHOT_STRETCH_LOW:
+      case SHT3x::cmd::CMD_SINGLE_SHOT_NO_STRETCH_LOW:
+      case SHT3x::cmd::CMD_PERIODIC_0_5_LOW:
+      case SHT3x::cmd::CMD_PERIODIC_1_LOW:
+      case SHT3x::cmd::CMD_PERIODIC_2_LOW:
+      case SHT3x::cmd::CMD_PERIODIC_4_LOW:
+      case SHT3x::cmd::CMD_PERIODIC_10_LOW: return SHT3x::Repeatability::LOW_REPEATABILITY;
+      default: return SHT3x::Repeatability::HIGH_REPEATABILITY;
+    }
+  }
+
+  static uint32_t _conversionUs(SHT3x::Repeatability rep) {
+    switch (rep) {
+      case SHT3x::Repeatability::LOW_REPEATABILITY: return 2500;
+      case SHT3x::Repeatability::MEDIUM_REPEATABILITY: return 4500;
+      default: return 12500;
+    }
+  }
+
+  static uint32_t _singleShotUs(uint16_t command) {
+    switch (command) {
+      case SHT3x::cmd::CMD_SINGLE_SHOT_STRETCH_HIGH:
+      case SHT3x::cmd::CMD_SINGLE_SHOT_NO_STRETCH_HIGH: return 12500;
+      case SHT3x::cmd::CMD_SINGLE_SHOT_STRETCH_MED:
+      case SHT3x::cmd::CMD_SINGLE_SHOT_NO_STRETCH_MED: return 4500;
+      case SHT3x::cmd::CMD_SINGLE_SHOT_STRETCH_LOW:
+      case SHT3x::cmd::CMD_SINGLE_SHOT_NO_STRETCH_LOW: return 2500;
+      default: return 0;
+    }
+  }
+
+  static uint32_t _periodUs(uint16_t command) {
+    switch (command) {
+      case SHT3x::cmd::CMD_PERIODIC_0_5_HIGH:
+      case SHT3x::cmd::CMD_PERIODIC_0_5_MED:
+      case SHT3x::cmd::CMD_PERIODIC_0_5_LOW: return 2000000;
+      case SHT3x::cmd::CMD_PERIODIC_1_HIGH:
+      case SHT3x::cmd::CMD_PERIODIC_1_MED:
+      case SHT3x::cmd::CMD_PERIODIC_1_LOW: return 1000000;
+      case SHT3x::cmd::CMD_PERIODIC_2_HIGH:
+      case SHT3x::cmd::CMD_PERIODIC_2_MED:
+      case SHT3x::cmd::CMD_PERIODIC_2_LOW: return 500000;
+      case SHT3x::cmd::CMD_PERIODIC_4_HIGH:
+      case SHT3x::cmd::CMD_PERIODIC_4_MED:
+      case SHT3x::cmd::CMD_PERIODIC_4_LOW:
+      case SHT3x::cmd::CMD_ART: return 250000;
+      case SHT3x::cmd::CMD_PERIODIC_10_HIGH:
+      case SHT3x::cmd::CMD_PERIODIC_10_MED:
+      case SHT3x::cmd::CMD_PERIODIC_10_LOW: return 100000;
+      default: return 0;
+    }
+  }
+};
+
+inline Status virtualWrite(uint8_t addr, const uint8_t* data, size_t len,
+                           uint32_t timeoutMs, void* user) {
+  (void)timeoutMs;
+  return static_cast<VirtualSht3x*>(user)->write(addr, data, len);
+}
+
+inline Status virtualWriteRead(uint8_t addr, const uint8_t* txData, size_t txLen,
+                               uint8_t* rxData, size_t rxLen, uint32_t timeoutMs,
+                               void* user) {
+  (void)txData;
+  (void)timeoutMs;
+  if (txLen != 0) {
+    return Status::Error(Err::INVALID_PARAM, "Combined write+read not supported");
+  }
+  return static_cast<VirtualSht3x*>(user)->read(addr, rxData, rxLen);
+}
+
+/// Point a driver Config at a virtual device and clock.
+/// The virtual transport can prove read-header NACK.
+inline void attach(SHT3x::Config& cfg, VirtualSht3x& device, Clock& clock) {
+  device.clock = &clock;
+  cfg.i2cWrite = virtualWrite;
+  cfg.i2cWriteRead = virtualWriteRead;
+  cfg.i2cUser = &device;
+  cfg.nowMs = clockNowMs;
+  cfg.nowUs = clockNowUs;
+  cfg.cooperativeYield = clockYield;
+  cfg.sleepUntilUs = clockSleepUntilUs;
+  cfg.timeUser = &clock;
+  cfg.i2cAddress = device.address;
+  cfg.transportCapabilities = SHT3x::TransportCapability::READ_HEADER_NACK;
+}
+
+} // namespace sim
@@ -0,0 +1,339 @@
+/// @file main.cpp
+/// @brief Event-driven Linux gateway daemon driving many SHT3x instances
+/// @note NOT part of the library API. Example-only. Linux host build:
+///
+///   g++ -std=c++17 -O2 -Iinclude -Iexamples src/SHT3x.cpp
+///       examples/host/gateway_epoll/main.cpp -o sht3x_gateway
+///   ./sht3x_gateway --sensors 1000 --period-ms 1000 --seconds 10
+///
+/// One owner thread services every sensor. A single timerfd is armed for the
+/// earliest due job, the thread blocks in epoll_wait(), and pollJob() is only
+/// called for sensors whose next step is due. Sensors run on the virtual
+/// transport from examples/host/common/VirtualSht3x.h against CLOCK_MONOTONIC.
+
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "SHT3x/SHT3x.h"
+#include "host/common/VirtualSht3x.h"
+
+namespace {
+
+struct Options {
+  uint32_t sensors = 1000;
+  uint32_t periodMs = 1000;
+  uint32_t seconds = 10;
+  uint32_t deadlineMs = 100;
+  SHT3x::Repeatability repeatability = SHT3x::Repeatability::HIGH_REPEATABILITY;
+};
+
+struct Sensor {
+  SHT3x::SHT3x driver;
+  sim::VirtualSht3x device;
+  uint64_t slotUs = 0;       ///< Scheduled start of the current/next measurement
+  bool jobActive = false;
+  bool startupDone = false;
+};
+
+struct Stats {
+  uint64_t samples = 0;
+  uint64_t failures = 0;
+  uint64_t deadlineMisses = 0;
+  uint64_t overruns = 0;
+  uint64_t polls = 0;
+  uint64_t busCallbacks = 0;
+  uint64_t wakeups = 0;
+  uint64_t latencySumUs = 0;
+  uint64_t latencyMaxUs = 0;
+};
+
+using DueEntry = std::pair<uint64_t, uint32_t>;  // (due time us, sensor index)
+using DueHeap = std::vector<DueEntry>;
+
+void pushDue(DueHeap& heap, uint64_t dueUs, uint32_t index) {
+  heap.emplace_back(dueUs, index);
+  std::push_heap(heap.begin(), heap.end(), std::greater<DueEntry>());
+}
+
+DueEntry popDue(DueHeap& heap) {
+  std::pop_heap(heap.begin(), heap.end(), std::greater<DueEntry>());
+  const DueEntry top = heap.back();
+  heap.pop_back();
+  return top;
+}
+
+bool parseU32(const char* text, uint32_t& out) {
+  char* end = nullptr;
+  const unsigned long value = std::strtoul(text, &end, 10);
+  if (end == text || *end != '\0' || value == 0 || value > 10000000UL) {
+    return false;
+  }
+  out = static_cast<uint32_t>(value);
+  return true;
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+  for (int i = 1; i < argc; ++i) {
+    const char* arg = argv[i];
+    const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    bool ok = value != nullptr;
+    if (std::strcmp(arg, "--sensors") == 0) {
+      ok = ok && parseU32(value, opt.sensors);
+    } else if (std::strcmp(arg, "--period-ms") == 0) {
+      ok = ok && parseU32(value, opt.periodMs);
+    } else if (std::strcmp(arg, "--seconds") == 0) {
+      ok = ok && parseU32(value, opt.seconds);
+    } else if (std::strcmp(arg, "--deadline-ms") == 0) {
+      ok = ok && parseU32(value, opt.deadlineMs);
+    } else if (std::strcmp(arg, "--repeatability") == 0) {
+      if (ok && std::strcmp(value, "low") == 0) {
+        opt.repeatability = SHT3x::Repeatability::LOW_REPEATABILITY;
+      } else if (ok && std::strcmp(value, "medium") == 0) {
+        opt.repeatability = SHT3x::Repeatability::MEDIUM_REPEATABILITY;
+      } else if (ok && std::strcmp(value, "high") == 0) {
+        opt.repeatability = SHT3x::Repeatability::HIGH_REPEATABILITY;
+      } else {
+        ok = false;
+      }
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      std::fprintf(stderr,
+                   "usage: %s [--sensors N] [--period-ms MS] [--seconds S] "
+                   "[--deadline-ms MS] [--repeatability low|medium|high]\n",
+                   argv[0]);
+      return false;
+    }
+    ++i;
+  }
+  return true;
+}
+
+double cpuSeconds() {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+         static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+void armTimer(int timerFd, uint64_t dueUs) {
+  itimerspec spec{};
+  // A zero it_value disarms the timer, so never arm for time zero.
+  dueUs = std::max<uint64_t>(dueUs, 1);
+  spec.it_value.tv_sec = static_cast<time_t>(dueUs / 1000000ULL);
+  spec.it_value.tv_nsec = static_cast<long>((dueUs % 1000000ULL) * 1000ULL);
+  timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &spec, nullptr);
+}
+
+/// Advance one sensor by a single one-callback poll and return its next due time.
+uint64_t service(Sensor& sensor, const Options& opt, uint32_t& nextRequestId,
+                 uint64_t nowUs, Stats& stats) {
+  const uint32_t nowMs = static_cast<uint32_t>(nowUs / 1000ULL);
+  const uint64_t periodUs = static_cast<uint64_t>(opt.periodMs) * 1000ULL;
+
+  if (!sensor.jobActive) {
+    SHT3x::JobRequest request{nextRequestId++, nowMs + opt.deadlineMs, true};
+    if (nextRequestId == 0) {
+      nextRequestId = 1;
+    }
+    const SHT3x::Status st = sensor.startupDone
+                                 ? sensor.driver.requestMeasurement(request)
+                                 : sensor.driver.requestEnsureIdle(request);
+    if (!st.inProgress()) {
+      stats.failures++;
+      return nowUs + periodUs;
+    }
+    sensor.jobActive = true;
+  }
+
+  SHT3x::PollJobResult result;
+  (void)sensor.driver.pollJob(nowMs, 1, result);
+  stats.polls++;
+  stats.busCallbacks += result.instructionsUsed;
+
+  if (!result.terminal) {
+    // Sleep until the driver's next due step: conversion ready, Break/reset
+    // settle end, or the job deadline.
+    uint32_t wakeMs = 0;
+    if (sensor.driver.jobWakeMs(nowMs, wakeMs)) {
+      return nowUs + static_cast<uint64_t>(wakeMs - nowMs) * 1000ULL;
+    }
+    if (result.instructionsUsed > 0) {
+      // The next command or read waits only for tIDLE.
+      return nowUs + static_cast<uint64_t>(sensor.driver.getConfig().commandDelayMs) * 1000ULL;
+    }
+    // Due time unknown: retry after one tick.
+    return nowUs + 1000ULL;
+  }
+
+  sensor.jobActive = false;
+  if (result.type == SHT3x::JobType::ENSURE_IDLE) {
+    sensor.startupDone = result.outcome == SHT3x::JobOutcome::SUCCEEDED;
+    if (!sensor.startupDone) {
+      stats.failures++;
+    }
+    return sensor.slotUs;
+  }
+
+  if (result.completed) {
+    stats.samples++;
+    const uint64_t latencyUs = nowUs - sensor.slotUs;
+    stats.latencySumUs += latencyUs;
+    stats.latencyMaxUs = std::max(stats.latencyMaxUs, latencyUs);
+  } else if (result.outcome == SHT3x::JobOutcome::TIMED_OUT) {
+    stats.deadlineMisses++;
+  } else {
+    stats.failures++;
+  }
+
+  sensor.slotUs += periodUs;
+  while (sensor.slotUs <= nowUs) {
+    sensor.slotUs += periodUs;
+    stats.overruns++;
+  }
+  return sensor.slotUs;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, opt)) {
+    return 2;
+  }
+
+  sim::Clock clock;
+  std::vector<Sensor> sensors(opt.sensors);
+  const uint64_t startUs = sim::monotonicUs();
+  const uint64_t periodUs = static_cast<uint64_t>(opt.periodMs) * 1000ULL;
+  DueHeap heap;
+  heap.reserve(opt.sensors);
+
+  for (uint32_t i = 0; i < opt.sensors; ++i) {
+    Sensor& sensor = sensors[i];
+    SHT3x::Config cfg;
+    sim::attach(cfg, sensor.device, clock);
+    cfg.repeatability = opt.repeatability;
+    cfg.healthPolicy = SHT3x::HealthPolicy::OBSERVE_ONLY;
+    const SHT3x::Status st = sensor.driver.bind(cfg);
+    if (!st.ok()) {
+      std::fprintf(stderr, "bind failed for sensor %u: %s\n", i, st.msg);
+      return 1;
+    }
+    // Spread first slots across one period so bus work is evenly staggered.
+    sensor.slotUs = startUs + periodUs + (periodUs * i) / opt.sensors;
+    pushDue(heap, startUs + (periodUs * i) / opt.sensors, i);
+  }
+
+  sigset_t mask;
+  sigemptyset(&mask);
+  sigaddset(&mask, SIGINT);
+  sigaddset(&mask, SIGTERM);
+  sigprocmask(SIG_BLOCK, &mask, nullptr);
+  const int signalFd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+  const int timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  const int epollFd = epoll_create1(EPOLL_CLOEXEC);
+  if (signalFd < 0 || timerFd < 0 || epollFd < 0) {
+    std::perror("gateway setup");
+    return 1;
+  }
+  epoll_event ev{};
+  ev.events = EPOLLIN;
+  ev.data.fd = timerFd;
+  epoll_ctl(epollFd, EPOLL_CTL_ADD, timerFd, &ev);
+  ev.data.fd = signalFd;
+  epoll_ctl(epollFd, EPOLL_CTL_ADD, signalFd, &ev);
+
+  std::printf("gateway: %u sensors, period %u ms, %u s, one timerfd + epoll\n",
+              opt.sensors, opt.periodMs, opt.seconds);
+
+  Stats stats;
+  Stats lastReport;
+  uint32_t nextRequestId = 1;
+  const uint64_t endUs = startUs + static_cast<uint64_t>(opt.seconds) * 1000000ULL;
+  uint64_t reportUs = startUs + 1000000ULL;
+  const double cpuStart = cpuSeconds();
+  bool running = true;
+
+  while (running) {
+    const uint64_t nextUs = heap.empty() ? endUs : std::min(heap.front().first, endUs);
+    armTimer(timerFd, nextUs);
+
+    epoll_event events[2];
+    const int n = epoll_wait(epollFd, events, 2, -1);
+    if (n < 0) {
+      continue;
+    }
+    stats.wakeups++;
+    for (int e = 0; e < n; ++e) {
+      if (events[e].data.fd == signalFd) {
+        running = false;
+      } else {
+        uint64_t expirations = 0;
+        (void)read(timerFd, &expirations, sizeof(expirations));
+      }
+    }
+
+    uint64_t nowUs = sim::monotonicUs();
+    while (!heap.empty() && heap.front().first <= nowUs) {
+      const DueEntry due = popDue(heap);
+      const uint64_t nextDueUs =
+          service(sensors[due.second], opt, nextRequestId, nowUs, stats);
+      pushDue(heap, nextDueUs, due.second);
+      nowUs = sim::monotonicUs();
+    }
+
+    if (nowUs >= reportUs) {
+      std::printf("  t=%3llus samples/s=%llu polls/s=%llu wakeups/s=%llu\n",
+                  static_cast<unsigned long long>((nowUs - startUs) / 1000000ULL),
+                  static_cast<unsigned long long>(stats.samples - lastReport.samples),
+                  static_cast<unsigned long long>(stats.polls - lastReport.polls),
+                  static_cast<unsigned long long>(stats.wakeups - lastReport.wakeups));
+      lastReport = stats;
+      reportUs += 1000000ULL;
+    }
+    if (nowUs >= endUs) {
+      running = false;
+    }
+  }
+
+  const double wallS = static_cast<double>(sim::monotonicUs() - startUs) / 1e6;
+  const double cpuS = cpuSeconds() - cpuStart;
+  std::printf("summary:\n");
+  std::printf("  samples=%llu (%.1f samples/s) failures=%llu deadline_misses=%llu "
+              "overruns=%llu\n",
+              static_cast<unsigned long long>(stats.samples),
+              static_cast<double>(stats.samples) / wallS,
+              static_cast<unsigned long long>(stats.failures),
+              static_cast<unsigned long long>(stats.deadlineMisses),
+              static_cast<unsigned long long>(stats.overruns));
+  std::printf("  polls=%llu (%.2f per sample) bus_callbacks=%llu wakeups=%llu\n",
+              static_cast<unsigned long long>(stats.polls),
+              stats.samples ? static_cast<double>(stats.polls) / stats.samples : 0.0,
+              static_cast<unsigned long long>(stats.busCallbacks),
+              static_cast<unsigned long long>(stats.wakeups));
+  std::printf("  slot-to-sample latency avg=%.0f us max=%llu us\n",
+              stats.samples ? static_cast<double>(stats.latencySumUs) / stats.samples : 0.0,
+              static_cast<unsigned long long>(stats.latencyMaxUs));
+  std::printf("  cpu=%.3f s over %.3f s wall (%.2f%% of one core)\n", cpuS, wallS,
+              100.0 * cpuS / wallS);
+
+  close(epollFd);
+  close(timerFd);
+  close(signalFd);
+  return 0;
+}
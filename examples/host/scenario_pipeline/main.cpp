@@ -0,0 +1,274 @@
+/// @file main.cpp
+/// @brief Reproducible end-to-end pipeline run on a generated environment
+/// @note NOT part of the library API. Example-only. Linux host build:
+///
+///   g++ -std=c++17 -O2 -Iinclude -Iexamples src/SHT3x.cpp src/KalmanFilter.cpp
+///       src/SoftAlert.cpp src/DeadBand.cpp examples/host/scenario_pipeline/main.cpp
+///       -o sht3x_scenario_pipeline
+///   ./sht3x_scenario_pipeline --hours 24 --period-ms 1000 --seed 7 --csv day.csv
+///
+/// A virtual SHT3x fed by host/common/ScenarioGenerator.h (diurnal cycle,
+/// door openings, one condensation event, repeatability noise) is sampled
+/// by a cadence job on a virtual clock, so a simulated day at 1 Hz runs in
+/// a fraction of a second. Every sample passes through KalmanFilter and SoftAlert, and
+/// DeadBand decides which samples an uplink would forward. The summary
+/// compares raw and filtered error against the noise-free ground truth,
+/// counts alert transitions and forwarded samples, times the pipeline stages, and prints a
+/// digest of the raw codes: the same options always give the same digest.
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+
+#include "SHT3x/DeadBand.h"
+#include "SHT3x/KalmanFilter.h"
+#include "SHT3x/SHT3x.h"
+#include "SHT3x/SoftAlert.h"
+#include "host/common/ScenarioGenerator.h"
+#include "host/common/VirtualSht3x.h"
+
+namespace {
+
+constexpr uint64_t HOUR_US = 3600ULL * 1000000ULL;
+
+struct Options {
+  uint32_t hours = 24;
+  uint32_t periodMs = 1000;
+  uint64_t seed = 1;
+  SHT3x::Repeatability repeatability = SHT3x::Repeatability::HIGH_REPEATABILITY;
+  const char* csv = nullptr;
+};
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+  for (int i = 1; i < argc; ++i) {
+    const char* arg = argv[i];
+    const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    if (std::strcmp(arg, "--hours") == 0 && value != nullptr) {
+      opt.hours = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+    } else if (std::strcmp(arg, "--period-ms") == 0 && value != nullptr) {
+      opt.periodMs = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+    } else if (std::strcmp(arg, "--seed") == 0 && value != nullptr) {
+      opt.seed = std::strtoull(value, nullptr, 10);
+    } else if (std::strcmp(arg, "--repeatability") == 0 && value != nullptr) {
+      if (std::strcmp(value, "low") == 0) {
+        opt.repeatability = SHT3x::Repeatability::LOW_REPEATABILITY;
+      } else if (std::strcmp(value, "medium") == 0) {
+        opt.repeatability = SHT3x::Repeatability::MEDIUM_REPEATABILITY;
+      } else if (std::strcmp(value, "high") == 0) {
+        opt.repeatability = SHT3x::Repeatability::HIGH_REPEATABILITY;
+      } else {
+        return false;
+      }
+    } else if (std::strcmp(arg, "--csv") == 0 && value != nullptr) {
+      opt.csv = value;
+    } else {
+      std::fprintf(stderr,
+                   "usage: %s [--hours N] [--period-ms N] [--seed N]\n"
+                   "          [--repeatability low|medium|high] [--csv FILE]\n",
+                   argv[0]);
+      return false;
+    }
+    ++i;
+  }
+  return opt.hours > 0 && opt.periodMs >= 100;
+}
+
+/// Running root-mean-square error.
+struct Rms {
+  double sum = 0.0;
+  uint64_t n = 0;
+  void add(double error) {
+    sum += error * error;
+    n++;
+  }
+  double value() const { return n > 0 ? std::sqrt(sum / static_cast<double>(n)) : 0.0; }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, opt)) {
+    return 2;
+  }
+
+  // Doors at 08:00, 12:30, and 18:00; a 30 minute shower-style condensation
+  // event at 06:30, repeated every day of the run.
+  constexpr size_t MAX_DAYS = 31;
+  sim::DoorEvent doors[MAX_DAYS * 3];
+  sim::CondensationEvent condensation[MAX_DAYS];
+  const size_t days = opt.hours / 24U + 1U < MAX_DAYS ? opt.hours / 24U + 1U : MAX_DAYS;
+  for (size_t d = 0; d < days; ++d) {
+    const uint64_t dayUs = d * 24ULL * HOUR_US;
+    doors[d * 3 + 0].startUs = dayUs + 8ULL * HOUR_US;
+    doors[d * 3 + 1].startUs = dayUs + 12ULL * HOUR_US + HOUR_US / 2U;
+    doors[d * 3 + 1].openMs = 20000;
+    doors[d * 3 + 2].startUs = dayUs + 18ULL * HOUR_US;
+    doors[d * 3 + 2].openMs = 180000;
+    condensation[d].startUs = dayUs + 6ULL * HOUR_US + HOUR_US / 2U;
+  }
+  sim::ScenarioConfig scenario;
+  scenario.seed = opt.seed;
+  scenario.doors = doors;
+  scenario.doorCount = days * 3;
+  scenario.condensation = condensation;
+  scenario.condensationCount = days;
+
+  sim::Clock clock;
+  clock.virtualTime = true;
+  sim::VirtualSht3x device;
+  sim::ScenarioGenerator generator(scenario);
+  generator.attach(device);
+
+  SHT3x::Config cfg;
+  sim::attach(cfg, device, clock);
+  cfg.repeatability = opt.repeatability;
+  SHT3x::SHT3x driver;
+  if (!driver.bind(cfg).ok()) {
+    std::fprintf(stderr, "bind failed\n");
+    return 1;
+  }
+
+  SHT3x::KalmanFilter kalman;
+  SHT3x::KalmanConfig kalmanConfig;
+  kalmanConfig.repeatability = opt.repeatability;
+  (void)kalman.configure(kalmanConfig);
+
+  SHT3x::SoftAlertThreshold thresholds[2];
+  thresholds[0].channel = SHT3x::SoftAlertChannel::HUMIDITY;
+  thresholds[0].kind = SHT3x::SoftAlertKind::HIGH_ALERT;
+  thresholds[0].setMilli = 80000;
+  thresholds[0].clearMilli = 75000;
+  thresholds[1].channel = SHT3x::SoftAlertChannel::TEMPERATURE;
+  thresholds[1].kind = SHT3x::SoftAlertKind::LOW_ALERT;
+  thresholds[1].setMilli = 19000;
+  thresholds[1].clearMilli = 19500;
+  SHT3x::SoftAlert alerts;
+  (void)alerts.configure(thresholds, 2);
+
+  // Report by exception: 0.1 C / 0.5 %RH dead-band, 60 s heartbeat.
+  SHT3x::DeadBand uplink;
+  (void)uplink.configure(SHT3x::DeadBandConfig{});
+
+  FILE* csv = nullptr;
+  if (opt.csv != nullptr) {
+    csv = std::fopen(opt.csv, "w");
+    if (csv == nullptr) {
+      std::fprintf(stderr, "cannot open %s\n", opt.csv);
+      return 1;
+    }
+    std::fprintf(csv, "time_s,truth_t,truth_rh,raw_t,raw_rh,kalman_t,kalman_rh\n");
+  }
+
+  SHT3x::CadenceRequest request;
+  request.requestId = 1;
+  request.periodMs = opt.periodMs;
+  request.firstSlotMs = 1;
+  if (!driver.requestCadence(request).inProgress()) {
+    std::fprintf(stderr, "requestCadence failed\n");
+    return 1;
+  }
+
+  const uint64_t endUs = static_cast<uint64_t>(opt.hours) * HOUR_US;
+  Rms rawT;
+  Rms rawRh;
+  Rms filteredT;
+  Rms filteredRh;
+  uint64_t samples = 0;
+  uint64_t polls = 0;
+  uint64_t alertEvents = 0;
+  uint64_t digest = 1469598103934665603ULL;  // FNV-1a
+  std::chrono::nanoseconds pipelineNs{0};
+  const auto wallStart = std::chrono::steady_clock::now();
+
+  while (clock.nowUs() < endUs) {
+    SHT3x::PollJobResult result;
+    (void)driver.pollJob(sim::clockNowMs(&clock), 1, result);
+    polls++;
+    if (result.terminal) {
+      std::fprintf(stderr, "cadence job ended: code %u\n",
+                   static_cast<unsigned>(result.status.code));
+      return 1;
+    }
+    if (!result.completed) {
+      clock.advanceUs(1000);
+      continue;
+    }
+
+    samples++;
+    SHT3x::RawSample raw;
+    (void)driver.getRawSample(raw);
+    for (uint16_t word : {raw.rawTemperature, raw.rawHumidity}) {
+      digest = (digest ^ (word >> 8)) * 1099511628211ULL;
+      digest = (digest ^ (word & 0xFFU)) * 1099511628211ULL;
+    }
+
+    const auto stageStart = std::chrono::steady_clock::now();
+    (void)kalman.update(driver);
+    SHT3x::SoftAlertEvent events[2];
+    size_t written = 0;
+    (void)alerts.update(driver, events, 2, written);
+    SHT3x::DeadBandReason reason;
+    (void)uplink.update(driver, reason);
+    pipelineNs += std::chrono::steady_clock::now() - stageStart;
+    alertEvents += written;
+
+    const uint64_t sampleUs = static_cast<uint64_t>(driver.sampleTimestampMs()) * 1000ULL;
+    int32_t truthT = 0;
+    int32_t truthRh = 0;
+    generator.truth(sampleUs, truthT, truthRh);
+    SHT3x::MeasurementMilli measured;
+    (void)driver.getMeasurementMilli(measured);
+    SHT3x::KalmanEstimate estimate;
+    (void)kalman.getEstimate(estimate);
+    rawT.add(measured.temperatureMilliCelsius - truthT);
+    rawRh.add(measured.humidityMilliPercent - truthRh);
+    filteredT.add(estimate.temperatureMilliCelsius - truthT);
+    filteredRh.add(estimate.humidityMilliPercent - truthRh);
+    if (csv != nullptr) {
+      std::fprintf(csv, "%.3f,%d,%d,%d,%d,%d,%d\n", static_cast<double>(sampleUs) / 1e6,
+                   truthT, truthRh, measured.temperatureMilliCelsius,
+                   measured.humidityMilliPercent, estimate.temperatureMilliCelsius,
+                   estimate.humidityMilliPercent);
+    }
+
+    // Jump straight to the next slot instead of polling through the gap.
+    SHT3x::CadenceStats stats;
+    (void)driver.getCadenceStats(stats);
+    const uint32_t gapMs = stats.nextSlotMs - sim::clockNowMs(&clock);
+    if (static_cast<int32_t>(gapMs) > 0) {
+      clock.advanceUs(static_cast<uint64_t>(gapMs) * 1000ULL);
+    }
+  }
+
+  const double wallS =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+  if (csv != nullptr) {
+    std::fclose(csv);
+  }
+
+  SHT3x::CadenceStats stats;
+  (void)driver.getCadenceStats(stats);
+  std::printf("scenario: %u h, period %u ms, seed %llu\n", opt.hours, opt.periodMs,
+              static_cast<unsigned long long>(opt.seed));
+  std::printf("samples %llu  polls %llu  skipped slots %u  wall %.2f s\n",
+              static_cast<unsigned long long>(samples), static_cast<unsigned long long>(polls),
+              stats.skippedSlots, wallS);
+  std::printf("raw error RMS:      T %.1f mC  RH %.1f m%%\n", rawT.value(), rawRh.value());
+  std::printf("Kalman error RMS:   T %.1f mC  RH %.1f m%%\n", filteredT.value(),
+              filteredRh.value());
+  std::printf("alert transitions:  %llu\n", static_cast<unsigned long long>(alertEvents));
+  const SHT3x::DeadBandStats forwarded = uplink.stats();
+  std::printf("uplink forwarded:   %u of %u (%.1f %%), %u heartbeats\n", forwarded.reported,
+              forwarded.samples,
+              forwarded.samples > 0 ? 100.0 * forwarded.reported / forwarded.samples : 0.0,
+              forwarded.heartbeats);
+  std::printf("pipeline stage:     %.0f ns/sample (Kalman + SoftAlert + DeadBand)\n",
+              samples > 0 ? static_cast<double>(pipelineNs.count()) / samples : 0.0);
+  std::printf("raw-code digest:    %016llx\n", static_cast<unsigned long long>(digest));
+  return 0;
+}
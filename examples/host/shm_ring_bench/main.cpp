@@ -0,0 +1,309 @@
+/// @file main.cpp
+/// @brief Shared-memory broadcast ring benchmark: one writer, many reader processes
+/// @note NOT part of the library API. Example-only. Linux host build:
+///
+///   g++ -std=c++17 -O2 -Iinclude -Iexamples src/SHT3x.cpp
+///       examples/host/shm_ring_bench/main.cpp -o sht3x_shm_ring_bench -lrt
+///   ./sht3x_shm_ring_bench --readers 8 --samples 2000000
+///   ./sht3x_shm_ring_bench --readers 8 --source driver --sensors 64
+///
+/// The writer publishes into shm_ring::Writer and never waits; each reader is a
+/// separate forked process that attaches by name and consumes every sample it
+/// can, counting overruns and checking each sample for torn payloads.
+/// `--source synthetic` measures the ring alone. `--source driver` feeds the
+/// ring from periodic-mode drivers on virtual sensors, each running one
+/// requestContinuous() job, through Writer::publishCompleted(), i.e. from the
+/// driver's completed pollJob() results.
+
+#include <sched.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "SHT3x/SHT3x.h"
+#include "host/common/ShmSampleRing.h"
+#include "host/common/VirtualSht3x.h"
+
+namespace {
+
+struct Options {
+  uint32_t readers = 8;
+  uint32_t samples = 2000000;
+  uint32_t capacity = 4096;
+  uint32_t rate = 0;       ///< Writer pacing in samples/s (0 = as fast as possible)
+  uint32_t sensors = 64;   ///< Driver source only
+  bool driverSource = false;
+};
+
+struct ReaderReport {
+  uint32_t index;
+  uint64_t received;
+  uint64_t lost;
+  uint64_t overruns;
+  uint64_t torn;
+  uint64_t outOfOrder;
+  double seconds;
+};
+
+bool parseU32(const char* text, uint32_t& out) {
+  char* end = nullptr;
+  const unsigned long value = std::strtoul(text, &end, 10);
+  if (end == text || *end != '\0' || value > 100000000UL) {
+    return false;
+  }
+  out = static_cast<uint32_t>(value);
+  return true;
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+  for (int i = 1; i < argc; i += 2) {
+    const char* arg = argv[i];
+    const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    bool ok = value != nullptr;
+    if (std::strcmp(arg, "--readers") == 0) {
+      ok = ok && parseU32(value, opt.readers) && opt.readers > 0 && opt.readers <= 64;
+    } else if (std::strcmp(arg, "--samples") == 0) {
+      ok = ok && parseU32(value, opt.samples) && opt.samples > 0;
+    } else if (std::strcmp(arg, "--capacity") == 0) {
+      ok = ok && parseU32(value, opt.capacity) && opt.capacity >= 2;
+    } else if (std::strcmp(arg, "--rate") == 0) {
+      ok = ok && parseU32(value, opt.rate);
+    } else if (std::strcmp(arg, "--sensors") == 0) {
+      ok = ok && parseU32(value, opt.sensors) && opt.sensors > 0;
+    } else if (std::strcmp(arg, "--source") == 0) {
+      ok = ok && (std::strcmp(value, "synthetic") == 0 || std::strcmp(value, "driver") == 0);
+      opt.driverSource = ok && std::strcmp(value, "driver") == 0;
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      std::fprintf(stderr,
+                   "usage: %s [--readers N] [--samples N] [--capacity N] [--rate N] "
+                   "[--source synthetic|driver] [--sensors N]\n",
+                   argv[0]);
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Synthetic payload whose fields are all derived from the sequence number so
+/// readers can detect a torn copy.
+shm_ring::Sample syntheticSample(uint64_t seq) {
+  shm_ring::Sample sample;
+  sample.sensorId = static_cast<uint32_t>(seq % 1000U);
+  sample.requestId = static_cast<uint32_t>(seq) + 1U;
+  sample.timestampMs = static_cast<uint32_t>(seq / 10U);
+  sample.rawTemperature = static_cast<uint16_t>(seq);
+  sample.rawHumidity = static_cast<uint16_t>(~seq);
+  sample.temperatureMilliC = static_cast<int32_t>(seq & 0x7FFFU);
+  sample.humidityMilliPct = -static_cast<int32_t>(seq & 0x7FFFU);
+  return sample;
+}
+
+bool syntheticValid(const shm_ring::Sample& s) {
+  const shm_ring::Sample expected = syntheticSample(s.seq);
+  return s.sensorId == expected.sensorId && s.requestId == expected.requestId &&
+         s.timestampMs == expected.timestampMs &&
+         s.rawTemperature == expected.rawTemperature &&
+         s.rawHumidity == expected.rawHumidity &&
+         s.temperatureMilliC == expected.temperatureMilliC &&
+         s.humidityMilliPct == expected.humidityMilliPct;
+}
+
+int runReader(const char* name, uint32_t index, bool checkPayload, int readyFd, int reportFd) {
+  shm_ring::Reader reader;
+  if (!reader.open(name)) {
+    return 1;
+  }
+  const char ready = 'r';
+  (void)write(readyFd, &ready, 1);
+
+  ReaderReport report{};
+  report.index = index;
+  const uint64_t startUs = sim::monotonicUs();
+  uint64_t lastSeq = 0;
+  bool haveLast = false;
+  shm_ring::Sample sample;
+  for (;;) {
+    if (reader.next(sample)) {
+      if (checkPayload && !syntheticValid(sample)) {
+        report.torn++;
+      }
+      if (haveLast && sample.seq <= lastSeq) {
+        report.outOfOrder++;
+      }
+      lastSeq = sample.seq;
+      haveLast = true;
+      continue;
+    }
+    if (reader.writerClosed()) {
+      // Drain anything published between the last empty read and close.
+      while (reader.next(sample)) {
+      }
+      break;
+    }
+    sched_yield();
+  }
+  report.seconds = static_cast<double>(sim::monotonicUs() - startUs) / 1e6;
+  report.received = reader.received();
+  report.lost = reader.lost();
+  report.overruns = reader.overruns();
+  (void)write(reportFd, &report, sizeof(report));
+  return 0;
+}
+
+void pace(const Options& opt, uint64_t published, uint64_t startUs) {
+  if (opt.rate == 0 || (published % 256U) != 0) {
+    return;
+  }
+  const uint64_t targetUs = startUs + published * 1000000ULL / opt.rate;
+  const uint64_t nowUs = sim::monotonicUs();
+  if (targetUs > nowUs) {
+    const uint64_t waitUs = targetUs - nowUs;
+    timespec ts{static_cast<time_t>(waitUs / 1000000ULL),
+                static_cast<long>((waitUs % 1000000ULL) * 1000ULL)};
+    nanosleep(&ts, nullptr);
+  }
+}
+
+uint64_t writeSynthetic(shm_ring::Writer& writer, const Options& opt) {
+  const uint64_t startUs = sim::monotonicUs();
+  for (uint64_t seq = 0; seq < opt.samples; ++seq) {
+    writer.publish(syntheticSample(seq));
+    pace(opt, seq + 1, startUs);
+  }
+  return opt.samples;
+}
+
+uint64_t writeFromDrivers(shm_ring::Writer& writer, const Options& opt) {
+  sim::Clock clock;
+  clock.virtualTime = true;
+  clock.virtualUs = 1000000ULL;
+  std::vector<sim::VirtualSht3x> devices(opt.sensors);
+  std::vector<SHT3x::SHT3x> drivers(opt.sensors);
+
+  for (uint32_t i = 0; i < opt.sensors; ++i) {
+    SHT3x::Config cfg;
+    sim::attach(cfg, devices[i], clock);
+    devices[i].rawTemperature = static_cast<uint16_t>(0x6000U + i);
+    if (!drivers[i].bind(cfg).ok() ||
+        !drivers[i].startPeriodic(SHT3x::PeriodicRate::MPS_10,
+                                  SHT3x::Repeatability::HIGH_REPEATABILITY).ok() ||
+        !drivers[i].requestContinuous(SHT3x::JobRequest{i + 1U, 0, false}).inProgress()) {
+      std::fprintf(stderr, "driver %u setup failed\n", i);
+      return 0;
+    }
+  }
+
+  const uint64_t startUs = sim::monotonicUs();
+  uint64_t published = 0;
+  while (published < opt.samples) {
+    clock.advanceUs(1000);
+    const uint32_t nowMs = sim::clockNowMs(&clock);
+    for (uint32_t i = 0; i < opt.sensors && published < opt.samples; ++i) {
+      // One continuous job per sensor: every completed result is a new sample.
+      SHT3x::PollJobResult result;
+      (void)drivers[i].pollJob(nowMs, 1, result);
+      if (writer.publishCompleted(drivers[i], result, i)) {
+        published++;
+        pace(opt, published, startUs);
+      } else if (result.terminal) {
+        std::fprintf(stderr, "driver %u job ended: %s\n", i, result.status.msg);
+        return published;
+      }
+    }
+  }
+  return published;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, opt)) {
+    return 2;
+  }
+
+  char name[64];
+  std::snprintf(name, sizeof(name), "/sht3x_ring_bench_%ld", static_cast<long>(getpid()));
+  shm_ring::Writer writer;
+  if (!writer.create(name, opt.capacity)) {
+    std::perror("shm ring create");
+    return 1;
+  }
+
+  int readyPipe[2];
+  int reportPipe[2];
+  if (pipe(readyPipe) != 0 || pipe(reportPipe) != 0) {
+    std::perror("pipe");
+    shm_unlink(name);
+    return 1;
+  }
+
+  std::vector<pid_t> children;
+  for (uint32_t i = 0; i < opt.readers; ++i) {
+    const pid_t pid = fork();
+    if (pid == 0) {
+      close(readyPipe[0]);
+      close(reportPipe[0]);
+      _exit(runReader(name, i, !opt.driverSource, readyPipe[1], reportPipe[1]));
+    }
+    children.push_back(pid);
+  }
+  close(readyPipe[1]);
+  close(reportPipe[1]);
+  for (uint32_t i = 0; i < opt.readers; ++i) {
+    char ready = 0;
+    (void)read(readyPipe[0], &ready, 1);
+  }
+
+  const uint64_t startUs = sim::monotonicUs();
+  const uint64_t published = opt.driverSource ? writeFromDrivers(writer, opt)
+                                              : writeSynthetic(writer, opt);
+  const double writeS = static_cast<double>(sim::monotonicUs() - startUs) / 1e6;
+  writer.markClosed();
+
+  std::vector<ReaderReport> reports;
+  ReaderReport report{};
+  while (read(reportPipe[0], &report, sizeof(report)) == static_cast<ssize_t>(sizeof(report))) {
+    reports.push_back(report);
+  }
+  for (pid_t pid : children) {
+    waitpid(pid, nullptr, 0);
+  }
+  std::sort(reports.begin(), reports.end(),
+            [](const ReaderReport& a, const ReaderReport& b) { return a.index < b.index; });
+  shm_unlink(name);
+
+  std::printf("shm ring: source=%s capacity=%u readers=%u rate=%s\n",
+              opt.driverSource ? "driver" : "synthetic", opt.capacity, opt.readers,
+              opt.rate ? "paced" : "unpaced");
+  std::printf("writer: %llu samples in %.3f s (%.2f M/s, %.1f ns/sample)\n",
+              static_cast<unsigned long long>(published), writeS,
+              static_cast<double>(published) / writeS / 1e6,
+              writeS * 1e9 / static_cast<double>(published ? published : 1));
+  std::printf("reader  received      lost  overruns  torn  order   M/s\n");
+  for (const ReaderReport& r : reports) {
+    std::printf("%6u %9llu %9llu %9llu %5llu %6llu %5.2f\n", r.index,
+                static_cast<unsigned long long>(r.received),
+                static_cast<unsigned long long>(r.lost),
+                static_cast<unsigned long long>(r.overruns),
+                static_cast<unsigned long long>(r.torn),
+                static_cast<unsigned long long>(r.outOfOrder),
+                static_cast<double>(r.received) / r.seconds / 1e6);
+  }
+  for (const ReaderReport& r : reports) {
+    if (r.torn != 0 || r.outOfOrder != 0 || r.received + r.lost > published) {
+      return 1;
+    }
+  }
+  return reports.size() == opt.readers ? 0 : 1;
+}
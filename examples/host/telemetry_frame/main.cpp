@@ -0,0 +1,94 @@
+/// @file main.cpp
+/// @brief Telemetry frame encode benchmark and decoder feed
+/// @note NOT part of the library API. Example-only. Linux host build:
+///
+///   g++ -std=c++17 -O2 -Iinclude -Iexamples src/SHT3x.cpp src/Telemetry.cpp
+///       examples/host/telemetry_frame/main.cpp -o sht3x_telemetry_frame
+///   ./sht3x_telemetry_frame | python tools/decode_sht3x_telemetry.py
+///
+/// Runs a few single-shot jobs on a virtual sensor, prints hex frames on
+/// stdout, and reports encode/decode cost on stderr.
+
+#include <cstdint>
+#include <cstdio>
+
+#include "SHT3x/SHT3x.h"
+#include "SHT3x/Telemetry.h"
+#include "host/common/VirtualSht3x.h"
+
+namespace {
+
+constexpr uint32_t ENCODE_ITERATIONS = 2000000;
+
+void printHex(const uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    std::printf("%02x", data[i]);
+  }
+  std::printf("\n");
+}
+
+bool runMeasurement(SHT3x::SHT3x& driver, sim::Clock& clock, uint32_t requestId) {
+  if (!driver.requestMeasurement(SHT3x::JobRequest{requestId, 0, false}).inProgress()) {
+    return false;
+  }
+  SHT3x::PollJobResult result;
+  for (int step = 0; step < 64 && !result.terminal; ++step) {
+    clock.advanceUs(1000);
+    (void)driver.pollJob(sim::clockNowMs(&clock), 1, result);
+  }
+  return result.completed;
+}
+
+} // namespace
+
+int main() {
+  sim::Clock clock;
+  clock.virtualTime = true;
+  clock.virtualUs = 5000000ULL;
+  sim::VirtualSht3x device;
+  SHT3x::Config cfg;
+  sim::attach(cfg, device, clock);
+  SHT3x::SHT3x driver;
+  if (!driver.bind(cfg).ok()) {
+    std::fprintf(stderr, "bind failed\n");
+    return 1;
+  }
+
+  uint8_t frame[SHT3x::TELEMETRY_FRAME_LEN];
+  size_t written = 0;
+  for (uint16_t seq = 0; seq < 3; ++seq) {
+    device.rawTemperature = static_cast<uint16_t>(0x6000U + seq * 0x100U);
+    if (!runMeasurement(driver, clock, seq + 1U)) {
+      std::fprintf(stderr, "measurement failed\n");
+      return 1;
+    }
+    (void)SHT3x::encodeTelemetryFrame(driver, sim::clockNowMs(&clock), seq, frame,
+                                      sizeof(frame), written);
+    printHex(frame, written);
+  }
+
+  uint32_t sink = 0;
+  uint64_t startUs = sim::monotonicUs();
+  for (uint32_t i = 0; i < ENCODE_ITERATIONS; ++i) {
+    (void)SHT3x::encodeTelemetryFrame(driver, i, static_cast<uint16_t>(i), frame,
+                                      sizeof(frame), written);
+    sink += frame[60];
+  }
+  const double encodeNs =
+      static_cast<double>(sim::monotonicUs() - startUs) * 1000.0 / ENCODE_ITERATIONS;
+
+  SHT3x::TelemetryFrame decoded;
+  startUs = sim::monotonicUs();
+  for (uint32_t i = 0; i < ENCODE_ITERATIONS; ++i) {
+    frame[16] = static_cast<uint8_t>(i);
+    (void)SHT3x::decodeTelemetryFrame(frame, sizeof(frame), decoded);
+    sink += decoded.sequence;
+  }
+  const double decodeNs =
+      static_cast<double>(sim::monotonicUs() - startUs) * 1000.0 / ENCODE_ITERATIONS;
+
+  std::fprintf(stderr, "telemetry frame: %u bytes, encode %.1f ns/frame, decode %.1f ns/frame (%u)\n",
+               static_cast<unsigned>(SHT3x::TELEMETRY_FRAME_LEN), encodeNs, decodeNs,
+               static_cast<unsigned>(sink & 1U));
+  return 0;
+}
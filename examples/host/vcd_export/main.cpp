@@ -0,0 +1,335 @@
+/// @file main.cpp
+/// @brief Value-change dump (VCD) timeline of driver bus activity and job phases
+/// @note NOT part of the library API. Example-only. Linux host build:
+///
+///   g++ -std=c++17 -O2 -Iinclude -Iexamples src/SHT3x.cpp
+///       examples/host/vcd_export/main.cpp -o sht3x_vcd_export
+///   ./sht3x_vcd_export --sensors 8 --ms 2000 --out sht3x.vcd
+///   gtkwave sht3x.vcd      # or: sigrok-cli -I vcd -i sht3x.vcd ...
+///
+/// Runs drivers on virtual sensors (two per virtual bus, addresses 0x44 and
+/// 0x45) on a shared virtual clock, records every transport callback through
+/// host/common/RecordingTransport.h, and writes one VCD scope per sensor:
+///
+///   txn      1 while a transfer is on the wire (400 kHz wire-time model)
+///   read     1 for receive-only reads, 0 for command writes
+///   cmd      last command word written
+///   phase    JobPhase of each poll (enum value; 0 = IDLE)
+///   wait     1 after a poll that found its job waiting (no I2C spent)
+///   gate     1 while the tIDLE command-delay gate is closed after a write
+///   late_us  for transfers that waited on the gate: time from the gate
+///            opening to the transfer, i.e. poll lateness
+///
+/// Timescale is 1 us from the first poll. Idle gaps, gate waits, and late
+/// polls line up directly against logic-analyzer captures of the same run.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "SHT3x/SHT3x.h"
+#include "host/common/RecordingTransport.h"
+#include "host/common/VirtualSht3x.h"
+
+namespace {
+
+struct Options {
+  uint32_t sensors = 4;
+  uint32_t ms = 2000;
+  uint32_t pollUs = 1000;
+  uint32_t periodMs = 100;  ///< Single-shot request spacing per sensor
+  uint32_t busHz = 400000;
+  bool periodic = false;
+  const char* out = "-";
+};
+
+/// Per-sensor VCD variables, in declaration order.
+enum Var : uint32_t { TXN = 0, READ, CMD, PHASE, WAIT, GATE, LATE, VAR_COUNT };
+
+struct VarInfo {
+  const char* name;
+  uint32_t width;
+};
+
+constexpr VarInfo VARS[VAR_COUNT] = {
+    {"txn", 1}, {"read", 1}, {"cmd", 16}, {"phase", 8},
+    {"wait", 1}, {"gate", 1}, {"late_us", 32},
+};
+
+struct Change {
+  uint64_t timeUs;
+  uint64_t order;
+  uint32_t var;  ///< sensor * VAR_COUNT + Var
+  uint32_t value;
+};
+
+struct Sensor {
+  sim::VirtualSht3x device;
+  sim::RecordingTransport recorder;
+  SHT3x::SHT3x driver;
+  uint32_t nextRequestId = 1;
+  uint64_t nextDueUs = 0;
+  int lastPhase = -1;
+  int lastWait = -1;
+  bool gateBlocked = false; ///< Last poll waited on the command-delay gate
+  uint64_t gateOpenUs = 0;
+  size_t seenEvents = 0;
+};
+
+bool parseU32(const char* text, uint32_t& out) {
+  char* end = nullptr;
+  const unsigned long value = std::strtoul(text, &end, 10);
+  if (end == text || *end != '\0' || value == 0 || value > 100000000UL) {
+    return false;
+  }
+  out = static_cast<uint32_t>(value);
+  return true;
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+  for (int i = 1; i < argc; i += 2) {
+    const char* arg = argv[i];
+    const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    bool ok = value != nullptr;
+    if (std::strcmp(arg, "--sensors") == 0) {
+      ok = ok && parseU32(value, opt.sensors) && opt.sensors <= 256;
+    } else if (std::strcmp(arg, "--ms") == 0) {
+      ok = ok && parseU32(value, opt.ms);
+    } else if (std::strcmp(arg, "--poll-us") == 0) {
+      ok = ok && parseU32(value, opt.pollUs);
+    } else if (std::strcmp(arg, "--period-ms") == 0) {
+      ok = ok && parseU32(value, opt.periodMs);
+    } else if (std::strcmp(arg, "--bus-hz") == 0) {
+      ok = ok && parseU32(value, opt.busHz);
+    } else if (std::strcmp(arg, "--mode") == 0) {
+      ok = ok && (std::strcmp(value, "single") == 0 || std::strcmp(value, "periodic") == 0);
+      opt.periodic = ok && std::strcmp(value, "periodic") == 0;
+    } else if (std::strcmp(arg, "--out") == 0) {
+      opt.out = value != nullptr ? value : opt.out;
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      std::fprintf(stderr,
+                   "usage: %s [--sensors N] [--ms N] [--poll-us N] [--period-ms N] "
+                   "[--bus-hz N] [--mode single|periodic] [--out FILE|-]\n",
+                   argv[0]);
+      return false;
+    }
+  }
+  return true;
+}
+
+/// VCD identifier: printable ASCII '!'..'~', base 94.
+void vcdId(uint32_t index, char* out) {
+  size_t n = 0;
+  do {
+    out[n++] = static_cast<char>('!' + index % 94U);
+    index /= 94U;
+  } while (index != 0 && n < 7);
+  out[n] = '\0';
+}
+
+void writeValue(FILE* f, uint32_t var, uint32_t value) {
+  char id[8];
+  vcdId(var, id);
+  const uint32_t width = VARS[var % VAR_COUNT].width;
+  if (width == 1) {
+    std::fprintf(f, "%u%s\n", value & 1U, id);
+    return;
+  }
+  char bits[33];
+  size_t n = 0;
+  for (int bit = static_cast<int>(width) - 1; bit >= 0; --bit) {
+    const bool set = (value >> bit) & 1U;
+    if (set || n != 0 || bit == 0) {
+      bits[n++] = set ? '1' : '0';
+    }
+  }
+  bits[n] = '\0';
+  std::fprintf(f, "b%s %s\n", bits, id);
+}
+
+void writeVcd(FILE* f, const Options& opt, std::vector<Change>& changes) {
+  std::fprintf(f, "$version sht3x_vcd_export $end\n$timescale 1us $end\n");
+  std::fprintf(f, "$comment phase: 0 IDLE 1 SS_CMD 2 SS_CONV 3 SS_READ 4 FETCH_CMD "
+                  "5 PERIODIC_READ 6 BREAK_CMD 7 BREAK_WAIT 8 RESET_CMD 9 RESET_WAIT "
+                  "10 STATUS_CMD 11 STATUS_READ $end\n");
+  for (uint32_t s = 0; s < opt.sensors; ++s) {
+    if (s % 2U == 0) {
+      std::fprintf(f, "$scope module bus%u $end\n", s / 2U);
+    }
+    std::fprintf(f, "$scope module sensor%u_0x%02x $end\n", s,
+                 (s % 2U == 0) ? SHT3x::cmd::I2C_ADDR_LOW : SHT3x::cmd::I2C_ADDR_HIGH);
+    for (uint32_t v = 0; v < VAR_COUNT; ++v) {
+      char id[8];
+      vcdId(s * VAR_COUNT + v, id);
+      std::fprintf(f, "$var %s %u %s %s $end\n", VARS[v].width == 1 ? "wire" : "reg",
+                   VARS[v].width, id, VARS[v].name);
+    }
+    std::fprintf(f, "$upscope $end\n");
+    if (s % 2U == 1 || s + 1 == opt.sensors) {
+      std::fprintf(f, "$upscope $end\n");
+    }
+  }
+  std::fprintf(f, "$enddefinitions $end\n#0\n$dumpvars\n");
+  for (uint32_t var = 0; var < opt.sensors * VAR_COUNT; ++var) {
+    writeValue(f, var, 0);
+  }
+  std::fprintf(f, "$end\n");
+
+  std::stable_sort(changes.begin(), changes.end(), [](const Change& a, const Change& b) {
+    return a.timeUs != b.timeUs ? a.timeUs < b.timeUs : a.order < b.order;
+  });
+  uint64_t currentUs = 0;
+  for (const Change& c : changes) {
+    if (c.timeUs != currentUs) {
+      currentUs = c.timeUs;
+      std::fprintf(f, "#%llu\n", static_cast<unsigned long long>(currentUs));
+    }
+    writeValue(f, c.var, c.value);
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, opt)) {
+    return 2;
+  }
+
+  sim::Clock clock;
+  clock.virtualTime = true;
+  clock.virtualUs = 1000000ULL;
+  std::vector<std::unique_ptr<Sensor>> sensors;
+  for (uint32_t i = 0; i < opt.sensors; ++i) {
+    sensors.emplace_back(new Sensor());
+    Sensor& s = *sensors.back();
+    s.device.address = (i % 2U == 0) ? SHT3x::cmd::I2C_ADDR_LOW : SHT3x::cmd::I2C_ADDR_HIGH;
+    s.recorder.busHz = opt.busHz;
+    SHT3x::Config cfg;
+    sim::attach(cfg, s.device, clock);
+    s.recorder.wrap(cfg, clock);
+    // Stagger sensors across the request period so the timeline is readable.
+    s.nextDueUs = clock.nowUs() + (static_cast<uint64_t>(opt.periodMs) * 1000ULL * i) /
+                                      opt.sensors;
+    if (!s.driver.bind(cfg).ok()) {
+      std::fprintf(stderr, "sensor %u bind failed\n", i);
+      return 1;
+    }
+    if (opt.periodic &&
+        (!s.driver.startPeriodic(SHT3x::PeriodicRate::MPS_10,
+                                 SHT3x::Repeatability::HIGH_REPEATABILITY).ok() ||
+         !s.driver.requestContinuous(SHT3x::JobRequest{1, 0, false}).inProgress())) {
+      std::fprintf(stderr, "sensor %u periodic start failed\n", i);
+      return 1;
+    }
+  }
+
+  const uint64_t originUs = clock.nowUs();
+  const uint64_t endUs = originUs + static_cast<uint64_t>(opt.ms) * 1000ULL;
+  std::vector<Change> changes;
+  uint64_t order = 0;
+  auto record = [&](uint64_t atUs, uint32_t sensor, Var var, uint32_t value) {
+    const uint64_t t = atUs > originUs ? atUs - originUs : 0;
+    changes.push_back(Change{t, order++, sensor * VAR_COUNT + var, value});
+  };
+  for (auto& s : sensors) {
+    s->recorder.clear();  // Setup traffic precedes the timeline.
+  }
+
+  const uint64_t commandDelayUs = static_cast<uint64_t>(SHT3x::Config{}.commandDelayMs) * 1000ULL;
+  uint64_t completed = 0;
+  uint64_t failed = 0;
+  uint64_t lateMaxUs = 0;
+  for (uint64_t tickUs = originUs; tickUs < endUs; tickUs += opt.pollUs) {
+    // Blocking transfers may already have pushed the clock past this tick.
+    clock.virtualUs = std::max(clock.virtualUs, tickUs);
+    for (uint32_t i = 0; i < opt.sensors; ++i) {
+      Sensor& s = *sensors[i];
+      const uint64_t pollUs = clock.nowUs();
+      if (!opt.periodic && pollUs >= s.nextDueUs) {
+        const SHT3x::JobRequest request{s.nextRequestId, 0, false};
+        if (s.driver.requestMeasurement(request).inProgress()) {
+          s.nextRequestId++;
+          s.nextDueUs += static_cast<uint64_t>(opt.periodMs) * 1000ULL;
+        }
+      }
+      SHT3x::PollJobResult result;
+      (void)s.driver.pollJob(static_cast<uint32_t>(pollUs / 1000ULL), 1, result);
+      if (result.completed) {
+        completed++;
+      } else if (result.terminal) {
+        failed++;
+      }
+
+      const auto& events = s.recorder.events();
+      for (; s.seenEvents < events.size(); ++s.seenEvents) {
+        const sim::TransportEvent& e = events[s.seenEvents];
+        if (s.gateBlocked && e.startUs >= s.gateOpenUs) {
+          const uint64_t lateUs = e.startUs - s.gateOpenUs;
+          lateMaxUs = std::max(lateMaxUs, lateUs);
+          record(e.startUs, i, LATE, static_cast<uint32_t>(lateUs));
+        }
+        record(e.startUs, i, READ, e.read ? 1U : 0U);
+        if (!e.read) {
+          record(e.startUs, i, CMD, e.command);
+        }
+        record(e.startUs, i, TXN, 1);
+        record(e.endUs, i, TXN, 0);
+        if (!e.read && e.result == SHT3x::Err::OK) {
+          record(e.endUs, i, GATE, 1);
+          record(e.endUs + commandDelayUs, i, GATE, 0);
+          s.gateOpenUs = e.endUs + commandDelayUs;
+        }
+      }
+      s.gateBlocked = std::strcmp(result.status.msg, "Command delay pending") == 0;
+
+      const int phase = static_cast<int>(result.phase);
+      const int wait = (result.active && result.instructionsUsed == 0) ? 1 : 0;
+      if (phase != s.lastPhase) {
+        record(pollUs, i, PHASE, static_cast<uint32_t>(phase));
+        s.lastPhase = phase;
+      }
+      if (wait != s.lastWait) {
+        record(pollUs, i, WAIT, static_cast<uint32_t>(wait));
+        s.lastWait = wait;
+      }
+    }
+  }
+
+  FILE* f = std::strcmp(opt.out, "-") == 0 ? stdout : std::fopen(opt.out, "w");
+  if (f == nullptr) {
+    std::perror("open output");
+    return 1;
+  }
+  writeVcd(f, opt, changes);
+  if (f != stdout) {
+    std::fclose(f);
+  }
+
+  uint64_t transactions = 0;
+  uint64_t busyUs = 0;
+  for (const auto& s : sensors) {
+    for (const sim::TransportEvent& e : s->recorder.events()) {
+      transactions++;
+      busyUs += e.endUs - e.startUs;
+    }
+  }
+  std::fprintf(stderr,
+               "vcd: %u sensors, %u ms, %zu changes, %llu transfers "
+               "(%.2f%% wire time per bus), %llu samples, %llu failed jobs, max late %llu us\n",
+               opt.sensors, opt.ms, changes.size(),
+               static_cast<unsigned long long>(transactions),
+               100.0 * static_cast<double>(busyUs) /
+                   (static_cast<double>(opt.ms) * 1000.0 * ((opt.sensors + 1U) / 2U)),
+               static_cast<unsigned long long>(completed),
+               static_cast<unsigned long long>(failed),
+               static_cast<unsigned long long>(lateMaxUs));
+  return failed == 0 ? 0 : 1;
+}
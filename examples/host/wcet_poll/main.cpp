@@ -0,0 +1,566 @@
+/// @file main.cpp
+/// @brief Worst-case instruction count of pollJob() per job phase
+/// @note NOT part of the library API. Example-only. Linux x86-64 host build:
+///
+///   g++ -std=c++17 -O2 -Iinclude -Iexamples src/SHT3x.cpp
+///       examples/host/wcet_poll/main.cpp -o sht3x_wcet_poll
+///   ./sht3x_wcet_poll --budget examples/host/wcet_poll/budget.txt
+///
+/// Drives every JobPhase and failure branch (transport NACK, timeout, bus
+/// error, read-header not-ready, CRC mismatch, deadline expiry, offline
+/// transition, cancellation, queued hand-off) on the virtual SHT3x through a
+/// scripted fault layer, and counts the user-mode instructions each
+/// pollJob() call retires. Counting single-steps the call with the x86 trap
+/// flag, so it is exact and needs neither hardware performance counters nor
+/// valgrind (both are usually unavailable in CI VMs). Instructions executed
+/// inside the transport and clock hooks are excluded: they belong to the
+/// platform, and only the call/return glue around each hook is counted.
+///
+/// The table reports the maximum per JobPhase of the returned result and the
+/// scenario that produced it. With --budget the harness exits nonzero when
+/// any phase exceeds its stored budget; --write-budget stores the measured
+/// maxima plus 25% headroom. Budgets are for g++ -O2 on x86-64; counts move
+/// a few percent between compiler versions, which the headroom absorbs.
+
+#include <signal.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+
+#include "SHT3x/SHT3x.h"
+#include "host/common/VirtualSht3x.h"
+
+#if !defined(__x86_64__)
+#error "wcet_poll counts instructions with the x86-64 trap flag"
+#endif
+
+namespace {
+
+using SHT3x::Err;
+using SHT3x::JobPhase;
+using SHT3x::Status;
+
+constexpr size_t PHASE_COUNT = static_cast<size_t>(JobPhase::ENSURE_STATUS_READ) + 1U;
+constexpr const char* PHASE_NAMES[PHASE_COUNT] = {
+    "IDLE",
+    "SINGLE_SHOT_COMMAND",
+    "SINGLE_SHOT_CONVERSION",
+    "SINGLE_SHOT_READ",
+    "PERIODIC_FETCH_COMMAND",
+    "PERIODIC_READ",
+    "ENSURE_BREAK_COMMAND",
+    "ENSURE_BREAK_WAIT",
+    "ENSURE_RESET_COMMAND",
+    "ENSURE_RESET_WAIT",
+    "ENSURE_STATUS_COMMAND",
+    "ENSURE_STATUS_READ",
+};
+
+// ---------------------------------------------------------------------------
+// Trap-flag instruction counter
+// ---------------------------------------------------------------------------
+
+volatile uint64_t gSteps = 0;
+volatile sig_atomic_t gInHook = 0;
+
+void onTrap(int, siginfo_t*, void*) {
+  if (gInHook == 0) {
+    gSteps = gSteps + 1;
+  }
+}
+
+// pushfq writes below %rsp, so step over the red zone first.
+inline void traceOn() {
+  __asm__ volatile(
+      "sub $128, %%rsp\n\t"
+      "pushfq\n\t"
+      "orq $0x100, (%%rsp)\n\t"
+      "popfq\n\t"
+      "add $128, %%rsp" ::: "cc", "memory");
+}
+
+inline void traceOff() {
+  __asm__ volatile(
+      "sub $128, %%rsp\n\t"
+      "pushfq\n\t"
+      "andq $-257, (%%rsp)\n\t"
+      "popfq\n\t"
+      "add $128, %%rsp" ::: "cc", "memory");
+}
+
+uint64_t gTraceOverhead = 0;
+
+void calibrate() {
+  gSteps = 0;
+  traceOn();
+  traceOff();
+  gTraceOverhead = gSteps;
+}
+
+struct HookScope {
+  HookScope() { gInHook = gInHook + 1; }
+  ~HookScope() { gInHook = gInHook - 1; }
+};
+
+// ---------------------------------------------------------------------------
+// Scripted fault layer over the virtual sensor
+// ---------------------------------------------------------------------------
+
+/// Fault injected into one transport callback. CRC_MISMATCH passes the call
+/// through and corrupts the first CRC byte of the returned frame.
+struct FaultScript {
+  static constexpr size_t MAX_FAULTS = 8;
+  Err faults[MAX_FAULTS] = {};
+  size_t count = 0;
+  size_t next = 0;
+
+  void set(std::initializer_list<Err> list) {
+    count = 0;
+    next = 0;
+    for (Err e : list) {
+      faults[count++] = e;
+    }
+  }
+
+  Err take() { return next < count ? faults[next++] : Err::OK; }
+};
+
+struct Bench {
+  sim::Clock clock;
+  sim::VirtualSht3x device;
+  FaultScript script;
+};
+
+Status injected(Err fault) {
+  return Status::Error(fault, "Injected fault");
+}
+
+Status scriptedWrite(uint8_t addr, const uint8_t* data, size_t len, uint32_t, void* user) {
+  HookScope hook;
+  Bench* b = static_cast<Bench*>(user);
+  const Err fault = b->script.take();
+  if (fault != Err::OK && fault != Err::CRC_MISMATCH) {
+    return injected(fault);
+  }
+  return b->device.write(addr, data, len);
+}
+
+Status scriptedWriteRead(uint8_t addr, const uint8_t*, size_t txLen, uint8_t* rx,
+                         size_t rxLen, uint32_t, void* user) {
+  HookScope hook;
+  Bench* b = static_cast<Bench*>(user);
+  if (txLen != 0) {
+    return Status::Error(Err::INVALID_PARAM, "Combined write+read not supported");
+  }
+  const Err fault = b->script.take();
+  if (fault != Err::OK && fault != Err::CRC_MISMATCH) {
+    return injected(fault);
+  }
+  const Status st = b->device.read(addr, rx, rxLen);
+  if (st.ok() && fault == Err::CRC_MISMATCH && rxLen >= 3) {
+    rx[2] = static_cast<uint8_t>(rx[2] ^ 0xFFU);
+  }
+  return st;
+}
+
+uint32_t hookNowMs(void* user) {
+  HookScope hook;
+  return sim::clockNowMs(user);
+}
+
+uint32_t hookNowUs(void* user) {
+  HookScope hook;
+  return sim::clockNowUs(user);
+}
+
+void hookYield(void* user) {
+  HookScope hook;
+  sim::clockYield(user);
+}
+
+void hookSleepUntilUs(uint32_t targetUs, void* user) {
+  HookScope hook;
+  sim::clockSleepUntilUs(targetUs, user);
+}
+
+// ---------------------------------------------------------------------------
+// Measurement
+// ---------------------------------------------------------------------------
+
+struct PhaseMax {
+  uint64_t calls = 0;
+  uint64_t maxInstructions = 0;
+  const char* scenario = "";
+};
+
+PhaseMax gPhases[PHASE_COUNT];
+uint64_t gOutcomes[static_cast<size_t>(SHT3x::JobOutcome::TIMED_OUT) + 1U] = {};
+const char* gScenario = "";
+bool gTwoClockPoll = false;
+
+/// One traced pollJob() call.
+void tracedPoll(SHT3x::SHT3x& driver, Bench& b, SHT3x::PollJobResult& result,
+                uint8_t budget = 1) {
+  const uint32_t nowMs = sim::clockNowMs(&b.clock);
+  const uint32_t nowUs = sim::clockNowUs(&b.clock);
+  gSteps = 0;
+  if (gTwoClockPoll) {
+    traceOn();
+    (void)driver.pollJob(nowMs, nowUs, budget, result);
+    traceOff();
+  } else {
+    traceOn();
+    (void)driver.pollJob(nowMs, budget, result);
+    traceOff();
+  }
+  const uint64_t steps = gSteps > gTraceOverhead ? gSteps - gTraceOverhead : 0;
+  if (result.terminal) {
+    gOutcomes[static_cast<size_t>(result.outcome)]++;
+  }
+  PhaseMax& p = gPhases[static_cast<size_t>(result.phase)];
+  p.calls++;
+  if (steps > p.maxInstructions) {
+    p.maxInstructions = steps;
+    p.scenario = gScenario;
+  }
+}
+
+/// Poll every stepUs until the job reports a terminal result (or maxPolls).
+void pollToTerminal(SHT3x::SHT3x& driver, Bench& b, uint32_t stepUs = 500,
+                    uint32_t maxPolls = 2000) {
+  for (uint32_t i = 0; i < maxPolls; ++i) {
+    SHT3x::PollJobResult result;
+    tracedPoll(driver, b, result);
+    if (result.terminal) {
+      return;
+    }
+    b.clock.advanceUs(stepUs);
+  }
+}
+
+/// Poll until `samples` completed results, then cancel.
+void pollSamplesThenCancel(SHT3x::SHT3x& driver, Bench& b, uint32_t samples,
+                           uint32_t stepUs = 1000) {
+  uint32_t seen = 0;
+  for (uint32_t i = 0; i < 20000 && seen < samples; ++i) {
+    SHT3x::PollJobResult result;
+    tracedPoll(driver, b, result);
+    if (result.terminal) {
+      return;
+    }
+    seen += result.completed ? 1U : 0U;
+    b.clock.advanceUs(stepUs);
+  }
+  SHT3x::PollJobResult cancelled;
+  (void)driver.cancelJob(SHT3x::CancelReason::REQUESTED, cancelled);
+}
+
+SHT3x::Config makeConfig(Bench& b) {
+  SHT3x::Config cfg;
+  sim::attach(cfg, b.device, b.clock);
+  cfg.i2cWrite = scriptedWrite;
+  cfg.i2cWriteRead = scriptedWriteRead;
+  cfg.i2cUser = &b;
+  cfg.nowMs = hookNowMs;
+  cfg.nowUs = hookNowUs;
+  cfg.cooperativeYield = hookYield;
+  cfg.sleepUntilUs = hookSleepUntilUs;
+  cfg.transportCapabilities = SHT3x::TransportCapability::READ_HEADER_NACK |
+                              SHT3x::TransportCapability::TIMEOUT |
+                              SHT3x::TransportCapability::BUS_ERROR;
+  return cfg;
+}
+
+using Scenario = void (*)(SHT3x::SHT3x&, Bench&);
+
+uint32_t gRequestId = 1;
+
+SHT3x::JobRequest nextRequest(Bench& b, uint32_t deadlineMs = 0) {
+  SHT3x::JobRequest request;
+  request.requestId = gRequestId++;
+  if (deadlineMs != 0) {
+    request.deadlineMs = sim::clockNowMs(&b.clock) + deadlineMs;
+    request.hasDeadline = true;
+  }
+  return request;
+}
+
+void singleShot(SHT3x::SHT3x& d, Bench& b, std::initializer_list<Err> faults,
+                uint32_t deadlineMs = 0) {
+  b.script.set(faults);
+  (void)d.requestMeasurement(nextRequest(b, deadlineMs));
+  pollToTerminal(d, b);
+}
+
+void scenarioIdle(SHT3x::SHT3x& d, Bench& b) {
+  SHT3x::PollJobResult result;
+  tracedPoll(d, b, result);
+  (void)d.requestMeasurement(nextRequest(b));
+  tracedPoll(d, b, result, 0);
+  pollToTerminal(d, b);
+}
+
+void scenarioSingleShotOk(SHT3x::SHT3x& d, Bench& b) {
+  for (SHT3x::Repeatability rep : {SHT3x::Repeatability::LOW_REPEATABILITY,
+                                   SHT3x::Repeatability::MEDIUM_REPEATABILITY,
+                                   SHT3x::Repeatability::HIGH_REPEATABILITY}) {
+    (void)d.setRepeatability(rep);
+    singleShot(d, b, {});
+  }
+}
+
+void scenarioSingleShotReadNack(SHT3x::SHT3x& d, Bench& b) {
+  singleShot(d, b, {Err::OK, Err::I2C_NACK_READ, Err::I2C_NACK_READ});
+}
+
+void scenarioSingleShotCommandFaults(SHT3x::SHT3x& d, Bench& b) {
+  singleShot(d, b, {Err::I2C_NACK_ADDR});
+  singleShot(d, b, {Err::I2C_TIMEOUT});
+  singleShot(d, b, {Err::I2C_BUS});
+}
+
+void scenarioSingleShotReadFaults(SHT3x::SHT3x& d, Bench& b) {
+  singleShot(d, b, {Err::OK, Err::CRC_MISMATCH});
+  singleShot(d, b, {Err::OK, Err::I2C_TIMEOUT});
+  singleShot(d, b, {Err::OK, Err::I2C_BUS});
+}
+
+void scenarioSingleShotDeadline(SHT3x::SHT3x& d, Bench& b) {
+  singleShot(d, b, {}, 2);
+}
+
+void scenarioOfflineTransition(SHT3x::SHT3x& d, Bench& b) {
+  SHT3x::Config cfg = d.getConfig();
+  cfg.offlineThreshold = 2;
+  (void)d.bind(cfg);
+  singleShot(d, b, {Err::I2C_TIMEOUT});
+  singleShot(d, b, {Err::OK, Err::I2C_TIMEOUT});
+}
+
+void scenarioPeriodicFetch(SHT3x::SHT3x& d, Bench& b) {
+  (void)d.startPeriodic(SHT3x::PeriodicRate::MPS_10, SHT3x::Repeatability::HIGH_REPEATABILITY);
+  b.clock.advanceUs(100000);
+  singleShot(d, b, {});
+  singleShot(d, b, {Err::OK, Err::I2C_NACK_READ});
+  b.clock.advanceUs(100000);
+  singleShot(d, b, {Err::OK, Err::CRC_MISMATCH});
+  b.clock.advanceUs(100000);
+  singleShot(d, b, {Err::I2C_BUS});
+}
+
+void scenarioContinuous(SHT3x::SHT3x& d, Bench& b) {
+  (void)d.startPeriodic(SHT3x::PeriodicRate::MPS_10, SHT3x::Repeatability::LOW_REPEATABILITY);
+  b.script.set({});
+  (void)d.requestContinuous(nextRequest(b));
+  pollSamplesThenCancel(d, b, 4);
+}
+
+void scenarioCadence(SHT3x::SHT3x& d, Bench& b) {
+  SHT3x::CadenceRequest request;
+  request.requestId = gRequestId++;
+  request.periodMs = 50;
+  request.firstSlotMs = sim::clockNowMs(&b.clock) + 5;
+  b.script.set({});
+  (void)d.requestCadence(request);
+  pollSamplesThenCancel(d, b, 4);
+}
+
+void ensureIdle(SHT3x::SHT3x& d, Bench& b, std::initializer_list<Err> faults) {
+  b.script.set(faults);
+  (void)d.requestEnsureIdle(nextRequest(b));
+  pollToTerminal(d, b);
+}
+
+void scenarioEnsureIdle(SHT3x::SHT3x& d, Bench& b) {
+  ensureIdle(d, b, {});
+  ensureIdle(d, b, {Err::I2C_NACK_ADDR});
+  ensureIdle(d, b, {Err::OK, Err::I2C_TIMEOUT});
+  ensureIdle(d, b, {Err::OK, Err::OK, Err::I2C_BUS});
+  ensureIdle(d, b, {Err::OK, Err::OK, Err::OK, Err::CRC_MISMATCH});
+  ensureIdle(d, b, {Err::OK, Err::OK, Err::OK, Err::I2C_TIMEOUT});
+}
+
+void scenarioQueuedHandOff(SHT3x::SHT3x& d, Bench& b) {
+  SHT3x::Config cfg = d.getConfig();
+  cfg.jobQueueDepth = 2;
+  (void)d.bind(cfg);
+  b.script.set({});
+  (void)d.requestEnsureIdle(nextRequest(b));
+  (void)d.requestMeasurement(nextRequest(b));
+  (void)d.requestMeasurement(nextRequest(b));
+  pollToTerminal(d, b);
+  pollToTerminal(d, b);
+  pollToTerminal(d, b);
+}
+
+struct NamedScenario {
+  const char* name;
+  Scenario run;
+};
+
+constexpr NamedScenario SCENARIOS[] = {
+    {"idle/zero-budget", scenarioIdle},
+    {"single-shot ok", scenarioSingleShotOk},
+    {"single-shot read NACK", scenarioSingleShotReadNack},
+    {"single-shot command fault", scenarioSingleShotCommandFaults},
+    {"single-shot read fault", scenarioSingleShotReadFaults},
+    {"single-shot deadline", scenarioSingleShotDeadline},
+    {"offline transition", scenarioOfflineTransition},
+    {"periodic fetch", scenarioPeriodicFetch},
+    {"continuous", scenarioContinuous},
+    {"cadence", scenarioCadence},
+    {"ensure-idle", scenarioEnsureIdle},
+    {"queued hand-off", scenarioQueuedHandOff},
+};
+
+void runScenarios() {
+  for (bool twoClock : {false, true}) {
+    gTwoClockPoll = twoClock;
+    for (const NamedScenario& s : SCENARIOS) {
+      Bench b;
+      b.clock.virtualTime = true;
+      b.clock.virtualUs = 1000000;
+      SHT3x::SHT3x driver;
+      if (!driver.bind(makeConfig(b)).ok()) {
+        std::fprintf(stderr, "bind failed for %s\n", s.name);
+        std::exit(2);
+      }
+      gScenario = s.name;
+      s.run(driver, b);
+    }
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Budget file: one "PHASE_NAME instructions" pair per line, '#' comments.
+// ---------------------------------------------------------------------------
+
+bool readBudget(const char* path, uint64_t (&budget)[PHASE_COUNT], bool (&present)[PHASE_COUNT]) {
+  FILE* f = std::fopen(path, "r");
+  if (f == nullptr) {
+    std::fprintf(stderr, "cannot open budget %s\n", path);
+    return false;
+  }
+  char line[128];
+  while (std::fgets(line, sizeof(line), f) != nullptr) {
+    char name[64];
+    unsigned long long value = 0;
+    if (line[0] == '#' || std::sscanf(line, "%63s %llu", name, &value) != 2) {
+      continue;
+    }
+    for (size_t i = 0; i < PHASE_COUNT; ++i) {
+      if (std::strcmp(name, PHASE_NAMES[i]) == 0) {
+        budget[i] = value;
+        present[i] = true;
+      }
+    }
+  }
+  std::fclose(f);
+  return true;
+}
+
+bool writeBudget(const char* path) {
+  FILE* f = std::fopen(path, "w");
+  if (f == nullptr) {
+    std::fprintf(stderr, "cannot write budget %s\n", path);
+    return false;
+  }
+  std::fprintf(f,
+               "# pollJob() worst-case user-mode instructions per call, by result JobPhase.\n"
+               "# Measured maxima + 25%% headroom; g++ -O2, x86-64. Regenerate with\n"
+               "# sht3x_wcet_poll --write-budget <file> after an intentional change.\n");
+  for (size_t i = 0; i < PHASE_COUNT; ++i) {
+    const uint64_t value = (gPhases[i].maxInstructions * 5U + 3U) / 4U;
+    std::fprintf(f, "%s %llu\n", PHASE_NAMES[i], static_cast<unsigned long long>(value));
+  }
+  std::fclose(f);
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const char* budgetPath = nullptr;
+  const char* writePath = nullptr;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--budget") == 0 && i + 1 < argc) {
+      budgetPath = argv[++i];
+    } else if (std::strcmp(argv[i], "--write-budget") == 0 && i + 1 < argc) {
+      writePath = argv[++i];
+    } else {
+      std::fprintf(stderr, "usage: %s [--budget FILE] [--write-budget FILE]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  struct sigaction sa {};
+  sa.sa_sigaction = onTrap;
+  sa.sa_flags = SA_SIGINFO;
+  sigemptyset(&sa.sa_mask);
+  sigaction(SIGTRAP, &sa, nullptr);
+  calibrate();
+
+  runScenarios();
+
+  uint64_t budget[PHASE_COUNT] = {};
+  bool present[PHASE_COUNT] = {};
+  if (budgetPath != nullptr && !readBudget(budgetPath, budget, present)) {
+    return 2;
+  }
+
+  std::printf("%-24s %8s %10s %10s  %s\n", "phase", "calls", "max_instr", "budget",
+              "worst scenario");
+  bool fail = false;
+  uint64_t worst = 0;
+  for (size_t i = 0; i < PHASE_COUNT; ++i) {
+    const PhaseMax& p = gPhases[i];
+    worst = p.maxInstructions > worst ? p.maxInstructions : worst;
+    char budgetText[24] = "-";
+    const char* verdict = "";
+    if (budgetPath != nullptr) {
+      if (!present[i]) {
+        verdict = "  MISSING BUDGET";
+        fail = true;
+      } else {
+        std::snprintf(budgetText, sizeof(budgetText), "%llu",
+                      static_cast<unsigned long long>(budget[i]));
+        if (p.maxInstructions > budget[i]) {
+          verdict = "  OVER BUDGET";
+          fail = true;
+        }
+      }
+    }
+    if (p.calls == 0) {
+      std::printf("%-24s %8s %10s %10s  (not reached)%s\n", PHASE_NAMES[i], "0", "-",
+                  budgetText, verdict);
+      fail = fail || budgetPath != nullptr;
+      continue;
+    }
+    std::printf("%-24s %8llu %10llu %10s  %s%s\n", PHASE_NAMES[i],
+                static_cast<unsigned long long>(p.calls),
+                static_cast<unsigned long long>(p.maxInstructions), budgetText, p.scenario,
+                verdict);
+  }
+  std::printf("terminal polls: %llu succeeded, %llu failed, %llu timed out\n",
+              static_cast<unsigned long long>(
+                  gOutcomes[static_cast<size_t>(SHT3x::JobOutcome::SUCCEEDED)]),
+              static_cast<unsigned long long>(
+                  gOutcomes[static_cast<size_t>(SHT3x::JobOutcome::FAILED)]),
+              static_cast<unsigned long long>(
+                  gOutcomes[static_cast<size_t>(SHT3x::JobOutcome::TIMED_OUT)]));
+  std::printf("worst pollJob() call: %llu instructions (trap overhead %llu subtracted)\n",
+              static_cast<unsigned long long>(worst),
+              static_cast<unsigned long long>(gTraceOverhead));
+
+  if (writePath != nullptr && !writeBudget(writePath)) {
+    return 2;
+  }
+  if (fail) {
+    std::printf("FAIL: pollJob() worst case exceeds the stored budget\n");
+    return 1;
+  }
+  return 0;
+}
@@ -61,6 +61,18 @@ void cooperativeYield(void*) {
   taskYIELD();
 }
 
+void sleepUntilUs(uint32_t targetUs, void*) {
+  // Sleep whole ticks that end before the target; the driver spins out the rest.
+  const int32_t remainingUs = static_cast<int32_t>(targetUs - nowUs(nullptr));
+  const TickType_t ticks =
+      remainingUs > 0 ? pdMS_TO_TICKS(static_cast<uint32_t>(remainingUs) / 1000U) : 0;
+  if (ticks > 0) {
+    vTaskDelay(ticks);
+  } else {
+    taskYIELD();
+  }
+}
+
 void printStatus(const char* label, const SHT3x::Status& st) {
   std::printf("%s: %s code=%u detail=%ld msg=%s\n",
               label,
@@ -334,6 +346,7 @@ void configureDriver() {
   gConfig.nowMs = nowMs;
   gConfig.nowUs = nowUs;
   gConfig.cooperativeYield = cooperativeYield;
+  gConfig.sleepUntilUs = sleepUntilUs;
   gConfig.i2cTimeoutMs = 50;
   gConfig.mode = SHT3x::Mode::SINGLE_SHOT;
   gConfig.clockStretching = SHT3x::ClockStretching::STRETCH_DISABLED;
@@ -0,0 +1,354 @@
+/// @file main.cpp
+/// @brief Dual-bus, dual-core ESP-IDF reference example
+/// @note NOT part of the library API. Example-only. Build with:
+///
+///   idf.py -C examples/idf/dual_bus set-target esp32s3 build flash monitor
+///
+/// Both I2C controllers are created, each with every SHT3x address attached,
+/// and one owner task per bus is pinned to its own core. Each owner is the
+/// only code that touches its bus handle and its drivers, so no lock is
+/// needed around the driver: the tasks share nothing but the statistics
+/// window, which the report loop in app_main() swaps out under a spinlock.
+/// Every driver runs free-running single-shot measurements through
+/// requestMeasurement(JobRequest) and one-callback pollJob() steps, and the
+/// owner sleeps until the earliest due step of any sensor on its bus.
+///
+/// Single-core targets (ESP32-S2) pin both owners to core 0; the buses still
+/// run their transfers in parallel in hardware.
+
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+
+#include <driver/i2c_master.h>
+#include <esp_err.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "IdfI2cTransport.h"
+#include "SHT3x/SHT3x.h"
+
+namespace {
+
+constexpr const char* TAG = "sht3x_dual_bus";
+constexpr size_t BUS_COUNT = 2;
+/// The SHT3x has two selectable addresses (ADDR pin low/high), so two sensors
+/// per bus is the most a bus carries without an external multiplexer.
+constexpr size_t SENSORS_PER_BUS = 2;
+constexpr uint8_t SENSOR_ADDRESSES[SENSORS_PER_BUS] = {0x44, 0x45};
+constexpr uint32_t I2C_FREQ_HZ = 400000;
+constexpr SHT3x::Repeatability REPEATABILITY = SHT3x::Repeatability::LOW_REPEATABILITY;
+constexpr uint32_t JOB_DEADLINE_MS = 100;
+constexpr uint32_t RETRY_US = 500000;
+constexpr uint32_t REPORT_MS = 5000;
+constexpr uint32_t OWNER_STACK_BYTES = 4096;
+constexpr UBaseType_t OWNER_PRIORITY = 5;
+
+struct BusPins {
+  i2c_port_num_t port;
+  gpio_num_t sda;
+  gpio_num_t scl;
+};
+
+constexpr BusPins BUS_PINS[BUS_COUNT] = {
+    {I2C_NUM_0, GPIO_NUM_8, GPIO_NUM_9},
+    {I2C_NUM_1, GPIO_NUM_17, GPIO_NUM_18},
+};
+
+/// Per-bus counters for one report window.
+struct BusStats {
+  uint32_t samples = 0;
+  uint32_t failures = 0;
+  uint32_t deadlineMisses = 0;
+  uint32_t polls = 0;
+  uint32_t busCallbacks = 0;
+  uint64_t busTimeUs = 0;     ///< Time spent inside polls that used the bus
+  uint64_t latencySumUs = 0;  ///< Request to terminal result, completed samples
+  uint32_t latencyMinUs = UINT32_MAX;
+  uint32_t latencyMaxUs = 0;
+};
+
+struct Sensor {
+  IdfI2cContext i2c = {};
+  SHT3x::SHT3x driver;
+  uint32_t requestUs = 0;
+  uint32_t dueUs = 0;
+  bool jobActive = false;
+  bool ready = false;
+};
+
+struct Bus {
+  size_t index = 0;
+  i2c_master_bus_handle_t handle = nullptr;
+  Sensor sensors[SENSORS_PER_BUS];
+  uint32_t nextRequestId = 1;
+  BaseType_t core = 0;
+  portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+  BusStats window;  ///< Guarded by lock
+};
+
+Bus gBuses[BUS_COUNT];
+
+uint32_t nowMs(void*) {
+  return static_cast<uint32_t>(esp_timer_get_time() / 1000LL);
+}
+
+uint32_t nowUs(void*) {
+  return static_cast<uint32_t>(esp_timer_get_time());
+}
+
+void cooperativeYield(void*) {
+  taskYIELD();
+}
+
+/// Block for whole ticks ending at or before targetUs; at least one tick so
+/// the idle task on this core is never starved by a spinning owner.
+void sleepUntil(uint32_t targetUs) {
+  const int32_t remainingUs = static_cast<int32_t>(targetUs - nowUs(nullptr));
+  const TickType_t ticks =
+      remainingUs > 0 ? pdMS_TO_TICKS(static_cast<uint32_t>(remainingUs) / 1000U) : 0;
+  vTaskDelay(ticks > 0 ? ticks : 1);
+}
+
+esp_err_t createBus(const BusPins& pins, i2c_master_bus_handle_t* bus) {
+  i2c_master_bus_config_t busConfig = {};
+  busConfig.i2c_port = pins.port;
+  busConfig.sda_io_num = pins.sda;
+  busConfig.scl_io_num = pins.scl;
+  busConfig.clk_source = I2C_CLK_SRC_DEFAULT;
+  busConfig.glitch_ignore_cnt = 7;
+  busConfig.flags.enable_internal_pullup = true;
+  return i2c_new_master_bus(&busConfig, bus);
+}
+
+esp_err_t addDevice(i2c_master_bus_handle_t bus, uint8_t address,
+                    i2c_master_dev_handle_t* dev) {
+  i2c_device_config_t devConfig = {};
+  devConfig.dev_addr_length = I2C_ADDR_BIT_LEN_7;
+  devConfig.device_address = address;
+  devConfig.scl_speed_hz = I2C_FREQ_HZ;
+  return i2c_master_bus_add_device(bus, &devConfig, dev);
+}
+
+SHT3x::Status bindSensor(Sensor& sensor) {
+  SHT3x::Config config;
+  config.i2cAddress = sensor.i2c.address;
+  config.i2cWrite = idfI2cWrite;
+  config.i2cWriteRead = idfI2cWriteRead;
+  config.i2cUser = &sensor.i2c;
+  config.nowMs = nowMs;
+  config.nowUs = nowUs;
+  config.cooperativeYield = cooperativeYield;
+  config.i2cTimeoutMs = 50;
+  config.mode = SHT3x::Mode::SINGLE_SHOT;
+  config.repeatability = REPEATABILITY;
+  config.clockStretching = SHT3x::ClockStretching::STRETCH_DISABLED;
+  config.transportCapabilities = SHT3x::TransportCapability::TIMEOUT |
+                                 SHT3x::TransportCapability::BUS_ERROR;
+  config.offlineThreshold = 5;
+  return sensor.driver.bind(config);
+}
+
+void publish(Bus& bus, const BusStats& delta) {
+  portENTER_CRITICAL(&bus.lock);
+  BusStats& w = bus.window;
+  w.samples += delta.samples;
+  w.failures += delta.failures;
+  w.deadlineMisses += delta.deadlineMisses;
+  w.polls += delta.polls;
+  w.busCallbacks += delta.busCallbacks;
+  w.busTimeUs += delta.busTimeUs;
+  w.latencySumUs += delta.latencySumUs;
+  w.latencyMinUs = delta.latencyMinUs < w.latencyMinUs ? delta.latencyMinUs : w.latencyMinUs;
+  w.latencyMaxUs = delta.latencyMaxUs > w.latencyMaxUs ? delta.latencyMaxUs : w.latencyMaxUs;
+  portEXIT_CRITICAL(&bus.lock);
+}
+
+/// Advance one sensor by a single one-callback poll and return its next due time.
+uint32_t service(Bus& bus, Sensor& sensor, BusStats& stats) {
+  const uint32_t startUs = nowUs(nullptr);
+  const uint32_t startMs = nowMs(nullptr);
+
+  if (!sensor.jobActive) {
+    SHT3x::JobRequest request{bus.nextRequestId++, startMs + JOB_DEADLINE_MS, true};
+    if (bus.nextRequestId == 0) {
+      bus.nextRequestId = 1;
+    }
+    const SHT3x::Status st = sensor.ready ? sensor.driver.requestMeasurement(request)
+                                          : sensor.driver.requestEnsureIdle(request);
+    if (!st.inProgress()) {
+      stats.failures++;
+      return startUs + RETRY_US;
+    }
+    sensor.jobActive = true;
+    sensor.requestUs = startUs;
+  }
+
+  SHT3x::PollJobResult result;
+  (void)sensor.driver.pollJob(startMs, startUs, 1, result);
+  const uint32_t endUs = nowUs(nullptr);
+  stats.polls++;
+  stats.busCallbacks += result.instructionsUsed;
+  if (result.instructionsUsed > 0) {
+    stats.busTimeUs += endUs - startUs;
+  }
+
+  if (!result.terminal) {
+    if (result.instructionsUsed == 0) {
+      // Nothing was due yet (settle or command spacing): retry after one tick.
+      return endUs + 1000U;
+    }
+    if (result.type == SHT3x::JobType::MEASUREMENT &&
+        result.phase == SHT3x::JobPhase::SINGLE_SHOT_COMMAND) {
+      return endUs + sensor.driver.estimateMeasurementTimeMs() * 1000U;
+    }
+    return endUs + sensor.driver.getConfig().commandDelayMs * 1000U;
+  }
+
+  sensor.jobActive = false;
+  if (result.type == SHT3x::JobType::ENSURE_IDLE) {
+    sensor.ready = result.outcome == SHT3x::JobOutcome::SUCCEEDED;
+    if (!sensor.ready) {
+      stats.failures++;
+      return endUs + RETRY_US;
+    }
+    return endUs;
+  }
+
+  if (result.completed) {
+    const uint32_t latencyUs = endUs - sensor.requestUs;
+    stats.samples++;
+    stats.latencySumUs += latencyUs;
+    stats.latencyMinUs = latencyUs < stats.latencyMinUs ? latencyUs : stats.latencyMinUs;
+    stats.latencyMaxUs = latencyUs > stats.latencyMaxUs ? latencyUs : stats.latencyMaxUs;
+    return endUs;
+  }
+  if (result.outcome == SHT3x::JobOutcome::TIMED_OUT) {
+    stats.deadlineMisses++;
+  } else {
+    stats.failures++;
+  }
+  // Reconcile again before the next measurement.
+  sensor.ready = false;
+  return endUs + RETRY_US;
+}
+
+/// Sole owner of one bus and its drivers.
+void busOwnerTask(void* arg) {
+  Bus& bus = *static_cast<Bus*>(arg);
+  ESP_LOGI(TAG, "bus %u owner running on core %d", static_cast<unsigned>(bus.index),
+           static_cast<int>(xPortGetCoreID()));
+  const uint32_t startUs = nowUs(nullptr);
+  for (Sensor& sensor : bus.sensors) {
+    sensor.dueUs = startUs;
+  }
+
+  for (;;) {
+    BusStats delta;
+    uint32_t nowUsValue = nowUs(nullptr);
+    for (Sensor& sensor : bus.sensors) {
+      if (static_cast<int32_t>(nowUsValue - sensor.dueUs) >= 0) {
+        sensor.dueUs = service(bus, sensor, delta);
+        nowUsValue = nowUs(nullptr);
+      }
+    }
+    publish(bus, delta);
+
+    uint32_t wakeUs = bus.sensors[0].dueUs;
+    for (const Sensor& sensor : bus.sensors) {
+      if (static_cast<int32_t>(sensor.dueUs - wakeUs) < 0) {
+        wakeUs = sensor.dueUs;
+      }
+    }
+    if (static_cast<int32_t>(wakeUs - nowUs(nullptr)) > 0) {
+      sleepUntil(wakeUs);
+    }
+  }
+}
+
+bool setUpBus(Bus& bus, size_t index) {
+  bus.index = index;
+  // Single-core parts have one core; both owners then share core 0.
+  bus.core = static_cast<BaseType_t>(index % portNUM_PROCESSORS);
+  esp_err_t err = createBus(BUS_PINS[index], &bus.handle);
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "bus %u: i2c_new_master_bus failed: %s", static_cast<unsigned>(index),
+             esp_err_to_name(err));
+    return false;
+  }
+  for (size_t i = 0; i < SENSORS_PER_BUS; ++i) {
+    Sensor& sensor = bus.sensors[i];
+    sensor.i2c.bus = bus.handle;
+    sensor.i2c.address = SENSOR_ADDRESSES[i];
+    err = addDevice(bus.handle, SENSOR_ADDRESSES[i], &sensor.i2c.device);
+    if (err != ESP_OK) {
+      ESP_LOGE(TAG, "bus %u 0x%02X: add device failed: %s", static_cast<unsigned>(index),
+               SENSOR_ADDRESSES[i], esp_err_to_name(err));
+      return false;
+    }
+    const SHT3x::Status st = bindSensor(sensor);
+    if (!st.ok()) {
+      ESP_LOGE(TAG, "bus %u 0x%02X: bind failed: %s", static_cast<unsigned>(index),
+               SENSOR_ADDRESSES[i], st.msg ? st.msg : "");
+      return false;
+    }
+  }
+  return true;
+}
+
+void report(uint32_t windowUs) {
+  uint32_t totalSamples = 0;
+  for (Bus& bus : gBuses) {
+    portENTER_CRITICAL(&bus.lock);
+    const BusStats w = bus.window;
+    bus.window = BusStats{};
+    portEXIT_CRITICAL(&bus.lock);
+
+    totalSamples += w.samples;
+    const float seconds = static_cast<float>(windowUs) / 1e6f;
+    const uint32_t avgUs =
+        w.samples > 0 ? static_cast<uint32_t>(w.latencySumUs / w.samples) : 0;
+    std::printf("bus %u core %d: %.1f samples/s  latency min/avg/max %" PRIu32 "/%" PRIu32
+                "/%" PRIu32 " us  bus busy %.2f%%  polls %" PRIu32 "  callbacks %" PRIu32
+                "  failures %" PRIu32 "  deadline misses %" PRIu32 "\n",
+                static_cast<unsigned>(bus.index), static_cast<int>(bus.core),
+                static_cast<double>(static_cast<float>(w.samples) / seconds),
+                w.samples > 0 ? w.latencyMinUs : 0, avgUs, w.latencyMaxUs,
+                static_cast<double>(100.0f * static_cast<float>(w.busTimeUs) /
+                                    static_cast<float>(windowUs)),
+                w.polls, w.busCallbacks, w.failures, w.deadlineMisses);
+  }
+  std::printf("total: %.1f samples/s across %u sensors\n",
+              static_cast<double>(static_cast<float>(totalSamples) * 1e6f /
+                                  static_cast<float>(windowUs)),
+              static_cast<unsigned>(BUS_COUNT * SENSORS_PER_BUS));
+}
+
+}  // namespace
+
+extern "C" void app_main(void) {
+  for (size_t i = 0; i < BUS_COUNT; ++i) {
+    if (!setUpBus(gBuses[i], i)) {
+      return;
+    }
+  }
+  for (Bus& bus : gBuses) {
+    char name[configMAX_TASK_NAME_LEN];
+    std::snprintf(name, sizeof(name), "sht3x_bus%u", static_cast<unsigned>(bus.index));
+    if (xTaskCreatePinnedToCore(busOwnerTask, name, OWNER_STACK_BYTES, &bus, OWNER_PRIORITY,
+                                nullptr, bus.core) != pdPASS) {
+      ESP_LOGE(TAG, "bus %u: owner task creation failed", static_cast<unsigned>(bus.index));
+      return;
+    }
+  }
+
+  uint32_t lastUs = nowUs(nullptr);
+  for (;;) {
+    vTaskDelay(pdMS_TO_TICKS(REPORT_MS));
+    const uint32_t now = nowUs(nullptr);
+    report(now - lastUs);
+    lastUs = now;
+  }
+}
@@ -0,0 +1,122 @@
+/// @file AlarmEngine.h
+/// @brief Threshold alarm rules evaluated over batches of sensor samples
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "SHT3x/SHT3x.h"
+
+#ifndef SHT3X_ALARM_MAX_RULES
+#define SHT3X_ALARM_MAX_RULES 16
+#endif
+
+#ifndef SHT3X_ALARM_MAX_SENSORS
+#define SHT3X_ALARM_MAX_SENSORS 64
+#endif
+
+namespace SHT3x {
+
+/// Rules an AlarmEngine holds (override with SHT3X_ALARM_MAX_RULES).
+static constexpr size_t ALARM_MAX_RULES = SHT3X_ALARM_MAX_RULES;
+
+/// Sensors per batch (override with SHT3X_ALARM_MAX_SENSORS).
+static constexpr size_t ALARM_MAX_SENSORS = SHT3X_ALARM_MAX_SENSORS;
+
+/// Largest accepted threshold magnitude and hysteresis, in milli-units.
+static constexpr int32_t ALARM_MAX_LEVEL = 10000000;
+
+/// Quantity a rule watches.
+enum class AlarmMetric : uint8_t {
+  TEMPERATURE = 0,      ///< temperatureMilliCelsius
+  HUMIDITY = 1,         ///< humidityMilliPercent
+  DEW_POINT_MARGIN = 2  ///< Temperature minus Magnus dew point, milli-degrees C
+};
+
+/// Side of the threshold that raises the alarm.
+enum class AlarmDirection : uint8_t {
+  ABOVE = 0, ///< Raise when the value exceeds the threshold
+  BELOW = 1  ///< Raise when the value falls under the threshold
+};
+
+/// One monitoring rule, applied to every sensor in a batch.
+///
+/// "RH > 85 % for 2 min" is {HUMIDITY, ABOVE, 85000, h, 120000, 0};
+/// "T below dew point + 2 C" is {DEW_POINT_MARGIN, BELOW, 2000, h, d, 0}.
+struct AlarmRule {
+  AlarmMetric metric = AlarmMetric::TEMPERATURE; ///< Watched quantity
+  AlarmDirection direction = AlarmDirection::ABOVE; ///< Raising side
+  int32_t thresholdMilli = 0;  ///< Raise level in milli-units
+  int32_t hysteresisMilli = 0; ///< Clear only this far back past the threshold (>= 0)
+  uint32_t debounceMs = 0;     ///< Condition must hold this long before either transition
+  uint32_t holdOffMs = 0;      ///< Minimum time between transitions of one rule/sensor pair
+};
+
+/// One alarm raise or clear.
+struct AlarmTransition {
+  uint16_t rule = 0;    ///< Rule index from addRule()
+  uint16_t sensor = 0;  ///< Sensor index in the batch
+  bool active = false;  ///< True when raised, false when cleared
+  int32_t valueMilli = 0; ///< Metric value that completed the transition
+  uint32_t timeMs = 0;  ///< evaluate() timestamp
+};
+
+/// Fixed-capacity alarm engine.
+///
+/// Rules and per-pair state live in structure-of-arrays form: rule
+/// parameters in per-field arrays, and per rule one contiguous row of flags,
+/// debounce-start, and last-transition times indexed by sensor. evaluate()
+/// first computes each metric once per sensor, then sweeps every rule row
+/// with branch-free selects that compilers vectorize, and finally emits only
+/// the pairs whose state changed. State for ALARM_MAX_RULES x
+/// ALARM_MAX_SENSORS pairs is 9 bytes each; no allocation.
+class AlarmEngine {
+ public:
+  /// Add a rule; its pairs start cleared.
+  /// @param rule Rule parameters
+  /// @param[out] ruleIndex Index reported in transitions
+  /// @return Status::Ok(), INVALID_PARAM for a bad metric, direction, or
+  ///         level, or BUSY when ALARM_MAX_RULES rules exist
+  Status addRule(const AlarmRule& rule, uint16_t& ruleIndex);
+
+  /// Remove all rules and state.
+  void clear();
+
+  /// Clear every alarm and timer but keep the rules.
+  void resetState();
+
+  /// Number of rules.
+  size_t rules() const { return _ruleCount; }
+
+  /// Evaluate every rule against one batch.
+  /// @param nowMs Batch timestamp (wrapping milliseconds)
+  /// @param samples Latest sample of sensors 0..sensorCount-1
+  /// @param sensorCount Sensors in the batch, at most ALARM_MAX_SENSORS;
+  ///        keep it constant between calls
+  /// @param[out] out Transition buffer
+  /// @param capacity Entries available in out
+  /// @param[out] written Transitions stored
+  /// @return Status::Ok(), INVALID_PARAM for a bad batch, or BUSY when more
+  ///         transitions happened than fit; the state still advanced and
+  ///         detail is the number dropped (see isActive())
+  Status evaluate(uint32_t nowMs, const MeasurementMilli* samples, size_t sensorCount,
+                  AlarmTransition* out, size_t capacity, size_t& written);
+
+  /// Current alarm state of one pair (false when out of range).
+  bool isActive(uint16_t rule, uint16_t sensor) const;
+
+ private:
+  int32_t _ruleSign[ALARM_MAX_RULES] = {};
+  int32_t _ruleSetLevel[ALARM_MAX_RULES] = {};
+  int32_t _ruleClearLevel[ALARM_MAX_RULES] = {};
+  uint32_t _ruleDebounceMs[ALARM_MAX_RULES] = {};
+  uint32_t _ruleHoldOffMs[ALARM_MAX_RULES] = {};
+  AlarmMetric _ruleMetric[ALARM_MAX_RULES] = {};
+  size_t _ruleCount = 0;
+
+  int32_t _metrics[3][ALARM_MAX_SENSORS] = {};
+  uint8_t _flags[ALARM_MAX_RULES][ALARM_MAX_SENSORS] = {};
+  uint32_t _sinceMs[ALARM_MAX_RULES][ALARM_MAX_SENSORS] = {};
+  uint32_t _changedMs[ALARM_MAX_RULES][ALARM_MAX_SENSORS] = {};
+};
+
+} // namespace SHT3x
@@ -0,0 +1,64 @@
+/// @file AllanDeviation.h
+/// @brief Streaming overlapping Allan deviation of raw SHT3x samples
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "SHT3x/SHT3x.h"
+
+namespace SHT3x {
+
+/// Averaging-factor octaves tracked: m = 1, 2, 4, ... 2^(ALLAN_OCTAVES - 1).
+static constexpr uint8_t ALLAN_OCTAVES = 8;
+
+/// Raw samples retained per channel (two windows of the largest factor).
+static constexpr size_t ALLAN_HISTORY = 2U << (ALLAN_OCTAVES - 1U);
+
+/// Allan deviation at one averaging time tau = averagingFactor * tau0.
+struct AllanPoint {
+  uint32_t averagingFactor = 0; ///< m, in sample periods
+  uint32_t terms = 0;           ///< Overlapping window pairs accumulated
+  float temperatureC = 0.0f;    ///< Temperature Allan deviation, degrees C
+  float humidityPct = 0.0f;     ///< Humidity Allan deviation, %RH
+};
+
+/// Fixed-memory overlapping Allan deviation accumulator.
+///
+/// Feed equally spaced samples (one per periodic/ART slot or fixed cadence
+/// slot); tau0 is that spacing. For each power-of-two factor m the
+/// accumulator keeps the sums of the newest two m-sample windows and adds the
+/// squared difference of their means once per sample, so every octave uses
+/// all N - 2m + 1 overlapping pairs with O(ALLAN_OCTAVES) integer work per
+/// sample and about 1.3 KB of state. No allocation; floating point is used
+/// only by getPoint().
+/// @note Lost samples break the equal-spacing assumption. Check
+///       SHT3x::lostSamples() over the run and discard it when nonzero.
+class AllanDeviation {
+ public:
+  /// Drop all samples and accumulated terms.
+  void reset();
+
+  /// Add the next sample of the series.
+  void add(const RawSample& sample);
+
+  /// Samples added since the last reset (saturating).
+  uint32_t samples() const { return _samples; }
+
+  /// Compute the deviation for one octave.
+  /// @param octave 0 .. ALLAN_OCTAVES-1; averaging factor is 1 << octave
+  /// @param[out] out Point for that octave
+  /// @return Status::Ok(), INVALID_PARAM for an octave out of range, or
+  ///         MEASUREMENT_NOT_READY before 2 * m samples have been added
+  Status getPoint(uint8_t octave, AllanPoint& out) const;
+
+ private:
+  uint16_t _history[2][ALLAN_HISTORY] = {};
+  int32_t _recent[2][ALLAN_OCTAVES] = {};
+  int32_t _older[2][ALLAN_OCTAVES] = {};
+  uint64_t _sumSquares[2][ALLAN_OCTAVES] = {};
+  uint32_t _terms[ALLAN_OCTAVES] = {};
+  uint32_t _samples = 0;
+  size_t _head = 0;
+};
+
+} // namespace SHT3x
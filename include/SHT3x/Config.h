@@ -107,10 +107,28 @@ using NowMsFn = uint32_t (*)(void* user);
 /// @return Current monotonic microseconds modulo 2^32
 using NowUsFn = uint32_t (*)(void* user);
 
+/// 64-bit millisecond timestamp callback.
+/// @param user User context pointer passed through from Config
+/// @return Current monotonic milliseconds; must not wrap during the session
+using NowMs64Fn = uint64_t (*)(void* user);
+
+/// 64-bit microsecond timestamp callback.
+/// @param user User context pointer passed through from Config
+/// @return Current monotonic microseconds; must not wrap during the session
+using NowUs64Fn = uint64_t (*)(void* user);
+
 /// Cooperative yield callback.
 /// @param user User context pointer passed through from Config
 using YieldFn = void (*)(void* user);
 
+/// Sleep callback for synchronous waits.
+/// @param targetUs Wake time on the Config::nowUs timebase (wraps modulo 2^32)
+/// @param user User context pointer passed through from Config
+/// @note May return early; the driver re-checks its clocks and calls again.
+///       Return immediately when targetUs is already due or shorter than
+///       the platform can sleep.
+using SleepUntilUsFn = void (*)(uint32_t targetUs, void* user);
+
 /// Measurement repeatability
 enum class Repeatability : uint8_t {
   LOW_REPEATABILITY = 0,
@@ -157,8 +175,8 @@ struct Config {
   HardResetFn hardReset = nullptr;       ///< Optional hard reset (nRESET pulse)
 
   // === Timing Hooks (required by bind/begin/runtime) ===
-  NowMsFn nowMs = nullptr;               ///< Monotonic uint32 scheduler milliseconds; wraps modulo 2^32
-  NowUsFn nowUs = nullptr;               ///< Monotonic uint32 scheduler microseconds; wraps modulo 2^32
+  NowMsFn nowMs = nullptr;               ///< Monotonic uint32 scheduler milliseconds; wraps modulo 2^32 (or set nowMs64)
+  NowUsFn nowUs = nullptr;               ///< Monotonic uint32 scheduler microseconds; wraps modulo 2^32 (or set nowUs64)
   YieldFn cooperativeYield = nullptr;    ///< Cooperative scheduler hint used while waiting for bounded deadlines
   void* timeUser = nullptr;              ///< User context for timing hooks
 
@@ -204,6 +222,24 @@ struct Config {
 
   // === v1.8 Additions (append-only for aggregate initialization compatibility) ===
   uint16_t singleShotMeasurementMarginMs = 1; ///< Extra wait after the datasheet single-shot maximum, 0..1000 ms
+
+  // === v1.9 Additions (append-only for aggregate initialization compatibility) ===
+  /// Optional 64-bit millisecond clock. When set it replaces nowMs (whose
+  /// value becomes its low 32 bits) and re-anchors the driver's 64-bit
+  /// timebase at every job request, so 64-bit deadlines and sample
+  /// timestamps never depend on observing each 32-bit wrap.
+  NowMs64Fn nowMs64 = nullptr;
+  NowUs64Fn nowUs64 = nullptr;                ///< Optional 64-bit microsecond clock; replaces nowUs when set
+  /// Reject job requests whose deadline falls before minimumCompletionUs()
+  /// with DEADLINE_INFEASIBLE, before any I2C. When false, such jobs are
+  /// accepted and time out from pollJob().
+  bool rejectInfeasibleDeadlines = false;
+  uint16_t transferBudgetUs = 100;            ///< Minimum time per transport callback assumed by deadline admission
+  uint8_t jobQueueDepth = 0;                  ///< Job requests queued behind an active job (0..JOB_QUEUE_CAPACITY); 0 keeps BUSY
+  /// Optional blocking sleep for synchronous command-delay and settle waits.
+  /// When set it replaces cooperativeYield in those wait loops; the
+  /// loops' timeout and stall guards still apply.
+  SleepUntilUsFn sleepUntilUs = nullptr;
 };
 
 } // namespace SHT3x
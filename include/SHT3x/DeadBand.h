@@ -0,0 +1,88 @@
+/// @file DeadBand.h
+/// @brief Dead-band report-by-exception filter for captured samples
+#pragma once
+
+#include <cstdint>
+#include "SHT3x/SHT3x.h"
+
+namespace SHT3x {
+
+/// Report-by-exception tuning.
+struct DeadBandConfig {
+  /// Report when temperature moves more than this from the last report.
+  int32_t temperatureMilliCelsius = 100;
+  /// Report when humidity moves more than this from the last report.
+  int32_t humidityMilliPercent = 500;
+  /// Heartbeat: report the first sample at least this long after the last
+  /// report even if nothing moved. 0 disables the heartbeat.
+  uint32_t maxSilenceMs = 60000;
+};
+
+/// Why update() forwarded or held back a sample.
+enum class DeadBandReason : uint8_t {
+  SUPPRESSED = 0, ///< Inside the dead-band and before the heartbeat
+  FIRST = 1,      ///< First sample after configure() or reset()
+  CHANGE = 2,     ///< Temperature or humidity left the dead-band
+  HEARTBEAT = 3,  ///< maxSilenceMs elapsed since the last report
+  DUPLICATE = 4   ///< Device sample already seen (same sampleSequence()); not counted
+};
+
+/// Counters since configure() or reset(), all saturating.
+struct DeadBandStats {
+  uint32_t samples = 0;             ///< Samples evaluated
+  uint32_t reported = 0;            ///< Samples forwarded, for any reason
+  uint32_t suppressed = 0;          ///< Samples held back
+  uint32_t temperatureChanges = 0;  ///< Reports where temperature left the dead-band
+  uint32_t humidityChanges = 0;     ///< Reports where humidity left the dead-band
+  uint32_t heartbeats = 0;          ///< Reports forced only by maxSilenceMs
+};
+
+/// Forward a sample only when it differs from the last forwarded one.
+///
+/// The reference is the last reported value, not the last sample, so a slow
+/// drift is reported once it has accumulated past the dead-band instead of
+/// being hidden step by step. A change must exceed the band: a sample
+/// exactly one band away is still suppressed. The heartbeat is checked on
+/// each sample with wrap-safe timestamp arithmetic, so it fires on the first
+/// sample after the interval rather than at the interval itself. Per-sample
+/// work is two compares and one subtraction, with no bus traffic.
+class DeadBand {
+ public:
+  /// Apply tuning and restart; the next sample is reported.
+  /// @return Status::Ok(), or INVALID_PARAM for a negative dead-band
+  Status configure(const DeadBandConfig& config);
+
+  /// Forget the last report and zero the counters.
+  void reset();
+
+  /// Evaluate one sample.
+  /// @param sample Temperature and humidity in milli-units
+  /// @param timestampMs Capture time, e.g. SHT3x::sampleTimestampMs()
+  /// @return SUPPRESSED, or the reason the sample should be forwarded
+  DeadBandReason update(const MeasurementMilli& sample, uint32_t timestampMs);
+
+  /// Evaluate the device's latest sample at its capture timestamp. A sample
+  /// already evaluated (same sampleSequence()) yields DUPLICATE and changes
+  /// no counter.
+  /// @param[out] reason As update() above, or DUPLICATE
+  /// @return getMeasurementMilli() errors, or Status::Ok()
+  Status update(const SHT3x& device, DeadBandReason& reason);
+
+  /// Last forwarded sample.
+  /// @return Status::Ok(), or MEASUREMENT_NOT_READY before the first report
+  Status getLastReport(MeasurementMilli& out, uint32_t& timestampMs) const;
+
+  /// Counters since configure() or reset().
+  DeadBandStats stats() const { return _stats; }
+
+ private:
+  DeadBandConfig _config;
+  DeadBandStats _stats;
+  MeasurementMilli _last;
+  uint32_t _lastMs = 0;
+  uint32_t _deviceSequence = 0;
+  bool _hasReport = false;
+  bool _hasDeviceSequence = false;
+};
+
+} // namespace SHT3x
@@ -0,0 +1,51 @@
+/// @file Energy.h
+/// @brief Energy-per-sample estimate from driver activity and supply currents
+#pragma once
+
+#include <cstdint>
+#include "SHT3x/SHT3x.h"
+
+namespace SHT3x {
+
+/// Sensor supply model. Defaults are SHT3x-DIS datasheet typical values at
+/// 3.3 V; replace them with board measurements where available.
+struct EnergyModel {
+  uint32_t supplyMillivolts = 3300;          ///< VDD
+  uint32_t idleNanoamps = 200;               ///< Idle, single-shot mode (0.2 uA typ)
+  uint32_t periodicIdleNanoamps = 45000;     ///< Idle between periodic/ART conversions (45 uA typ)
+  uint32_t measuringNanoamps = 600000;       ///< During a conversion (600 uA typ)
+  uint32_t conversionUs[3] = {2500, 4500, 12500}; ///< Typical conversion time by Repeatability
+  uint32_t heaterMicrowatts = 10000;         ///< Heater power (3.6-33 mW over the VDD range)
+  uint32_t busNanojoulesPerCallback = 3000;  ///< Pull-up energy per transport callback; 0 to exclude
+};
+
+/// Energy estimate for one driver session.
+struct EnergyEstimate {
+  uint32_t elapsedMs = 0;           ///< Session time covered
+  uint32_t samples = 0;             ///< Samples captured
+  float idleMicrojoules = 0.0f;     ///< Idle current in single-shot and periodic/ART mode
+  float conversionMicrojoules = 0.0f; ///< Single-shot and sensor-timed conversions
+  float heaterMicrojoules = 0.0f;   ///< Heater on-time
+  float busMicrojoules = 0.0f;      ///< I2C transactions
+  float totalMicrojoules = 0.0f;    ///< Sum of the components
+  float microjoulesPerSample = 0.0f; ///< totalMicrojoules / samples (0 without samples)
+  float averageMicroamps = 0.0f;    ///< Mean supply current over elapsedMs
+};
+
+/// Estimate the energy a driver session has cost.
+/// @param activity Totals from SHT3x::getActivity()
+/// @param model Supply model
+/// @param[out] out Estimate
+/// @return Status::Ok() or INVALID_PARAM for a zero supply voltage
+/// @note Periodic conversions are charged at the measuring current on top of
+///       the periodic idle current. Host-side bus energy is a flat per-callback
+///       figure; it ignores transfer length and clock rate.
+Status estimateEnergy(const ActivityCounters& activity, const EnergyModel& model,
+                      EnergyEstimate& out);
+
+/// Convenience overload: snapshot device activity at nowMs, then estimate.
+/// @return getActivity() errors, or as above
+Status estimateEnergy(const SHT3x& device, uint32_t nowMs, const EnergyModel& model,
+                      EnergyEstimate& out);
+
+} // namespace SHT3x
@@ -0,0 +1,57 @@
+/// @file Features.h
+/// @brief Compile-time feature selection for the core driver
+///
+/// Every optional group is enabled by default. Define SHT3X_MINIMAL=1 to turn
+/// all of them off at once, keeping bind(), the cooperative jobs
+/// (measurement, continuous, cadence, ensure-idle), mode/repeatability/rate
+/// configuration, periodic start/stop, sample access, and conversions. Any
+/// SHT3X_ENABLE_* macro defined explicitly overrides the profile default.
+#pragma once
+
+/// @def SHT3X_MINIMAL
+/// @brief 1 selects the minimal profile (all optional groups default to 0).
+#ifndef SHT3X_MINIMAL
+#define SHT3X_MINIMAL 0
+#endif
+
+// Default for every SHT3X_ENABLE_* group below.
+#if SHT3X_MINIMAL
+#define SHT3X_FEATURE_DEFAULT 0
+#else
+#define SHT3X_FEATURE_DEFAULT 1
+#endif
+
+/// @def SHT3X_ENABLE_SYNC_API
+/// @brief Synchronous convenience APIs: begin(), probe(), readStatus(),
+///        readStatusWithModeRestore(), clearStatus(), setHeater(),
+///        readHeaterStatus(), readSerialNumber(), and readSettings().
+#ifndef SHT3X_ENABLE_SYNC_API
+#define SHT3X_ENABLE_SYNC_API SHT3X_FEATURE_DEFAULT
+#endif
+
+/// @def SHT3X_ENABLE_RECOVERY
+/// @brief Recovery ladder and resets: recover(), resetToDefaults(),
+///        resetAndRestore(), softReset(), interfaceReset(), and
+///        generalCallReset(). Requires SHT3X_ENABLE_SYNC_API.
+#ifndef SHT3X_ENABLE_RECOVERY
+#define SHT3X_ENABLE_RECOVERY SHT3X_FEATURE_DEFAULT
+#endif
+
+/// @def SHT3X_ENABLE_ALERTS
+/// @brief Alert-limit access and encoding: readAlertLimit*(),
+///        writeAlertLimit*(), disableAlerts(), encodeAlertLimit(), and
+///        decodeAlertLimit(), plus alert restore in resetAndRestore().
+#ifndef SHT3X_ENABLE_ALERTS
+#define SHT3X_ENABLE_ALERTS SHT3X_FEATURE_DEFAULT
+#endif
+
+/// @def SHT3X_ENABLE_RAW_COMMANDS
+/// @brief Low-level command access: writeCommand(), writeCommandWithData(),
+///        and readCommand().
+#ifndef SHT3X_ENABLE_RAW_COMMANDS
+#define SHT3X_ENABLE_RAW_COMMANDS SHT3X_FEATURE_DEFAULT
+#endif
+
+#if SHT3X_ENABLE_RECOVERY && !SHT3X_ENABLE_SYNC_API
+#error "SHT3X_ENABLE_RECOVERY requires SHT3X_ENABLE_SYNC_API"
+#endif
@@ -0,0 +1,98 @@
+/// @file KalmanFilter.h
+/// @brief Fixed-point constant-velocity Kalman estimate of temperature and humidity
+#pragma once
+
+#include <cstdint>
+#include "SHT3x/SHT3x.h"
+
+namespace SHT3x {
+
+/// Largest sample gap the filter predicts across. A longer gap, or a
+/// timestamp that moves backwards, restarts the filter at the new sample.
+static constexpr uint32_t KALMAN_MAX_GAP_MS = 10000;
+
+/// Largest accepted acceleration noise, in milli-units per second squared.
+static constexpr uint32_t KALMAN_MAX_ACCEL = 10000;
+
+/// Filter tuning.
+struct KalmanConfig {
+  /// Sets the measurement noise: the datasheet 3-sigma repeatability for this
+  /// setting (0.04/0.08/0.15 C and 0.08/0.15/0.21 %RH, high to low).
+  Repeatability repeatability = Repeatability::HIGH_REPEATABILITY;
+  /// Standard deviation of the temperature rate change per second (white
+  /// acceleration). Larger tracks steps faster; smaller smooths harder.
+  uint32_t temperatureAccelMilliCelsiusPerS2 = 100;
+  /// As above for humidity.
+  uint32_t humidityAccelMilliPercentPerS2 = 500;
+};
+
+/// Filtered state after the latest update.
+struct KalmanEstimate {
+  int32_t temperatureMilliCelsius = 0;          ///< Temperature estimate
+  int32_t humidityMilliPercent = 0;             ///< Humidity estimate (not clamped to 0..100 %)
+  int32_t temperatureRateMilliCelsiusPerS = 0;  ///< Temperature rate estimate
+  int32_t humidityRateMilliPercentPerS = 0;     ///< Humidity rate estimate
+  uint32_t temperatureStdDevMilliCelsius = 0;   ///< 1-sigma uncertainty of the temperature estimate
+  uint32_t humidityStdDevMilliPercent = 0;      ///< 1-sigma uncertainty of the humidity estimate
+  uint32_t timestampMs = 0;                     ///< Capture time of the latest sample
+  uint32_t samples = 0;                         ///< Samples since the last (re)start, saturating
+};
+
+/// Two-state (level, rate) Kalman filter per channel in integer math.
+///
+/// Each update predicts across the real sample interval, so irregular
+/// spacing from cadence skips or lost periodic slots is handled directly.
+/// States are Q8 milli-units and Q8 milli-units per second, covariances Q8
+/// milli-units squared in int64, and the interval a Q16 second count; every
+/// product stays below 2^62 for gaps up to KALMAN_MAX_GAP_MS and
+/// accelerations up to KALMAN_MAX_ACCEL. Per-sample work is a fixed set of
+/// 64-bit multiplies and two divides per channel, with no allocation and no
+/// floating point.
+class KalmanFilter {
+ public:
+  /// Apply tuning and restart.
+  /// @return Status::Ok(), or INVALID_PARAM for a bad repeatability or an
+  ///         acceleration of 0 or above KALMAN_MAX_ACCEL
+  Status configure(const KalmanConfig& config);
+
+  /// Forget the state; the next sample starts the filter again.
+  void reset();
+
+  /// Add one sample.
+  /// @param sample Raw words as captured
+  /// @param timestampMs Capture time, e.g. SHT3x::sampleTimestampMs()
+  void update(const RawSample& sample, uint32_t timestampMs);
+
+  /// Add the device's latest sample at its capture timestamp, with the
+  /// measurement noise of the device's current repeatability. A sample
+  /// already added (same sampleSequence()) is skipped.
+  /// @return getRawSample() errors, or Status::Ok()
+  Status update(const SHT3x& device);
+
+  /// Current estimate.
+  /// @return Status::Ok(), or MEASUREMENT_NOT_READY before the first sample
+  Status getEstimate(KalmanEstimate& out) const;
+
+ private:
+  struct Channel {
+    int32_t level = 0;   // Q8 milli-units
+    int32_t rate = 0;    // Q8 milli-units per second
+    int64_t p00 = 0;     // Q8 level variance
+    int64_t p01 = 0;     // Q8 level/rate covariance
+    int64_t p11 = 0;     // Q8 rate variance
+  };
+
+  void _update(const RawSample& sample, uint32_t timestampMs, Repeatability repeatability);
+  void _start(Channel& ch, int32_t milli, int64_t noise);
+  void _step(Channel& ch, int32_t milli, int64_t noise, int64_t accelNoise,
+             int64_t dtQ16);
+
+  KalmanConfig _config;
+  Channel _channels[2];
+  uint32_t _timestampMs = 0;
+  uint32_t _samples = 0;
+  uint32_t _deviceSequence = 0;
+  bool _started = false;
+};
+
+} // namespace SHT3x
@@ -8,6 +8,7 @@
 #include "SHT3x/Config.h"
 #include "SHT3x/CommandTable.h"
 #include "SHT3x/Version.h"
+#include "SHT3x/Features.h"
 
 namespace SHT3x {
 
@@ -99,6 +100,95 @@ struct JobRequest {
   bool hasDeadline = false; ///< Enforce deadline before each poll step
 };
 
+/// JobRequest with a 64-bit absolute deadline.
+/// @note deadlineMs is on the driver's 64-bit timebase: Config::nowMs64 when
+///       set, otherwise the 32-bit clock extended across wraps (see
+///       toTimeMs64()). It has no INT32_MAX distance limit.
+///       Fields are in JobRequest order, so {id, deadline, true} means the
+///       same for both.
+struct JobRequest64 {
+  uint32_t requestId = 0;   ///< Nonzero caller identity
+  uint64_t deadlineMs = 0;  ///< Absolute deadline when hasDeadline is true
+  bool hasDeadline = false; ///< Enforce deadline before each poll step
+};
+
+/// Fixed-cadence single-shot schedule request.
+/// @note Slot k starts at firstSlotMs + k * periodMs on the same wrapping
+///       millisecond timebase as pollJob(), so poll latency never accumulates
+///       into drift. Keep firstSlotMs within INT32_MAX milliseconds of the
+///       request time.
+struct CadenceRequest {
+  uint32_t requestId = 0;   ///< Nonzero caller identity reported with every sample
+  uint32_t periodMs = 0;    ///< Slot spacing; must cover one conversion plus tIDLE
+  uint32_t firstSlotMs = 0; ///< Absolute wrapping time of slot 0
+};
+
+/// Cached progress of the fixed-cadence single-shot job.
+struct CadenceStats {
+  bool active = false;             ///< True while the cadence job is running
+  uint32_t periodMs = 0;           ///< Slot spacing of the current or last cadence job
+  uint32_t nextSlotMs = 0;         ///< Absolute time of the next unissued slot
+  uint32_t nextSlot = 0;           ///< Index of the next unissued slot
+  uint32_t lastSlot = 0;           ///< Slot index of the last completed sample
+  uint32_t samples = 0;            ///< Samples completed by the cadence job
+  uint32_t skippedSlots = 0;       ///< Overdue slots skipped instead of queued
+  uint32_t lastScheduleErrorMs = 0; ///< Command time minus slot time for the last sample
+  uint32_t maxScheduleErrorMs = 0;  ///< Largest schedule error of the cadence job
+};
+
+/// Upper bound for BurstRequest::count.
+static constexpr uint8_t MAX_BURST_COUNT = 16;
+
+/// Burst-averaged single-shot request.
+/// @note The deadline bounds the whole burst, like JobRequest's bounds one job.
+struct BurstRequest {
+  uint32_t requestId = 0;   ///< Nonzero caller identity
+  uint32_t deadlineMs = 0;  ///< Absolute wrapping deadline when hasDeadline is true
+  bool hasDeadline = false; ///< Enforce deadline before each poll step
+  uint8_t count = 0;        ///< Conversions to average, 2..MAX_BURST_COUNT
+  /// Let the poll that reads a conversion also send the next command when
+  /// maxInstructions >= 2: two callbacks in that poll, N + 1 polls in total.
+  bool chainCommands = false;
+};
+
+/// Spread of the last completed burst (cached; zero I2C).
+/// @note The published sample (getRawSample() and friends) is the rounded
+///       integer mean; its timestamp is the last conversion's read.
+struct BurstStats {
+  bool valid = false;             ///< True once a burst job has completed
+  uint8_t count = 0;              ///< Conversions averaged
+  RawSample mean;                 ///< Rounded mean raw codes
+  RawSample min;                  ///< Lowest raw code per channel
+  RawSample max;                  ///< Highest raw code per channel
+  MeasurementMilli spreadMilli;   ///< max - min, in milli-degC and milli-%RH
+  MeasurementMilli stdDevMilli;   ///< Population standard deviation, same units
+};
+
+/// Cumulative sensor activity for energy estimation (cached; zero I2C).
+/// @note Arrays are indexed by Repeatability. ART conversions are counted as
+///       high repeatability because ART exposes no repeatability setting.
+struct ActivityCounters {
+  uint32_t elapsedMs = 0;                 ///< Time since bind()
+  uint32_t singleShotConversions[3] = {}; ///< Single-shot commands accepted by the sensor
+  uint32_t periodicConversions[3] = {};   ///< Sensor-timed periodic/ART conversions
+  uint32_t periodicUptimeMs = 0;          ///< Time spent in periodic/ART mode
+  uint32_t heaterOnMs = 0;                ///< Heater on-time; any reset ends it, restore resumes it
+  uint32_t transportCallbacks = 0;        ///< transportSuccess() + transportFailures()
+  uint32_t samples = 0;                   ///< Samples captured (sequence minus lost)
+};
+
+/// Number of sample-sequence gaps retained by getSampleGaps().
+static constexpr size_t SAMPLE_GAP_HISTORY = 8;
+
+/// Upper bound for Config::jobQueueDepth.
+static constexpr uint8_t JOB_QUEUE_CAPACITY = 4;
+
+/// Hole in the captured-sample sequence.
+struct SampleGap {
+  uint32_t firstMissing = 0; ///< First sequence number that was never captured
+  uint32_t count = 0;        ///< Consecutive sequence numbers missing from firstMissing
+};
+
 /// Local cancellation reason. Cancellation never performs I2C.
 enum class CancelReason : uint8_t {
   REQUESTED = 0,
@@ -138,7 +228,7 @@ struct SettingsSnapshot {
   uint8_t i2cAddress = 0x44;                                 ///< Active 7-bit I2C address
   uint32_t i2cTimeoutMs = 50;                                ///< Active I2C timeout
   uint8_t offlineThreshold = 5;                              ///< Failure threshold for OFFLINE
-  bool hasNowMsHook = false;                                 ///< True when Config::nowMs is provided
+  bool hasNowMsHook = false;                                 ///< True when Config::nowMs or nowMs64 is provided
   Mode mode = Mode::SINGLE_SHOT;                              ///< Active acquisition mode
   Repeatability repeatability = Repeatability::HIGH_REPEATABILITY; ///< Cached repeatability setting
   PeriodicRate periodicRate = PeriodicRate::MPS_1;            ///< Cached periodic rate
@@ -207,7 +297,8 @@ struct AlertLimit {
 ///
 /// APIs are not ISR-safe and the instance is not internally thread-safe.
 /// Serialize access externally. Owner-safe bind/request/poll/cancel operations
-/// do not spin and perform at most one transport callback per poll. Synchronous
+/// do not spin and perform at most one transport callback per poll (the one
+/// exception is BurstRequest::chainCommands, see requestBurst()). Synchronous
 /// convenience, advanced, and maintenance APIs remain bounded but may perform
 /// multiple callbacks and cooperative waits. While any cooperative job is
 /// active, synchronous/advanced I/O and configuration mutation APIs return BUSY;
@@ -224,6 +315,7 @@ public:
   // Lifecycle
   // =========================================================================
 
+#if SHT3X_ENABLE_SYNC_API
   /// Initialize the driver with configuration.
   /// @note Performs multiple bounded transactions: best-effort Break, soft
   ///       reset, status probe, and optional periodic/ART start from config.
@@ -233,6 +325,7 @@ public:
   /// @param config Configuration including transport callbacks
   /// @return Status::Ok() on success, error otherwise
   Status begin(const Config& config);
+#endif
 
   /// Validate and store configuration without touching I2C or waiting.
   /// @note This is the owner-safe lifecycle entry point. The device may be
@@ -240,8 +333,10 @@ public:
   ///       reconciliation is required. Because no hardware is touched, the
   ///       normalized active mode is SINGLE_SHOT even when config requested a
   ///       periodic mode; start that mode explicitly after reconciliation.
-  ///       Returns BUSY rather than discarding an active job; cancel it first.
-  ///       Invalid configuration leaves an existing idle binding unchanged.
+  ///       Returns BUSY rather than discarding an active or queued job:
+  ///       cancel the active one with cancelJob(), and let queued ones run
+  ///       (pollJob()) or remove them with cancelQueuedJob() first. Invalid
+  ///       configuration leaves an existing idle binding unchanged.
   Status bind(const Config& config);
 
   /// Process one pending cooperative-job step with a one-callback budget.
@@ -256,18 +351,34 @@ public:
   /// One command write or read-only measurement frame counts as one instruction.
   /// The current implementation deliberately uses at most one instruction per
   /// call even when maxInstructions is larger; zero performs no I2C. Waiting
-  /// phases also perform no I2C.
+  /// phases also perform no I2C. The one exception is a burst requested with
+  /// BurstRequest::chainCommands, whose read may be followed by the next
+  /// command in the same call when maxInstructions >= 2.
   /// @note Cancellation is observed only between pollJob() calls. An injected
   ///       transport callback is externally bounded but atomic from the
   ///       driver's perspective and cannot be interrupted by cancelJob().
   Status pollJob(uint32_t nowMs, uint8_t maxInstructions, PollJobResult& result);
 
+  /// pollJob() with the caller's current time for both driver clocks.
+  /// @param nowMs Config::nowMs timebase, as for pollJob()
+  /// @param nowUs Config::nowUs timebase, read at the same instant
+  /// @note The driver uses this pair until its first transport callback and
+  ///       re-reads each hook at most once after every callback, instead of
+  ///       calling the hooks for every deadline, tIDLE, health, and
+  ///       completion stamp. Both polls cache hook reads per step this way;
+  ///       this variant also saves the reads taken before any I/O.
+  Status pollJob(uint32_t nowMs, uint32_t nowUs, uint8_t maxInstructions,
+                 PollJobResult& result);
+
   /// Schedule bounded destructive reconciliation into single-shot idle state.
   /// @note The job performs at most four transport callbacks across polls:
   ///       Break, soft reset, status command, and status read. Wait phases use
   ///       zero I2C. request.requestId must be nonzero.
   Status requestEnsureIdle(const JobRequest& request);
 
+  /// requestEnsureIdle() with a 64-bit deadline.
+  Status requestEnsureIdle(const JobRequest64& request);
+
   /// Cancel the active cooperative job locally with zero I2C.
   /// @note The terminal result is returned exactly once by this call.
   ///       Measurement-job cancellation preserves previous cached sample data.
@@ -277,6 +388,39 @@ public:
   ///       Invalid CancelReason values return INVALID_PARAM and leave the job active.
   Status cancelJob(CancelReason reason, PollJobResult& result);
 
+  /// Time at which the active job can next make progress, for owners that
+  /// sleep between polls instead of polling on a fixed tick.
+  /// @param nowMs Current time in the pollJob() millisecond timebase
+  /// @param[out] wakeMs Conversion-ready time, periodic fetch time, reset or
+  ///        Break settle end, or cadence slot, clamped to the job deadline;
+  ///        written only when returning true
+  /// @return true when every pollJob() before wakeMs would perform no I2C;
+  ///         false when no job is active, the next step is due now, or it is
+  ///         gated only by tIDLE (poll again after Config::commandDelayMs)
+  bool jobWakeMs(uint32_t nowMs, uint32_t& wakeMs) const;
+
+  /// Job requests waiting behind the active job (see Config::jobQueueDepth).
+  /// @note With a nonzero depth, a measurement, continuous or ensure-idle
+  ///       request made while a job is active (or others are waiting) is
+  ///       queued and returns IN_PROGRESS with the queue position in detail,
+  ///       instead of BUSY. pollJob() starts the next queued job on the first
+  ///       call after the previous one terminates, spending that call's
+  ///       budget on it. Each queued job keeps its own requestId, deadline
+  ///       (which runs while queued), and exactly-once terminal result; a job
+  ///       that can no longer start terminates on that poll with zero I2C and
+  ///       the rejection in status: outcome TIMED_OUT for an infeasible
+  ///       deadline (DEADLINE_INFEASIBLE), FAILED otherwise (mode changed,
+  ///       offline). Requests behind a continuous or cadence job, or beyond
+  ///       the depth, still return BUSY. Synchronous operations issued
+  ///       between polls run ahead of the queue. bind() returns BUSY while
+  ///       jobs are queued; end() drops them without terminal results.
+  size_t queuedJobs() const { return _jobQueueCount; }
+
+  /// Remove a queued, not yet started job locally. No terminal result is
+  /// emitted for it.
+  /// @return Status::Ok(), or MEASUREMENT_NOT_READY if no queued job has that ID
+  Status cancelQueuedJob(uint32_t requestId);
+
   /// Cancel an active measurement locally with zero I2C.
   Status cancelMeasurement();
 
@@ -287,6 +431,9 @@ public:
   ///       before end() when hardware acquisition state matters. Call
   ///       cancelJob() first if the owner must consume an active job's terminal
   ///       identity; end() is an explicit session teardown and emits no result.
+  ///       Queued jobs are dropped the same way: their requestIds never get a
+  ///       terminal result, so drain or cancelQueuedJob() them first if the
+  ///       owner tracks them.
   void end();
 
   /// Check if bind()/begin() completed successfully and end() has not been called
@@ -301,6 +448,7 @@ public:
   // Diagnostics
   // =========================================================================
 
+#if SHT3X_ENABLE_SYNC_API
   /// Raw diagnostic presence check with no health tracking.
   /// @note Uses the status-register command path through raw transport wrappers.
   ///       This can issue I2C outside normal health accounting and is not an
@@ -308,7 +456,9 @@ public:
   ///       that diagnostic side effect is intentional.
   /// @return Status::Ok() if device responds, error otherwise
   Status probe();
+#endif
 
+#if SHT3X_ENABLE_RECOVERY
   /// Run the manual communication recovery ladder after bind()/begin().
   /// @note May run multiple bounded transactions through the configured
   ///       recovery ladder and is destructive to pending measurement/acquisition
@@ -337,6 +487,7 @@ public:
   ///       successful probe without issuing a sensor reset. A failure can leave
   ///       hardware partially restored while the returned Status identifies the step.
   Status resetAndRestore();
+#endif
 
   // =========================================================================
   // Driver State
@@ -424,6 +575,67 @@ public:
   /// Schedule a measurement correlated with caller identity and optional deadline.
   Status requestMeasurement(const JobRequest& request);
 
+  /// requestMeasurement() with a 64-bit deadline.
+  Status requestMeasurement(const JobRequest64& request);
+
+  /// Start a periodic/ART fetch job that stays active until cancelled.
+  /// @note Performs zero I2C and requires active periodic/ART mode. Each
+  ///       sample is reported by one pollJob() result with completed=true,
+  ///       terminal=false, and the same requestId; the job then re-arms its
+  ///       next Fetch Data for the following sample period without a new
+  ///       request. Each poll still uses at most one callback. cancelJob(), a
+  ///       failure, or the optional request deadline (which bounds the whole
+  ///       job) ends it with the usual exactly-once terminal result.
+  /// @return IN_PROGRESS when started, INVALID_PARAM for a zero ID or when
+  ///         periodic/ART is not active, BUSY when a job is active
+  Status requestContinuous(const JobRequest& request);
+
+  /// requestContinuous() with a 64-bit deadline bounding the whole job.
+  Status requestContinuous(const JobRequest64& request);
+
+  /// Start a single-shot job that re-arms itself on a fixed absolute cadence.
+  /// @note Performs zero I2C and requires idle SINGLE_SHOT mode. The job stays
+  ///       active: each sample is reported by one pollJob() result with
+  ///       completed=true, terminal=false, and the cadence requestId. Each
+  ///       slot's deadline is the start of the next slot; a slot whose
+  ///       conversion can no longer finish by then is skipped and counted
+  ///       rather than queued. The command is never issued before its slot.
+  ///       Only cancelJob() or a failure ends the job, with the usual
+  ///       exactly-once terminal result.
+  /// @return IN_PROGRESS when started, INVALID_PARAM for a zero ID, a period
+  ///         shorter than estimateMeasurementTimeMs() + commandDelayMs or
+  ///         longer than one day, or periodic/ART mode, BUSY when a job is active
+  Status requestCadence(const CadenceRequest& request);
+
+  /// Get fixed-cadence schedule progress and the last sample's schedule error (no I2C).
+  /// @note Counters describe the most recent cadence job and stay readable
+  ///       after it ends until the next requestCadence(), bind(), or end().
+  Status getCadenceStats(CadenceStats& out) const;
+
+  /// Start a single-shot job that averages count back-to-back conversions.
+  /// @note Performs zero I2C and requires idle SINGLE_SHOT mode. Each
+  ///       conversion is a command and a read as in requestMeasurement(),
+  ///       each on its own poll, so count conversions take 2 * count bus
+  ///       polls with at most one callback each: the same owner wake-ups as
+  ///       count separate jobs. With chainCommands and maxInstructions >= 2 a
+  ///       read and the next command share one poll (tIDLE runs command to
+  ///       command, so it is already open), for count + 1 polls; this is the
+  ///       only job that issues two callbacks in one poll. Only the final
+  ///       read emits a result: completed=true, terminal=true, with the
+  ///       rounded integer mean published as the sample. One requestId and
+  ///       deadline cover the whole burst; with rejectInfeasibleDeadlines the
+  ///       deadline must fit count conversions. Failure, cancellation, or the
+  ///       deadline ends it like any measurement job and discards the partial
+  ///       sums.
+  /// @return IN_PROGRESS when started, INVALID_PARAM for a zero ID, a count
+  ///         outside 2..MAX_BURST_COUNT, or periodic/ART mode, BUSY when a job
+  ///         is active, DEADLINE_INFEASIBLE when admission rejects the deadline
+  Status requestBurst(const BurstRequest& request);
+
+  /// Get the mean and spread of the last completed burst (no I2C).
+  /// @note Stays readable until the next requestBurst(), bind(), or end().
+  Status getBurstStats(BurstStats& out) const;
+
   /// Check if measurement is ready to read
   bool measurementReady() const { return _measurementReady; }
 
@@ -449,9 +661,67 @@ public:
     return _hasSample ? (nowMs - _sampleTimestampMs) : 0;
   }
 
+  /// Timestamp of the last completed sample on the 64-bit timebase (0 if none).
+  uint64_t sampleTimestampMs64() const { return _sampleTimestampMs64; }
+
+  /// Age of the last captured sample against a 64-bit timestamp; no wrap.
+  /// @return `nowMs - sampleTimestampMs64()` when a sample exists and is not
+  ///         newer than nowMs, otherwise 0
+  uint64_t sampleAgeMs64(uint64_t nowMs) const {
+    return (_hasSample && nowMs >= _sampleTimestampMs64) ? (nowMs - _sampleTimestampMs64) : 0;
+  }
+
+  /// Map a 32-bit timestamp onto the driver's 64-bit timebase.
+  /// @note The driver anchors the timebase at bind(), at each job request
+  ///       (re-reading Config::nowMs64 when set), and whenever it observes a
+  ///       newer time in pollJob() or a sample. nowMs must lie within
+  ///       INT32_MAX ms of the last anchor; without nowMs64 the driver must
+  ///       therefore observe time at least once every 24.8 days.
+  uint64_t toTimeMs64(uint32_t nowMs) const {
+    return static_cast<uint64_t>(static_cast<int64_t>(_timeAnchorMs64) +
+                                 static_cast<int32_t>(nowMs - _timeAnchorMs));
+  }
+
   /// Best-effort estimate of missed samples (periodic/ART mode)
   uint32_t missedSamplesEstimate() const { return _missedSamples; }
 
+  /// Sequence number of the last captured sample (0 before the first sample).
+  /// @note Every periodic/ART sample slot and every fixed-cadence slot gets a
+  ///       number, so slots that were overwritten before Fetch Data or skipped
+  ///       as overdue leave holes. Periodic slots are derived from the slot
+  ///       period and a phase re-learned from each fetch that contradicts it;
+  ///       with READ_HEADER_NACK the period is learned from on-schedule fetch
+  ///       intervals (bounded to nominal +/- 1/16), otherwise it is nominal.
+  ///       Plain single-shot samples advance by one. The sequence is monotonic
+  ///       (modulo 2^32) for the driver session and is reset only by bind(),
+  ///       begin(), or end(); mode restarts start a new slot phase.
+  uint32_t sampleSequence() const { return _sampleSequence; }
+
+  /// Total sequence numbers skipped between captured samples.
+  /// @note As accurate as the slot phase: a sensor running fast enough to
+  ///       produce a slot the driver did not expect without any not-ready
+  ///       response is undercounted, and without READ_HEADER_NACK the nominal
+  ///       period over- or undercounts a sensor whose oscillator is off.
+  uint32_t lostSamples() const { return _lostSamples; }
+
+  /// Total sequence gaps recorded this session, including gaps no longer retained.
+  uint32_t sampleGapCount() const { return _sampleGapCount; }
+
+  /// Snapshot cumulative sensor activity since bind().
+  /// @param nowMs Caller timestamp; closes the open periodic run and heater interval
+  /// @param[out] out Activity totals (saturating)
+  /// @return Status::Ok() or NOT_INITIALIZED
+  /// @note Input for estimateEnergy() in SHT3x/Energy.h. Zero I2C.
+  Status getActivity(uint32_t nowMs, ActivityCounters& out) const;
+
+  /// Copy the most recent sequence gaps, oldest first.
+  /// @param[out] out Caller array of at least capacity entries
+  /// @param capacity Entries available in out
+  /// @param[out] count Entries written: min(capacity, retained gaps), keeping the newest
+  /// @return Status::Ok(), or INVALID_PARAM for a null array with nonzero capacity
+  /// @note At most SAMPLE_GAP_HISTORY gaps are retained.
+  Status getSampleGaps(SampleGap* out, size_t capacity, size_t& count) const;
+
   /// Get measurement result (float)
   /// Returns MEASUREMENT_NOT_READY if not available
   /// Clears ready flag after successful read
@@ -501,6 +771,7 @@ public:
   /// Check if cached settings are available
   bool hasCachedSettings() const { return _hasCachedSettings; }
 
+#if SHT3X_ENABLE_SYNC_API
   /// Get a snapshot of settings/state and attempt a non-disruptive status read.
   /// statusValid is true only if the status read succeeds; statusReadStatus
   /// records the exact status-read result when it does not.
@@ -510,11 +781,13 @@ public:
   ///       In OFFLINE state under LATCH_OFFLINE, readSettings() returns BUSY.
   ///       OBSERVE_ONLY records the state but still authorizes the attempt.
   Status readSettings(SettingsSnapshot& out);
+#endif
 
   // =========================================================================
   // Low-Level Command Access
   // =========================================================================
 
+#if SHT3X_ENABLE_RAW_COMMANDS
   /// Issue one raw 16-bit command using the tracked transport path.
   /// @param command 16-bit SHT3x command constant from CommandTable.h
   /// @note Expert escape hatch. This bypasses high-level mode safety for
@@ -557,6 +830,7 @@ public:
   /// @return Status::Ok() on success, error otherwise
   Status readCommand(uint16_t command, uint8_t* out, size_t len,
                      bool allowNoData = false);
+#endif
 
   /// Set measurement repeatability; active periodic/ART modes are restarted and
   /// cached settings are updated only after the restart succeeds.
@@ -604,6 +878,7 @@ public:
   // Status / Heater / Resets
   // =========================================================================
 
+#if SHT3X_ENABLE_SYNC_API
   /// Read raw status register without clearing flags.
   /// @note Returns BUSY while any cooperative job or periodic/ART acquisition
   ///       is active. Use readStatusWithModeRestore()
@@ -642,7 +917,9 @@ public:
   /// Read heater state from status register.
   /// @note Follows readStatus() restrictions in active periodic/ART mode.
   Status readHeaterStatus(bool& enabled);
+#endif
 
+#if SHT3X_ENABLE_RECOVERY
   /// Soft reset the device.
   /// @note Sends one reset command and waits the bounded reset delay. Returns
   ///       BUSY while periodic/ART is active. A pending single-shot conversion
@@ -669,11 +946,13 @@ public:
   ///       explicit opt-in is set. On success, local measurement state is
   ///       cleared and mode is set to SINGLE_SHOT.
   Status generalCallReset();
+#endif
 
   // =========================================================================
   // Serial Number
   // =========================================================================
 
+#if SHT3X_ENABLE_SYNC_API
   /// Read electronic identification code (serial number).
   /// @param[out] serial 32-bit serial/EIC value assembled from two CRC-checked words
   /// @param stretch Command family to use for this read
@@ -683,11 +962,13 @@ public:
   ///       product grade or humidity accuracy.
   Status readSerialNumber(uint32_t& serial,
                           ClockStretching stretch = ClockStretching::STRETCH_DISABLED);
+#endif
 
   // =========================================================================
   // Alert Limits
   // =========================================================================
 
+#if SHT3X_ENABLE_ALERTS
   /// Read raw alert limit word.
   /// @note Alert mode is active during periodic acquisition, but alert-limit
   ///       commands are not documented as valid while periodic/ART is running.
@@ -720,11 +1001,13 @@ public:
   /// @return Status::Ok() only after both writes succeed; otherwise the first
   ///         failing write status is returned and partial hardware/cache state is possible.
   Status disableAlerts();
+#endif
 
   // =========================================================================
   // Helpers
   // =========================================================================
 
+#if SHT3X_ENABLE_ALERTS
   /// Encode alert limit word from physical values.
   /// @param temperatureC Temperature threshold in Celsius
   /// @param humidityPct Relative humidity threshold in percent
@@ -747,6 +1030,7 @@ public:
   /// @param[out] humidityPct Decoded approximate relative humidity in percent
   /// @note Alert-limit packing is quantized, so decode is approximate.
   static void decodeAlertLimit(uint16_t limit, float& temperatureC, float& humidityPct);
+#endif
 
   /// Convert raw temperature to Celsius (float)
   /// @param raw Raw 16-bit temperature word
@@ -793,6 +1077,16 @@ public:
   /// @return Measurement time in milliseconds
   uint32_t estimateMeasurementTimeMs() const;
 
+  /// Lower bound on how long a job requested now would take to complete.
+  /// Sums the remaining tIDLE, the single-shot conversion estimate or the
+  /// periodic/ART ready time, reset/break settle times, and
+  /// Config::transferBudgetUs per transport callback.
+  /// @param type MEASUREMENT (for the current mode) or ENSURE_IDLE
+  /// @return Microseconds from now; 0 for JobType::NONE
+  /// @note Deadline admission (Config::rejectInfeasibleDeadlines) rejects a
+  ///       request when now + this bound reaches its deadline.
+  uint32_t minimumCompletionUs(JobType type) const;
+
 private:
   // =========================================================================
   // Transport Wrappers
@@ -854,6 +1148,50 @@ private:
 
   /// Record any bus activity (including expected NACK)
   void _recordBusActivity(uint32_t nowMs);
+  Status _pollJobStep(uint32_t nowMs, uint8_t maxInstructions, PollJobResult& result);
+  bool _pollIdleHit(uint32_t nowMs, uint8_t maxInstructions) const;
+
+  /// Per-phase pollJob() step, indexed by JobPhase in POLL_PHASE_HANDLERS.
+  using PollPhaseHandler = Status (SHT3x::*)(uint32_t nowMs, uint8_t maxInstructions,
+                                              PollJobResult& result);
+  static const PollPhaseHandler POLL_PHASE_HANDLERS[];
+  Status _pollInvalidPhase(uint32_t nowMs, uint8_t maxInstructions, PollJobResult& result);
+  Status _pollSingleShotCommand(uint32_t nowMs, uint8_t maxInstructions,
+                                PollJobResult& result);
+  Status _pollSingleShotConversion(uint32_t nowMs, uint8_t maxInstructions,
+                                   PollJobResult& result);
+  Status _pollSingleShotRead(uint32_t nowMs, uint8_t maxInstructions, PollJobResult& result);
+  Status _pollPeriodicFetchCommand(uint32_t nowMs, uint8_t maxInstructions,
+                                   PollJobResult& result);
+  Status _pollPeriodicRead(uint32_t nowMs, uint8_t maxInstructions, PollJobResult& result);
+  Status _pollEnsureBreakCommand(uint32_t nowMs, uint8_t maxInstructions,
+                                 PollJobResult& result);
+  Status _pollEnsureBreakWait(uint32_t nowMs, uint8_t maxInstructions, PollJobResult& result);
+  Status _pollEnsureResetCommand(uint32_t nowMs, uint8_t maxInstructions,
+                                 PollJobResult& result);
+  Status _pollEnsureResetWait(uint32_t nowMs, uint8_t maxInstructions, PollJobResult& result);
+  Status _pollEnsureStatusCommand(uint32_t nowMs, uint8_t maxInstructions,
+                                  PollJobResult& result);
+  Status _pollEnsureStatusRead(uint32_t nowMs, uint8_t maxInstructions,
+                               PollJobResult& result);
+
+  // Shared pollJob() outcomes.
+  Status _jobProgress(PollJobResult& result, const char* message);
+  Status _jobWaiting(uint32_t nowMs, uint32_t wakeMs, PollJobResult& result,
+                     const char* message);
+  Status _jobFailed(PollJobResult& result, Status st);
+  Status _jobDeadlineExpired(PollJobResult& result, bool measurementReadResolved);
+  Status _jobSampled(PollJobResult& result, const RawSample& sample, uint32_t completedMs,
+                     uint32_t sequenceAdvance);
+  Status _jobEnsureSucceeded(PollJobResult& result);
+  bool _jobDeadlinePassed(uint32_t nowMs);
+  bool _commandDelayOpen();
+  uint32_t _clockMs();
+  uint32_t _clockUs();
+  void _invalidatePollClock() {
+    _pollClockMsValid = false;
+    _pollClockUsValid = false;
+  }
 
   // =========================================================================
   // Internal Helpers
@@ -862,13 +1200,33 @@ private:
   uint32_t _periodicFetchMarginMs() const;
   uint32_t _periodicReadyMs(uint32_t nowMs) const;
   uint32_t _periodicRetryMs(uint32_t nowMs) const;
+  bool _slotLearning() const;
   bool _singleShotMeasurementPending() const;
   bool _jobActive() const { return _jobType != JobType::NONE; }
   uint32_t _allocateJobId();
   JobEffect _effectForPhase(JobPhase phase, bool ambiguous) const;
   void _clearJobState();
+  void _skipOverdueCadenceSlots(uint32_t nowMs);
+  uint32_t _periodicSlotAdvance(uint32_t fetchMs);
+  void _notePeriodicNotReady(uint32_t fetchMs);
+  void _recordSampleSequence(uint32_t advance);
+  void _closePeriodicRun(uint32_t nowMs);
+  void _noteHeaterState(bool on, uint32_t nowMs);
+  void _syncTimebase();
+  uint64_t _extendMs(uint32_t nowMs);
+  JobRequest64 _widenRequest(const JobRequest& request);
+  Status _admitDeadline(const JobRequest64& request, JobType type);
+  Status _admitDeadline(const JobRequest64& request, uint32_t minimumUs);
+  Status _burstSampled(uint32_t nowMs, uint8_t maxInstructions, PollJobResult& result,
+                       const RawSample& sample, uint32_t completedMs);
+  bool _jobSlotBusy() const {
+    return _jobActive() || (_jobQueueCount != 0 && !_dispatchingQueuedJob);
+  }
+  Status _enqueueJob(JobType type, const JobRequest64& request, bool continuous);
+  Status _dispatchQueuedJob(PollJobResult& result);
   Status _ensureCommandDelay();
   Status _waitMs(uint32_t delayMs);
+  void _waitStep(uint32_t targetUs);
   Status _readStatusRaw(uint16_t& raw, bool tracked);
   Status _readMeasurementRawNoDelay(RawSample& out, bool tracked, bool allowNoData);
   Status _enterPeriodic(PeriodicRate rate, Repeatability rep, bool art);
@@ -887,6 +1245,7 @@ private:
   static uint32_t _periodMsForRate(PeriodicRate rate);
   static bool _durationElapsed(uint32_t now, uint32_t start, uint32_t duration);
   static bool _timeElapsed(uint32_t now, uint32_t target);
+  static bool _timeElapsed64(uint64_t now, uint64_t target);
   static void _parseStatusRegister(uint16_t raw, StatusRegister& out);
 
   // =========================================================================
@@ -901,6 +1260,12 @@ private:
   uint32_t _lastOkMs = 0;
   uint32_t _lastErrorMs = 0;
   uint32_t _lastBusActivityMs = 0;
+  // Hook reads cached for the current pollJob() step; see _clockMs().
+  bool _pollClockActive = false;
+  bool _pollClockMsValid = false;
+  bool _pollClockUsValid = false;
+  uint32_t _pollClockMs = 0;
+  uint32_t _pollClockUs = 0;
   Status _lastError = Status::Ok();
   uint8_t _consecutiveFailures = 0;
   uint32_t _totalFailures = 0;
@@ -923,10 +1288,49 @@ private:
   JobType _jobType = JobType::NONE;
   uint32_t _jobRequestId = 0;
   uint32_t _nextJobId = 1;
-  uint32_t _jobDeadlineMs = 0;
+  uint64_t _jobDeadlineMs64 = 0;
+  uint64_t _timeAnchorMs64 = 0;
+  uint32_t _timeAnchorMs = 0;
+  uint64_t _sampleTimestampMs64 = 0;
   bool _jobHasDeadline = false;
   JobEffect _jobEffect = JobEffect::NONE;
   uint32_t _jobWakeMs = 0;
+  // Result replayed by pollJob() while the active job waits; see _jobWaiting().
+  bool _pollIdleValid = false;
+  uint32_t _pollIdleUntilMs = 0;
+  PollJobResult _pollIdleResult;
+  bool _jobContinuous = false;
+  bool _cadenceActive = false;
+
+  struct QueuedJob {
+    uint64_t deadlineMs = 0;
+    uint32_t requestId = 0;
+    JobType type = JobType::NONE;
+    bool hasDeadline = false;
+    bool continuous = false;
+  };
+  QueuedJob _jobQueue[JOB_QUEUE_CAPACITY] = {};
+  uint8_t _jobQueueHead = 0;
+  uint8_t _jobQueueCount = 0;
+  bool _dispatchingQueuedJob = false;
+  uint32_t _cadencePeriodMs = 0;
+  uint32_t _cadenceNextSlotMs = 0;
+  uint32_t _cadenceNextSlot = 0;
+  uint32_t _cadenceLastSlot = 0;
+  uint32_t _cadenceSamples = 0;
+  uint32_t _cadenceSkippedSlots = 0;
+  uint32_t _cadencePendingErrorMs = 0;
+  uint32_t _cadenceLastErrorMs = 0;
+  uint32_t _cadenceMaxErrorMs = 0;
+  bool _burstActive = false;
+  bool _burstChain = false;
+  uint8_t _burstTarget = 0;
+  uint8_t _burstCount = 0;
+  uint32_t _burstSum[2] = {};
+  uint64_t _burstSumSquares[2] = {};
+  RawSample _burstMin;
+  RawSample _burstMax;
+  BurstStats _burstStats;
   Status _lastMeasurementStatus = Status::Error(Err::MEASUREMENT_NOT_READY,
                                                 "Measurement not ready");
   uint32_t _measurementReadyMs = 0;
@@ -936,6 +1340,23 @@ private:
   uint32_t _periodMs = 0;
   uint32_t _sampleTimestampMs = 0;
   uint32_t _missedSamples = 0;
+  uint32_t _sampleSequence = 0;
+  uint32_t _lostSamples = 0;
+  uint32_t _sampleGapCount = 0;
+  SampleGap _sampleGaps[SAMPLE_GAP_HISTORY] = {};
+  uint32_t _slotOriginMs = 0; // Next unfetched slot due, plus _slotOriginFrac / 256 ms
+  uint32_t _slotPeriodQ8 = 0; // Learned slot period in 1/256 ms
+  uint8_t _slotOriginFrac = 0;
+  bool _slotFetchOnTime = false;
+  bool _periodicSlotValid = false;
+  uint32_t _bindMs = 0;
+  uint32_t _singleShotConversions[3] = {};
+  uint32_t _periodicConversions[3] = {};
+  uint32_t _periodicUptimeMs = 0;
+  uint8_t _periodicRunRep = 0;
+  uint32_t _heaterOnMs = 0;
+  uint32_t _heaterOnSinceMs = 0;
+  bool _heaterOn = false;  // Physical heater state for heaterOnMs, not the restore plan
   uint32_t _notReadyStartMs = 0;
   bool _notReadyStartValid = false;
   uint32_t _notReadyCount = 0;
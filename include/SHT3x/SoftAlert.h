@@ -0,0 +1,113 @@
+/// @file SoftAlert.h
+/// @brief Software alert thresholds with hardware-style set/clear hysteresis
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "SHT3x/SHT3x.h"
+
+namespace SHT3x {
+
+/// Channel a software alert threshold watches.
+enum class SoftAlertChannel : uint8_t {
+  TEMPERATURE = 0, ///< Milli-degrees Celsius; reported as tAlert
+  HUMIDITY = 1     ///< Milli-percent RH; reported as rhAlert
+};
+
+/// Side of a software alert threshold.
+enum class SoftAlertKind : uint8_t {
+  HIGH_ALERT = 0, ///< Set above setMilli, clear below clearMilli (clearMilli <= setMilli)
+  LOW_ALERT = 1   ///< Set below setMilli, clear above clearMilli (clearMilli >= setMilli)
+};
+
+/// One set/clear threshold. Configuration fields are caller-owned; `active`
+/// is maintained by SoftAlert while the array is configured.
+struct SoftAlertThreshold {
+  SoftAlertChannel channel = SoftAlertChannel::TEMPERATURE; ///< Watched channel
+  SoftAlertKind kind = SoftAlertKind::HIGH_ALERT;           ///< Alert side
+  int32_t setMilli = 0;    ///< Raise level, like HIGH_SET / LOW_SET
+  int32_t clearMilli = 0;  ///< Release level, like HIGH_CLEAR / LOW_CLEAR
+  bool enabled = true;     ///< Disabled thresholds never raise
+  bool active = false;     ///< Alert currently raised (state)
+};
+
+/// One threshold raise or release.
+struct SoftAlertEvent {
+  uint32_t threshold = 0;  ///< Index into the configured array
+  bool active = false;     ///< True when raised, false when released
+  int32_t valueMilli = 0;  ///< Sample value that caused the transition
+  uint32_t timestampMs = 0; ///< Sample capture time
+};
+
+/// Status-register-like summary.
+struct SoftAlertStatus {
+  bool alertPending = false; ///< Any threshold raised since clearStatus()
+  bool rhAlert = false;      ///< A humidity threshold raised since clearStatus()
+  bool tAlert = false;       ///< A temperature threshold raised since clearStatus()
+  bool rhActive = false;     ///< A humidity threshold is raised now
+  bool tActive = false;      ///< A temperature threshold is raised now
+  uint32_t events = 0;       ///< Transitions since configure(), saturating
+};
+
+/// Evaluate alert thresholds on each captured sample, without bus traffic.
+///
+/// Mirrors the sensor's ALERT logic for any number of thresholds, including
+/// on parts without an ALERT pin: a high alert raises when the value exceeds
+/// its set level and releases only when it falls below the clear level (low
+/// alerts mirror this), and tAlert/rhAlert/alertPending latch until
+/// clearStatus(). The threshold array is caller storage; each sample costs
+/// one compare per threshold.
+class SoftAlert {
+ public:
+  /// Attach a threshold array and release every alert.
+  /// @param thresholds Caller array that outlives this object
+  /// @param count Entries in thresholds
+  /// @return Status::Ok(), or INVALID_PARAM for a null array with nonzero
+  ///         count, a bad channel or kind, or a clear level on the wrong side
+  ///         of its set level (detail is the index)
+  Status configure(SoftAlertThreshold* thresholds, size_t count);
+
+  /// Release every alert and clear the status flags.
+  void reset();
+
+  /// Clear the latched alertPending/rhAlert/tAlert flags, like clearStatus().
+  void clearStatus();
+
+  /// Evaluate one sample.
+  /// @param sample Temperature and humidity in milli-units
+  /// @param timestampMs Capture time copied into events
+  /// @param[out] events Caller buffer for transitions (may be null with capacity 0)
+  /// @param capacity Entries available in events
+  /// @param[out] written Events stored
+  /// @return Status::Ok(), INVALID_PARAM for a null buffer with nonzero
+  ///         capacity, or BUSY when more transitions happened than fit; the
+  ///         state and flags still advanced and detail is the number dropped
+  Status update(const MeasurementMilli& sample, uint32_t timestampMs, SoftAlertEvent* events,
+                size_t capacity, size_t& written);
+
+  /// Evaluate the device's latest sample at its capture timestamp. A sample
+  /// already evaluated (same sampleSequence()) produces no events.
+  /// @return getMeasurementMilli() errors, or as update() above
+  Status update(const SHT3x& device, SoftAlertEvent* events, size_t capacity, size_t& written);
+
+  /// Current summary.
+  SoftAlertStatus status() const { return _status; }
+
+  /// Build the four thresholds the sensor's alert limits describe, in the
+  /// order temperature high, humidity high, temperature low, humidity low.
+  /// @param alertRaw Limit words indexed by AlertLimitKind, e.g.
+  ///        CachedSettings::alertRaw
+  /// @param[out] out Four thresholds, released
+  /// @note A channel whose high set level lies below its low set level (as
+  ///       written by disableAlerts()) yields disabled thresholds.
+  static void fromAlertLimits(const uint16_t alertRaw[4], SoftAlertThreshold out[4]);
+
+ private:
+  SoftAlertThreshold* _thresholds = nullptr;
+  size_t _count = 0;
+  SoftAlertStatus _status;
+  uint32_t _deviceSequence = 0;
+  bool _hasDeviceSequence = false;
+};
+
+} // namespace SHT3x
@@ -28,7 +28,8 @@ enum class Err : uint8_t {
   I2C_NACK_READ,           ///< I2C NACK on read header / no data
   I2C_TIMEOUT,             ///< I2C transaction timeout
   I2C_BUS,                 ///< I2C bus error (SDA stuck, arbitration, etc.)
-  CANCELLED                ///< Cooperative job cancelled locally without I2C
+  CANCELLED,               ///< Cooperative job cancelled locally without I2C
+  DEADLINE_INFEASIBLE      ///< Job deadline precedes its minimum completion time; rejected without I2C
 };
 
 /// True for errors returned directly by an injected I2C transport callback.
@@ -0,0 +1,106 @@
+/// @file Telemetry.h
+/// @brief Fixed-layout binary telemetry frame for SHT3x health and samples
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "SHT3x/SHT3x.h"
+
+namespace SHT3x {
+
+/// @name Telemetry frame layout (version 1)
+/// All multi-byte fields are little-endian. The CRC is CRC-16/CCITT-FALSE
+/// (poly 0x1021, init 0xFFFF) over every byte before it.
+///
+/// | Offset | Size | Field |
+/// |-------:|-----:|-------|
+/// | 0  | 1 | magic (0x53) |
+/// | 1  | 1 | version (1) |
+/// | 2  | 2 | caller frame sequence |
+/// | 4  | 1 | DriverState |
+/// | 5  | 1 | lastError() Err code |
+/// | 6  | 1 | lastMeasurementStatus() Err code |
+/// | 7  | 1 | flags (TELEMETRY_FLAG_*) |
+/// | 8  | 1 | consecutiveFailures() |
+/// | 9  | 1 | settings: mode bits 0-1, repeatability bits 2-3, periodic rate bits 4-6 |
+/// | 10 | 2 | raw temperature word |
+/// | 12 | 2 | raw humidity word |
+/// | 14 | 2 | reserved (0) |
+/// | 16 | 4 | frame timestamp (caller nowMs) |
+/// | 20 | 4 | sampleTimestampMs() |
+/// | 24 | 4 | lastOkMs() |
+/// | 28 | 4 | lastErrorMs() |
+/// | 32 | 4 | totalSuccess() |
+/// | 36 | 4 | totalFailures() |
+/// | 40 | 4 | transportSuccess() |
+/// | 44 | 4 | transportFailures() |
+/// | 48 | 4 | protocolFailures() |
+/// | 52 | 4 | totalNotReady() |
+/// | 56 | 4 | missedSamplesEstimate() |
+/// | 60 | 2 | CRC-16 |
+/// @{
+
+static constexpr uint8_t TELEMETRY_MAGIC = 0x53;       ///< First byte of every frame
+static constexpr uint8_t TELEMETRY_VERSION = 1;        ///< Layout version encoded in byte 1
+static constexpr size_t TELEMETRY_FRAME_LEN = 62;      ///< Encoded frame length in bytes
+
+static constexpr uint8_t TELEMETRY_FLAG_INITIALIZED = 1U << 0;         ///< isInitialized()
+static constexpr uint8_t TELEMETRY_FLAG_HAS_SAMPLE = 1U << 1;          ///< hasSample(); raw words are valid
+static constexpr uint8_t TELEMETRY_FLAG_SAMPLE_READY = 1U << 2;        ///< measurementReady()
+static constexpr uint8_t TELEMETRY_FLAG_PERIODIC_ACTIVE = 1U << 3;     ///< isPeriodicActive()
+static constexpr uint8_t TELEMETRY_FLAG_HW_STATE_VALID = 1U << 4;      ///< hardwareStateValid()
+static constexpr uint8_t TELEMETRY_FLAG_MEASUREMENT_PENDING = 1U << 5; ///< measurementPending()
+
+/// @}
+
+/// Decoded telemetry frame.
+struct TelemetryFrame {
+  uint8_t version = 0;                          ///< Layout version
+  uint16_t sequence = 0;                        ///< Caller frame sequence
+  DriverState state = DriverState::UNINIT;      ///< Driver health state
+  Err lastError = Err::OK;                      ///< Code of lastError()
+  Err lastMeasurement = Err::OK;                ///< Code of lastMeasurementStatus()
+  uint8_t flags = 0;                            ///< TELEMETRY_FLAG_* bits
+  uint8_t consecutiveFailures = 0;              ///< Consecutive logical failures
+  Mode mode = Mode::SINGLE_SHOT;                ///< Configured mode
+  Repeatability repeatability = Repeatability::HIGH_REPEATABILITY; ///< Configured repeatability
+  PeriodicRate periodicRate = PeriodicRate::MPS_1; ///< Configured periodic rate
+  RawSample sample = {};                        ///< Last captured raw sample (valid with HAS_SAMPLE)
+  uint32_t frameTimestampMs = 0;                ///< Caller timestamp at encode time
+  uint32_t sampleTimestampMs = 0;               ///< Timestamp of the last sample
+  uint32_t lastOkMs = 0;                        ///< Last successful transport operation
+  uint32_t lastErrorMs = 0;                     ///< Last failed transport operation
+  uint32_t totalSuccess = 0;                    ///< Logical transport successes
+  uint32_t totalFailures = 0;                   ///< Logical transport failures
+  uint32_t transportSuccess = 0;                ///< Successful transport callbacks
+  uint32_t transportFailures = 0;               ///< Failed transport callbacks
+  uint32_t protocolFailures = 0;                ///< CRC/protocol failures
+  uint32_t totalNotReady = 0;                   ///< Expected not-ready responses
+  uint32_t missedSamples = 0;                   ///< Missed periodic sample estimate
+};
+
+/// Encode the driver's health counters and last sample into a telemetry frame.
+/// @param device Driver to snapshot (cached state only; zero I2C)
+/// @param nowMs Caller timestamp stored in the frame
+/// @param sequence Caller frame sequence number for uplink loss detection
+/// @param out Caller buffer
+/// @param capacity Size of out; must be at least TELEMETRY_FRAME_LEN
+/// @param[out] written Bytes written (TELEMETRY_FRAME_LEN on success, else 0)
+/// @return Status::Ok() or INVALID_PARAM for a null/short buffer
+/// @note No allocation, formatting, or floating point. Safe to call while a
+///       cooperative job is active.
+Status encodeTelemetryFrame(const SHT3x& device, uint32_t nowMs, uint16_t sequence,
+                            uint8_t* out, size_t capacity, size_t& written);
+
+/// Decode and verify a telemetry frame.
+/// @param data Frame bytes
+/// @param len Number of bytes available
+/// @param[out] out Decoded frame on success
+/// @return Status::Ok(), INVALID_PARAM for short input, bad magic, or an
+///         unknown version, or CRC_MISMATCH when the CRC does not match
+Status decodeTelemetryFrame(const uint8_t* data, size_t len, TelemetryFrame& out);
+
+/// CRC-16/CCITT-FALSE used by telemetry frames.
+uint16_t telemetryCrc16(const uint8_t* data, size_t len);
+
+} // namespace SHT3x
@@ -0,0 +1,189 @@
+/**
+ * @file AlarmEngine.cpp
+ * @brief Structure-of-arrays threshold alarm engine.
+ */
+
+#include "SHT3x/AlarmEngine.h"
+
+#include <cmath>
+
+namespace SHT3x {
+namespace {
+
+static_assert(ALARM_MAX_RULES <= 0xFFFFU && ALARM_MAX_SENSORS <= 0xFFFFU,
+              "alarm indices are 16-bit");
+
+// Per-pair flag bits.
+static constexpr uint8_t FLAG_ACTIVE = 1U << 0;   // Alarm raised
+static constexpr uint8_t FLAG_PENDING = 1U << 1;  // Condition differs; debounce running
+static constexpr uint8_t FLAG_CHANGED = 1U << 2;  // At least one transition (hold-off armed)
+static constexpr uint8_t FLAG_FIRED = 1U << 3;    // Transitioned in the current evaluate()
+
+// Magnus coefficients over water (Sonntag 1990), -45..60 C.
+static constexpr float MAGNUS_B = 17.62f;
+static constexpr float MAGNUS_C_MILLI = 243120.0f;
+
+int32_t dewPointMarginMilli(const MeasurementMilli& sample) {
+  const float t = static_cast<float>(sample.temperatureMilliCelsius);
+  const int32_t rh = sample.humidityMilliPercent > 1 ? sample.humidityMilliPercent : 1;
+  const float gamma =
+      std::log(static_cast<float>(rh) / 100000.0f) + MAGNUS_B * t / (MAGNUS_C_MILLI + t);
+  const float dewPoint = MAGNUS_C_MILLI * gamma / (MAGNUS_B - gamma);
+  return static_cast<int32_t>(t - dewPoint);
+}
+
+} // namespace
+
+Status AlarmEngine::addRule(const AlarmRule& rule, uint16_t& ruleIndex) {
+  if (static_cast<uint8_t>(rule.metric) > static_cast<uint8_t>(AlarmMetric::DEW_POINT_MARGIN)) {
+    return Status::Error(Err::INVALID_PARAM, "Invalid alarm metric");
+  }
+  if (rule.direction != AlarmDirection::ABOVE && rule.direction != AlarmDirection::BELOW) {
+    return Status::Error(Err::INVALID_PARAM, "Invalid alarm direction");
+  }
+  if (rule.thresholdMilli > ALARM_MAX_LEVEL || rule.thresholdMilli < -ALARM_MAX_LEVEL ||
+      rule.hysteresisMilli < 0 || rule.hysteresisMilli > ALARM_MAX_LEVEL) {
+    return Status::Error(Err::INVALID_PARAM, "Alarm level out of range");
+  }
+  if (_ruleCount >= ALARM_MAX_RULES) {
+    return Status::Error(Err::BUSY, "Alarm rule table full",
+                         static_cast<int32_t>(ALARM_MAX_RULES));
+  }
+
+  // BELOW rules compare negated values so every row runs the same test:
+  // sign * value > level, with the clear level hysteresis further back.
+  const size_t r = _ruleCount;
+  const int32_t sign = (rule.direction == AlarmDirection::ABOVE) ? 1 : -1;
+  _ruleSign[r] = sign;
+  _ruleSetLevel[r] = sign * rule.thresholdMilli;
+  _ruleClearLevel[r] = sign * rule.thresholdMilli - rule.hysteresisMilli;
+  _ruleDebounceMs[r] = rule.debounceMs;
+  _ruleHoldOffMs[r] = rule.holdOffMs;
+  _ruleMetric[r] = rule.metric;
+  for (size_t s = 0; s < ALARM_MAX_SENSORS; ++s) {
+    _flags[r][s] = 0;
+    _sinceMs[r][s] = 0;
+    _changedMs[r][s] = 0;
+  }
+  ruleIndex = static_cast<uint16_t>(r);
+  _ruleCount++;
+  return Status::Ok();
+}
+
+void AlarmEngine::clear() {
+  _ruleCount = 0;
+  resetState();
+}
+
+void AlarmEngine::resetState() {
+  for (size_t r = 0; r < ALARM_MAX_RULES; ++r) {
+    for (size_t s = 0; s < ALARM_MAX_SENSORS; ++s) {
+      _flags[r][s] = 0;
+      _sinceMs[r][s] = 0;
+      _changedMs[r][s] = 0;
+    }
+  }
+}
+
+Status AlarmEngine::evaluate(uint32_t nowMs, const MeasurementMilli* samples,
+                             size_t sensorCount, AlarmTransition* out, size_t capacity,
+                             size_t& written) {
+  written = 0;
+  if (sensorCount > ALARM_MAX_SENSORS) {
+    return Status::Error(Err::INVALID_PARAM, "Too many alarm sensors",
+                         static_cast<int32_t>(ALARM_MAX_SENSORS));
+  }
+  if ((samples == nullptr && sensorCount > 0) || (out == nullptr && capacity > 0)) {
+    return Status::Error(Err::INVALID_PARAM, "Alarm batch buffer is null");
+  }
+
+  bool needDewPoint = false;
+  for (size_t r = 0; r < _ruleCount; ++r) {
+    needDewPoint = needDewPoint || _ruleMetric[r] == AlarmMetric::DEW_POINT_MARGIN;
+  }
+  int32_t* temperature = _metrics[static_cast<uint8_t>(AlarmMetric::TEMPERATURE)];
+  int32_t* humidity = _metrics[static_cast<uint8_t>(AlarmMetric::HUMIDITY)];
+  int32_t* dewMargin = _metrics[static_cast<uint8_t>(AlarmMetric::DEW_POINT_MARGIN)];
+  for (size_t s = 0; s < sensorCount; ++s) {
+    temperature[s] = samples[s].temperatureMilliCelsius;
+    humidity[s] = samples[s].humidityMilliPercent;
+  }
+  if (needDewPoint) {
+    for (size_t s = 0; s < sensorCount; ++s) {
+      dewMargin[s] = dewPointMarginMilli(samples[s]);
+    }
+  }
+
+  size_t dropped = 0;
+  for (size_t r = 0; r < _ruleCount; ++r) {
+    const int32_t* values = _metrics[static_cast<uint8_t>(_ruleMetric[r])];
+    const int32_t sign = _ruleSign[r];
+    const int32_t setLevel = _ruleSetLevel[r];
+    const int32_t clearLevel = _ruleClearLevel[r];
+    const uint32_t debounceMs = _ruleDebounceMs[r];
+    const uint32_t holdOffMs = _ruleHoldOffMs[r];
+    uint8_t* flags = _flags[r];
+    uint32_t* sinceMs = _sinceMs[r];
+    uint32_t* changedMs = _changedMs[r];
+
+    // Branch-free sweep over the row: flags are 0/1 integers combined with
+    // bitwise operators and every select is a conditional move, so the loop
+    // vectorizes across sensors. A firing pair always flips its state.
+    uint32_t fired = 0;
+    for (size_t s = 0; s < sensorCount; ++s) {
+      const uint32_t f = flags[s];
+      const uint32_t active = f & FLAG_ACTIVE;
+      const int32_t level = active != 0 ? clearLevel : setLevel;
+      const uint32_t condition = (sign * values[s] > level) ? 1U : 0U;
+      const uint32_t mismatch = condition ^ active;
+      const uint32_t starting = mismatch & ~(f >> 1);
+      const uint32_t since = (starting & 1U) != 0 ? nowMs : sinceMs[s];
+      const uint32_t settled = (nowMs - since >= debounceMs) ? 1U : 0U;
+      const uint32_t held =
+          (~(f >> 2) & 1U) | ((nowMs - changedMs[s] >= holdOffMs) ? 1U : 0U);
+      const uint32_t fire = mismatch & settled & held;
+      sinceMs[s] = since;
+      changedMs[s] = fire != 0 ? nowMs : changedMs[s];
+      flags[s] = static_cast<uint8_t>((f & FLAG_CHANGED) | (active ^ fire) |
+                                      ((mismatch & ~fire) << 1) |
+                                      (fire * (FLAG_CHANGED | FLAG_FIRED)));
+      fired += fire;
+    }
+    if (fired == 0) {
+      continue;
+    }
+
+    for (size_t s = 0; s < sensorCount && fired > 0; ++s) {
+      if ((flags[s] & FLAG_FIRED) == 0) {
+        continue;
+      }
+      flags[s] = static_cast<uint8_t>(flags[s] & ~FLAG_FIRED);
+      fired--;
+      if (written >= capacity) {
+        dropped++;
+        continue;
+      }
+      AlarmTransition& t = out[written++];
+      t.rule = static_cast<uint16_t>(r);
+      t.sensor = static_cast<uint16_t>(s);
+      t.active = (flags[s] & FLAG_ACTIVE) != 0;
+      t.valueMilli = values[s];
+      t.timeMs = nowMs;
+    }
+  }
+
+  if (dropped > 0) {
+    return Status::Error(Err::BUSY, "Alarm transition buffer full",
+                         static_cast<int32_t>(dropped));
+  }
+  return Status::Ok();
+}
+
+bool AlarmEngine::isActive(uint16_t rule, uint16_t sensor) const {
+  if (rule >= _ruleCount || sensor >= ALARM_MAX_SENSORS) {
+    return false;
+  }
+  return (_flags[rule][sensor] & FLAG_ACTIVE) != 0;
+}
+
+} // namespace SHT3x
@@ -0,0 +1,93 @@
+/**
+ * @file AllanDeviation.cpp
+ * @brief Streaming overlapping Allan deviation accumulator.
+ */
+
+#include "SHT3x/AllanDeviation.h"
+
+#include <cmath>
+
+namespace SHT3x {
+namespace {
+
+static constexpr size_t HISTORY_MASK = ALLAN_HISTORY - 1U;
+static_assert((ALLAN_HISTORY & HISTORY_MASK) == 0, "history must be a power of two");
+
+// Full-scale raw word to physical units (datasheet conversion slopes).
+static constexpr float TEMPERATURE_C_PER_COUNT = 175.0f / 65535.0f;
+static constexpr float HUMIDITY_PCT_PER_COUNT = 100.0f / 65535.0f;
+
+inline uint64_t saturatingAddU64(uint64_t a, uint64_t b) {
+  const uint64_t sum = a + b;
+  return (sum < a) ? UINT64_MAX : sum;
+}
+
+} // namespace
+
+void AllanDeviation::reset() {
+  *this = AllanDeviation();
+}
+
+void AllanDeviation::add(const RawSample& sample) {
+  const uint16_t values[2] = {sample.rawTemperature, sample.rawHumidity};
+  const uint32_t n = _samples;
+  for (size_t ch = 0; ch < 2; ++ch) {
+    const int32_t y = values[ch];
+    const uint16_t* history = _history[ch];
+    for (uint8_t k = 0; k < ALLAN_OCTAVES; ++k) {
+      const uint32_t m = 1U << k;
+      // Slide both windows by one sample: y(n-m) moves from recent to older
+      // and y(n-2m) leaves. The history still holds y(n-2m) because y(n) is
+      // stored only after every octave has read it.
+      _recent[ch][k] += y;
+      if (n >= m) {
+        const int32_t crossing = history[(_head - m) & HISTORY_MASK];
+        _recent[ch][k] -= crossing;
+        _older[ch][k] += crossing;
+      }
+      if (n >= 2U * m) {
+        _older[ch][k] -= history[(_head - 2U * m) & HISTORY_MASK];
+      }
+      if (n + 1U >= 2U * m) {
+        const int64_t diff = static_cast<int64_t>(_recent[ch][k]) - _older[ch][k];
+        _sumSquares[ch][k] =
+            saturatingAddU64(_sumSquares[ch][k], static_cast<uint64_t>(diff * diff));
+      }
+    }
+    _history[ch][_head] = values[ch];
+  }
+  for (uint8_t k = 0; k < ALLAN_OCTAVES; ++k) {
+    if (n + 1U >= (2U << k) && _terms[k] != UINT32_MAX) {
+      _terms[k]++;
+    }
+  }
+  _head = (_head + 1U) & HISTORY_MASK;
+  if (_samples != UINT32_MAX) {
+    _samples++;
+  }
+}
+
+Status AllanDeviation::getPoint(uint8_t octave, AllanPoint& out) const {
+  out = AllanPoint{};
+  if (octave >= ALLAN_OCTAVES) {
+    return Status::Error(Err::INVALID_PARAM, "Allan octave out of range", octave);
+  }
+  const uint32_t m = 1U << octave;
+  out.averagingFactor = m;
+  out.terms = _terms[octave];
+  if (out.terms == 0) {
+    return Status::Error(Err::MEASUREMENT_NOT_READY, "Not enough samples",
+                         static_cast<int32_t>(2U * m));
+  }
+  // sigma^2(m) = sum((mean_recent - mean_older)^2) / (2 * terms); the window
+  // sums carry a factor m on each mean.
+  const float denom = 2.0f * static_cast<float>(m) * static_cast<float>(m) *
+                      static_cast<float>(out.terms);
+  out.temperatureC = std::sqrt(static_cast<float>(_sumSquares[0][octave]) / denom) *
+                     TEMPERATURE_C_PER_COUNT;
+  out.humidityPct = std::sqrt(static_cast<float>(_sumSquares[1][octave]) / denom) *
+                    HUMIDITY_PCT_PER_COUNT;
+  return Status::Ok();
+}
+
+} // namespace SHT3x
@@ -0,0 +1,107 @@
+/**
+ * @file DeadBand.cpp
+ * @brief Dead-band report-by-exception filter.
+ */
+
+#include "SHT3x/DeadBand.h"
+
+namespace SHT3x {
+namespace {
+
+void bump(uint32_t& counter) {
+  if (counter != UINT32_MAX) {
+    counter++;
+  }
+}
+
+/// |a - b| > band without int32 overflow.
+bool outside(int32_t a, int32_t b, int32_t band) {
+  const int64_t diff = static_cast<int64_t>(a) - static_cast<int64_t>(b);
+  return (diff < 0 ? -diff : diff) > band;
+}
+
+} // namespace
+
+Status DeadBand::configure(const DeadBandConfig& config) {
+  if (config.temperatureMilliCelsius < 0 || config.humidityMilliPercent < 0) {
+    return Status::Error(Err::INVALID_PARAM, "Dead-band must not be negative");
+  }
+  _config = config;
+  reset();
+  return Status::Ok();
+}
+
+void DeadBand::reset() {
+  _stats = DeadBandStats{};
+  _last = MeasurementMilli{};
+  _lastMs = 0;
+  _deviceSequence = 0;
+  _hasReport = false;
+  _hasDeviceSequence = false;
+}
+
+DeadBandReason DeadBand::update(const MeasurementMilli& sample, uint32_t timestampMs) {
+  bump(_stats.samples);
+
+  DeadBandReason reason = DeadBandReason::SUPPRESSED;
+  if (!_hasReport) {
+    reason = DeadBandReason::FIRST;
+  } else {
+    const bool temperature = outside(sample.temperatureMilliCelsius,
+                                     _last.temperatureMilliCelsius,
+                                     _config.temperatureMilliCelsius);
+    const bool humidity = outside(sample.humidityMilliPercent, _last.humidityMilliPercent,
+                                  _config.humidityMilliPercent);
+    if (temperature || humidity) {
+      reason = DeadBandReason::CHANGE;
+      if (temperature) {
+        bump(_stats.temperatureChanges);
+      }
+      if (humidity) {
+        bump(_stats.humidityChanges);
+      }
+    } else if (_config.maxSilenceMs > 0 &&
+               static_cast<uint32_t>(timestampMs - _lastMs) >= _config.maxSilenceMs) {
+      reason = DeadBandReason::HEARTBEAT;
+      bump(_stats.heartbeats);
+    }
+  }
+
+  if (reason == DeadBandReason::SUPPRESSED) {
+    bump(_stats.suppressed);
+    return reason;
+  }
+  bump(_stats.reported);
+  _last = sample;
+  _lastMs = timestampMs;
+  _hasReport = true;
+  return reason;
+}
+
+Status DeadBand::update(const SHT3x& device, DeadBandReason& reason) {
+  reason = DeadBandReason::DUPLICATE;
+  MeasurementMilli sample;
+  const Status st = device.getMeasurementMilli(sample);
+  if (!st.ok()) {
+    return st;
+  }
+  const uint32_t sequence = device.sampleSequence();
+  if (_hasDeviceSequence && sequence == _deviceSequence) {
+    return Status::Ok();
+  }
+  _deviceSequence = sequence;
+  _hasDeviceSequence = true;
+  reason = update(sample, device.sampleTimestampMs());
+  return Status::Ok();
+}
+
+Status DeadBand::getLastReport(MeasurementMilli& out, uint32_t& timestampMs) const {
+  if (!_hasReport) {
+    return Status::Error(Err::MEASUREMENT_NOT_READY, "No sample reported yet");
+  }
+  out = _last;
+  timestampMs = _lastMs;
+  return Status::Ok();
+}
+
+} // namespace SHT3x
@@ -0,0 +1,68 @@
+/**
+ * @file Energy.cpp
+ * @brief Energy-per-sample estimator.
+ */
+
+#include "SHT3x/Energy.h"
+
+namespace SHT3x {
+
+Status estimateEnergy(const ActivityCounters& activity, const EnergyModel& model,
+                      EnergyEstimate& out) {
+  out = EnergyEstimate{};
+  if (model.supplyMillivolts == 0) {
+    return Status::Error(Err::INVALID_PARAM, "Supply voltage is zero");
+  }
+  const float volts = static_cast<float>(model.supplyMillivolts) / 1000.0f;
+  // uA * V * s = uJ; nA * V * ms = pJ, so nA * V * ms / 1e6 = uJ.
+  const float periodicMs = static_cast<float>(activity.periodicUptimeMs);
+  const float singleShotMs =
+      activity.elapsedMs > activity.periodicUptimeMs
+          ? static_cast<float>(activity.elapsedMs - activity.periodicUptimeMs)
+          : 0.0f;
+  out.idleMicrojoules = (static_cast<float>(model.idleNanoamps) * singleShotMs +
+                         static_cast<float>(model.periodicIdleNanoamps) * periodicMs) *
+                        volts / 1e6f;
+
+  float conversionUs = 0.0f;
+  for (size_t i = 0; i < 3; ++i) {
+    const float conversions = static_cast<float>(activity.singleShotConversions[i]) +
+                              static_cast<float>(activity.periodicConversions[i]);
+    conversionUs += conversions * static_cast<float>(model.conversionUs[i]);
+  }
+  // nA * V * us = fJ.
+  out.conversionMicrojoules =
+      static_cast<float>(model.measuringNanoamps) * volts * conversionUs / 1e9f;
+  // uW * ms = nJ.
+  out.heaterMicrojoules = static_cast<float>(model.heaterMicrowatts) *
+                          static_cast<float>(activity.heaterOnMs) / 1000.0f;
+  out.busMicrojoules = static_cast<float>(model.busNanojoulesPerCallback) *
+                       static_cast<float>(activity.transportCallbacks) / 1000.0f;
+
+  out.elapsedMs = activity.elapsedMs;
+  out.samples = activity.samples;
+  out.totalMicrojoules = out.idleMicrojoules + out.conversionMicrojoules +
+                         out.heaterMicrojoules + out.busMicrojoules;
+  if (activity.samples > 0) {
+    out.microjoulesPerSample = out.totalMicrojoules / static_cast<float>(activity.samples);
+  }
+  if (activity.elapsedMs > 0) {
+    // uJ / (V * ms) = mA; scale to uA.
+    out.averageMicroamps = out.totalMicrojoules * 1000.0f /
+                           (volts * static_cast<float>(activity.elapsedMs));
+  }
+  return Status::Ok();
+}
+
+Status estimateEnergy(const SHT3x& device, uint32_t nowMs, const EnergyModel& model,
+                      EnergyEstimate& out) {
+  out = EnergyEstimate{};
+  ActivityCounters activity;
+  const Status st = device.getActivity(nowMs, activity);
+  if (!st.ok()) {
+    return st;
+  }
+  return estimateEnergy(activity, model, out);
+}
+
+} // namespace SHT3x
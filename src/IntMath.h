@@ -0,0 +1,30 @@
+/// @file IntMath.h
+/// @brief Private integer helpers shared by the core and the optional filters.
+#pragma once
+
+#include <cstdint>
+
+namespace SHT3x {
+namespace intmath {
+
+/// Floor of the square root, bit by bit: 32 iterations, no division.
+inline uint32_t sqrtU64(uint64_t value) {
+  uint64_t root = 0;
+  uint64_t bit = static_cast<uint64_t>(1) << 62;
+  while (bit > value) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return static_cast<uint32_t>(root);
+}
+
+}  // namespace intmath
+}  // namespace SHT3x
@@ -0,0 +1,178 @@
+/**
+ * @file KalmanFilter.cpp
+ * @brief Fixed-point constant-velocity Kalman filter.
+ */
+
+#include "SHT3x/KalmanFilter.h"
+
+#include "IntMath.h"
+
+namespace SHT3x {
+namespace {
+
+// Bound on every covariance term (Q8 milli-units squared, about 32 units
+// 1-sigma) and on the Q16 rate gain, so products with Q16 gains, residuals,
+// and intervals stay below 2^62.
+static constexpr int64_t MAX_VARIANCE = static_cast<int64_t>(1) << 38;
+static constexpr int64_t MAX_RATE_GAIN = static_cast<int64_t>(1) << 30;
+static constexpr int64_t INT32_LIMIT = 0x7FFFFFFF;
+
+// Datasheet repeatability is 3 sigma; variance = (value / 3)^2 in milli-units
+// squared, Q8. Indexed by Repeatability (LOW, MEDIUM, HIGH).
+static constexpr int64_t TEMPERATURE_NOISE_Q8[3] = {2500 * 256, 711 * 256, 178 * 256};
+static constexpr int64_t HUMIDITY_NOISE_Q8[3] = {4900 * 256, 2500 * 256, 711 * 256};
+
+// Rate variance for a newly started filter: 1 unit per second, 1 sigma.
+static constexpr int64_t INITIAL_RATE_VARIANCE_Q8 = 1000000LL * 256;
+
+inline int64_t mulQ16(int64_t a, int64_t b) {
+  return (a * b) >> 16;
+}
+
+inline int64_t clampI64(int64_t value, int64_t low, int64_t high) {
+  return value < low ? low : (value > high ? high : value);
+}
+
+inline int32_t roundQ8(int64_t value) {
+  return static_cast<int32_t>(value >= 0 ? (value + 128) >> 8 : -((-value + 128) >> 8));
+}
+
+bool validRepeatability(Repeatability rep) {
+  return static_cast<uint8_t>(rep) <= static_cast<uint8_t>(Repeatability::HIGH_REPEATABILITY);
+}
+
+} // namespace
+
+Status KalmanFilter::configure(const KalmanConfig& config) {
+  if (!validRepeatability(config.repeatability)) {
+    return Status::Error(Err::INVALID_PARAM, "Invalid repeatability");
+  }
+  if (config.temperatureAccelMilliCelsiusPerS2 == 0 ||
+      config.temperatureAccelMilliCelsiusPerS2 > KALMAN_MAX_ACCEL ||
+      config.humidityAccelMilliPercentPerS2 == 0 ||
+      config.humidityAccelMilliPercentPerS2 > KALMAN_MAX_ACCEL) {
+    return Status::Error(Err::INVALID_PARAM, "Kalman acceleration out of range");
+  }
+  _config = config;
+  reset();
+  return Status::Ok();
+}
+
+void KalmanFilter::reset() {
+  _channels[0] = Channel{};
+  _channels[1] = Channel{};
+  _timestampMs = 0;
+  _samples = 0;
+  _deviceSequence = 0;
+  _started = false;
+}
+
+void KalmanFilter::update(const RawSample& sample, uint32_t timestampMs) {
+  _update(sample, timestampMs, _config.repeatability);
+}
+
+Status KalmanFilter::update(const SHT3x& device) {
+  RawSample sample;
+  const Status st = device.getRawSample(sample);
+  if (!st.ok()) {
+    return st;
+  }
+  const uint32_t sequence = device.sampleSequence();
+  if (_started && sequence == _deviceSequence) {
+    return Status::Ok();
+  }
+  _deviceSequence = sequence;
+  _update(sample, device.sampleTimestampMs(), device.getConfig().repeatability);
+  return Status::Ok();
+}
+
+void KalmanFilter::_update(const RawSample& sample, uint32_t timestampMs,
+                           Repeatability repeatability) {
+  const uint8_t rep = validRepeatability(repeatability)
+                          ? static_cast<uint8_t>(repeatability)
+                          : static_cast<uint8_t>(Repeatability::LOW_REPEATABILITY);
+  const int32_t milli[2] = {SHT3x::convertTemperatureMilliCelsius(sample.rawTemperature),
+                            SHT3x::convertHumidityMilliPercent(sample.rawHumidity)};
+  const int64_t noise[2] = {TEMPERATURE_NOISE_Q8[rep], HUMIDITY_NOISE_Q8[rep]};
+
+  const int32_t gapMs = static_cast<int32_t>(timestampMs - _timestampMs);
+  if (!_started || gapMs < 0 || static_cast<uint32_t>(gapMs) > KALMAN_MAX_GAP_MS) {
+    _start(_channels[0], milli[0], noise[0]);
+    _start(_channels[1], milli[1], noise[1]);
+    _timestampMs = timestampMs;
+    _samples = 1;
+    _started = true;
+    return;
+  }
+
+  const int64_t accel[2] = {static_cast<int64_t>(_config.temperatureAccelMilliCelsiusPerS2),
+                            static_cast<int64_t>(_config.humidityAccelMilliPercentPerS2)};
+  const int64_t dtQ16 = (static_cast<int64_t>(gapMs) << 16) / 1000;
+  for (uint8_t i = 0; i < 2; ++i) {
+    _step(_channels[i], milli[i], noise[i], accel[i] * accel[i] * 256, dtQ16);
+  }
+  _timestampMs = timestampMs;
+  if (_samples != UINT32_MAX) {
+    _samples++;
+  }
+}
+
+void KalmanFilter::_start(Channel& ch, int32_t milli, int64_t noise) {
+  ch.level = milli * 256;
+  ch.rate = 0;
+  ch.p00 = noise;
+  ch.p01 = 0;
+  ch.p11 = INITIAL_RATE_VARIANCE_Q8;
+}
+
+void KalmanFilter::_step(Channel& ch, int32_t milli, int64_t noise, int64_t accelNoise,
+                         int64_t dtQ16) {
+  // Predict across the interval with white-acceleration process noise:
+  // Q = q * [dt^3/3, dt^2/2; dt^2/2, dt].
+  if (dtQ16 > 0) {
+    const int64_t q11 = mulQ16(accelNoise, dtQ16);
+    const int64_t qdt2 = mulQ16(q11, dtQ16);
+    const int64_t q01 = qdt2 / 2;
+    const int64_t q00 = mulQ16(qdt2, dtQ16) / 3;
+    const int64_t dtP11 = mulQ16(dtQ16, ch.p11);
+    const int64_t level = ch.level + mulQ16(ch.rate, dtQ16);
+    ch.level = static_cast<int32_t>(clampI64(level, -INT32_LIMIT, INT32_LIMIT));
+    ch.p00 = clampI64(ch.p00 + mulQ16(dtQ16, 2 * ch.p01 + dtP11) + q00, 0, MAX_VARIANCE);
+    ch.p01 = clampI64(ch.p01 + dtP11 + q01, -MAX_VARIANCE, MAX_VARIANCE);
+    ch.p11 = clampI64(ch.p11 + q11, 0, MAX_VARIANCE);
+  }
+
+  // Correct with the scalar level measurement.
+  const int64_t residual = static_cast<int64_t>(milli) * 256 - ch.level;
+  const int64_t innovation = ch.p00 + noise;
+  const int64_t levelGain = (ch.p00 << 16) / innovation;
+  const int64_t rateGain =
+      clampI64((ch.p01 << 16) / innovation, -MAX_RATE_GAIN, MAX_RATE_GAIN);
+  const int64_t level = ch.level + mulQ16(levelGain, residual);
+  const int64_t rate = ch.rate + mulQ16(rateGain, residual);
+  ch.level = static_cast<int32_t>(clampI64(level, -INT32_LIMIT, INT32_LIMIT));
+  ch.rate = static_cast<int32_t>(clampI64(rate, -INT32_LIMIT, INT32_LIMIT));
+  const int64_t p01 = ch.p01;
+  ch.p00 = clampI64(ch.p00 - mulQ16(levelGain, ch.p00), 1, MAX_VARIANCE);
+  ch.p01 = p01 - mulQ16(levelGain, p01);
+  ch.p11 = clampI64(ch.p11 - mulQ16(rateGain, p01), 0, MAX_VARIANCE);
+}
+
+Status KalmanFilter::getEstimate(KalmanEstimate& out) const {
+  out = KalmanEstimate{};
+  if (!_started) {
+    return Status::Error(Err::MEASUREMENT_NOT_READY, "No sample filtered");
+  }
+  out.temperatureMilliCelsius = roundQ8(_channels[0].level);
+  out.humidityMilliPercent = roundQ8(_channels[1].level);
+  out.temperatureRateMilliCelsiusPerS = roundQ8(_channels[0].rate);
+  out.humidityRateMilliPercentPerS = roundQ8(_channels[1].rate);
+  out.temperatureStdDevMilliCelsius =
+      intmath::sqrtU64(static_cast<uint64_t>(_channels[0].p00) >> 8);
+  out.humidityStdDevMilliPercent = intmath::sqrtU64(static_cast<uint64_t>(_channels[1].p00) >> 8);
+  out.timestampMs = _timestampMs;
+  out.samples = _samples;
+  return Status::Ok();
+}
+
+} // namespace SHT3x
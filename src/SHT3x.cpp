@@ -5,6 +5,7 @@
 
 #include "SHT3x/SHT3x.h"
 
+#include "IntMath.h"
 #include "PlatformTime.h"
 
 #include <cstring>
@@ -26,6 +27,9 @@ static constexpr uint32_t MAX_NOT_READY_TIMEOUT_MS = 600000;
 static constexpr uint32_t MAX_PERIODIC_FETCH_MARGIN_MS = 60000;
 static constexpr uint32_t MAX_RECOVER_BACKOFF_MS = 600000;
 static constexpr uint16_t MAX_SINGLE_SHOT_MARGIN_MS = 1000;
+static constexpr uint32_t MAX_CADENCE_PERIOD_MS = 86400000;
+
+#if SHT3X_ENABLE_ALERTS
 static constexpr float ALERT_DEFAULT_MATCH_EPSILON = 0.001f;
 
 struct AlertDefaultVector {
@@ -42,6 +46,7 @@ static constexpr AlertDefaultVector ALERT_APP_NOTE_DEFAULTS[] = {
     {-9.0f, 22.0f, 0x3869},
     {-10.0f, 20.0f, 0x3466},
 };
+#endif
 
 class ScopedOfflineI2cAllowance {
 public:
@@ -62,13 +67,23 @@ private:
 };
 
 static uint32_t _nowMs(const Config& cfg) {
+  if (cfg.nowMs64 != nullptr) {
+    return static_cast<uint32_t>(cfg.nowMs64(cfg.timeUser));
+  }
   return (cfg.nowMs != nullptr) ? cfg.nowMs(cfg.timeUser) : platform::nowMs();
 }
 
 static uint32_t _nowUs(const Config& cfg) {
+  if (cfg.nowUs64 != nullptr) {
+    return static_cast<uint32_t>(cfg.nowUs64(cfg.timeUser));
+  }
   return (cfg.nowUs != nullptr) ? cfg.nowUs(cfg.timeUser) : platform::nowUs();
 }
 
+static uint32_t largerU32(uint32_t a, uint32_t b) {
+  return (a > b) ? a : b;
+}
+
 static uint32_t saturatingAddU32(uint32_t a, uint32_t b) {
   const uint32_t maxU32 = std::numeric_limits<uint32_t>::max();
   if (a > (maxU32 - b)) {
@@ -82,6 +97,7 @@ static CachedSettings defaultCachedSettings() {
   return settings;
 }
 
+#if SHT3X_ENABLE_ALERTS
 static bool isCloseAlertDefault(float value, float expected) {
   return std::fabs(value - expected) <= ALERT_DEFAULT_MATCH_EPSILON;
 }
@@ -96,6 +112,7 @@ static bool alertAppNoteDefaultWord(float temperatureC, float humidityPct, uint1
   }
   return false;
 }
+#endif
 
 static bool isValidRepeatability(Repeatability rep) {
   return rep == Repeatability::LOW_REPEATABILITY || rep == Repeatability::MEDIUM_REPEATABILITY ||
@@ -124,12 +141,14 @@ static Status initialMeasurementStatus() {
   return Status::Error(Err::MEASUREMENT_NOT_READY, "Measurement not ready");
 }
 
+#if SHT3X_ENABLE_SYNC_API
 static Status mapPresenceProbeFailure(const Status& st) {
   if (st.code == Err::I2C_NACK_ADDR) {
     return Status::Error(Err::DEVICE_NOT_FOUND, "Device address not acknowledged", st.detail);
   }
   return st;
 }
+#endif
 
 static Status statusDiagnosticFailure(uint16_t raw) {
   if ((raw & cmd::STATUS_WRITE_CRC_ERROR) != 0U) {
@@ -184,6 +203,11 @@ Status SHT3x::bind(const Config& config) {
   if (_jobActive()) {
     return Status::Error(Err::BUSY, "Cancel active job before rebinding");
   }
+  if (_jobQueueCount != 0) {
+    // Rebinding would drop queued requests without their terminal results.
+    return Status::Error(Err::BUSY, "Drain or cancel queued jobs before rebinding",
+                         _jobQueueCount);
+  }
 
   // Copy before validation so bind(device.getConfig()) is alias-safe.
   const Config candidate = config;
@@ -222,7 +246,11 @@ Status SHT3x::bind(const Config& config) {
   if (candidate.singleShotMeasurementMarginMs > MAX_SINGLE_SHOT_MARGIN_MS) {
     return Status::Error(Err::INVALID_CONFIG, "Single-shot margin too large");
   }
-  if (candidate.nowMs == nullptr || candidate.nowUs == nullptr ||
+  if (candidate.jobQueueDepth > JOB_QUEUE_CAPACITY) {
+    return Status::Error(Err::INVALID_CONFIG, "Job queue depth too large");
+  }
+  if ((candidate.nowMs == nullptr && candidate.nowMs64 == nullptr) ||
+      (candidate.nowUs == nullptr && candidate.nowUs64 == nullptr) ||
       candidate.cooperativeYield == nullptr) {
     return Status::Error(Err::INVALID_CONFIG, "Timing callbacks not set");
   }
@@ -251,10 +279,38 @@ Status SHT3x::bind(const Config& config) {
   _jobType = JobType::NONE;
   _jobRequestId = 0;
   _nextJobId = 1;
-  _jobDeadlineMs = 0;
+  _jobDeadlineMs64 = 0;
+  _jobQueueHead = 0;
+  _jobQueueCount = 0;
   _jobHasDeadline = false;
   _jobEffect = JobEffect::NONE;
   _jobWakeMs = 0;
+  _jobContinuous = false;
+  _cadenceActive = false;
+  _cadencePeriodMs = 0;
+  _cadenceNextSlotMs = 0;
+  _cadenceNextSlot = 0;
+  _cadenceLastSlot = 0;
+  _cadenceSamples = 0;
+  _cadenceSkippedSlots = 0;
+  _cadencePendingErrorMs = 0;
+  _cadenceLastErrorMs = 0;
+  _cadenceMaxErrorMs = 0;
+  _burstActive = false;
+  _burstStats = BurstStats{};
+  _sampleSequence = 0;
+  _lostSamples = 0;
+  _sampleGapCount = 0;
+  _periodicSlotValid = false;
+  for (size_t i = 0; i < 3; ++i) {
+    _singleShotConversions[i] = 0;
+    _periodicConversions[i] = 0;
+  }
+  _periodicUptimeMs = 0;
+  _periodicRunRep = 0;
+  _heaterOnMs = 0;
+  _heaterOnSinceMs = 0;
+  _heaterOn = false;
   _lastMeasurementStatus = initialMeasurementStatus();
   _measurementReadyMs = 0;
   _periodicStartMs = 0;
@@ -262,6 +318,7 @@ Status SHT3x::bind(const Config& config) {
   _lastFetchValid = false;
   _periodMs = 0;
   _sampleTimestampMs = 0;
+  _sampleTimestampMs64 = 0;
   _missedSamples = 0;
   _notReadyStartMs = 0;
   _notReadyStartValid = false;
@@ -290,6 +347,10 @@ Status SHT3x::bind(const Config& config) {
   // Passive binding cannot claim or create a periodic/ART hardware state.
   _config.mode = Mode::SINGLE_SHOT;
   _mode = Mode::SINGLE_SHOT;
+  _bindMs = _nowMs(_config);
+  _timeAnchorMs = _bindMs;
+  _timeAnchorMs64 = _bindMs;
+  _syncTimebase();
   _initialized = true;
   _driverState = DriverState::READY;
   _syncCacheFromConfig();
@@ -297,6 +358,7 @@ Status SHT3x::bind(const Config& config) {
   return Status::Ok();
 }
 
+#if SHT3X_ENABLE_SYNC_API
 Status SHT3x::begin(const Config& config) {
   const Mode requestedMode = config.mode;
   Status st = bind(config);
@@ -350,6 +412,7 @@ Status SHT3x::begin(const Config& config) {
 
   return Status::Ok();
 }
+#endif
 
 void SHT3x::tick(uint32_t nowMs) {
   PollJobResult result;
@@ -357,6 +420,58 @@ void SHT3x::tick(uint32_t nowMs) {
 }
 
 Status SHT3x::pollJob(uint32_t nowMs, uint8_t maxInstructions, PollJobResult& result) {
+  if (_pollIdleHit(nowMs, maxInstructions)) {
+    result = _pollIdleResult;
+    return result.status;
+  }
+  _pollClockActive = true;
+  const Status st = _pollJobStep(nowMs, maxInstructions, result);
+  _pollClockActive = false;
+  _invalidatePollClock();
+  return st;
+}
+
+Status SHT3x::pollJob(uint32_t nowMs, uint32_t nowUs, uint8_t maxInstructions,
+                      PollJobResult& result) {
+  if (_pollIdleHit(nowMs, maxInstructions)) {
+    result = _pollIdleResult;
+    return result.status;
+  }
+  _pollClockActive = true;
+  _pollClockMs = nowMs;
+  _pollClockUs = nowUs;
+  _pollClockMsValid = true;
+  _pollClockUsValid = true;
+  const Status st = _pollJobStep(nowMs, maxInstructions, result);
+  _pollClockActive = false;
+  _invalidatePollClock();
+  return st;
+}
+
+bool SHT3x::_pollIdleHit(uint32_t nowMs, uint8_t maxInstructions) const {
+  // Replaying is exact only while nothing the slow path checks first can
+  // differ: a zero budget reports exhaustion and OFFLINE may latch the job.
+  return _pollIdleValid && maxInstructions != 0 && !_timeElapsed(nowMs, _pollIdleUntilMs) &&
+         _driverState != DriverState::OFFLINE;
+}
+
+const SHT3x::PollPhaseHandler SHT3x::POLL_PHASE_HANDLERS[] = {
+    &SHT3x::_pollInvalidPhase,          // IDLE
+    &SHT3x::_pollSingleShotCommand,     // SINGLE_SHOT_COMMAND
+    &SHT3x::_pollSingleShotConversion,  // SINGLE_SHOT_CONVERSION
+    &SHT3x::_pollSingleShotRead,        // SINGLE_SHOT_READ
+    &SHT3x::_pollPeriodicFetchCommand,  // PERIODIC_FETCH_COMMAND
+    &SHT3x::_pollPeriodicRead,          // PERIODIC_READ
+    &SHT3x::_pollEnsureBreakCommand,    // ENSURE_BREAK_COMMAND
+    &SHT3x::_pollEnsureBreakWait,       // ENSURE_BREAK_WAIT
+    &SHT3x::_pollEnsureResetCommand,    // ENSURE_RESET_COMMAND
+    &SHT3x::_pollEnsureResetWait,       // ENSURE_RESET_WAIT
+    &SHT3x::_pollEnsureStatusCommand,   // ENSURE_STATUS_COMMAND
+    &SHT3x::_pollEnsureStatusRead,      // ENSURE_STATUS_READ
+};
+
+Status SHT3x::_pollJobStep(uint32_t nowMs, uint8_t maxInstructions, PollJobResult& result) {
+  _pollIdleValid = false;
   result = PollJobResult{};
 
   if (!_initialized) {
@@ -364,8 +479,14 @@ Status SHT3x::pollJob(uint32_t nowMs, uint8_t maxInstructions, PollJobResult& re
     return result.status;
   }
   if (!_jobActive()) {
-    result.status = _measurementReady ? Status::Ok() : measurementStatus();
-    return result.status;
+    if (_jobQueueCount == 0) {
+      result.status = _measurementReady ? Status::Ok() : measurementStatus();
+      return result.status;
+    }
+    const Status started = _dispatchQueuedJob(result);
+    if (!started.inProgress()) {
+      return started;
+    }
   }
 
   result.active = true;
@@ -375,320 +496,504 @@ Status SHT3x::pollJob(uint32_t nowMs, uint8_t maxInstructions, PollJobResult& re
   result.outcome = JobOutcome::ACTIVE;
   result.effect = _jobEffect;
 
-  auto recordDeadline = [this, &result](bool measurementReadResolved = false) -> Status {
-    const uint8_t instructionsUsed = result.instructionsUsed;
-    const bool hardwareStateWasValid = _hardwareStateValid;
-    Status st = cancelJob(CancelReason::DEADLINE_EXPIRED, result);
-    result.instructionsUsed = instructionsUsed;
-    if (measurementReadResolved) {
-      result.effect = JobEffect::NONE;
-      _hardwareStateValid = hardwareStateWasValid;
-    }
-    return st;
-  };
-
-  if (_jobHasDeadline && _timeElapsed(nowMs, _jobDeadlineMs)) {
-    return recordDeadline();
-  }
-
-  auto recordFailure = [this, &result](Status st) -> Status {
-    const JobType type = _jobType;
-    const JobPhase phase = _measurementPhase;
-    const bool timedOut = st.code == Err::TIMEOUT || st.code == Err::I2C_TIMEOUT;
-    const bool ambiguous = timedOut || st.code == Err::I2C_ERROR || st.code == Err::I2C_BUS;
-    const bool consumedInvalidMeasurement =
-        type == JobType::MEASUREMENT && st.code == Err::CRC_MISMATCH &&
-        (phase == JobPhase::SINGLE_SHOT_READ || phase == JobPhase::PERIODIC_READ);
-    const JobEffect effect = consumedInvalidMeasurement
-                                 ? JobEffect::NONE
-                                 : _effectForPhase(phase, ambiguous);
-
-    if (type == JobType::MEASUREMENT) {
-      _lastMeasurementStatus = isTransportError(st.code) ? stableStatus(st) : st;
-      _measurementReady = false;
-      _measurementRequested = false;
-    }
+  // Extend on every slow step so the 64-bit timebase keeps its anchor while
+  // jobs run; replayed waits end before the anchor can go stale.
+  const uint64_t nowMs64 = _extendMs(nowMs);
+  if (_jobHasDeadline && _timeElapsed64(nowMs64, _jobDeadlineMs64)) {
+    return _jobDeadlineExpired(result, false);
+  }
 
-    result.status = st;
-    result.active = false;
-    result.terminal = true;
-    result.requestId = _jobRequestId;
-    result.type = type;
-    result.phase = phase;
-    result.outcome = timedOut ? JobOutcome::TIMED_OUT : JobOutcome::FAILED;
-    result.effect = effect;
-    if (!consumedInvalidMeasurement) {
-      _hardwareStateValid = false;
-    }
-    _clearJobState();
-    return st;
-  };
+  if (_jobType == JobType::MEASUREMENT &&
+      _config.healthPolicy == HealthPolicy::LATCH_OFFLINE &&
+      _driverState == DriverState::OFFLINE) {
+    return _jobFailed(result, _offlineStatus());
+  }
+  if (maxInstructions == 0) {
+    return _jobProgress(result, "Poll budget exhausted");
+  }
+
+  constexpr size_t handlerCount = sizeof(POLL_PHASE_HANDLERS) / sizeof(POLL_PHASE_HANDLERS[0]);
+  static_assert(handlerCount == static_cast<size_t>(JobPhase::ENSURE_STATUS_READ) + 1U,
+                "one poll handler per JobPhase");
+  const uint8_t phase = static_cast<uint8_t>(_measurementPhase);
+  if (phase >= handlerCount) {
+    return _pollInvalidPhase(nowMs, maxInstructions, result);
+  }
+  return (this->*POLL_PHASE_HANDLERS[phase])(nowMs, maxInstructions, result);
+}
+
+Status SHT3x::_jobProgress(PollJobResult& result, const char* message) {
+  const Status st = Status::Error(Err::IN_PROGRESS, message);
+  if (_jobType == JobType::MEASUREMENT) {
+    _lastMeasurementStatus = st;
+  }
+  result.status = st;
+  result.active = true;
+  result.outcome = JobOutcome::ACTIVE;
+  result.effect = _jobEffect;
+  return st;
+}
 
-  auto recordProgress = [this, &result](const char* message) -> Status {
-    const Status st = Status::Error(Err::IN_PROGRESS, message);
-    if (_jobType == JobType::MEASUREMENT) {
-      _lastMeasurementStatus = st;
+Status SHT3x::_jobWaiting(uint32_t nowMs, uint32_t wakeMs, PollJobResult& result,
+                          const char* message) {
+  const Status st = _jobProgress(result, message);
+  // Until wakeMs (or the deadline, if sooner) nothing but time can move this
+  // job, so later polls replay this result without re-entering the phase.
+  uint32_t untilMs = wakeMs;
+  if (_jobHasDeadline) {
+    const uint64_t remainingMs = _jobDeadlineMs64 - _extendMs(nowMs);
+    if (remainingMs < static_cast<uint64_t>(wakeMs - nowMs)) {
+      untilMs = nowMs + static_cast<uint32_t>(remainingMs);
     }
-    result.status = st;
-    result.active = true;
-    result.outcome = JobOutcome::ACTIVE;
-    result.effect = _jobEffect;
-    return st;
-  };
-
-  auto recordSample = [this, &result](const RawSample& sample,
-                                      uint32_t completedMs) -> Status {
-    const uint32_t requestId = _jobRequestId;
-    const JobPhase phase = _measurementPhase;
-    _rawSample = sample;
-    _compSample.tempC_x100 = convertTemperatureC_x100(_rawSample.rawTemperature);
-    _compSample.humidityPct_x100 = convertHumidityPct_x100(_rawSample.rawHumidity);
-    _milliSample.temperatureMilliCelsius =
-        convertTemperatureMilliCelsius(_rawSample.rawTemperature);
-    _milliSample.humidityMilliPercent =
-        convertHumidityMilliPercent(_rawSample.rawHumidity);
-    _sampleTimestampMs = completedMs;
-    _measurementReady = true;
-    _hasSample = true;
+  }
+  _pollIdleResult = result;
+  _pollIdleUntilMs = untilMs;
+  _pollIdleValid = true;
+  return st;
+}
+
+Status SHT3x::_jobFailed(PollJobResult& result, Status st) {
+  const JobType type = _jobType;
+  const JobPhase phase = _measurementPhase;
+  const bool timedOut = st.code == Err::TIMEOUT || st.code == Err::I2C_TIMEOUT;
+  const bool ambiguous = timedOut || st.code == Err::I2C_ERROR || st.code == Err::I2C_BUS;
+  const bool consumedInvalidMeasurement =
+      type == JobType::MEASUREMENT && st.code == Err::CRC_MISMATCH &&
+      (phase == JobPhase::SINGLE_SHOT_READ || phase == JobPhase::PERIODIC_READ);
+  const JobEffect effect = consumedInvalidMeasurement
+                               ? JobEffect::NONE
+                               : _effectForPhase(phase, ambiguous);
+
+  if (type == JobType::MEASUREMENT) {
+    _lastMeasurementStatus = isTransportError(st.code) ? stableStatus(st) : st;
+    _measurementReady = false;
     _measurementRequested = false;
-    _lastMeasurementStatus = Status::Ok();
+  }
+
+  result.status = st;
+  result.active = false;
+  result.terminal = true;
+  result.requestId = _jobRequestId;
+  result.type = type;
+  result.phase = phase;
+  result.outcome = timedOut ? JobOutcome::TIMED_OUT : JobOutcome::FAILED;
+  result.effect = effect;
+  if (!consumedInvalidMeasurement) {
+    _hardwareStateValid = false;
+  }
+  _clearJobState();
+  return st;
+}
 
+Status SHT3x::_jobDeadlineExpired(PollJobResult& result, bool measurementReadResolved) {
+  const uint8_t instructionsUsed = result.instructionsUsed;
+  const bool hardwareStateWasValid = _hardwareStateValid;
+  Status st = cancelJob(CancelReason::DEADLINE_EXPIRED, result);
+  result.instructionsUsed = instructionsUsed;
+  if (measurementReadResolved) {
+    result.effect = JobEffect::NONE;
+    _hardwareStateValid = hardwareStateWasValid;
+  }
+  return st;
+}
+
+Status SHT3x::_jobSampled(PollJobResult& result, const RawSample& sample,
+                          uint32_t completedMs, uint32_t sequenceAdvance) {
+  const uint32_t requestId = _jobRequestId;
+  const JobPhase phase = _measurementPhase;
+  if (_cadenceActive) {
+    // Skipped cadence slots are sequence gaps, like overwritten periodic slots.
+    const uint32_t slot = _cadenceNextSlot - 1U;
+    sequenceAdvance = (_cadenceSamples == 0) ? slot + 1U : slot - _cadenceLastSlot;
+  }
+  _recordSampleSequence(sequenceAdvance);
+  _rawSample = sample;
+  _compSample.tempC_x100 = convertTemperatureC_x100(_rawSample.rawTemperature);
+  _compSample.humidityPct_x100 = convertHumidityPct_x100(_rawSample.rawHumidity);
+  _milliSample.temperatureMilliCelsius =
+      convertTemperatureMilliCelsius(_rawSample.rawTemperature);
+  _milliSample.humidityMilliPercent =
+      convertHumidityMilliPercent(_rawSample.rawHumidity);
+  _sampleTimestampMs = completedMs;
+  _sampleTimestampMs64 = _extendMs(completedMs);
+  _measurementReady = true;
+  _hasSample = true;
+  _measurementRequested = false;
+  _lastMeasurementStatus = Status::Ok();
+
+  if (_jobContinuous) {
+    // Continuous jobs re-arm for the next sample instead of terminating.
+    if (_cadenceActive) {
+      _cadenceSamples = saturatingAddU32(_cadenceSamples, 1);
+      _cadenceLastSlot = _cadenceNextSlot - 1U;
+      _cadenceLastErrorMs = _cadencePendingErrorMs;
+      if (_cadencePendingErrorMs > _cadenceMaxErrorMs) {
+        _cadenceMaxErrorMs = _cadencePendingErrorMs;
+      }
+      _measurementPhase = JobPhase::SINGLE_SHOT_COMMAND;
+    } else {
+      _measurementPhase = JobPhase::PERIODIC_FETCH_COMMAND;
+      _measurementReadyMs = _periodicReadyMs(completedMs);
+    }
+    _measurementRequested = true;
+    _jobEffect = JobEffect::NONE;
     result.completed = true;
-    result.active = false;
-    result.terminal = true;
+    result.active = true;
     result.requestId = requestId;
     result.type = JobType::MEASUREMENT;
     result.phase = phase;
-    result.outcome = JobOutcome::SUCCEEDED;
+    result.outcome = JobOutcome::ACTIVE;
     result.effect = JobEffect::NONE;
     result.status = Status::Ok();
-    _clearJobState();
     return result.status;
-  };
-
-  auto recordEnsureSuccess = [this, &result]() -> Status {
-    const uint32_t requestId = _jobRequestId;
-    const JobPhase phase = _measurementPhase;
-    _setSafeBaseline();
-    _hardwareStateValid = true;
-    result.status = Status::Ok();
-    result.active = false;
-    result.terminal = true;
-    result.requestId = requestId;
-    result.type = JobType::ENSURE_IDLE;
-    result.phase = phase;
-    result.outcome = JobOutcome::SUCCEEDED;
-    result.effect = JobEffect::DEVICE_STATE_CHANGED;
-    _clearJobState();
-    return result.status;
-  };
-
-  if (_jobType == JobType::MEASUREMENT &&
-      _config.healthPolicy == HealthPolicy::LATCH_OFFLINE &&
-      _driverState == DriverState::OFFLINE) {
-    return recordFailure(_offlineStatus());
-  }
-  if (maxInstructions == 0) {
-    return recordProgress("Poll budget exhausted");
   }
 
-  auto commandDelayOpen = [this]() -> bool {
-    if (!_lastCommandValid) {
-      return true;
-    }
-    const uint32_t delayUs = static_cast<uint32_t>(_config.commandDelayMs) * 1000U;
-    return _durationElapsed(_nowUs(_config), _lastCommandUs, delayUs);
-  };
+  result.completed = true;
+  result.active = false;
+  result.terminal = true;
+  result.requestId = requestId;
+  result.type = JobType::MEASUREMENT;
+  result.phase = phase;
+  result.outcome = JobOutcome::SUCCEEDED;
+  result.effect = JobEffect::NONE;
+  result.status = Status::Ok();
+  _clearJobState();
+  return result.status;
+}
 
-  switch (_measurementPhase) {
-    case JobPhase::ENSURE_BREAK_COMMAND: {
-      if (!commandDelayOpen()) {
-        return recordProgress("Command delay pending");
-      }
-      Status st = _writeCommandNoDelay(cmd::CMD_BREAK, true, false);
-      result.instructionsUsed = 1;
-      if (!st.ok()) {
-        return recordFailure(st);
-      }
-      _periodicActive = false;
-      _mode = Mode::SINGLE_SHOT;
-      _config.mode = Mode::SINGLE_SHOT;
-      _jobEffect = JobEffect::DEVICE_STATE_CHANGED;
-      _jobWakeMs = _nowMs(_config) + BREAK_DELAY_MS;
-      _measurementPhase = JobPhase::ENSURE_BREAK_WAIT;
-      if (_jobHasDeadline && _timeElapsed(_nowMs(_config), _jobDeadlineMs)) {
-        return recordDeadline();
-      }
-      return recordProgress("Break settle pending");
-    }
+Status SHT3x::_jobEnsureSucceeded(PollJobResult& result) {
+  const uint32_t requestId = _jobRequestId;
+  const JobPhase phase = _measurementPhase;
+  _setSafeBaseline();
+  _hardwareStateValid = true;
+  result.status = Status::Ok();
+  result.active = false;
+  result.terminal = true;
+  result.requestId = requestId;
+  result.type = JobType::ENSURE_IDLE;
+  result.phase = phase;
+  result.outcome = JobOutcome::SUCCEEDED;
+  result.effect = JobEffect::DEVICE_STATE_CHANGED;
+  _clearJobState();
+  return result.status;
+}
 
-    case JobPhase::ENSURE_BREAK_WAIT:
-      if (!_timeElapsed(nowMs, _jobWakeMs)) {
-        return recordProgress("Break settle pending");
-      }
-      _measurementPhase = JobPhase::ENSURE_RESET_COMMAND;
-      return recordProgress("Soft reset pending");
+bool SHT3x::_jobDeadlinePassed(uint32_t nowMs) {
+  return _jobHasDeadline && _timeElapsed64(_extendMs(nowMs), _jobDeadlineMs64);
+}
 
-    case JobPhase::ENSURE_RESET_COMMAND: {
-      if (!commandDelayOpen()) {
-        return recordProgress("Command delay pending");
-      }
-      Status st = _writeCommandNoDelay(cmd::CMD_SOFT_RESET, true, false);
-      result.instructionsUsed = 1;
-      if (!st.ok()) {
-        return recordFailure(st);
-      }
-      _measurementRequested = false;
-      _measurementReady = false;
-      _hasSample = false;
-      _lastMeasurementStatus = initialMeasurementStatus();
-      _jobEffect = JobEffect::DEVICE_STATE_CHANGED;
-      _jobWakeMs = _nowMs(_config) + RESET_DELAY_MS;
-      _measurementPhase = JobPhase::ENSURE_RESET_WAIT;
-      if (_jobHasDeadline && _timeElapsed(_nowMs(_config), _jobDeadlineMs)) {
-        return recordDeadline();
-      }
-      return recordProgress("Reset settle pending");
-    }
+bool SHT3x::_commandDelayOpen() {
+  if (!_lastCommandValid) {
+    return true;
+  }
+  const uint32_t delayUs = static_cast<uint32_t>(_config.commandDelayMs) * 1000U;
+  return _durationElapsed(_clockUs(), _lastCommandUs, delayUs);
+}
 
-    case JobPhase::ENSURE_RESET_WAIT:
-      if (!_timeElapsed(nowMs, _jobWakeMs)) {
-        return recordProgress("Reset settle pending");
-      }
-      _measurementPhase = JobPhase::ENSURE_STATUS_COMMAND;
-      return recordProgress("Status verification pending");
+Status SHT3x::_pollInvalidPhase(uint32_t nowMs, uint8_t maxInstructions,
+                                PollJobResult& result) {
+  (void)nowMs;
+  (void)maxInstructions;
+  return _jobFailed(result, Status::Error(Err::INVALID_PARAM, "Invalid poll job phase"));
+}
 
-    case JobPhase::ENSURE_STATUS_COMMAND: {
-      if (!commandDelayOpen()) {
-        return recordProgress("Command delay pending");
-      }
-      Status st = _writeCommandNoDelay(cmd::CMD_READ_STATUS, true, false);
-      result.instructionsUsed = 1;
-      if (!st.ok()) {
-        return recordFailure(st);
-      }
-      _measurementPhase = JobPhase::ENSURE_STATUS_READ;
-      if (_jobHasDeadline && _timeElapsed(_nowMs(_config), _jobDeadlineMs)) {
-        return recordDeadline();
-      }
-      return recordProgress("Status read pending");
-    }
+Status SHT3x::_pollEnsureBreakCommand(uint32_t nowMs, uint8_t maxInstructions,
+                                      PollJobResult& result) {
+  (void)nowMs;
+  (void)maxInstructions;
+  if (!_commandDelayOpen()) {
+    return _jobProgress(result, "Command delay pending");
+  }
+  Status st = _writeCommandNoDelay(cmd::CMD_BREAK, true, false);
+  result.instructionsUsed = 1;
+  if (!st.ok()) {
+    return _jobFailed(result, st);
+  }
+  _closePeriodicRun(_clockMs());
+  _periodicActive = false;
+  _mode = Mode::SINGLE_SHOT;
+  _config.mode = Mode::SINGLE_SHOT;
+  _jobEffect = JobEffect::DEVICE_STATE_CHANGED;
+  _jobWakeMs = _clockMs() + BREAK_DELAY_MS;
+  _measurementPhase = JobPhase::ENSURE_BREAK_WAIT;
+  if (_jobDeadlinePassed(_clockMs())) {
+    return _jobDeadlineExpired(result, false);
+  }
+  return _jobProgress(result, "Break settle pending");
+}
 
-    case JobPhase::ENSURE_STATUS_READ: {
-      if (!commandDelayOpen()) {
-        return recordProgress("Command delay pending");
-      }
-      uint8_t buf[cmd::STATUS_DATA_LEN] = {};
-      Status st = _readOnly(buf, sizeof(buf), true, false, true);
-      result.instructionsUsed = 1;
-      if (!st.ok()) {
-        return recordFailure(st);
-      }
-      if (_crc8(buf, 2) != buf[2]) {
-        _recordProtocolFailure();
-        return recordFailure(Status::Error(Err::CRC_MISMATCH,
-                                           "CRC mismatch (status)"));
-      }
-      const uint16_t statusRaw =
-          static_cast<uint16_t>((static_cast<uint16_t>(buf[0]) << 8) | buf[1]);
-      st = statusDiagnosticFailure(statusRaw);
-      if (!st.ok()) {
-        _recordProtocolFailure();
-        return recordFailure(st);
-      }
-      if (_jobHasDeadline && _timeElapsed(_nowMs(_config), _jobDeadlineMs)) {
-        return recordDeadline();
-      }
-      return recordEnsureSuccess();
-    }
+Status SHT3x::_pollEnsureBreakWait(uint32_t nowMs, uint8_t maxInstructions,
+                                   PollJobResult& result) {
+  (void)maxInstructions;
+  if (!_timeElapsed(nowMs, _jobWakeMs)) {
+    return _jobWaiting(nowMs, _jobWakeMs, result, "Break settle pending");
+  }
+  _measurementPhase = JobPhase::ENSURE_RESET_COMMAND;
+  return _jobProgress(result, "Soft reset pending");
+}
 
-    case JobPhase::SINGLE_SHOT_COMMAND: {
-      if (!commandDelayOpen()) {
-        return recordProgress("Command delay pending");
-      }
-      if (_periodicActive) {
-        return recordFailure(Status::Error(Err::BUSY, "Periodic mode active"));
-      }
-      const uint16_t command = _commandForSingleShot(_config.repeatability,
-                                                     _config.clockStretching);
-      if (command == 0) {
-        return recordFailure(Status::Error(Err::INVALID_PARAM,
-                                           "Invalid single-shot configuration"));
-      }
-      Status st = _writeCommandNoDelay(command, true, false);
-      result.instructionsUsed = 1;
-      if (!st.ok()) {
-        return recordFailure(st);
-      }
-      _jobEffect = JobEffect::RESULT_MAY_BE_PENDING;
-      _measurementPhase = JobPhase::SINGLE_SHOT_CONVERSION;
-      _measurementReadyMs = _nowMs(_config) + estimateMeasurementTimeMs();
-      if (_jobHasDeadline && _timeElapsed(_nowMs(_config), _jobDeadlineMs)) {
-        return recordDeadline();
-      }
-      return recordProgress("Conversion pending");
-    }
+Status SHT3x::_pollEnsureResetCommand(uint32_t nowMs, uint8_t maxInstructions,
+                                      PollJobResult& result) {
+  (void)nowMs;
+  (void)maxInstructions;
+  if (!_commandDelayOpen()) {
+    return _jobProgress(result, "Command delay pending");
+  }
+  Status st = _writeCommandNoDelay(cmd::CMD_SOFT_RESET, true, false);
+  result.instructionsUsed = 1;
+  if (!st.ok()) {
+    return _jobFailed(result, st);
+  }
+  _noteHeaterState(false, _clockMs());
+  _measurementRequested = false;
+  _measurementReady = false;
+  _hasSample = false;
+  _lastMeasurementStatus = initialMeasurementStatus();
+  _jobEffect = JobEffect::DEVICE_STATE_CHANGED;
+  _jobWakeMs = _clockMs() + RESET_DELAY_MS;
+  _measurementPhase = JobPhase::ENSURE_RESET_WAIT;
+  if (_jobDeadlinePassed(_clockMs())) {
+    return _jobDeadlineExpired(result, false);
+  }
+  return _jobProgress(result, "Reset settle pending");
+}
 
-    case JobPhase::SINGLE_SHOT_CONVERSION:
-      if (!_timeElapsed(nowMs, _measurementReadyMs)) {
-        return recordProgress("Conversion pending");
-      }
-      _measurementPhase = JobPhase::SINGLE_SHOT_READ;
-      break;
+Status SHT3x::_pollEnsureResetWait(uint32_t nowMs, uint8_t maxInstructions,
+                                   PollJobResult& result) {
+  (void)maxInstructions;
+  if (!_timeElapsed(nowMs, _jobWakeMs)) {
+    return _jobWaiting(nowMs, _jobWakeMs, result, "Reset settle pending");
+  }
+  _measurementPhase = JobPhase::ENSURE_STATUS_COMMAND;
+  return _jobProgress(result, "Status verification pending");
+}
 
-    case JobPhase::PERIODIC_FETCH_COMMAND:
-      if (!_periodicActive) {
-        return recordFailure(Status::Error(Err::INVALID_PARAM,
-                                           "Periodic mode not active"));
-      }
-      if (!_timeElapsed(nowMs, _measurementReadyMs)) {
-        return recordProgress("Periodic fetch pending");
-      }
-      if (!commandDelayOpen()) {
-        return recordProgress("Command delay pending");
-      }
-      {
-        Status st = _writeCommandNoDelay(cmd::CMD_FETCH_DATA, true, false);
-        result.instructionsUsed = 1;
-        if (!st.ok()) {
-          return recordFailure(st);
-        }
-      }
-      _measurementPhase = JobPhase::PERIODIC_READ;
-      if (_jobHasDeadline && _timeElapsed(_nowMs(_config), _jobDeadlineMs)) {
-        return recordDeadline();
-      }
-      return recordProgress("Periodic read pending");
+Status SHT3x::_pollEnsureStatusCommand(uint32_t nowMs, uint8_t maxInstructions,
+                                       PollJobResult& result) {
+  (void)nowMs;
+  (void)maxInstructions;
+  if (!_commandDelayOpen()) {
+    return _jobProgress(result, "Command delay pending");
+  }
+  Status st = _writeCommandNoDelay(cmd::CMD_READ_STATUS, true, false);
+  result.instructionsUsed = 1;
+  if (!st.ok()) {
+    return _jobFailed(result, st);
+  }
+  _measurementPhase = JobPhase::ENSURE_STATUS_READ;
+  if (_jobDeadlinePassed(_clockMs())) {
+    return _jobDeadlineExpired(result, false);
+  }
+  return _jobProgress(result, "Status read pending");
+}
 
-    case JobPhase::SINGLE_SHOT_READ:
-    case JobPhase::PERIODIC_READ:
-      break;
+Status SHT3x::_pollEnsureStatusRead(uint32_t nowMs, uint8_t maxInstructions,
+                                    PollJobResult& result) {
+  (void)nowMs;
+  (void)maxInstructions;
+  if (!_commandDelayOpen()) {
+    return _jobProgress(result, "Command delay pending");
+  }
+  uint8_t buf[cmd::STATUS_DATA_LEN] = {};
+  Status st = _readOnly(buf, sizeof(buf), true, false, true);
+  result.instructionsUsed = 1;
+  if (!st.ok()) {
+    return _jobFailed(result, st);
+  }
+  if (_crc8(buf, 2) != buf[2]) {
+    _recordProtocolFailure();
+    return _jobFailed(result, Status::Error(Err::CRC_MISMATCH, "CRC mismatch (status)"));
+  }
+  const uint16_t statusRaw =
+      static_cast<uint16_t>((static_cast<uint16_t>(buf[0]) << 8) | buf[1]);
+  st = statusDiagnosticFailure(statusRaw);
+  if (!st.ok()) {
+    _recordProtocolFailure();
+    return _jobFailed(result, st);
+  }
+  if (_jobDeadlinePassed(_clockMs())) {
+    return _jobDeadlineExpired(result, false);
+  }
+  return _jobEnsureSucceeded(result);
+}
 
-    case JobPhase::IDLE:
-    default:
-      return recordFailure(Status::Error(Err::INVALID_PARAM,
-                                         "Invalid poll job phase"));
+Status SHT3x::_pollSingleShotCommand(uint32_t nowMs, uint8_t maxInstructions,
+                                     PollJobResult& result) {
+  (void)maxInstructions;
+  if (_cadenceActive) {
+    if (!_timeElapsed(nowMs, _cadenceNextSlotMs)) {
+      return _jobWaiting(nowMs, _cadenceNextSlotMs, result, "Cadence slot pending");
+    }
+    _skipOverdueCadenceSlots(nowMs);
+    if (!_timeElapsed(nowMs, _cadenceNextSlotMs)) {
+      return _jobWaiting(nowMs, _cadenceNextSlotMs, result, "Cadence slot pending");
+    }
+  }
+  if (!_commandDelayOpen()) {
+    return _jobProgress(result, "Command delay pending");
+  }
+  if (_periodicActive) {
+    return _jobFailed(result, Status::Error(Err::BUSY, "Periodic mode active"));
+  }
+  const uint16_t command = _commandForSingleShot(_config.repeatability,
+                                                 _config.clockStretching);
+  if (command == 0) {
+    return _jobFailed(result, Status::Error(Err::INVALID_PARAM,
+                                            "Invalid single-shot configuration"));
+  }
+  Status st = _writeCommandNoDelay(command, true, false);
+  result.instructionsUsed++;
+  if (!st.ok()) {
+    return _jobFailed(result, st);
+  }
+  _jobEffect = JobEffect::RESULT_MAY_BE_PENDING;
+  _measurementPhase = JobPhase::SINGLE_SHOT_CONVERSION;
+  {
+    uint32_t& conversions =
+        _singleShotConversions[static_cast<uint8_t>(_config.repeatability)];
+    conversions = saturatingAddU32(conversions, 1);
+  }
+  const uint32_t commandMs = _clockMs();
+  _measurementReadyMs = commandMs + estimateMeasurementTimeMs();
+  if (_cadenceActive) {
+    _cadencePendingErrorMs = _timeElapsed(commandMs, _cadenceNextSlotMs)
+                                 ? commandMs - _cadenceNextSlotMs
+                                 : 0;
+    _cadenceNextSlotMs += _cadencePeriodMs;
+    _cadenceNextSlot++;
+  }
+  if (_jobDeadlinePassed(_clockMs())) {
+    return _jobDeadlineExpired(result, false);
+  }
+  return _jobProgress(result, "Conversion pending");
+}
+
+Status SHT3x::_pollSingleShotConversion(uint32_t nowMs, uint8_t maxInstructions,
+                                        PollJobResult& result) {
+  if (!_timeElapsed(nowMs, _measurementReadyMs)) {
+    return _jobWaiting(nowMs, _measurementReadyMs, result, "Conversion pending");
   }
+  _measurementPhase = JobPhase::SINGLE_SHOT_READ;
+  return _pollSingleShotRead(nowMs, maxInstructions, result);
+}
 
+Status SHT3x::_pollSingleShotRead(uint32_t nowMs, uint8_t maxInstructions,
+                                  PollJobResult& result) {
   if (result.instructionsUsed >= maxInstructions) {
-    return recordProgress("Poll budget exhausted");
+    return _jobProgress(result, "Poll budget exhausted");
   }
-  if (!commandDelayOpen()) {
-    return recordProgress("Command delay pending");
+  if (!_commandDelayOpen()) {
+    return _jobProgress(result, "Command delay pending");
   }
+  RawSample sample;
+  Status st = _readMeasurementRawNoDelay(sample, true, false);
+  result.instructionsUsed++;
+  if (!st.ok()) {
+    return _jobFailed(result, st);
+  }
+  const uint32_t completedMs = _clockMs();
+  if (_jobDeadlinePassed(completedMs)) {
+    return _jobDeadlineExpired(result, true);
+  }
+  if (_burstActive) {
+    return _burstSampled(nowMs, maxInstructions, result, sample, completedMs);
+  }
+  return _jobSampled(result, sample, completedMs, 1U);
+}
 
-  if (_measurementPhase == JobPhase::SINGLE_SHOT_READ) {
-    RawSample sample;
-    Status st = _readMeasurementRawNoDelay(sample, true, false);
-    result.instructionsUsed++;
-    if (!st.ok()) {
-      return recordFailure(st);
+Status SHT3x::_burstSampled(uint32_t nowMs, uint8_t maxInstructions, PollJobResult& result,
+                            const RawSample& sample, uint32_t completedMs) {
+  const uint16_t words[2] = {sample.rawTemperature, sample.rawHumidity};
+  uint16_t* mins[2] = {&_burstMin.rawTemperature, &_burstMin.rawHumidity};
+  uint16_t* maxs[2] = {&_burstMax.rawTemperature, &_burstMax.rawHumidity};
+  for (size_t i = 0; i < 2; ++i) {
+    _burstSum[i] += words[i];
+    _burstSumSquares[i] += static_cast<uint64_t>(words[i]) * words[i];
+    if (_burstCount == 0 || words[i] < *mins[i]) {
+      *mins[i] = words[i];
     }
-    const uint32_t completedMs = _nowMs(_config);
-    if (_jobHasDeadline && _timeElapsed(completedMs, _jobDeadlineMs)) {
-      return recordDeadline(true);
+    if (_burstCount == 0 || words[i] > *maxs[i]) {
+      *maxs[i] = words[i];
     }
-    return recordSample(sample, completedMs);
+  }
+  _burstCount++;
+
+  if (_burstCount < _burstTarget) {
+    // tIDLE runs from the previous command and has long passed. The next
+    // command goes out on the following poll unless the caller opted into
+    // chaining and left budget for a second callback.
+    _jobEffect = JobEffect::NONE;
+    _measurementPhase = JobPhase::SINGLE_SHOT_COMMAND;
+    if (!_burstChain || result.instructionsUsed >= maxInstructions) {
+      return _jobProgress(result, "Burst command pending");
+    }
+    result.phase = _measurementPhase;
+    return _pollSingleShotCommand(nowMs, maxInstructions, result);
+  }
+
+  // Integer mean and spread. Variance is taken in raw codes scaled by 2^16
+  // so the square root keeps 1/256-code resolution before unit conversion.
+  const uint32_t n = _burstCount;
+  BurstStats stats;
+  stats.valid = true;
+  stats.count = _burstCount;
+  stats.min = _burstMin;
+  stats.max = _burstMax;
+  stats.mean.rawTemperature = static_cast<uint16_t>((_burstSum[0] + n / 2U) / n);
+  stats.mean.rawHumidity = static_cast<uint16_t>((_burstSum[1] + n / 2U) / n);
+  stats.spreadMilli.temperatureMilliCelsius =
+      convertTemperatureMilliCelsius(_burstMax.rawTemperature) -
+      convertTemperatureMilliCelsius(_burstMin.rawTemperature);
+  stats.spreadMilli.humidityMilliPercent =
+      convertHumidityMilliPercent(_burstMax.rawHumidity) -
+      convertHumidityMilliPercent(_burstMin.rawHumidity);
+  const uint32_t fullScale[2] = {175000U, 100000U};
+  int32_t stdDev[2] = {0, 0};
+  for (size_t i = 0; i < 2; ++i) {
+    const uint64_t sum = _burstSum[i];
+    const uint64_t scatter = n * _burstSumSquares[i] - sum * sum;
+    const uint64_t rootX256 = intmath::sqrtU64((scatter << 16) / (static_cast<uint64_t>(n) * n));
+    stdDev[i] = static_cast<int32_t>((rootX256 * fullScale[i] + 65535ULL * 128ULL) /
+                                     (65535ULL * 256ULL));
+  }
+  stats.stdDevMilli.temperatureMilliCelsius = stdDev[0];
+  stats.stdDevMilli.humidityMilliPercent = stdDev[1];
+  _burstStats = stats;
+  _burstActive = false;
+  return _jobSampled(result, stats.mean, completedMs, 1U);
+}
+
+Status SHT3x::_pollPeriodicFetchCommand(uint32_t nowMs, uint8_t maxInstructions,
+                                        PollJobResult& result) {
+  (void)maxInstructions;
+  if (!_periodicActive) {
+    return _jobFailed(result, Status::Error(Err::INVALID_PARAM, "Periodic mode not active"));
+  }
+  if (!_timeElapsed(nowMs, _measurementReadyMs)) {
+    return _jobWaiting(nowMs, _measurementReadyMs, result, "Periodic fetch pending");
+  }
+  if (!_commandDelayOpen()) {
+    return _jobProgress(result, "Command delay pending");
+  }
+  Status st = _writeCommandNoDelay(cmd::CMD_FETCH_DATA, true, false);
+  result.instructionsUsed = 1;
+  if (!st.ok()) {
+    return _jobFailed(result, st);
+  }
+  _measurementPhase = JobPhase::PERIODIC_READ;
+  if (_jobDeadlinePassed(_clockMs())) {
+    return _jobDeadlineExpired(result, false);
+  }
+  return _jobProgress(result, "Periodic read pending");
+}
+
+Status SHT3x::_pollPeriodicRead(uint32_t nowMs, uint8_t maxInstructions,
+                                PollJobResult& result) {
+  if (result.instructionsUsed >= maxInstructions) {
+    return _jobProgress(result, "Poll budget exhausted");
+  }
+  if (!_commandDelayOpen()) {
+    return _jobProgress(result, "Command delay pending");
   }
 
   bool allowNoData = hasCapability(_config.transportCapabilities,
@@ -703,7 +1008,7 @@ Status SHT3x::pollJob(uint32_t nowMs, uint8_t maxInstructions, PollJobResult& re
   RawSample sample;
   Status st = _readMeasurementRawNoDelay(sample, true, allowNoData);
   result.instructionsUsed++;
-  const uint32_t readCompletedMs = _nowMs(_config);
+  const uint32_t readCompletedMs = _clockMs();
   if (!st.ok()) {
     if (st.code == Err::MEASUREMENT_NOT_READY) {
       if (!_notReadyStartValid) {
@@ -713,21 +1018,22 @@ Status SHT3x::pollJob(uint32_t nowMs, uint8_t maxInstructions, PollJobResult& re
       if (_notReadyCount < std::numeric_limits<uint32_t>::max()) {
         _notReadyCount++;
       }
-      if (_jobHasDeadline && _timeElapsed(readCompletedMs, _jobDeadlineMs)) {
-        return recordDeadline(true);
+      if (_jobDeadlinePassed(readCompletedMs)) {
+        return _jobDeadlineExpired(result, true);
       }
+      _notePeriodicNotReady(readCompletedMs);
       _measurementPhase = JobPhase::PERIODIC_FETCH_COMMAND;
       _measurementReadyMs = _periodicRetryMs(readCompletedMs);
-      return recordProgress("Periodic sample not ready");
+      return _jobProgress(result, "Periodic sample not ready");
     }
-    return recordFailure(st);
+    return _jobFailed(result, st);
   }
 
   _notReadyStartMs = 0;
   _notReadyStartValid = false;
   _notReadyCount = 0;
-  if (_jobHasDeadline && _timeElapsed(readCompletedMs, _jobDeadlineMs)) {
-    return recordDeadline(true);
+  if (_jobDeadlinePassed(readCompletedMs)) {
+    return _jobDeadlineExpired(result, true);
   }
 
   if (_lastFetchValid && _periodMs > 0) {
@@ -740,25 +1046,47 @@ Status SHT3x::pollJob(uint32_t nowMs, uint8_t maxInstructions, PollJobResult& re
       }
     }
   }
+  const uint32_t advance = _periodicSlotAdvance(readCompletedMs);
   _lastFetchMs = readCompletedMs;
   _lastFetchValid = true;
-  return recordSample(sample, readCompletedMs);
+  return _jobSampled(result, sample, readCompletedMs, advance);
 }
 
 void SHT3x::end() {
   _clearJobState();
+  _jobQueueHead = 0;
+  _jobQueueCount = 0;
+  _jobContinuous = false;
+  _cadenceActive = false;
+  _cadencePeriodMs = 0;
+  _cadenceNextSlotMs = 0;
+  _cadenceNextSlot = 0;
+  _cadenceLastSlot = 0;
+  _cadenceSamples = 0;
+  _cadenceSkippedSlots = 0;
+  _cadencePendingErrorMs = 0;
+  _cadenceLastErrorMs = 0;
+  _cadenceMaxErrorMs = 0;
+  _burstActive = false;
+  _burstStats = BurstStats{};
+  _sampleSequence = 0;
+  _lostSamples = 0;
+  _sampleGapCount = 0;
+  _periodicSlotValid = false;
   _measurementRequested = false;
   _measurementReady = false;
   _hasSample = false;
   _measurementPhase = JobPhase::IDLE;
   _lastMeasurementStatus = initialMeasurementStatus();
   _measurementReadyMs = 0;
+  _closePeriodicRun(_nowMs(_config));
   _periodicActive = false;
   _periodicStartMs = 0;
   _lastFetchMs = 0;
   _lastFetchValid = false;
   _periodMs = 0;
   _sampleTimestampMs = 0;
+  _sampleTimestampMs64 = 0;
   _missedSamples = 0;
   _notReadyStartMs = 0;
   _notReadyStartValid = false;
@@ -771,6 +1099,7 @@ void SHT3x::end() {
   _hardwareStateValid = false;
 }
 
+#if SHT3X_ENABLE_SYNC_API
 Status SHT3x::probe() {
   if (!_initialized) {
     return Status::Error(Err::NOT_INITIALIZED, "Driver not bound");
@@ -787,7 +1116,9 @@ Status SHT3x::probe() {
 
   return Status::Ok();
 }
+#endif
 
+#if SHT3X_ENABLE_RECOVERY
 Status SHT3x::recover() {
   if (!_initialized) {
     return Status::Error(Err::NOT_INITIALIZED, "Driver not bound");
@@ -847,6 +1178,7 @@ Status SHT3x::resetAndRestore() {
   _hardwareStateValid = true;
   return Status::Ok();
 }
+#endif
 
 Status SHT3x::requestMeasurement() {
   if (!_initialized) {
@@ -858,6 +1190,10 @@ Status SHT3x::requestMeasurement() {
 }
 
 Status SHT3x::requestMeasurement(const JobRequest& request) {
+  return requestMeasurement(_widenRequest(request));
+}
+
+Status SHT3x::requestMeasurement(const JobRequest64& request) {
   if (!_initialized) {
     return Status::Error(Err::NOT_INITIALIZED, "Driver not bound");
   }
@@ -869,10 +1205,17 @@ Status SHT3x::requestMeasurement(const JobRequest& request) {
     _lastMeasurementStatus = _offlineStatus();
     return _lastMeasurementStatus;
   }
-  if (_jobActive()) {
-    _lastMeasurementStatus = Status::Error(Err::BUSY, "Cooperative job in progress");
+  if (_jobSlotBusy()) {
+    _lastMeasurementStatus = _enqueueJob(JobType::MEASUREMENT, request, false);
     return _lastMeasurementStatus;
   }
+  if (_mode == Mode::SINGLE_SHOT || _periodicActive) {
+    const Status admitted = _admitDeadline(request, JobType::MEASUREMENT);
+    if (!admitted.ok()) {
+      _lastMeasurementStatus = admitted;
+      return _lastMeasurementStatus;
+    }
+  }
 
   _measurementReady = false;
 
@@ -890,7 +1233,7 @@ Status SHT3x::requestMeasurement(const JobRequest& request) {
     _measurementReadyMs = _nowMs(_config);
     _jobType = JobType::MEASUREMENT;
     _jobRequestId = request.requestId;
-    _jobDeadlineMs = request.deadlineMs;
+    _jobDeadlineMs64 = request.deadlineMs;
     _jobHasDeadline = request.hasDeadline;
     _jobEffect = JobEffect::NONE;
     _lastMeasurementStatus = Status::Error(Err::IN_PROGRESS, "Measurement scheduled");
@@ -912,7 +1255,7 @@ Status SHT3x::requestMeasurement(const JobRequest& request) {
     _measurementReadyMs = readyMs;
     _jobType = JobType::MEASUREMENT;
     _jobRequestId = request.requestId;
-    _jobDeadlineMs = request.deadlineMs;
+    _jobDeadlineMs64 = request.deadlineMs;
     _jobHasDeadline = request.hasDeadline;
     _jobEffect = JobEffect::NONE;
     _lastMeasurementStatus = Status::Error(Err::IN_PROGRESS, "Measurement scheduled");
@@ -924,27 +1267,249 @@ Status SHT3x::requestMeasurement(const JobRequest& request) {
   return _lastMeasurementStatus;
 }
 
+Status SHT3x::requestContinuous(const JobRequest& request) {
+  return requestContinuous(_widenRequest(request));
+}
+
+Status SHT3x::requestContinuous(const JobRequest64& request) {
+  if (!_initialized) {
+    return Status::Error(Err::NOT_INITIALIZED, "Driver not bound");
+  }
+  if (request.requestId == 0) {
+    return Status::Error(Err::INVALID_PARAM, "Job request ID must be nonzero");
+  }
+  if (_config.healthPolicy == HealthPolicy::LATCH_OFFLINE &&
+      _driverState == DriverState::OFFLINE) {
+    _lastMeasurementStatus = _offlineStatus();
+    return _lastMeasurementStatus;
+  }
+  if (_mode == Mode::SINGLE_SHOT || !_periodicActive) {
+    return Status::Error(Err::INVALID_PARAM, "Periodic mode not active");
+  }
+  if (_jobSlotBusy()) {
+    return _enqueueJob(JobType::MEASUREMENT, request, true);
+  }
+  Status st = requestMeasurement(request);
+  if (st.inProgress()) {
+    _jobContinuous = true;
+  }
+  return st;
+}
+
+Status SHT3x::requestCadence(const CadenceRequest& request) {
+  if (!_initialized) {
+    return Status::Error(Err::NOT_INITIALIZED, "Driver not bound");
+  }
+  if (request.requestId == 0) {
+    return Status::Error(Err::INVALID_PARAM, "Job request ID must be nonzero");
+  }
+  if (_config.healthPolicy == HealthPolicy::LATCH_OFFLINE &&
+      _driverState == DriverState::OFFLINE) {
+    _lastMeasurementStatus = _offlineStatus();
+    return _lastMeasurementStatus;
+  }
+  if (_jobSlotBusy()) {
+    _lastMeasurementStatus = Status::Error(Err::BUSY, "Cooperative job in progress");
+    return _lastMeasurementStatus;
+  }
+  if (_mode != Mode::SINGLE_SHOT) {
+    return Status::Error(Err::INVALID_PARAM, "Cadence requires single-shot mode");
+  }
+  if (_commandForSingleShot(_config.repeatability, _config.clockStretching) == 0) {
+    return Status::Error(Err::INVALID_PARAM, "Invalid single-shot configuration");
+  }
+  const uint32_t minPeriodMs = estimateMeasurementTimeMs() + _config.commandDelayMs;
+  if (request.periodMs < minPeriodMs || request.periodMs > MAX_CADENCE_PERIOD_MS) {
+    return Status::Error(Err::INVALID_PARAM, "Cadence period out of range",
+                         static_cast<int32_t>(minPeriodMs));
+  }
+
+  _measurementReady = false;
+  _measurementRequested = true;
+  _measurementPhase = JobPhase::SINGLE_SHOT_COMMAND;
+  _measurementReadyMs = _nowMs(_config);
+  _jobType = JobType::MEASUREMENT;
+  _jobRequestId = request.requestId;
+  _jobDeadlineMs64 = 0;
+  _jobHasDeadline = false;
+  _jobEffect = JobEffect::NONE;
+  _jobContinuous = true;
+  _cadenceActive = true;
+  _cadencePeriodMs = request.periodMs;
+  _cadenceNextSlotMs = request.firstSlotMs;
+  _cadenceNextSlot = 0;
+  _cadenceLastSlot = 0;
+  _cadenceSamples = 0;
+  _cadenceSkippedSlots = 0;
+  _cadencePendingErrorMs = 0;
+  _cadenceLastErrorMs = 0;
+  _cadenceMaxErrorMs = 0;
+  _lastMeasurementStatus = Status::Error(Err::IN_PROGRESS, "Cadence scheduled");
+  return _lastMeasurementStatus;
+}
+
+Status SHT3x::getCadenceStats(CadenceStats& out) const {
+  if (!_initialized) {
+    return Status::Error(Err::NOT_INITIALIZED, "Driver not bound");
+  }
+  out = CadenceStats{};
+  out.active = _cadenceActive;
+  out.periodMs = _cadencePeriodMs;
+  out.nextSlotMs = _cadenceNextSlotMs;
+  out.nextSlot = _cadenceNextSlot;
+  out.lastSlot = _cadenceLastSlot;
+  out.samples = _cadenceSamples;
+  out.skippedSlots = _cadenceSkippedSlots;
+  out.lastScheduleErrorMs = _cadenceLastErrorMs;
+  out.maxScheduleErrorMs = _cadenceMaxErrorMs;
+  return Status::Ok();
+}
+
+Status SHT3x::requestBurst(const BurstRequest& request) {
+  if (!_initialized) {
+    return Status::Error(Err::NOT_INITIALIZED, "Driver not bound");
+  }
+  if (request.requestId == 0) {
+    return Status::Error(Err::INVALID_PARAM, "Job request ID must be nonzero");
+  }
+  if (request.count < 2 || request.count > MAX_BURST_COUNT) {
+    return Status::Error(Err::INVALID_PARAM, "Burst count out of range",
+                         static_cast<int32_t>(MAX_BURST_COUNT));
+  }
+  if (_config.healthPolicy == HealthPolicy::LATCH_OFFLINE &&
+      _driverState == DriverState::OFFLINE) {
+    _lastMeasurementStatus = _offlineStatus();
+    return _lastMeasurementStatus;
+  }
+  if (_jobSlotBusy()) {
+    _lastMeasurementStatus = Status::Error(Err::BUSY, "Cooperative job in progress");
+    return _lastMeasurementStatus;
+  }
+  if (_mode != Mode::SINGLE_SHOT) {
+    return Status::Error(Err::INVALID_PARAM, "Burst requires single-shot mode");
+  }
+  if (_commandForSingleShot(_config.repeatability, _config.clockStretching) == 0) {
+    return Status::Error(Err::INVALID_PARAM, "Invalid single-shot configuration");
+  }
+  JobRequest narrow;
+  narrow.requestId = request.requestId;
+  narrow.deadlineMs = request.deadlineMs;
+  narrow.hasDeadline = request.hasDeadline;
+  const JobRequest64 wide = _widenRequest(narrow);
+  if (wide.hasDeadline && _config.rejectInfeasibleDeadlines) {
+    // First conversion as a measurement job, then command, conversion (which
+    // covers tIDLE), and read for each further one.
+    const uint32_t commandDelayUs = static_cast<uint32_t>(_config.commandDelayMs) * 1000U;
+    const uint32_t repeatUs = 2U * _config.transferBudgetUs +
+                              largerU32(estimateMeasurementTimeMs() * 1000U, commandDelayUs);
+    const Status admitted = _admitDeadline(
+        wide, minimumCompletionUs(JobType::MEASUREMENT) + (request.count - 1U) * repeatUs);
+    if (!admitted.ok()) {
+      _lastMeasurementStatus = admitted;
+      return _lastMeasurementStatus;
+    }
+  }
+
+  _measurementReady = false;
+  _measurementRequested = true;
+  _measurementPhase = JobPhase::SINGLE_SHOT_COMMAND;
+  _measurementReadyMs = _nowMs(_config);
+  _jobType = JobType::MEASUREMENT;
+  _jobRequestId = wide.requestId;
+  _jobDeadlineMs64 = wide.deadlineMs;
+  _jobHasDeadline = wide.hasDeadline;
+  _jobEffect = JobEffect::NONE;
+  _burstActive = true;
+  _burstChain = request.chainCommands;
+  _burstTarget = request.count;
+  _burstCount = 0;
+  _burstSum[0] = 0;
+  _burstSum[1] = 0;
+  _burstSumSquares[0] = 0;
+  _burstSumSquares[1] = 0;
+  _burstStats = BurstStats{};
+  _lastMeasurementStatus = Status::Error(Err::IN_PROGRESS, "Burst scheduled");
+  return _lastMeasurementStatus;
+}
+
+Status SHT3x::getBurstStats(BurstStats& out) const {
+  if (!_initialized) {
+    return Status::Error(Err::NOT_INITIALIZED, "Driver not bound");
+  }
+  out = _burstStats;
+  return Status::Ok();
+}
+
 Status SHT3x::requestEnsureIdle(const JobRequest& request) {
+  return requestEnsureIdle(_widenRequest(request));
+}
+
+Status SHT3x::requestEnsureIdle(const JobRequest64& request) {
   if (!_initialized) {
     return Status::Error(Err::NOT_INITIALIZED, "Driver not bound");
   }
   if (request.requestId == 0) {
     return Status::Error(Err::INVALID_PARAM, "Job request ID must be nonzero");
   }
-  if (_jobActive()) {
-    return Status::Error(Err::BUSY, "Cooperative job in progress");
+  if (_jobSlotBusy()) {
+    return _enqueueJob(JobType::ENSURE_IDLE, request, false);
+  }
+  const Status admitted = _admitDeadline(request, JobType::ENSURE_IDLE);
+  if (!admitted.ok()) {
+    return admitted;
   }
 
   _measurementPhase = JobPhase::ENSURE_BREAK_COMMAND;
   _jobType = JobType::ENSURE_IDLE;
   _jobRequestId = request.requestId;
-  _jobDeadlineMs = request.deadlineMs;
+  _jobDeadlineMs64 = request.deadlineMs;
   _jobHasDeadline = request.hasDeadline;
   _jobEffect = JobEffect::NONE;
   _jobWakeMs = 0;
   return Status::Error(Err::IN_PROGRESS, "Ensure-idle scheduled");
 }
 
+bool SHT3x::jobWakeMs(uint32_t nowMs, uint32_t& wakeMs) const {
+  if (!_initialized || !_jobActive() || _driverState == DriverState::OFFLINE) {
+    return false;
+  }
+  uint32_t dueMs = 0;
+  switch (_measurementPhase) {
+    case JobPhase::SINGLE_SHOT_COMMAND:
+      if (!_cadenceActive) {
+        return false;
+      }
+      dueMs = _cadenceNextSlotMs;
+      break;
+    case JobPhase::SINGLE_SHOT_CONVERSION:
+    case JobPhase::PERIODIC_FETCH_COMMAND:
+      dueMs = _measurementReadyMs;
+      break;
+    case JobPhase::ENSURE_BREAK_WAIT:
+    case JobPhase::ENSURE_RESET_WAIT:
+      dueMs = _jobWakeMs;
+      break;
+    default:
+      return false;
+  }
+  if (_timeElapsed(nowMs, dueMs)) {
+    return false;
+  }
+  if (_jobHasDeadline) {
+    // The poll at the deadline emits the TIMED_OUT result.
+    const uint64_t now64 = toTimeMs64(nowMs);
+    if (_timeElapsed64(now64, _jobDeadlineMs64)) {
+      return false;
+    }
+    const uint64_t remainingMs = _jobDeadlineMs64 - now64;
+    if (remainingMs < static_cast<uint64_t>(dueMs - nowMs)) {
+      dueMs = nowMs + static_cast<uint32_t>(remainingMs);
+    }
+  }
+  wakeMs = dueMs;
+  return true;
+}
+
 Status SHT3x::cancelJob(CancelReason reason, PollJobResult& result) {
   result = PollJobResult{};
   if (!_initialized) {
@@ -1134,7 +1699,7 @@ Status SHT3x::getSettings(SettingsSnapshot& out) const {
   out.i2cTimeoutMs = _config.i2cTimeoutMs;
   out.offlineThreshold = _config.offlineThreshold;
   out.healthPolicy = _config.healthPolicy;
-  out.hasNowMsHook = (_config.nowMs != nullptr);
+  out.hasNowMsHook = (_config.nowMs != nullptr || _config.nowMs64 != nullptr);
   out.mode = _mode;
   out.repeatability = _config.repeatability;
   out.periodicRate = _config.periodicRate;
@@ -1156,6 +1721,7 @@ Status SHT3x::getSettings(SettingsSnapshot& out) const {
   return Status::Ok();
 }
 
+#if SHT3X_ENABLE_SYNC_API
 Status SHT3x::readSettings(SettingsSnapshot& out) {
   Status st = getSettings(out);
   if (!st.ok()) {
@@ -1178,7 +1744,9 @@ Status SHT3x::readSettings(SettingsSnapshot& out) {
   }
   return stStatus;
 }
+#endif
 
+#if SHT3X_ENABLE_RAW_COMMANDS
 Status SHT3x::writeCommand(uint16_t command) {
   if (!_initialized) {
     return Status::Error(Err::NOT_INITIALIZED, "Driver not bound");
@@ -1227,6 +1795,7 @@ Status SHT3x::readCommand(uint16_t command, uint8_t* out, size_t len,
   _hardwareStateValid = false;
   return st;
 }
+#endif
 
 Status SHT3x::setRepeatability(Repeatability rep) {
   if (!_initialized) {
@@ -1400,6 +1969,7 @@ Status SHT3x::stopPeriodic() {
   return st;
 }
 
+#if SHT3X_ENABLE_SYNC_API
 Status SHT3x::readStatus(uint16_t& raw) {
   if (!_initialized) {
     return Status::Error(Err::NOT_INITIALIZED, "Driver not bound");
@@ -1520,6 +2090,7 @@ Status SHT3x::setHeater(bool enable) {
 
   Status st = _writeCommand(enable ? cmd::CMD_HEATER_ENABLE : cmd::CMD_HEATER_DISABLE, true);
   if (st.ok()) {
+    _noteHeaterState(enable, _nowMs(_config));
     _cachedSettings.heaterEnabled = enable;
     _hasCachedSettings = true;
   }
@@ -1535,7 +2106,9 @@ Status SHT3x::readHeaterStatus(bool& enabled) {
   enabled = stReg.heaterOn;
   return Status::Ok();
 }
+#endif
 
+#if SHT3X_ENABLE_RECOVERY
 Status SHT3x::softReset() {
   if (!_initialized) {
     return Status::Error(Err::NOT_INITIALIZED, "Driver not bound");
@@ -1554,6 +2127,7 @@ Status SHT3x::softReset() {
     if (!st.ok()) {
       return st;
     }
+    _noteHeaterState(false, _nowMs(_config));
 
     st = _waitMs(RESET_DELAY_MS);
     if (!st.ok()) {
@@ -1568,12 +2142,14 @@ Status SHT3x::softReset() {
     _lastMeasurementStatus = initialMeasurementStatus();
     _mode = Mode::SINGLE_SHOT;
     _config.mode = Mode::SINGLE_SHOT;
+    _closePeriodicRun(_nowMs(_config));
     _periodicActive = false;
     _periodicStartMs = 0;
     _lastFetchMs = 0;
     _lastFetchValid = false;
     _periodMs = 0;
     _sampleTimestampMs = 0;
+    _sampleTimestampMs64 = 0;
     _missedSamples = 0;
     _notReadyStartMs = 0;
     _notReadyStartValid = false;
@@ -1620,6 +2196,7 @@ Status SHT3x::interfaceReset() {
   _lastFetchMs = 0;
   _lastFetchValid = false;
   _sampleTimestampMs = 0;
+  _sampleTimestampMs64 = 0;
   _missedSamples = 0;
   _notReadyStartMs = 0;
   _notReadyStartValid = false;
@@ -1658,6 +2235,7 @@ Status SHT3x::generalCallReset() {
 
     _lastCommandUs = _nowUs(_config);
     _lastCommandValid = true;
+    _noteHeaterState(false, _nowMs(_config));
     st = _waitMs(RESET_DELAY_MS);
     if (!st.ok()) {
       _hardwareStateValid = false;
@@ -1672,12 +2250,14 @@ Status SHT3x::generalCallReset() {
     _measurementReadyMs = 0;
     _mode = Mode::SINGLE_SHOT;
     _config.mode = Mode::SINGLE_SHOT;
+    _closePeriodicRun(_nowMs(_config));
     _periodicActive = false;
     _periodicStartMs = 0;
     _lastFetchMs = 0;
     _lastFetchValid = false;
     _periodMs = 0;
     _sampleTimestampMs = 0;
+    _sampleTimestampMs64 = 0;
     _missedSamples = 0;
     _notReadyStartMs = 0;
     _notReadyStartValid = false;
@@ -1691,7 +2271,9 @@ Status SHT3x::generalCallReset() {
   }
   return result;
 }
+#endif
 
+#if SHT3X_ENABLE_SYNC_API
 Status SHT3x::readSerialNumber(uint32_t& serial, ClockStretching stretch) {
   if (!_initialized) {
     return Status::Error(Err::NOT_INITIALIZED, "Driver not bound");
@@ -1736,7 +2318,9 @@ Status SHT3x::readSerialNumber(uint32_t& serial, ClockStretching stretch) {
 
   return Status::Ok();
 }
+#endif
 
+#if SHT3X_ENABLE_ALERTS
 Status SHT3x::readAlertLimitRaw(AlertLimitKind kind, uint16_t& value) {
   if (!_initialized) {
     return Status::Error(Err::NOT_INITIALIZED, "Driver not bound");
@@ -1898,6 +2482,7 @@ void SHT3x::decodeAlertLimit(uint16_t limit, float& temperatureC, float& humidit
   humidityPct = (100.0f * static_cast<float>(rawRh)) / 65535.0f;
   temperatureC = -45.0f + (175.0f * static_cast<float>(rawT) / 65535.0f);
 }
+#endif
 
 float SHT3x::convertTemperatureC(uint16_t raw) {
   return -45.0f + (175.0f * static_cast<float>(raw) / 65535.0f);
@@ -1991,14 +2576,290 @@ JobEffect SHT3x::_effectForPhase(JobPhase phase, bool ambiguous) const {
 }
 
 void SHT3x::_clearJobState() {
+  _pollIdleValid = false;
   _measurementRequested = false;
   _measurementPhase = JobPhase::IDLE;
   _jobType = JobType::NONE;
   _jobRequestId = 0;
-  _jobDeadlineMs = 0;
+  _jobDeadlineMs64 = 0;
   _jobHasDeadline = false;
   _jobEffect = JobEffect::NONE;
   _jobWakeMs = 0;
+  _jobContinuous = false;
+  _cadenceActive = false;
+  _burstActive = false;
+}
+
+void SHT3x::_skipOverdueCadenceSlots(uint32_t nowMs) {
+  // A slot is overdue once its conversion can no longer finish before the
+  // next slot starts. Skip to the first slot that still can, never queueing.
+  const uint32_t finishMs = nowMs + estimateMeasurementTimeMs();
+  const uint32_t slotEndMs = _cadenceNextSlotMs + _cadencePeriodMs;
+  if (!_timeElapsed(finishMs, slotEndMs)) {
+    return;
+  }
+  const uint32_t skipped = (finishMs - slotEndMs) / _cadencePeriodMs + 1U;
+  _cadenceNextSlotMs += skipped * _cadencePeriodMs;
+  _cadenceNextSlot += skipped;
+  _cadenceSkippedSlots = saturatingAddU32(_cadenceSkippedSlots, skipped);
+}
+
+uint32_t SHT3x::_periodicSlotAdvance(uint32_t fetchMs) {
+  // The next unfetched slot is assumed readable from _slotOriginMs (plus
+  // _slotOriginFrac / 256). A fetch always holds at least that slot; one a
+  // whole period or more past it holds a later slot, and the ones between were
+  // overwritten. A fetch before it means the phase was wrong, so re-anchor.
+  _periodicSlotValid = true;
+  if (_periodMs == 0) {
+    return 1U;
+  }
+  const int64_t lateQ8 =
+      static_cast<int64_t>(static_cast<int32_t>(fetchMs - _slotOriginMs)) * 256 - _slotOriginFrac;
+  uint32_t advance = 1U;
+  if (lateQ8 >= 0) {
+    advance += static_cast<uint32_t>(lateQ8 / _slotPeriodQ8);
+    const uint64_t originQ8 = _slotOriginFrac + static_cast<uint64_t>(advance) * _slotPeriodQ8;
+    _slotOriginMs += static_cast<uint32_t>(originQ8 >> 8);
+    _slotOriginFrac = static_cast<uint8_t>(originQ8 & 0xFFU);
+  } else {
+    _slotOriginMs = fetchMs + (_slotPeriodQ8 >> 8);
+    _slotOriginFrac = static_cast<uint8_t>(_slotPeriodQ8 & 0xFFU);
+  }
+
+  // Scheduled fetches land within the margin of the slot they were armed for,
+  // and a NACK pushes the retry past the real slot time. The interval between
+  // two such consecutive fetches therefore averages to the sensor's own period.
+  const uint32_t windowMs = 2U * _periodicFetchMarginMs();
+  const bool onTime = lateQ8 >= 0 && lateQ8 <= static_cast<int64_t>(windowMs) * 256;
+  if (_slotLearning() && onTime && _slotFetchOnTime && advance == 1U && _lastFetchValid) {
+    const int32_t errorQ8 = static_cast<int32_t>(((fetchMs - _lastFetchMs) << 8) - _slotPeriodQ8);
+    const uint32_t nominalQ8 = _periodMs << 8;
+    const uint32_t boundQ8 = _periodMs << 4; // +/- 1/16 of the nominal period
+    uint32_t periodQ8 = static_cast<uint32_t>(static_cast<int32_t>(_slotPeriodQ8) + errorQ8 / 8);
+    if (periodQ8 > nominalQ8 + boundQ8) {
+      periodQ8 = nominalQ8 + boundQ8;
+    } else if (periodQ8 < nominalQ8 - boundQ8) {
+      periodQ8 = nominalQ8 - boundQ8;
+    }
+    _slotPeriodQ8 = periodQ8;
+  }
+  _slotFetchOnTime = onTime;
+  return advance;
+}
+
+void SHT3x::_notePeriodicNotReady(uint32_t fetchMs) {
+  // No new slot yet: the next one becomes readable strictly after fetchMs.
+  if (_periodMs > 0 && _timeElapsed(fetchMs, _slotOriginMs)) {
+    _slotOriginMs = fetchMs + 1U;
+    _slotOriginFrac = 0;
+  }
+}
+
+void SHT3x::_recordSampleSequence(uint32_t advance) {
+  if (advance > 1U) {
+    SampleGap& gap = _sampleGaps[_sampleGapCount % SAMPLE_GAP_HISTORY];
+    gap.firstMissing = _sampleSequence + 1U;
+    gap.count = advance - 1U;
+    _sampleGapCount++;
+    _lostSamples = saturatingAddU32(_lostSamples, advance - 1U);
+  }
+  _sampleSequence += advance;
+}
+
+void SHT3x::_syncTimebase() {
+  if (_config.nowMs64 != nullptr) {
+    // An authoritative 64-bit clock replaces the extension outright.
+    _timeAnchorMs64 = _config.nowMs64(_config.timeUser);
+    _timeAnchorMs = static_cast<uint32_t>(_timeAnchorMs64);
+    return;
+  }
+  (void)_extendMs(_nowMs(_config));
+}
+
+uint64_t SHT3x::_extendMs(uint32_t nowMs) {
+  const int32_t delta = static_cast<int32_t>(nowMs - _timeAnchorMs);
+  const uint64_t extended =
+      static_cast<uint64_t>(static_cast<int64_t>(_timeAnchorMs64) + delta);
+  if (delta > 0) {
+    _timeAnchorMs = nowMs;
+    _timeAnchorMs64 = extended;
+  }
+  return extended;
+}
+
+JobRequest64 SHT3x::_widenRequest(const JobRequest& request) {
+  JobRequest64 wide;
+  wide.requestId = request.requestId;
+  wide.hasDeadline = request.hasDeadline;
+  if (_initialized) {
+    _syncTimebase();
+    wide.deadlineMs = toTimeMs64(request.deadlineMs);
+  }
+  return wide;
+}
+
+Status SHT3x::cancelQueuedJob(uint32_t requestId) {
+  if (!_initialized) {
+    return Status::Error(Err::NOT_INITIALIZED, "Driver not bound");
+  }
+  for (uint8_t i = 0; i < _jobQueueCount; ++i) {
+    if (_jobQueue[(_jobQueueHead + i) % JOB_QUEUE_CAPACITY].requestId != requestId) {
+      continue;
+    }
+    // Close the gap, keeping the remaining jobs in order.
+    for (uint8_t j = i; j + 1U < _jobQueueCount; ++j) {
+      _jobQueue[(_jobQueueHead + j) % JOB_QUEUE_CAPACITY] =
+          _jobQueue[(_jobQueueHead + j + 1U) % JOB_QUEUE_CAPACITY];
+    }
+    _jobQueueCount--;
+    return Status::Ok();
+  }
+  return Status::Error(Err::MEASUREMENT_NOT_READY, "Queued job not found");
+}
+
+Status SHT3x::_enqueueJob(JobType type, const JobRequest64& request, bool continuous) {
+  if (_config.jobQueueDepth == 0) {
+    return Status::Error(Err::BUSY, "Cooperative job in progress");
+  }
+  const uint8_t tail = static_cast<uint8_t>((_jobQueueHead + _jobQueueCount) % JOB_QUEUE_CAPACITY);
+  const bool lastContinuous =
+      _jobQueueCount != 0 &&
+      _jobQueue[(tail + JOB_QUEUE_CAPACITY - 1U) % JOB_QUEUE_CAPACITY].continuous;
+  if (_jobContinuous || _cadenceActive || lastContinuous) {
+    return Status::Error(Err::BUSY, "Continuous job never releases the queue");
+  }
+  if (_jobQueueCount >= _config.jobQueueDepth) {
+    return Status::Error(Err::BUSY, "Job queue full", _jobQueueCount);
+  }
+  QueuedJob& slot = _jobQueue[tail];
+  slot.deadlineMs = request.deadlineMs;
+  slot.requestId = request.requestId;
+  slot.type = type;
+  slot.hasDeadline = request.hasDeadline;
+  slot.continuous = continuous;
+  _jobQueueCount++;
+  return Status::Error(Err::IN_PROGRESS, "Job queued", _jobQueueCount);
+}
+
+Status SHT3x::_dispatchQueuedJob(PollJobResult& result) {
+  const QueuedJob job = _jobQueue[_jobQueueHead];
+  _jobQueueHead = static_cast<uint8_t>((_jobQueueHead + 1U) % JOB_QUEUE_CAPACITY);
+  _jobQueueCount--;
+
+  JobRequest64 request;
+  request.deadlineMs = job.deadlineMs;
+  request.requestId = job.requestId;
+  request.hasDeadline = job.hasDeadline;
+  _dispatchingQueuedJob = true;
+  Status st = Status::Ok();
+  if (job.type == JobType::ENSURE_IDLE) {
+    st = requestEnsureIdle(request);
+  } else if (job.continuous) {
+    st = requestContinuous(request);
+  } else {
+    st = requestMeasurement(request);
+  }
+  _dispatchingQueuedJob = false;
+  if (st.inProgress()) {
+    return st;
+  }
+
+  // The job never started: emit its terminal result now, with zero I2C. A
+  // deadline that ran out while queued is a timeout, not a bus failure.
+  result.status = st;
+  result.terminal = true;
+  result.requestId = job.requestId;
+  result.type = job.type;
+  result.outcome =
+      st.code == Err::DEADLINE_INFEASIBLE ? JobOutcome::TIMED_OUT : JobOutcome::FAILED;
+  return st;
+}
+
+Status SHT3x::_admitDeadline(const JobRequest64& request, JobType type) {
+  if (!request.hasDeadline || !_config.rejectInfeasibleDeadlines) {
+    return Status::Ok();
+  }
+  return _admitDeadline(request, minimumCompletionUs(type));
+}
+
+Status SHT3x::_admitDeadline(const JobRequest64& request, uint32_t minimumUs) {
+  if (!request.hasDeadline || !_config.rejectInfeasibleDeadlines) {
+    return Status::Ok();
+  }
+  _syncTimebase();
+  const uint64_t nowMs64 = _extendMs(_nowMs(_config));
+  // Whole elapsed milliseconds only, so a job that could just finish on a
+  // millisecond boundary is still admitted.
+  const uint32_t minimumMs = minimumUs / 1000U;
+  if (_timeElapsed64(nowMs64 + minimumMs, request.deadlineMs)) {
+    return Status::Error(Err::DEADLINE_INFEASIBLE, "Deadline before minimum completion time",
+                         static_cast<int32_t>(minimumMs));
+  }
+  return Status::Ok();
+}
+
+void SHT3x::_closePeriodicRun(uint32_t nowMs) {
+  if (!_periodicActive) {
+    return;
+  }
+  const uint32_t elapsed = nowMs - _periodicStartMs;
+  _periodicUptimeMs = saturatingAddU32(_periodicUptimeMs, elapsed);
+  if (_periodMs > 0) {
+    _periodicConversions[_periodicRunRep] =
+        saturatingAddU32(_periodicConversions[_periodicRunRep], elapsed / _periodMs);
+  }
+}
+
+void SHT3x::_noteHeaterState(bool on, uint32_t nowMs) {
+  if (on && !_heaterOn) {
+    _heaterOnSinceMs = nowMs;
+  } else if (!on && _heaterOn) {
+    _heaterOnMs = saturatingAddU32(_heaterOnMs, nowMs - _heaterOnSinceMs);
+  }
+  _heaterOn = on;
+}
+
+Status SHT3x::getActivity(uint32_t nowMs, ActivityCounters& out) const {
+  out = ActivityCounters{};
+  if (!_initialized) {
+    return Status::Error(Err::NOT_INITIALIZED, "Driver not bound");
+  }
+  out.elapsedMs = nowMs - _bindMs;
+  for (size_t i = 0; i < 3; ++i) {
+    out.singleShotConversions[i] = _singleShotConversions[i];
+    out.periodicConversions[i] = _periodicConversions[i];
+  }
+  out.periodicUptimeMs = _periodicUptimeMs;
+  if (_periodicActive) {
+    const uint32_t elapsed = nowMs - _periodicStartMs;
+    out.periodicUptimeMs = saturatingAddU32(out.periodicUptimeMs, elapsed);
+    if (_periodMs > 0) {
+      out.periodicConversions[_periodicRunRep] =
+          saturatingAddU32(out.periodicConversions[_periodicRunRep], elapsed / _periodMs);
+    }
+  }
+  out.heaterOnMs = _heaterOnMs;
+  if (_heaterOn) {
+    out.heaterOnMs = saturatingAddU32(out.heaterOnMs, nowMs - _heaterOnSinceMs);
+  }
+  out.transportCallbacks = saturatingAddU32(_transportSuccess, _transportFailures);
+  out.samples = _sampleSequence - _lostSamples;
+  return Status::Ok();
+}
+
+Status SHT3x::getSampleGaps(SampleGap* out, size_t capacity, size_t& count) const {
+  count = 0;
+  if (out == nullptr && capacity > 0) {
+    return Status::Error(Err::INVALID_PARAM, "Gap buffer is null");
+  }
+  const uint32_t retained =
+      _sampleGapCount < SAMPLE_GAP_HISTORY ? _sampleGapCount : SAMPLE_GAP_HISTORY;
+  const size_t n = capacity < retained ? capacity : retained;
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = _sampleGaps[(_sampleGapCount - n + i) % SAMPLE_GAP_HISTORY];
+  }
+  count = n;
+  return Status::Ok();
 }
 
 uint32_t SHT3x::_periodicFetchMarginMs() const {
@@ -2018,10 +2879,50 @@ uint32_t SHT3x::_periodicFetchMarginMs() const {
   return margin;
 }
 
+uint32_t SHT3x::minimumCompletionUs(JobType type) const {
+  const uint32_t transferUs = _config.transferBudgetUs;
+  const uint32_t commandDelayUs = static_cast<uint32_t>(_config.commandDelayMs) * 1000U;
+  uint32_t idleUs = 0;
+  if (_lastCommandValid) {
+    const uint32_t sinceUs = _nowUs(_config) - _lastCommandUs;
+    idleUs = (sinceUs < commandDelayUs) ? commandDelayUs - sinceUs : 0;
+  }
+
+  switch (type) {
+    case JobType::ENSURE_IDLE:
+      // Break, soft reset, status command and read; each command after the
+      // first also waits out the previous settle time or tIDLE.
+      return idleUs + 4U * transferUs + largerU32(BREAK_DELAY_MS * 1000U, commandDelayUs) +
+             largerU32(RESET_DELAY_MS * 1000U, commandDelayUs) + commandDelayUs;
+
+    case JobType::MEASUREMENT: {
+      if (_mode == Mode::SINGLE_SHOT) {
+        // Command, conversion (which covers tIDLE before the read), read.
+        const uint32_t conversionUs = estimateMeasurementTimeMs() * 1000U;
+        return idleUs + 2U * transferUs + largerU32(conversionUs, commandDelayUs);
+      }
+      // Fetch once the slot is ready, then tIDLE before the read.
+      const uint32_t nowMs = _nowMs(_config);
+      const uint32_t readyUs = (_periodicReadyMs(nowMs) - nowMs) * 1000U;
+      return largerU32(idleUs, readyUs) + 2U * transferUs + commandDelayUs;
+    }
+
+    case JobType::NONE:
+    default:
+      return 0;
+  }
+}
+
 uint32_t SHT3x::_periodicReadyMs(uint32_t nowMs) const {
   if (_periodMs == 0) {
     return nowMs;
   }
+  if (_slotLearning()) {
+    // Fetch one margin after the next slot is due on the learned phase.
+    const uint32_t readyMs =
+        _slotOriginMs + (_slotOriginFrac != 0 ? 1U : 0U) + _periodicFetchMarginMs();
+    return _timeElapsed(nowMs, readyMs) ? nowMs : readyMs;
+  }
 
   uint32_t startMs = 0;
   uint32_t waitMs = 0;
@@ -2044,9 +2945,20 @@ uint32_t SHT3x::_periodicRetryMs(uint32_t nowMs) const {
   if (_periodMs == 0) {
     return nowMs + _config.commandDelayMs;
   }
+  if (_slotLearning() && _periodicSlotValid && _notReadyCount <= 1U) {
+    // One early fetch on a known phase: the slot is due just after it.
+    return _periodicReadyMs(nowMs);
+  }
   return nowMs + _periodMs + _periodicFetchMarginMs();
 }
 
+bool SHT3x::_slotLearning() const {
+  // Only a read-header NACK proves a fetch came early. Without it an early
+  // fetch fails the job, so the nominal, drift-accumulating schedule stays.
+  return _periodMs > 0 &&
+         hasCapability(_config.transportCapabilities, TransportCapability::READ_HEADER_NACK);
+}
+
 void SHT3x::_setSafeBaseline() {
   _measurementRequested = false;
   _measurementReady = false;
@@ -2054,12 +2966,14 @@ void SHT3x::_setSafeBaseline() {
   _measurementPhase = JobPhase::IDLE;
   _lastMeasurementStatus = initialMeasurementStatus();
   _measurementReadyMs = 0;
+  _closePeriodicRun(_nowMs(_config));
   _periodicActive = false;
   _periodicStartMs = 0;
   _lastFetchMs = 0;
   _lastFetchValid = false;
   _periodMs = 0;
   _sampleTimestampMs = 0;
+  _sampleTimestampMs64 = 0;
   _missedSamples = 0;
   _notReadyStartMs = 0;
   _notReadyStartValid = false;
@@ -2068,6 +2982,7 @@ void SHT3x::_setSafeBaseline() {
   _config.mode = Mode::SINGLE_SHOT;
 }
 
+#if SHT3X_ENABLE_RECOVERY
 void SHT3x::_setDefaultsToConfigAndCache() {
   Config defaults;
   _config.repeatability = defaults.repeatability;
@@ -2079,6 +2994,7 @@ void SHT3x::_setDefaultsToConfigAndCache() {
   _cachedSettings = defaultCachedSettings();
   _hasCachedSettings = true;
 }
+#endif
 
 void SHT3x::_syncCacheFromConfig() {
   _cachedSettings.mode = _mode;
@@ -2087,6 +3003,7 @@ void SHT3x::_syncCacheFromConfig() {
   _cachedSettings.clockStretching = _config.clockStretching;
 }
 
+#if SHT3X_ENABLE_RECOVERY
 Status SHT3x::_applyCachedSettingsAfterReset() {
   Status st = setRepeatability(_cachedSettings.repeatability);
   if (!st.ok()) {
@@ -2105,6 +3022,7 @@ Status SHT3x::_applyCachedSettingsAfterReset() {
     return st;
   }
 
+#if SHT3X_ENABLE_ALERTS
   for (size_t i = 0; i < 4; ++i) {
     if (!_cachedSettings.alertValid[i]) {
       continue;
@@ -2115,6 +3033,7 @@ Status SHT3x::_applyCachedSettingsAfterReset() {
       return st;
     }
   }
+#endif
 
   if (_cachedSettings.mode == Mode::PERIODIC) {
     return startPeriodic(_cachedSettings.periodicRate, _cachedSettings.repeatability);
@@ -2216,6 +3135,7 @@ Status SHT3x::_performRecoveryLadder() {
     if (_config.recoverUseHardReset && _config.hardReset != nullptr) {
       Status st = _config.hardReset(_config.i2cUser);
       if (st.ok()) {
+        _noteHeaterState(false, _nowMs(_config));
         st = _waitMs(RESET_DELAY_MS);
         if (!st.ok()) {
           return st;
@@ -2249,6 +3169,7 @@ Status SHT3x::_performRecoveryLadder() {
   }
   return result;
 }
+#endif
 
 Status SHT3x::_i2cWriteReadRaw(const uint8_t* txBuf, size_t txLen,
                                uint8_t* rxBuf, size_t rxLen) {
@@ -2266,6 +3187,7 @@ Status SHT3x::_i2cWriteReadRaw(const uint8_t* txBuf, size_t txLen,
   }
   Status st = _config.i2cWriteRead(_config.i2cAddress, txBuf, txLen, rxBuf, rxLen,
                                    _config.i2cTimeoutMs, _config.i2cUser);
+  _invalidatePollClock();
   if (st.code == Err::I2C_NACK_READ &&
       !hasCapability(_config.transportCapabilities,
                      TransportCapability::READ_HEADER_NACK)) {
@@ -2286,12 +3208,14 @@ Status SHT3x::_i2cWriteRaw(const uint8_t* buf, size_t len) {
   }
   const Status st = _config.i2cWrite(_config.i2cAddress, buf, len,
                                      _config.i2cTimeoutMs, _config.i2cUser);
+  _invalidatePollClock();
   // A failed callback may still have placed the command on the bus/device.
-  _lastCommandUs = _nowUs(_config);
+  _lastCommandUs = _clockUs();
   _lastCommandValid = true;
   return st;
 }
 
+#if SHT3X_ENABLE_RECOVERY
 Status SHT3x::_i2cWriteRawAddr(uint8_t addr, const uint8_t* buf, size_t len) {
   if (_config.i2cWrite == nullptr) {
     return Status::Error(Err::INVALID_CONFIG, "I2C write not set");
@@ -2301,7 +3225,8 @@ Status SHT3x::_i2cWriteRawAddr(uint8_t addr, const uint8_t* buf, size_t len) {
   }
   const Status st =
       _config.i2cWrite(addr, buf, len, _config.i2cTimeoutMs, _config.i2cUser);
-  _lastCommandUs = _nowUs(_config);
+  _invalidatePollClock();
+  _lastCommandUs = _clockUs();
   _lastCommandValid = true;
   return st;
 }
@@ -2322,6 +3247,7 @@ Status SHT3x::_i2cWriteRawAddrTracked(uint8_t addr, const uint8_t* buf, size_t l
   }
   return _updateHealth(st);
 }
+#endif
 
 Status SHT3x::_i2cWriteReadTracked(const uint8_t* txBuf, size_t txLen,
                                    uint8_t* rxBuf, size_t rxLen,
@@ -2364,7 +3290,7 @@ Status SHT3x::_i2cWriteReadTrackedAllowNoData(const uint8_t* txBuf, size_t txLen
     return st;
   }
   if (allow && st.code == Err::I2C_NACK_READ && txLen == 0 && rxLen > 0) {
-    _recordBusActivity(_nowMs(_config));
+    _recordBusActivity(_clockMs());
     if (_totalNotReady < std::numeric_limits<uint32_t>::max()) {
       _totalNotReady++;
     }
@@ -2412,6 +3338,7 @@ Status SHT3x::_writeCommandNoDelay(uint16_t cmd, bool tracked,
   return st;
 }
 
+#if SHT3X_ENABLE_RAW_COMMANDS || SHT3X_ENABLE_ALERTS
 Status SHT3x::_writeCommandWithData(uint16_t cmd, uint16_t data, bool tracked,
                                     bool logicalComplete) {
   Status st = _ensureCommandDelay();
@@ -2430,6 +3357,7 @@ Status SHT3x::_writeCommandWithData(uint16_t cmd, uint16_t data, bool tracked,
                : _i2cWriteRaw(payload, sizeof(payload));
   return st;
 }
+#endif
 
 Status SHT3x::_readAfterCommand(uint8_t* buf, size_t len, bool tracked,
                                 bool allowNoData, bool logicalComplete) {
@@ -2465,7 +3393,7 @@ Status SHT3x::_updateHealth(const Status& st, bool logicalComplete) {
     return st;
   }
 
-  const uint32_t now = _nowMs(_config);
+  const uint32_t now = _clockMs();
   const uint32_t maxU32 = std::numeric_limits<uint32_t>::max();
   const uint8_t maxU8 = std::numeric_limits<uint8_t>::max();
 
@@ -2523,6 +3451,28 @@ void SHT3x::_reassertOfflineLatch() {
   }
 }
 
+uint32_t SHT3x::_clockMs() {
+  // Outside pollJob() every read goes to the hook; inside, a read is reused
+  // until the next transport callback moves time on.
+  if (_pollClockMsValid) {
+    return _pollClockMs;
+  }
+  const uint32_t now = _nowMs(_config);
+  _pollClockMs = now;
+  _pollClockMsValid = _pollClockActive;
+  return now;
+}
+
+uint32_t SHT3x::_clockUs() {
+  if (_pollClockUsValid) {
+    return _pollClockUs;
+  }
+  const uint32_t now = _nowUs(_config);
+  _pollClockUs = now;
+  _pollClockUsValid = _pollClockActive;
+  return now;
+}
+
 void SHT3x::_recordBusActivity(uint32_t nowMs) {
   _lastBusActivityMs = nowMs;
 }
@@ -2550,11 +3500,7 @@ Status SHT3x::_ensureCommandDelay() {
     } else if (++stableLoops >= 500000U) {
       return Status::Error(Err::TIMEOUT, "Command delay timeout");
     }
-    if (_config.cooperativeYield != nullptr) {
-      _config.cooperativeYield(_config.timeUser);
-    } else {
-      platform::cooperativeYield();
-    }
+    _waitStep(_lastCommandUs + delayUs);
   }
 
   return Status::Ok();
@@ -2567,6 +3513,9 @@ Status SHT3x::_waitMs(uint32_t delayMs) {
 
   const uint32_t startMs = _nowMs(_config);
   const uint32_t deadline = startMs + delayMs;
+  // Only a sleeping wait needs a microsecond target; spinning skips the read.
+  const uint32_t targetUs =
+      (_config.sleepUntilUs != nullptr) ? _nowUs(_config) + delayMs * 1000U : 0U;
   const uint32_t timeoutMs = saturatingAddU32(delayMs, _config.i2cTimeoutMs);
   uint32_t lastMs = startMs;
   uint32_t stableLoops = 0;
@@ -2585,16 +3534,23 @@ Status SHT3x::_waitMs(uint32_t delayMs) {
     } else if (++stableLoops >= 500000U) {
       return Status::Error(Err::TIMEOUT, "Wait timeout");
     }
-    if (_config.cooperativeYield != nullptr) {
-      _config.cooperativeYield(_config.timeUser);
-    } else {
-      platform::cooperativeYield();
-    }
+    _waitStep(targetUs);
   }
 
   return Status::Ok();
 }
 
+void SHT3x::_waitStep(uint32_t targetUs) {
+  if (_config.sleepUntilUs != nullptr) {
+    _config.sleepUntilUs(targetUs, _config.timeUser);
+  } else if (_config.cooperativeYield != nullptr) {
+    _config.cooperativeYield(_config.timeUser);
+  } else {
+    platform::cooperativeYield();
+  }
+}
+
+#if SHT3X_ENABLE_SYNC_API || SHT3X_ENABLE_ALERTS
 Status SHT3x::_readStatusRaw(uint16_t& raw, bool tracked) {
   Status st = _writeCommand(cmd::CMD_READ_STATUS, tracked, false);
   if (!st.ok()) {
@@ -2617,6 +3573,7 @@ Status SHT3x::_readStatusRaw(uint16_t& raw, bool tracked) {
   raw = static_cast<uint16_t>((buf[0] << 8) | buf[1]);
   return Status::Ok();
 }
+#endif
 
 Status SHT3x::_readMeasurementRawNoDelay(RawSample& out, bool tracked, bool allowNoData) {
   uint8_t buf[cmd::MEASUREMENT_DATA_LEN] = {};
@@ -2688,6 +3645,13 @@ Status SHT3x::_enterPeriodic(PeriodicRate rate, Repeatability rep, bool art) {
   _periodicStartMs = _nowMs(_config);
   _lastFetchMs = 0;
   _lastFetchValid = false;
+  _periodicRunRep = static_cast<uint8_t>(art ? Repeatability::HIGH_REPEATABILITY : rep);
+  // First slot is assumed ready one conversion after the mode command.
+  _slotOriginMs = _periodicStartMs + estimateMeasurementTimeMs();
+  _slotOriginFrac = 0;
+  _slotPeriodQ8 = _periodMs << 8;
+  _slotFetchOnTime = false;
+  _periodicSlotValid = false;
 
   return Status::Ok();
 }
@@ -2725,6 +3689,7 @@ Status SHT3x::_stopPeriodicInternal() {
   _measurementPhase = JobPhase::IDLE;
   _lastMeasurementStatus = initialMeasurementStatus();
   _measurementReadyMs = 0;
+  _closePeriodicRun(_nowMs(_config));
   _periodicActive = false;
   _mode = Mode::SINGLE_SHOT;
   _config.mode = Mode::SINGLE_SHOT;
@@ -2821,6 +3786,7 @@ uint16_t SHT3x::_commandForPeriodic(Repeatability rep, PeriodicRate rate) {
   }
 }
 
+#if SHT3X_ENABLE_ALERTS
 uint16_t SHT3x::_commandForAlertRead(AlertLimitKind kind) {
   switch (kind) {
     case AlertLimitKind::HIGH_SET: return cmd::CMD_ALERT_READ_HIGH_SET;
@@ -2840,6 +3806,7 @@ uint16_t SHT3x::_commandForAlertWrite(AlertLimitKind kind) {
     default: return 0;
   }
 }
+#endif
 
 uint32_t SHT3x::_periodMsForRate(PeriodicRate rate) {
   switch (rate) {
@@ -2860,6 +3827,10 @@ bool SHT3x::_timeElapsed(uint32_t now, uint32_t target) {
   return static_cast<int32_t>(now - target) >= 0;
 }
 
+bool SHT3x::_timeElapsed64(uint64_t now, uint64_t target) {
+  return static_cast<int64_t>(now - target) >= 0;
+}
+
 void SHT3x::_parseStatusRegister(uint16_t raw, StatusRegister& out) {
   out.raw = raw;
   out.alertPending = (raw & cmd::STATUS_ALERT_PENDING) != 0;
@@ -0,0 +1,162 @@
+/**
+ * @file SoftAlert.cpp
+ * @brief Software alert thresholds with hardware-style set/clear hysteresis.
+ */
+
+#include "SHT3x/SoftAlert.h"
+
+namespace SHT3x {
+namespace {
+
+bool validThreshold(const SoftAlertThreshold& t) {
+  if (static_cast<uint8_t>(t.channel) > static_cast<uint8_t>(SoftAlertChannel::HUMIDITY)) {
+    return false;
+  }
+  if (t.kind == SoftAlertKind::HIGH_ALERT) {
+    return t.clearMilli <= t.setMilli;
+  }
+  return t.kind == SoftAlertKind::LOW_ALERT && t.clearMilli >= t.setMilli;
+}
+
+} // namespace
+
+Status SoftAlert::configure(SoftAlertThreshold* thresholds, size_t count) {
+  if (thresholds == nullptr && count > 0) {
+    return Status::Error(Err::INVALID_PARAM, "Alert threshold array is null");
+  }
+  for (size_t i = 0; i < count; ++i) {
+    if (!validThreshold(thresholds[i])) {
+      return Status::Error(Err::INVALID_PARAM, "Invalid alert threshold",
+                           static_cast<int32_t>(i));
+    }
+  }
+  _thresholds = thresholds;
+  _count = count;
+  reset();
+  return Status::Ok();
+}
+
+void SoftAlert::reset() {
+  for (size_t i = 0; i < _count; ++i) {
+    _thresholds[i].active = false;
+  }
+  _status = SoftAlertStatus{};
+  _deviceSequence = 0;
+  _hasDeviceSequence = false;
+}
+
+void SoftAlert::clearStatus() {
+  _status.alertPending = false;
+  _status.rhAlert = false;
+  _status.tAlert = false;
+}
+
+Status SoftAlert::update(const MeasurementMilli& sample, uint32_t timestampMs,
+                         SoftAlertEvent* events, size_t capacity, size_t& written) {
+  written = 0;
+  if (events == nullptr && capacity > 0) {
+    return Status::Error(Err::INVALID_PARAM, "Alert event buffer is null");
+  }
+
+  size_t dropped = 0;
+  bool tActive = false;
+  bool rhActive = false;
+  for (size_t i = 0; i < _count; ++i) {
+    SoftAlertThreshold& t = _thresholds[i];
+    const bool humidity = t.channel == SoftAlertChannel::HUMIDITY;
+    const int32_t value =
+        humidity ? sample.humidityMilliPercent : sample.temperatureMilliCelsius;
+    bool active = t.active;
+    if (t.kind == SoftAlertKind::HIGH_ALERT) {
+      active = active ? value >= t.clearMilli : value > t.setMilli;
+    } else {
+      active = active ? value <= t.clearMilli : value < t.setMilli;
+    }
+    active = active && t.enabled;
+
+    if (active != t.active) {
+      t.active = active;
+      if (active) {
+        _status.alertPending = true;
+        _status.rhAlert = _status.rhAlert || humidity;
+        _status.tAlert = _status.tAlert || !humidity;
+      }
+      if (_status.events != UINT32_MAX) {
+        _status.events++;
+      }
+      if (written < capacity) {
+        SoftAlertEvent& e = events[written++];
+        e.threshold = static_cast<uint32_t>(i);
+        e.active = active;
+        e.valueMilli = value;
+        e.timestampMs = timestampMs;
+      } else {
+        dropped++;
+      }
+    }
+    rhActive = rhActive || (active && humidity);
+    tActive = tActive || (active && !humidity);
+  }
+  _status.rhActive = rhActive;
+  _status.tActive = tActive;
+
+  if (dropped > 0) {
+    return Status::Error(Err::BUSY, "Alert event buffer full", static_cast<int32_t>(dropped));
+  }
+  return Status::Ok();
+}
+
+Status SoftAlert::update(const SHT3x& device, SoftAlertEvent* events, size_t capacity,
+                         size_t& written) {
+  written = 0;
+  MeasurementMilli sample;
+  const Status st = device.getMeasurementMilli(sample);
+  if (!st.ok()) {
+    return st;
+  }
+  const uint32_t sequence = device.sampleSequence();
+  if (_hasDeviceSequence && sequence == _deviceSequence) {
+    return Status::Ok();
+  }
+  _deviceSequence = sequence;
+  _hasDeviceSequence = true;
+  return update(sample, device.sampleTimestampMs(), events, capacity, written);
+}
+
+void SoftAlert::fromAlertLimits(const uint16_t alertRaw[4], SoftAlertThreshold out[4]) {
+  // Limit words keep the top 9 bits of the temperature word and the top 7
+  // bits of the humidity word.
+  int32_t temperature[4];
+  int32_t humidity[4];
+  for (uint8_t i = 0; i < 4; ++i) {
+    temperature[i] = SHT3x::convertTemperatureMilliCelsius(
+        static_cast<uint16_t>((alertRaw[i] & 0x01FFU) << 7));
+    humidity[i] = SHT3x::convertHumidityMilliPercent(
+        static_cast<uint16_t>(((alertRaw[i] >> 9) & 0x7FU) << 9));
+  }
+  const uint8_t highSet = static_cast<uint8_t>(AlertLimitKind::HIGH_SET);
+  const uint8_t highClear = static_cast<uint8_t>(AlertLimitKind::HIGH_CLEAR);
+  const uint8_t lowClear = static_cast<uint8_t>(AlertLimitKind::LOW_CLEAR);
+  const uint8_t lowSet = static_cast<uint8_t>(AlertLimitKind::LOW_SET);
+  const int32_t* levels[2] = {temperature, humidity};
+  for (uint8_t ch = 0; ch < 2; ++ch) {
+    const int32_t* v = levels[ch];
+    const bool enabled = v[highSet] >= v[lowSet];
+    SoftAlertThreshold& high = out[ch];
+    high = SoftAlertThreshold{};
+    high.channel = static_cast<SoftAlertChannel>(ch);
+    high.kind = SoftAlertKind::HIGH_ALERT;
+    high.setMilli = v[highSet];
+    high.clearMilli = v[highClear] < v[highSet] ? v[highClear] : v[highSet];
+    high.enabled = enabled;
+    SoftAlertThreshold& low = out[2 + ch];
+    low = SoftAlertThreshold{};
+    low.channel = static_cast<SoftAlertChannel>(ch);
+    low.kind = SoftAlertKind::LOW_ALERT;
+    low.setMilli = v[lowSet];
+    low.clearMilli = v[lowClear] > v[lowSet] ? v[lowClear] : v[lowSet];
+    low.enabled = enabled;
+  }
+}
+
+} // namespace SHT3x
@@ -0,0 +1,157 @@
+/**
+ * @file Telemetry.cpp
+ * @brief Binary telemetry frame encoder/decoder.
+ */
+
+#include "SHT3x/Telemetry.h"
+
+namespace SHT3x {
+namespace {
+
+static constexpr size_t CRC_OFFSET = TELEMETRY_FRAME_LEN - 2;
+
+// CRC-16/CCITT-FALSE nibble table: 32 bytes of flash, two lookups per byte.
+static constexpr uint16_t CRC16_NIBBLE[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+inline void putU16(uint8_t* p, uint16_t v) {
+  p[0] = static_cast<uint8_t>(v & 0xFFU);
+  p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+inline void putU32(uint8_t* p, uint32_t v) {
+  p[0] = static_cast<uint8_t>(v & 0xFFU);
+  p[1] = static_cast<uint8_t>((v >> 8) & 0xFFU);
+  p[2] = static_cast<uint8_t>((v >> 16) & 0xFFU);
+  p[3] = static_cast<uint8_t>(v >> 24);
+}
+
+inline uint16_t getU16(const uint8_t* p) {
+  return static_cast<uint16_t>(p[0] | (static_cast<uint16_t>(p[1]) << 8));
+}
+
+inline uint32_t getU32(const uint8_t* p) {
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+         (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+} // namespace
+
+uint16_t telemetryCrc16(const uint8_t* data, size_t len) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < len; ++i) {
+    crc = static_cast<uint16_t>((crc << 4) ^ CRC16_NIBBLE[(crc >> 12) ^ (data[i] >> 4)]);
+    crc = static_cast<uint16_t>((crc << 4) ^ CRC16_NIBBLE[(crc >> 12) ^ (data[i] & 0x0FU)]);
+  }
+  return crc;
+}
+
+Status encodeTelemetryFrame(const SHT3x& device, uint32_t nowMs, uint16_t sequence,
+                            uint8_t* out, size_t capacity, size_t& written) {
+  written = 0;
+  if (out == nullptr || capacity < TELEMETRY_FRAME_LEN) {
+    return Status::Error(Err::INVALID_PARAM, "Telemetry buffer too small",
+                         static_cast<int32_t>(TELEMETRY_FRAME_LEN));
+  }
+
+  uint8_t flags = 0;
+  if (device.isInitialized()) {
+    flags |= TELEMETRY_FLAG_INITIALIZED;
+  }
+  if (device.hasSample()) {
+    flags |= TELEMETRY_FLAG_HAS_SAMPLE;
+  }
+  if (device.measurementReady()) {
+    flags |= TELEMETRY_FLAG_SAMPLE_READY;
+  }
+  if (device.isPeriodicActive()) {
+    flags |= TELEMETRY_FLAG_PERIODIC_ACTIVE;
+  }
+  if (device.hardwareStateValid()) {
+    flags |= TELEMETRY_FLAG_HW_STATE_VALID;
+  }
+  if (device.measurementPending()) {
+    flags |= TELEMETRY_FLAG_MEASUREMENT_PENDING;
+  }
+
+  const Config& cfg = device.getConfig();
+  RawSample sample;
+  (void)device.getRawSample(sample);
+
+  out[0] = TELEMETRY_MAGIC;
+  out[1] = TELEMETRY_VERSION;
+  putU16(&out[2], sequence);
+  out[4] = static_cast<uint8_t>(device.state());
+  out[5] = static_cast<uint8_t>(device.lastError().code);
+  out[6] = static_cast<uint8_t>(device.lastMeasurementStatus().code);
+  out[7] = flags;
+  out[8] = device.consecutiveFailures();
+  out[9] = static_cast<uint8_t>((static_cast<uint8_t>(cfg.mode) & 0x03U) |
+                                ((static_cast<uint8_t>(cfg.repeatability) & 0x03U) << 2) |
+                                ((static_cast<uint8_t>(cfg.periodicRate) & 0x07U) << 4));
+  putU16(&out[10], sample.rawTemperature);
+  putU16(&out[12], sample.rawHumidity);
+  putU16(&out[14], 0);
+  putU32(&out[16], nowMs);
+  putU32(&out[20], device.sampleTimestampMs());
+  putU32(&out[24], device.lastOkMs());
+  putU32(&out[28], device.lastErrorMs());
+  putU32(&out[32], device.totalSuccess());
+  putU32(&out[36], device.totalFailures());
+  putU32(&out[40], device.transportSuccess());
+  putU32(&out[44], device.transportFailures());
+  putU32(&out[48], device.protocolFailures());
+  putU32(&out[52], device.totalNotReady());
+  putU32(&out[56], device.missedSamplesEstimate());
+  putU16(&out[CRC_OFFSET], telemetryCrc16(out, CRC_OFFSET));
+
+  written = TELEMETRY_FRAME_LEN;
+  return Status::Ok();
+}
+
+Status decodeTelemetryFrame(const uint8_t* data, size_t len, TelemetryFrame& out) {
+  if (data == nullptr || len < TELEMETRY_FRAME_LEN) {
+    return Status::Error(Err::INVALID_PARAM, "Telemetry frame too short",
+                         static_cast<int32_t>(len));
+  }
+  if (data[0] != TELEMETRY_MAGIC) {
+    return Status::Error(Err::INVALID_PARAM, "Telemetry magic mismatch", data[0]);
+  }
+  if (data[1] != TELEMETRY_VERSION) {
+    return Status::Error(Err::INVALID_PARAM, "Unsupported telemetry version", data[1]);
+  }
+  if (telemetryCrc16(data, CRC_OFFSET) != getU16(&data[CRC_OFFSET])) {
+    return Status::Error(Err::CRC_MISMATCH, "CRC mismatch (telemetry)");
+  }
+
+  TelemetryFrame frame;
+  frame.version = data[1];
+  frame.sequence = getU16(&data[2]);
+  frame.state = static_cast<DriverState>(data[4]);
+  frame.lastError = static_cast<Err>(data[5]);
+  frame.lastMeasurement = static_cast<Err>(data[6]);
+  frame.flags = data[7];
+  frame.consecutiveFailures = data[8];
+  frame.mode = static_cast<Mode>(data[9] & 0x03U);
+  frame.repeatability = static_cast<Repeatability>((data[9] >> 2) & 0x03U);
+  frame.periodicRate = static_cast<PeriodicRate>((data[9] >> 4) & 0x07U);
+  frame.sample.rawTemperature = getU16(&data[10]);
+  frame.sample.rawHumidity = getU16(&data[12]);
+  frame.frameTimestampMs = getU32(&data[16]);
+  frame.sampleTimestampMs = getU32(&data[20]);
+  frame.lastOkMs = getU32(&data[24]);
+  frame.lastErrorMs = getU32(&data[28]);
+  frame.totalSuccess = getU32(&data[32]);
+  frame.totalFailures = getU32(&data[36]);
+  frame.transportSuccess = getU32(&data[40]);
+  frame.transportFailures = getU32(&data[44]);
+  frame.protocolFailures = getU32(&data[48]);
+  frame.totalNotReady = getU32(&data[52]);
+  frame.missedSamples = getU32(&data[56]);
+  out = frame;
+  return Status::Ok();
+}
+
+} // namespace SHT3x
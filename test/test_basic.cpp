@@ -2,6 +2,9 @@
 /// @brief Basic unit tests for SHT3x driver
 
 #include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <type_traits>
 
 // Include stubs first
@@ -9,6 +12,7 @@
 #include "Wire.h"
 #include "examples/common/I2cTransport.h"
 #include "examples/common/I2cScanner.h"
+#include "examples/host/common/ScenarioGenerator.h"
 
 // Stub implementations
 SerialClass Serial;
@@ -20,7 +24,14 @@ uint32_t gMicrosStep = 0;
 
 // Include driver (expose private for test hooks)
 #define private public
+#include "SHT3x/AlarmEngine.h"
+#include "SHT3x/AllanDeviation.h"
+#include "SHT3x/DeadBand.h"
+#include "SHT3x/Energy.h"
+#include "SHT3x/KalmanFilter.h"
 #include "SHT3x/SHT3x.h"
+#include "SHT3x/SoftAlert.h"
+#include "SHT3x/Telemetry.h"
 #undef private
 
 using namespace SHT3x;
@@ -818,6 +829,11 @@ static void clearFrameLog(FrameScriptTransport& ctx) {
 
 struct PreciseTimingTransport {
   uint32_t nowMs = 0;
+  uint32_t msWraps = 0;
+  uint32_t msReads = 0;
+  uint32_t usReads = 0;
+  uint32_t sleepCalls = 0;
+  uint32_t lastSleepTargetUs = 0;
   uint32_t nowUs = 0;
   uint32_t writeAdvanceMs = 0;
   uint32_t writeAdvanceUs = 0;
@@ -903,10 +919,23 @@ static Status preciseTimingRead(uint8_t addr, const uint8_t* txData, size_t txLe
 }
 
 static uint32_t preciseTimingNowMs(void* user) {
-  return static_cast<PreciseTimingTransport*>(user)->nowMs;
+  auto* ctx = static_cast<PreciseTimingTransport*>(user);
+  ++ctx->msReads;
+  return ctx->nowMs;
 }
 
 static uint32_t preciseTimingNowUs(void* user) {
+  auto* ctx = static_cast<PreciseTimingTransport*>(user);
+  ++ctx->usReads;
+  return ctx->nowUs;
+}
+
+static uint64_t preciseTimingNowMs64(void* user) {
+  const auto* ctx = static_cast<PreciseTimingTransport*>(user);
+  return (static_cast<uint64_t>(ctx->msWraps) << 32) | ctx->nowMs;
+}
+
+static uint64_t preciseTimingNowUs64(void* user) {
   return static_cast<PreciseTimingTransport*>(user)->nowUs;
 }
 
@@ -916,6 +945,17 @@ static void preciseTimingYield(void* user) {
   ctx->nowUs += 1000u;
 }
 
+static void preciseTimingSleepUntilUs(uint32_t targetUs, void* user) {
+  auto* ctx = static_cast<PreciseTimingTransport*>(user);
+  ++ctx->sleepCalls;
+  ctx->lastSleepTargetUs = targetUs;
+  const int32_t remainingUs = static_cast<int32_t>(targetUs - ctx->nowUs);
+  if (remainingUs > 0) {
+    ctx->nowUs = targetUs;
+    ctx->nowMs += (static_cast<uint32_t>(remainingUs) + 999u) / 1000u;
+  }
+}
+
 static Config makePreciseTimingConfig(PreciseTimingTransport& ctx,
                                       uint8_t address = cmd::I2C_ADDR_LOW) {
   Config cfg;
@@ -950,7 +990,11 @@ static void preparePreciseTimingDevice(SHT3xDevice& device,
 
 static void advancePreciseTimeMs(PreciseTimingTransport& ctx,
                                  uint32_t deltaMs) {
+  const uint32_t beforeMs = ctx.nowMs;
   ctx.nowMs += deltaMs;
+  if (ctx.nowMs < beforeMs) {
+    ++ctx.msWraps;
+  }
   ctx.nowUs += deltaMs * 1000u;
 }
 
@@ -3375,729 +3419,1084 @@ void test_cancel_periodic_read_is_zero_i2c_and_preserves_cached_sample() {
   TEST_ASSERT_EQUAL_UINT32(callbacksBeforeCancel, ctx.writes + ctx.reads);
 }
 
-void test_job_deadlines_before_work_inside_callback_and_across_wrap() {
-  {
-    PreciseTimingTransport ctx;
-    ctx.nowMs = 100;
-    ctx.nowUs = 100000;
-    SHT3xDevice device;
-    Status st = device.bind(makePreciseTimingConfig(ctx));
-    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-
-    JobRequest request;
-    request.requestId = 51;
-    request.hasDeadline = true;
-    request.deadlineMs = ctx.nowMs;
-    st = device.requestMeasurement(request);
-    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    PollJobResult result;
+static Status runPreciseJobToTerminal(SHT3xDevice& device, PreciseTimingTransport& ctx,
+                                      PollJobResult& result) {
+  Status st = device.pollJob(ctx.nowMs, 1, result);
+  for (int i = 0; i < 100 && st.inProgress(); ++i) {
+    advancePreciseTimeMs(ctx, 1);
     st = device.pollJob(ctx.nowMs, 1, result);
-    TEST_ASSERT_EQUAL(Err::TIMEOUT, st.code);
-    TEST_ASSERT_TRUE(result.terminal);
-    TEST_ASSERT_EQUAL_UINT32(51u, result.requestId);
-    TEST_ASSERT_EQUAL(JobPhase::SINGLE_SHOT_COMMAND, result.phase);
-    TEST_ASSERT_EQUAL(JobOutcome::TIMED_OUT, result.outcome);
-    TEST_ASSERT_EQUAL(JobEffect::NONE, result.effect);
-    TEST_ASSERT_EQUAL_UINT8(0u, result.instructionsUsed);
-    TEST_ASSERT_EQUAL_UINT32(0u, ctx.writes + ctx.reads);
   }
+  return st;
+}
+
+void test_nowms64_hook_drives_64bit_deadlines_and_sample_timestamps() {
+  PreciseTimingTransport ctx;
+  ctx.nowMs = 0xFFFFFFF0u;
+  ctx.msWraps = 5;
+  ctx.rawTemperature = 0x6666;
+  ctx.rawHumidity = 0x8000;
+  Config cfg = makePreciseTimingConfig(ctx);
+  cfg.nowMs = nullptr;
+  cfg.nowUs = nullptr;
+  cfg.nowMs64 = preciseTimingNowMs64;
+  cfg.nowUs64 = preciseTimingNowUs64;
+  SHT3xDevice device;
+  Status st = device.bind(cfg);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  const uint64_t startMs = preciseTimingNowMs64(&ctx);
+  TEST_ASSERT_TRUE(startMs == device.toTimeMs64(ctx.nowMs));
+
+  // 40 days out: beyond INT32_MAX ms, so its low 32 bits alone read as past.
+  // Braced initialization follows JobRequest's {id, deadline, hasDeadline}.
+  JobRequest64 request{84, startMs + 40ull * 24u * 3600u * 1000u, true};
+  TEST_ASSERT_EQUAL_UINT32(84u, request.requestId);
+  st = device.requestMeasurement(request);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  PollJobResult result;
+  st = runPreciseJobToTerminal(device, ctx, result);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_EQUAL(JobOutcome::SUCCEEDED, result.outcome);
+  TEST_ASSERT_EQUAL_UINT32(6u, ctx.msWraps);
+  TEST_ASSERT_TRUE(device.sampleTimestampMs64() == preciseTimingNowMs64(&ctx));
+  TEST_ASSERT_TRUE(device.sampleTimestampMs64() > startMs);
+  TEST_ASSERT_TRUE(device.sampleAgeMs64(device.sampleTimestampMs64() + 7u) == 7u);
+  TEST_ASSERT_TRUE(device.sampleAgeMs64(startMs) == 0u);
+
+  const uint32_t ioBefore = ctx.writes + ctx.reads;
+  request.requestId = 85;
+  request.deadlineMs = startMs;
+  st = device.requestEnsureIdle(request);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_EQUAL(Err::TIMEOUT, st.code);
+  TEST_ASSERT_EQUAL(JobOutcome::TIMED_OUT, result.outcome);
+  TEST_ASSERT_EQUAL_UINT32(85u, result.requestId);
+  TEST_ASSERT_EQUAL_UINT32(ioBefore, ctx.writes + ctx.reads);
+}
+
+void test_32bit_clock_extends_sample_timestamps_across_wrap() {
+  PreciseTimingTransport ctx;
+  ctx.nowMs = 0xFFFFFFF8u;
+  ctx.rawTemperature = 0x6666;
+  ctx.rawHumidity = 0x8000;
+  SHT3xDevice device;
+  Status st = device.bind(makePreciseTimingConfig(ctx));
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_TRUE(device.toTimeMs64(ctx.nowMs) == 0xFFFFFFF8ull);
+  TEST_ASSERT_TRUE(device.sampleTimestampMs64() == 0u);
+
+  JobRequest request;
+  request.requestId = 86;
+  request.hasDeadline = true;
+  request.deadlineMs = ctx.nowMs + 1000u;
+  st = device.requestMeasurement(request);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  PollJobResult result;
+  st = runPreciseJobToTerminal(device, ctx, result);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_EQUAL_UINT32(1u, ctx.msWraps);
+  TEST_ASSERT_TRUE(device.sampleTimestampMs64() == (0x100000000ull | ctx.nowMs));
+  TEST_ASSERT_EQUAL_UINT32(ctx.nowMs, device.sampleTimestampMs());
+  TEST_ASSERT_TRUE(device.toTimeMs64(0xFFFFFFF0u) == 0xFFFFFFF0ull);
+  TEST_ASSERT_TRUE(device.toTimeMs64(ctx.nowMs + 100u) == (0x100000000ull | (ctx.nowMs + 100u)));
+}
 
+void test_deadline_admission_rejects_infeasible_jobs_without_i2c() {
   {
     PreciseTimingTransport ctx;
-    ctx.nowMs = 0xFFFFFFF0u;
-    ctx.nowUs = 1000;
+    ctx.nowMs = 1000;
+    ctx.nowUs = 1000000;
+    Config cfg = makePreciseTimingConfig(ctx);
+    cfg.rejectInfeasibleDeadlines = true;
+    cfg.transferBudgetUs = 400;
     SHT3xDevice device;
-    Status st = device.bind(makePreciseTimingConfig(ctx));
+    Status st = device.bind(cfg);
     TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
 
+    const uint32_t minimumUs = device.minimumCompletionUs(JobType::MEASUREMENT);
+    TEST_ASSERT_EQUAL_UINT32(device.estimateMeasurementTimeMs() * 1000u + 800u, minimumUs);
+    const uint32_t minimumMs = minimumUs / 1000u;
+
     JobRequest request;
-    request.requestId = 52;
+    request.requestId = 91;
     request.hasDeadline = true;
-    request.deadlineMs = 5u;
+    request.deadlineMs = ctx.nowMs + minimumMs;
     st = device.requestMeasurement(request);
-    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    PollJobResult result;
-    st = device.pollJob(ctx.nowMs, 0, result);
-    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    TEST_ASSERT_TRUE(result.active);
-    ctx.nowMs = 4u;
-    st = device.pollJob(ctx.nowMs, 0, result);
-    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    TEST_ASSERT_TRUE(result.active);
-    TEST_ASSERT_EQUAL_UINT32(0u, ctx.writes + ctx.reads);
-    ctx.nowMs = 5u;
-    st = device.pollJob(ctx.nowMs, 1, result);
-    TEST_ASSERT_EQUAL(Err::TIMEOUT, st.code);
-    TEST_ASSERT_TRUE(result.terminal);
-    TEST_ASSERT_EQUAL_UINT32(52u, result.requestId);
-    TEST_ASSERT_EQUAL(JobOutcome::TIMED_OUT, result.outcome);
-    TEST_ASSERT_EQUAL_UINT8(0u, result.instructionsUsed);
+    TEST_ASSERT_EQUAL(Err::DEADLINE_INFEASIBLE, st.code);
+    TEST_ASSERT_EQUAL_INT32(static_cast<int32_t>(minimumMs), st.detail);
+    TEST_ASSERT_FALSE(device._jobActive());
     TEST_ASSERT_EQUAL_UINT32(0u, ctx.writes + ctx.reads);
-  }
 
-  {
-    PreciseTimingTransport ctx;
-    ctx.nowMs = 200;
-    ctx.nowUs = 200000;
-    ctx.writeAdvanceMs = 6;
-    ctx.writeAdvanceUs = 6000;
-    SHT3xDevice device;
-    Status st = device.bind(makePreciseTimingConfig(ctx));
-    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-
-    JobRequest request;
-    request.requestId = 53;
-    request.hasDeadline = true;
-    request.deadlineMs = 205;
+    // One millisecond more is feasible and the job does meet it.
+    request.deadlineMs = ctx.nowMs + minimumMs + 1u;
     st = device.requestMeasurement(request);
     TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
     PollJobResult result;
-    st = device.pollJob(200u, 1, result);
-    TEST_ASSERT_EQUAL(Err::TIMEOUT, st.code);
-    TEST_ASSERT_TRUE(result.terminal);
-    TEST_ASSERT_EQUAL_UINT32(53u, result.requestId);
-    TEST_ASSERT_EQUAL(JobPhase::SINGLE_SHOT_CONVERSION, result.phase);
-    TEST_ASSERT_EQUAL(JobOutcome::TIMED_OUT, result.outcome);
-    TEST_ASSERT_EQUAL(JobEffect::RESULT_MAY_BE_PENDING, result.effect);
-    TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
-    TEST_ASSERT_EQUAL_UINT32(1u, ctx.writes);
-    TEST_ASSERT_EQUAL_UINT32(0u, ctx.reads);
+    st = runPreciseJobToTerminal(device, ctx, result);
+    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+    TEST_ASSERT_EQUAL_UINT32(91u, result.requestId);
+
+    // Right after the read tIDLE is still pending for ensure-idle.
+    const uint32_t ioBefore = ctx.writes + ctx.reads;
+    const uint32_t idleMinimumUs = device.minimumCompletionUs(JobType::ENSURE_IDLE);
+    TEST_ASSERT_TRUE(idleMinimumUs >= 4u * 400u + 1000u + 2000u + 1000u);
+    request.requestId = 92;
+    request.deadlineMs = ctx.nowMs + 2u;
+    st = device.requestEnsureIdle(request);
+    TEST_ASSERT_EQUAL(Err::DEADLINE_INFEASIBLE, st.code);
+    TEST_ASSERT_EQUAL_UINT32(ioBefore, ctx.writes + ctx.reads);
+    request.hasDeadline = false;
+    st = device.requestEnsureIdle(request);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
   }
 
   {
     PreciseTimingTransport ctx;
-    ctx.nowMs = 300;
-    ctx.nowUs = 300000;
-    ctx.rawTemperature = 0x1111;
-    ctx.rawHumidity = 0x2222;
+    ctx.nowMs = 5000;
+    ctx.nowUs = 5000000;
     SHT3xDevice device;
-    Status st = device.begin(makePreciseTimingConfig(ctx));
-    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-    TEST_ASSERT_TRUE(device.hardwareStateValid());
-
-    JobRequest initial;
-    initial.requestId = 54;
-    st = device.requestMeasurement(initial);
-    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    PollJobResult result;
-    st = device.pollJob(ctx.nowMs, 1, result);
-    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    ctx.nowMs = device._measurementReadyMs;
-    ctx.nowUs = ctx.nowMs * 1000u;
-    st = device.pollJob(ctx.nowMs, 1, result);
-    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-    RawSample previous;
-    st = device.getRawSample(previous);
-    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+    preparePreciseTimingDevice(device, ctx, Mode::PERIODIC);
+    device._periodMs = 1000;
+    device._config.rejectInfeasibleDeadlines = true;
+    device._config.transferBudgetUs = 0;
+    // First periodic sample: conversion estimate plus the fetch margin.
+    const uint32_t readyMs = device._periodicReadyMs(ctx.nowMs) - ctx.nowMs;
+    TEST_ASSERT_TRUE(readyMs > device.estimateMeasurementTimeMs());
+    TEST_ASSERT_EQUAL_UINT32(readyMs * 1000u + 1000u,
+                             device.minimumCompletionUs(JobType::MEASUREMENT));
 
-    ctx.rawTemperature = 0xAAAA;
-    ctx.rawHumidity = 0xBBBB;
-    ctx.readAdvanceMs = 6;
-    ctx.readAdvanceUs = 6000;
-    JobRequest late;
-    late.requestId = 55;
-    late.hasDeadline = true;
-    late.deadlineMs = ctx.nowMs + device.estimateMeasurementTimeMs() + 5u;
-    st = device.requestMeasurement(late);
-    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    st = device.pollJob(ctx.nowMs, 1, result);
+    JobRequest request;
+    request.requestId = 93;
+    request.hasDeadline = true;
+    request.deadlineMs = ctx.nowMs + readyMs;
+    Status st = device.requestContinuous(request);
+    TEST_ASSERT_EQUAL(Err::DEADLINE_INFEASIBLE, st.code);
+    TEST_ASSERT_FALSE(device._jobActive());
+
+    // Admission is opt-in: the same request is accepted and times out later.
+    device._config.rejectInfeasibleDeadlines = false;
+    st = device.requestContinuous(request);
     TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    ctx.nowMs = device._measurementReadyMs;
-    ctx.nowUs = ctx.nowMs * 1000u;
-    st = device.pollJob(ctx.nowMs, 1, result);
-    TEST_ASSERT_EQUAL(Err::TIMEOUT, st.code);
-    TEST_ASSERT_TRUE(result.terminal);
-    TEST_ASSERT_EQUAL_UINT32(55u, result.requestId);
-    TEST_ASSERT_EQUAL(JobPhase::SINGLE_SHOT_READ, result.phase);
-    TEST_ASSERT_EQUAL(JobOutcome::TIMED_OUT, result.outcome);
-    TEST_ASSERT_EQUAL(JobEffect::NONE, result.effect);
-    TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
-    TEST_ASSERT_TRUE(device.hardwareStateValid());
-
-    RawSample afterLateRead;
-    st = device.getRawSample(afterLateRead);
-    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-    TEST_ASSERT_EQUAL_HEX16(previous.rawTemperature, afterLateRead.rawTemperature);
-    TEST_ASSERT_EQUAL_HEX16(previous.rawHumidity, afterLateRead.rawHumidity);
+    TEST_ASSERT_EQUAL_UINT32(0u, ctx.writes + ctx.reads);
   }
 }
 
-void test_periodic_not_ready_callback_crossing_deadline_terminates_once() {
+void test_job_queue_runs_requests_back_to_back_with_own_identity() {
   PreciseTimingTransport ctx;
-  ctx.nowMs = 100u;
-  ctx.nowUs = 100000u;
-  ctx.readAdvanceMs = 2u;
-  ctx.readAdvanceUs = 2000u;
-  ctx.readStatus = Status::Error(Err::I2C_NACK_READ, "frame not ready");
+  ctx.nowMs = 2000;
+  ctx.nowUs = 2000000;
+  ctx.rawTemperature = 0x6666;
+  ctx.rawHumidity = 0x8000;
   Config cfg = makePreciseTimingConfig(ctx);
-  cfg.transportCapabilities = TransportCapability::READ_HEADER_NACK;
+  cfg.jobQueueDepth = 3;
   SHT3xDevice device;
   Status st = device.bind(cfg);
   TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  device._mode = Mode::PERIODIC;
-  device._periodicActive = true;
-  device._periodMs = 0u;
-  device._periodicStartMs = ctx.nowMs;
-  device._hardwareStateValid = true;
 
   JobRequest request;
-  request.requestId = 407;
+  request.requestId = 1;
+  st = device.requestMeasurement(request);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  request.requestId = 2;
+  st = device.requestEnsureIdle(request);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  TEST_ASSERT_EQUAL_INT32(1, st.detail);
+  request.requestId = 3;
   request.hasDeadline = true;
-  request.deadlineMs = 102u;
+  request.deadlineMs = ctx.nowMs + 5u;  // Expires while queued.
+  st = device.requestMeasurement(request);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  request.requestId = 4;
+  request.hasDeadline = false;
   st = device.requestMeasurement(request);
   TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  request.requestId = 5;
+  st = device.requestMeasurement(request);
+  TEST_ASSERT_EQUAL(Err::BUSY, st.code);
+  TEST_ASSERT_EQUAL_UINT32(3u, device.queuedJobs());
+  TEST_ASSERT_EQUAL_UINT32(0u, ctx.writes + ctx.reads);
+
+  TEST_ASSERT_EQUAL(Err::MEASUREMENT_NOT_READY, device.cancelQueuedJob(99).code);
+  TEST_ASSERT_TRUE(device.cancelQueuedJob(4).ok());
+  TEST_ASSERT_EQUAL_UINT32(2u, device.queuedJobs());
+
   PollJobResult result;
+  st = runPreciseJobToTerminal(device, ctx, result);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_TRUE(result.terminal);
+  TEST_ASSERT_EQUAL_UINT32(1u, result.requestId);
+  TEST_ASSERT_EQUAL(JobType::MEASUREMENT, result.type);
+
+  // The next poll starts the queued ensure-idle job and spends its budget.
+  const uint32_t writesBefore = ctx.writes;
   st = device.pollJob(ctx.nowMs, 1, result);
   TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  TEST_ASSERT_EQUAL(JobPhase::PERIODIC_READ, device._measurementPhase);
-  advancePreciseTimeMs(ctx, 1u);
+  TEST_ASSERT_EQUAL_UINT32(2u, result.requestId);
+  TEST_ASSERT_EQUAL(JobType::ENSURE_IDLE, result.type);
+  TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
+  TEST_ASSERT_EQUAL_UINT32(writesBefore + 1u, ctx.writes);
+  TEST_ASSERT_EQUAL_UINT32(1u, device.queuedJobs());
+  st = runPreciseJobToTerminal(device, ctx, result);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_TRUE(result.terminal);
+  TEST_ASSERT_EQUAL_UINT32(2u, result.requestId);
+
+  // Job 3's own deadline ran out while it waited; it ends without I2C.
+  const uint32_t ioBefore = ctx.writes + ctx.reads;
   st = device.pollJob(ctx.nowMs, 1, result);
   TEST_ASSERT_EQUAL(Err::TIMEOUT, st.code);
   TEST_ASSERT_TRUE(result.terminal);
-  TEST_ASSERT_EQUAL_UINT32(407u, result.requestId);
-  TEST_ASSERT_EQUAL(JobPhase::PERIODIC_READ, result.phase);
+  TEST_ASSERT_EQUAL_UINT32(3u, result.requestId);
   TEST_ASSERT_EQUAL(JobOutcome::TIMED_OUT, result.outcome);
-  TEST_ASSERT_EQUAL(JobEffect::NONE, result.effect);
-  TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
-  TEST_ASSERT_EQUAL_UINT32(1u, device.totalNotReady());
-  TEST_ASSERT_TRUE(device.hardwareStateValid());
+  TEST_ASSERT_EQUAL_UINT32(ioBefore, ctx.writes + ctx.reads);
+  TEST_ASSERT_EQUAL_UINT32(0u, device.queuedJobs());
 
-  const uint32_t callbacks = ctx.writes + ctx.reads;
   st = device.pollJob(ctx.nowMs, 1, result);
-  TEST_ASSERT_EQUAL(Err::TIMEOUT, st.code);
+  TEST_ASSERT_FALSE(result.active);
   TEST_ASSERT_FALSE(result.terminal);
   TEST_ASSERT_EQUAL_UINT32(0u, result.requestId);
-  TEST_ASSERT_EQUAL_UINT32(callbacks, ctx.writes + ctx.reads);
 }
 
-void test_request_ensure_idle_is_staged_and_one_callback_bounded() {
+void test_job_queue_reports_unstartable_jobs_and_rejects_behind_continuous() {
   PreciseTimingTransport ctx;
-  ctx.nowMs = 400;
-  ctx.nowUs = 400000;
+  ctx.nowMs = 3000;
+  ctx.nowUs = 3000000;
   SHT3xDevice device;
-  Status st = device.bind(makePreciseTimingConfig(ctx));
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  preparePreciseTimingDevice(device, ctx, Mode::PERIODIC);
+  device._periodMs = 1000;
+  device._config.jobQueueDepth = JOB_QUEUE_CAPACITY;
 
   JobRequest request;
-  request.requestId = 61;
-  st = device.requestEnsureIdle(request);
+  request.requestId = 10;
+  Status st = device.requestContinuous(request);
   TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  TEST_ASSERT_EQUAL_UINT32(0u, ctx.writes + ctx.reads);
-
-  PeriodicRate originalRate = PeriodicRate::MPS_10;
-  st = device.getPeriodicRate(originalRate);
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  st = device.setPeriodicRate(PeriodicRate::MPS_4);
+  request.requestId = 11;
+  st = device.requestEnsureIdle(request);
   TEST_ASSERT_EQUAL(Err::BUSY, st.code);
-  PeriodicRate retainedRate = PeriodicRate::MPS_10;
-  st = device.getPeriodicRate(retainedRate);
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  TEST_ASSERT_EQUAL(originalRate, retainedRate);
-  TEST_ASSERT_EQUAL_UINT32(0u, ctx.writes + ctx.reads);
+  TEST_ASSERT_EQUAL_UINT32(0u, device.queuedJobs());
 
   PollJobResult result;
-  st = device.pollJob(ctx.nowMs, 8, result);
+  st = device.cancelJob(CancelReason::REQUESTED, result);
+  TEST_ASSERT_EQUAL(Err::CANCELLED, st.code);
+  request.requestId = 12;
+  st = device.requestMeasurement(request);
   TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  TEST_ASSERT_EQUAL(JobPhase::ENSURE_BREAK_COMMAND, result.phase);
-  TEST_ASSERT_EQUAL(JobEffect::DEVICE_STATE_CHANGED, result.effect);
-  TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
-  TEST_ASSERT_EQUAL_UINT32(1u, ctx.writes);
-  TEST_ASSERT_EQUAL_UINT32(0u, ctx.reads);
-  TEST_ASSERT_EQUAL_HEX16(cmd::CMD_BREAK, ctx.lastCommand);
+  request.requestId = 13;
+  st = device.requestContinuous(request);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  TEST_ASSERT_EQUAL_UINT32(1u, device.queuedJobs());
+  request.requestId = 14;
+  st = device.requestMeasurement(request);
+  TEST_ASSERT_EQUAL(Err::BUSY, st.code);
 
-  SettingsSnapshot duringEnsure;
-  st = device.getSettings(duringEnsure);
+  // Periodic mode ends before the queued continuous job can start.
+  st = device.cancelJob(CancelReason::REQUESTED, result);
+  TEST_ASSERT_EQUAL_UINT32(12u, result.requestId);
+  device._periodicActive = false;
+  device._mode = Mode::SINGLE_SHOT;
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, st.code);
+  TEST_ASSERT_TRUE(result.terminal);
+  TEST_ASSERT_FALSE(result.active);
+  TEST_ASSERT_EQUAL_UINT32(13u, result.requestId);
+  TEST_ASSERT_EQUAL(JobOutcome::FAILED, result.outcome);
+  TEST_ASSERT_EQUAL_UINT32(0u, ctx.writes + ctx.reads);
+  TEST_ASSERT_EQUAL_UINT32(0u, device.queuedJobs());
+
+  // A deadline that became infeasible while queued ends as TIMED_OUT.
+  device._periodicActive = true;
+  device._mode = Mode::PERIODIC;
+  device._config.rejectInfeasibleDeadlines = true;
+  request.requestId = 15;
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.requestMeasurement(request).code);
+  request.requestId = 16;
+  request.hasDeadline = true;
+  request.deadlineMs = ctx.nowMs + 1000u;
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.requestMeasurement(request).code);
+  TEST_ASSERT_EQUAL_UINT32(1u, device.queuedJobs());
+  st = device.cancelJob(CancelReason::REQUESTED, result);
+  TEST_ASSERT_EQUAL_UINT32(15u, result.requestId);
+  ctx.nowMs += 999u;
+  ctx.nowUs += 999000u;
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_EQUAL(Err::DEADLINE_INFEASIBLE, st.code);
+  TEST_ASSERT_TRUE(result.terminal);
+  TEST_ASSERT_EQUAL_UINT32(16u, result.requestId);
+  TEST_ASSERT_EQUAL(JobOutcome::TIMED_OUT, result.outcome);
+  TEST_ASSERT_EQUAL_UINT32(0u, ctx.writes + ctx.reads);
+
+  // Offline under LATCH_OFFLINE: continuous requests are refused, not queued.
+  request.requestId = 17;
+  request.hasDeadline = false;
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.requestMeasurement(request).code);
+  device._config.healthPolicy = HealthPolicy::LATCH_OFFLINE;
+  device._driverState = DriverState::OFFLINE;
+  request.requestId = 18;
+  st = device.requestContinuous(request);
+  TEST_ASSERT_EQUAL(Err::BUSY, st.code);
+  TEST_ASSERT_EQUAL_STRING("Driver is offline; call recover()", st.msg);
+  TEST_ASSERT_EQUAL_UINT32(0u, device.queuedJobs());
+}
+
+void test_job_queue_blocks_rebind_until_queued_jobs_finish() {
+  PreciseTimingTransport ctx;
+  ctx.nowMs = 4000;
+  ctx.nowUs = 4000000;
+  Config cfg = makePreciseTimingConfig(ctx);
+  cfg.jobQueueDepth = 2;
+  SHT3xDevice device;
+  Status st = device.bind(cfg);
   TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  TEST_ASSERT_FALSE(duringEnsure.measurementPending);
-  TEST_ASSERT_FALSE(duringEnsure.measurementReady);
-  TEST_ASSERT_EQUAL_UINT32(0u, duringEnsure.measurementReadyMs);
 
-  st = device.pollJob(ctx.nowMs, 8, result);
+  JobRequest request;
+  request.requestId = 20;
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.requestMeasurement(request).code);
+  request.requestId = 21;
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.requestMeasurement(request).code);
+  PollJobResult result;
+  st = runPreciseJobToTerminal(device, ctx, result);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_EQUAL_UINT32(20u, result.requestId);
+
+  // Between job 20's terminal result and the next poll no job is active, but
+  // job 21 still waits for its own result: rebinding must not drop it.
+  st = device.bind(cfg);
+  TEST_ASSERT_EQUAL(Err::BUSY, st.code);
+  TEST_ASSERT_EQUAL_INT32(1, st.detail);
+  TEST_ASSERT_EQUAL_UINT32(1u, device.queuedJobs());
+  st = runPreciseJobToTerminal(device, ctx, result);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_EQUAL_UINT32(21u, result.requestId);
+  TEST_ASSERT_EQUAL(JobOutcome::SUCCEEDED, result.outcome);
+
+  request.requestId = 22;
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.requestMeasurement(request).code);
+  request.requestId = 23;
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.requestMeasurement(request).code);
+  TEST_ASSERT_EQUAL(Err::CANCELLED, device.cancelJob(CancelReason::REQUESTED, result).code);
+  TEST_ASSERT_EQUAL(Err::BUSY, device.bind(cfg).code);
+  TEST_ASSERT_TRUE(device.cancelQueuedJob(23).ok());
+  st = device.bind(cfg);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+}
+
+void test_end_drops_queued_jobs_without_terminal_results() {
+  PreciseTimingTransport ctx;
+  ctx.nowMs = 5000;
+  ctx.nowUs = 5000000;
+  Config cfg = makePreciseTimingConfig(ctx);
+  cfg.jobQueueDepth = 2;
+  SHT3xDevice device;
+  Status st = device.bind(cfg);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+
+  JobRequest request;
+  request.requestId = 30;
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.requestMeasurement(request).code);
+  request.requestId = 31;
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.requestEnsureIdle(request).code);
+  TEST_ASSERT_EQUAL_UINT32(1u, device.queuedJobs());
+
+  device.end();
+  TEST_ASSERT_EQUAL_UINT32(0u, device.queuedJobs());
+  st = device.bind(cfg);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  const uint32_t ioBefore = ctx.writes + ctx.reads;
+  PollJobResult result;
+  (void)device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_FALSE(result.active);
+  TEST_ASSERT_FALSE(result.terminal);
+  TEST_ASSERT_EQUAL_UINT32(0u, result.requestId);
+  TEST_ASSERT_EQUAL_UINT32(ioBefore, ctx.writes + ctx.reads);
+}
+
+void test_sleep_hook_blocks_synchronous_waits_to_exact_targets() {
+  PreciseTimingTransport ctx;
+  ctx.nowMs = 100;
+  ctx.nowUs = 100000;
+  Config cfg = makePreciseTimingConfig(ctx);
+  cfg.sleepUntilUs = preciseTimingSleepUntilUs;
+  SHT3xDevice device;
+  Status st = device.bind(cfg);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+
+  // tIDLE between the status command and its read: one sleep to the end of
+  // the gap replaces the yield-per-check spin.
+  uint16_t raw = 0;
+  st = device.readStatus(raw);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_EQUAL_UINT32(1u, ctx.sleepCalls);
+  TEST_ASSERT_EQUAL_UINT32(device._lastCommandUs + cfg.commandDelayMs * 1000u,
+                           ctx.lastSleepTargetUs);
+  TEST_ASSERT_EQUAL_UINT32(ctx.lastSleepTargetUs, ctx.nowUs);
+
+  // Settle waits sleep for their full length on the microsecond clock.
+  advancePreciseTimeMs(ctx, 5);
+  ctx.sleepCalls = 0;
+  st = device.softReset();
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_EQUAL_UINT32(1u, ctx.sleepCalls);
+  TEST_ASSERT_EQUAL_UINT32(ctx.nowUs, ctx.lastSleepTargetUs);
+
+  // A hook that never blocks leaves the stall guard in charge.
+  cfg.sleepUntilUs = [](uint32_t, void*) {};
+  device.end();
+  st = device.bind(cfg);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  st = device.readStatus(raw);
+  TEST_ASSERT_EQUAL(Err::TIMEOUT, st.code);
+}
+
+void test_poll_replays_waiting_result_until_wake_or_deadline() {
+  PreciseTimingTransport ctx;
+  ctx.nowMs = 100;
+  ctx.nowUs = 100000;
+  ctx.rawTemperature = 0x6666;
+  ctx.rawHumidity = 0x8000;
+  SHT3xDevice device;
+  Status st = device.bind(makePreciseTimingConfig(ctx));
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_TRUE(device.estimateMeasurementTimeMs() > 4u);
+
+  JobRequest request;
+  request.requestId = 89;
+  request.deadlineMs = ctx.nowMs + 4u;
+  request.hasDeadline = true;
+  st = device.requestMeasurement(request);
   TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  TEST_ASSERT_EQUAL(JobPhase::ENSURE_BREAK_WAIT, result.phase);
-  TEST_ASSERT_EQUAL_UINT8(0u, result.instructionsUsed);
-  TEST_ASSERT_EQUAL_UINT32(1u, ctx.writes + ctx.reads);
+  PollJobResult result;
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  TEST_ASSERT_FALSE(device._pollIdleValid);
 
+  // The first waiting poll runs the phase and caches its result, capped at
+  // the deadline because that comes before the conversion.
   advancePreciseTimeMs(ctx, 1);
-  st = device.pollJob(ctx.nowMs, 8, result);
+  st = device.pollJob(ctx.nowMs, 1, result);
   TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  TEST_ASSERT_EQUAL(JobPhase::ENSURE_BREAK_WAIT, result.phase);
-  TEST_ASSERT_EQUAL_UINT8(0u, result.instructionsUsed);
-  TEST_ASSERT_EQUAL_UINT32(1u, ctx.writes + ctx.reads);
+  TEST_ASSERT_TRUE(device._pollIdleValid);
+  TEST_ASSERT_EQUAL_UINT32(request.deadlineMs, device._pollIdleUntilMs);
 
-  st = device.pollJob(ctx.nowMs, 8, result);
+  ctx.msReads = 0;
+  ctx.usReads = 0;
+  advancePreciseTimeMs(ctx, 2);
+  PollJobResult replay;
+  st = device.pollJob(ctx.nowMs, 1, replay);
   TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  TEST_ASSERT_EQUAL(JobPhase::ENSURE_RESET_COMMAND, result.phase);
-  TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
-  TEST_ASSERT_EQUAL_UINT32(2u, ctx.writes);
-  TEST_ASSERT_EQUAL_HEX16(cmd::CMD_SOFT_RESET, ctx.lastCommand);
+  TEST_ASSERT_EQUAL_STRING("Conversion pending", replay.status.msg);
+  TEST_ASSERT_EQUAL_UINT32(0u, ctx.msReads + ctx.usReads);
+  TEST_ASSERT_TRUE(replay.active);
+  TEST_ASSERT_FALSE(replay.terminal);
+  TEST_ASSERT_EQUAL_UINT8(0u, replay.instructionsUsed);
+  TEST_ASSERT_EQUAL_UINT32(89u, replay.requestId);
+  TEST_ASSERT_EQUAL(JobPhase::SINGLE_SHOT_CONVERSION, replay.phase);
+  TEST_ASSERT_EQUAL(JobOutcome::ACTIVE, replay.outcome);
+  TEST_ASSERT_EQUAL(JobEffect::RESULT_MAY_BE_PENDING, replay.effect);
+
+  // A zero budget still reports exhaustion rather than the cached wait.
+  st = device.pollJob(ctx.nowMs, 0, replay);
+  TEST_ASSERT_EQUAL_STRING("Poll budget exhausted", replay.status.msg);
 
-  st = device.pollJob(ctx.nowMs, 8, result);
+  advancePreciseTimeMs(ctx, 1);
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_EQUAL(Err::TIMEOUT, st.code);
+  TEST_ASSERT_TRUE(result.terminal);
+  TEST_ASSERT_EQUAL(JobOutcome::TIMED_OUT, result.outcome);
+  TEST_ASSERT_FALSE(device._pollIdleValid);
+
+  // Cancelling drops the cache, so a new job in the same phase re-enters it.
+  request.hasDeadline = false;
+  st = device.requestMeasurement(request);
   TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  TEST_ASSERT_EQUAL(JobPhase::ENSURE_RESET_WAIT, result.phase);
-  TEST_ASSERT_EQUAL_UINT8(0u, result.instructionsUsed);
-  TEST_ASSERT_EQUAL_UINT32(2u, ctx.writes + ctx.reads);
+  advancePreciseTimeMs(ctx, 1);
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_TRUE(device._pollIdleValid);
+  TEST_ASSERT_EQUAL_UINT32(device._measurementReadyMs, device._pollIdleUntilMs);
+  st = device.cancelJob(CancelReason::REQUESTED, result);
+  TEST_ASSERT_EQUAL(Err::CANCELLED, st.code);
+  TEST_ASSERT_FALSE(device._pollIdleValid);
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_FALSE(result.active);
+}
 
-  advancePreciseTimeMs(ctx, 2);
-  st = device.pollJob(ctx.nowMs, 8, result);
+void test_poll_with_caller_time_reads_hooks_only_after_transport_callbacks() {
+  PreciseTimingTransport ctx;
+  ctx.nowMs = 100;
+  ctx.nowUs = 100000;
+  ctx.rawTemperature = 0x6666;
+  ctx.rawHumidity = 0x8000;
+  SHT3xDevice device;
+  Status st = device.bind(makePreciseTimingConfig(ctx));
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  JobRequest request;
+  request.requestId = 88;
+  st = device.requestMeasurement(request);
   TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  TEST_ASSERT_EQUAL(JobPhase::ENSURE_RESET_WAIT, result.phase);
-  TEST_ASSERT_EQUAL_UINT8(0u, result.instructionsUsed);
-  TEST_ASSERT_EQUAL_UINT32(2u, ctx.writes + ctx.reads);
 
-  st = device.pollJob(ctx.nowMs, 8, result);
+  // Command step: one read of each clock after the write, none before it.
+  ctx.msReads = 0;
+  ctx.usReads = 0;
+  PollJobResult result;
+  st = device.pollJob(ctx.nowMs, ctx.nowUs, 1, result);
   TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  TEST_ASSERT_EQUAL(JobPhase::ENSURE_STATUS_COMMAND, result.phase);
   TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
-  TEST_ASSERT_EQUAL_UINT32(3u, ctx.writes);
-  TEST_ASSERT_EQUAL_HEX16(cmd::CMD_READ_STATUS, ctx.lastCommand);
+  TEST_ASSERT_EQUAL_UINT32(1u, ctx.msReads);
+  TEST_ASSERT_EQUAL_UINT32(1u, ctx.usReads);
 
-  st = device.pollJob(ctx.nowMs, 8, result);
+  // Waiting steps read no hooks at all.
+  ctx.msReads = 0;
+  ctx.usReads = 0;
+  advancePreciseTimeMs(ctx, 1);
+  st = device.pollJob(ctx.nowMs, ctx.nowUs, 1, result);
   TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  TEST_ASSERT_EQUAL(JobPhase::ENSURE_STATUS_READ, result.phase);
-  TEST_ASSERT_EQUAL_UINT8(0u, result.instructionsUsed);
-  TEST_ASSERT_EQUAL_UINT32(3u, ctx.writes + ctx.reads);
+  TEST_ASSERT_EQUAL_UINT32(0u, ctx.msReads + ctx.usReads);
 
-  advancePreciseTimeMs(ctx, 1);
-  st = device.pollJob(ctx.nowMs, 8, result);
+  // Read step: tIDLE is judged on the caller's microseconds; the completion
+  // stamp and health update share a single millisecond read.
+  advancePreciseTimeMs(ctx, device.estimateMeasurementTimeMs());
+  ctx.msReads = 0;
+  st = device.pollJob(ctx.nowMs, ctx.nowUs, 1, result);
   TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  TEST_ASSERT_TRUE(result.terminal);
-  TEST_ASSERT_FALSE(result.active);
-  TEST_ASSERT_EQUAL_UINT32(61u, result.requestId);
-  TEST_ASSERT_EQUAL(JobType::ENSURE_IDLE, result.type);
-  TEST_ASSERT_EQUAL(JobPhase::ENSURE_STATUS_READ, result.phase);
-  TEST_ASSERT_EQUAL(JobOutcome::SUCCEEDED, result.outcome);
-  TEST_ASSERT_EQUAL(JobEffect::DEVICE_STATE_CHANGED, result.effect);
+  TEST_ASSERT_TRUE(result.completed);
+  TEST_ASSERT_EQUAL_UINT32(1u, ctx.msReads);
+  TEST_ASSERT_EQUAL_UINT32(0u, ctx.usReads);
+  TEST_ASSERT_EQUAL_UINT32(ctx.nowMs, device.sampleTimestampMs());
+
+  // The millisecond-only poll caches too, but must read the µs hook for tIDLE.
+  st = device.requestMeasurement(request);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  advancePreciseTimeMs(ctx, 1);
+  ctx.msReads = 0;
+  ctx.usReads = 0;
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
   TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
-  TEST_ASSERT_EQUAL_UINT32(3u, ctx.writes);
-  TEST_ASSERT_EQUAL_UINT32(1u, ctx.reads);
-  TEST_ASSERT_TRUE(device.hardwareStateValid());
-  TEST_ASSERT_EQUAL(Mode::SINGLE_SHOT, device.getConfig().mode);
+  TEST_ASSERT_EQUAL_UINT32(1u, ctx.msReads);
+  TEST_ASSERT_EQUAL_UINT32(2u, ctx.usReads);
 }
 
-void test_ensure_idle_stage_failures_report_phase_and_effect() {
+void test_job_deadlines_before_work_inside_callback_and_across_wrap() {
   {
     PreciseTimingTransport ctx;
-    ctx.nowMs = 25;
-    ctx.nowUs = 25000;
+    ctx.nowMs = 100;
+    ctx.nowUs = 100000;
     SHT3xDevice device;
     Status st = device.bind(makePreciseTimingConfig(ctx));
     TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+
     JobRequest request;
-    request.requestId = 75;
-    st = device.requestEnsureIdle(request);
+    request.requestId = 51;
+    request.hasDeadline = true;
+    request.deadlineMs = ctx.nowMs;
+    st = device.requestMeasurement(request);
     TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
     PollJobResult result;
     st = device.pollJob(ctx.nowMs, 1, result);
-    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    const uint32_t callbacksAfterBreak = ctx.writes + ctx.reads;
-    st = device.cancelJob(CancelReason::REQUESTED, result);
-    TEST_ASSERT_EQUAL(Err::CANCELLED, st.code);
+    TEST_ASSERT_EQUAL(Err::TIMEOUT, st.code);
     TEST_ASSERT_TRUE(result.terminal);
-    TEST_ASSERT_EQUAL_UINT32(75u, result.requestId);
-    TEST_ASSERT_EQUAL(JobType::ENSURE_IDLE, result.type);
-    TEST_ASSERT_EQUAL(JobPhase::ENSURE_BREAK_WAIT, result.phase);
-    TEST_ASSERT_EQUAL(JobOutcome::CANCELLED, result.outcome);
-    TEST_ASSERT_EQUAL(JobEffect::DEVICE_STATE_CHANGED, result.effect);
-    TEST_ASSERT_EQUAL_UINT32(callbacksAfterBreak, ctx.writes + ctx.reads);
-    st = device.pollJob(ctx.nowMs, 1, result);
-    TEST_ASSERT_EQUAL(Err::MEASUREMENT_NOT_READY, st.code);
-    TEST_ASSERT_FALSE(result.terminal);
-    TEST_ASSERT_EQUAL_UINT32(0u, result.requestId);
-    TEST_ASSERT_EQUAL_UINT32(callbacksAfterBreak, ctx.writes + ctx.reads);
+    TEST_ASSERT_EQUAL_UINT32(51u, result.requestId);
+    TEST_ASSERT_EQUAL(JobPhase::SINGLE_SHOT_COMMAND, result.phase);
+    TEST_ASSERT_EQUAL(JobOutcome::TIMED_OUT, result.outcome);
+    TEST_ASSERT_EQUAL(JobEffect::NONE, result.effect);
+    TEST_ASSERT_EQUAL_UINT8(0u, result.instructionsUsed);
+    TEST_ASSERT_EQUAL_UINT32(0u, ctx.writes + ctx.reads);
   }
 
   {
     PreciseTimingTransport ctx;
-    ctx.nowMs = 50;
-    ctx.nowUs = 50000;
+    ctx.nowMs = 0xFFFFFFF0u;
+    ctx.nowUs = 1000;
     SHT3xDevice device;
     Status st = device.bind(makePreciseTimingConfig(ctx));
     TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+
     JobRequest request;
-    request.requestId = 76;
+    request.requestId = 52;
     request.hasDeadline = true;
-    request.deadlineMs = 51;
-    st = device.requestEnsureIdle(request);
+    request.deadlineMs = 5u;
+    st = device.requestMeasurement(request);
     TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
     PollJobResult result;
-    st = device.pollJob(ctx.nowMs, 1, result);
+    st = device.pollJob(ctx.nowMs, 0, result);
     TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    TEST_ASSERT_EQUAL_UINT32(1u, ctx.writes + ctx.reads);
-    advancePreciseTimeMs(ctx, 1);
+    TEST_ASSERT_TRUE(result.active);
+    ctx.nowMs = 4u;
+    st = device.pollJob(ctx.nowMs, 0, result);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    TEST_ASSERT_TRUE(result.active);
+    TEST_ASSERT_EQUAL_UINT32(0u, ctx.writes + ctx.reads);
+    ctx.nowMs = 5u;
     st = device.pollJob(ctx.nowMs, 1, result);
     TEST_ASSERT_EQUAL(Err::TIMEOUT, st.code);
     TEST_ASSERT_TRUE(result.terminal);
-    TEST_ASSERT_EQUAL_UINT32(76u, result.requestId);
-    TEST_ASSERT_EQUAL(JobType::ENSURE_IDLE, result.type);
-    TEST_ASSERT_EQUAL(JobPhase::ENSURE_BREAK_WAIT, result.phase);
+    TEST_ASSERT_EQUAL_UINT32(52u, result.requestId);
     TEST_ASSERT_EQUAL(JobOutcome::TIMED_OUT, result.outcome);
-    TEST_ASSERT_EQUAL(JobEffect::DEVICE_STATE_CHANGED, result.effect);
     TEST_ASSERT_EQUAL_UINT8(0u, result.instructionsUsed);
-    TEST_ASSERT_EQUAL_UINT32(1u, ctx.writes + ctx.reads);
-    st = device.pollJob(ctx.nowMs, 1, result);
-    TEST_ASSERT_EQUAL(Err::MEASUREMENT_NOT_READY, st.code);
-    TEST_ASSERT_FALSE(result.terminal);
-    TEST_ASSERT_EQUAL_UINT32(0u, result.requestId);
-    TEST_ASSERT_EQUAL_UINT32(1u, ctx.writes + ctx.reads);
+    TEST_ASSERT_EQUAL_UINT32(0u, ctx.writes + ctx.reads);
   }
 
   {
     PreciseTimingTransport ctx;
-    ctx.failCommand = cmd::CMD_BREAK;
-    ctx.failCommandStatus = Status::Error(Err::I2C_TIMEOUT, "break timeout", 1);
+    ctx.nowMs = 200;
+    ctx.nowUs = 200000;
+    ctx.writeAdvanceMs = 6;
+    ctx.writeAdvanceUs = 6000;
     SHT3xDevice device;
     Status st = device.bind(makePreciseTimingConfig(ctx));
     TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+
     JobRequest request;
-    request.requestId = 71;
-    st = device.requestEnsureIdle(request);
+    request.requestId = 53;
+    request.hasDeadline = true;
+    request.deadlineMs = 205;
+    st = device.requestMeasurement(request);
     TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
     PollJobResult result;
-    st = device.pollJob(ctx.nowMs, 1, result);
-    TEST_ASSERT_EQUAL(Err::I2C_TIMEOUT, st.code);
+    st = device.pollJob(200u, 1, result);
+    TEST_ASSERT_EQUAL(Err::TIMEOUT, st.code);
     TEST_ASSERT_TRUE(result.terminal);
-    TEST_ASSERT_EQUAL_UINT32(71u, result.requestId);
-    TEST_ASSERT_EQUAL(JobPhase::ENSURE_BREAK_COMMAND, result.phase);
+    TEST_ASSERT_EQUAL_UINT32(53u, result.requestId);
+    TEST_ASSERT_EQUAL(JobPhase::SINGLE_SHOT_CONVERSION, result.phase);
     TEST_ASSERT_EQUAL(JobOutcome::TIMED_OUT, result.outcome);
-    TEST_ASSERT_EQUAL(JobEffect::DEVICE_STATE_INDETERMINATE, result.effect);
-    TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
-    TEST_ASSERT_EQUAL_UINT32(1u, ctx.writes + ctx.reads);
-
-    ctx.failCommand = 0;
-    request.requestId = 77;
-    st = device.requestEnsureIdle(request);
-    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    st = device.pollJob(ctx.nowMs, 1, result);
-    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    TEST_ASSERT_EQUAL(JobPhase::ENSURE_BREAK_COMMAND, result.phase);
-    TEST_ASSERT_EQUAL_UINT8(0u, result.instructionsUsed);
-    TEST_ASSERT_EQUAL_UINT32(1u, ctx.writes + ctx.reads);
-    advancePreciseTimeMs(ctx, 1);
-    st = device.pollJob(ctx.nowMs, 1, result);
-    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
-    TEST_ASSERT_EQUAL_UINT32(2u, ctx.writes + ctx.reads);
-  }
-
-  {
-    PreciseTimingTransport ctx;
-    ctx.nowMs = 100;
-    ctx.nowUs = 100000;
-    SHT3xDevice device;
-    Status st = device.bind(makePreciseTimingConfig(ctx));
-    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-    JobRequest request;
-    request.requestId = 72;
-    st = device.requestEnsureIdle(request);
-    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    PollJobResult result;
-    st = device.pollJob(ctx.nowMs, 1, result);
-    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    advancePreciseTimeMs(ctx, 1);
-    st = device.pollJob(ctx.nowMs, 1, result);
-    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    ctx.failCommand = cmd::CMD_SOFT_RESET;
-    ctx.failCommandStatus = Status::Error(Err::I2C_NACK_DATA, "reset rejected", 2);
-    st = device.pollJob(ctx.nowMs, 1, result);
-    TEST_ASSERT_EQUAL(Err::I2C_NACK_DATA, st.code);
-    TEST_ASSERT_TRUE(result.terminal);
-    TEST_ASSERT_EQUAL_UINT32(72u, result.requestId);
-    TEST_ASSERT_EQUAL(JobPhase::ENSURE_RESET_COMMAND, result.phase);
-    TEST_ASSERT_EQUAL(JobOutcome::FAILED, result.outcome);
-    TEST_ASSERT_EQUAL(JobEffect::DEVICE_STATE_CHANGED, result.effect);
-    TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
-    TEST_ASSERT_EQUAL_UINT32(2u, ctx.writes + ctx.reads);
-  }
-
-  {
-    PreciseTimingTransport ctx;
-    ctx.nowMs = 200;
-    ctx.nowUs = 200000;
-    SHT3xDevice device;
-    Status st = device.bind(makePreciseTimingConfig(ctx));
-    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-    JobRequest request;
-    request.requestId = 73;
-    st = device.requestEnsureIdle(request);
-    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    PollJobResult result;
-    st = device.pollJob(ctx.nowMs, 1, result);
-    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    advancePreciseTimeMs(ctx, 1);
-    st = device.pollJob(ctx.nowMs, 1, result);
-    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    st = device.pollJob(ctx.nowMs, 1, result);
-    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    advancePreciseTimeMs(ctx, 2);
-    st = device.pollJob(ctx.nowMs, 1, result);
-    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    ctx.failCommand = cmd::CMD_READ_STATUS;
-    ctx.failCommandStatus = Status::Error(Err::I2C_BUS, "status command bus error", 3);
-    st = device.pollJob(ctx.nowMs, 1, result);
-    TEST_ASSERT_EQUAL(Err::I2C_BUS, st.code);
-    TEST_ASSERT_TRUE(result.terminal);
-    TEST_ASSERT_EQUAL_UINT32(73u, result.requestId);
-    TEST_ASSERT_EQUAL(JobPhase::ENSURE_STATUS_COMMAND, result.phase);
-    TEST_ASSERT_EQUAL(JobOutcome::FAILED, result.outcome);
-    TEST_ASSERT_EQUAL(JobEffect::DEVICE_STATE_INDETERMINATE, result.effect);
+    TEST_ASSERT_EQUAL(JobEffect::RESULT_MAY_BE_PENDING, result.effect);
     TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
-    TEST_ASSERT_EQUAL_UINT32(3u, ctx.writes + ctx.reads);
+    TEST_ASSERT_EQUAL_UINT32(1u, ctx.writes);
+    TEST_ASSERT_EQUAL_UINT32(0u, ctx.reads);
   }
 
   {
     PreciseTimingTransport ctx;
     ctx.nowMs = 300;
     ctx.nowUs = 300000;
+    ctx.rawTemperature = 0x1111;
+    ctx.rawHumidity = 0x2222;
     SHT3xDevice device;
-    Status st = device.bind(makePreciseTimingConfig(ctx));
+    Status st = device.begin(makePreciseTimingConfig(ctx));
     TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-    JobRequest request;
-    request.requestId = 74;
-    st = device.requestEnsureIdle(request);
+    TEST_ASSERT_TRUE(device.hardwareStateValid());
+
+    JobRequest initial;
+    initial.requestId = 54;
+    st = device.requestMeasurement(initial);
     TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
     PollJobResult result;
     st = device.pollJob(ctx.nowMs, 1, result);
     TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    advancePreciseTimeMs(ctx, 1);
-    st = device.pollJob(ctx.nowMs, 1, result);
-    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    st = device.pollJob(ctx.nowMs, 1, result);
-    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    advancePreciseTimeMs(ctx, 2);
+    ctx.nowMs = device._measurementReadyMs;
+    ctx.nowUs = ctx.nowMs * 1000u;
     st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+    RawSample previous;
+    st = device.getRawSample(previous);
+    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+
+    ctx.rawTemperature = 0xAAAA;
+    ctx.rawHumidity = 0xBBBB;
+    ctx.readAdvanceMs = 6;
+    ctx.readAdvanceUs = 6000;
+    JobRequest late;
+    late.requestId = 55;
+    late.hasDeadline = true;
+    late.deadlineMs = ctx.nowMs + device.estimateMeasurementTimeMs() + 5u;
+    st = device.requestMeasurement(late);
     TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
     st = device.pollJob(ctx.nowMs, 1, result);
     TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-    advancePreciseTimeMs(ctx, 1);
-    ctx.readStatus = Status::Error(Err::I2C_TIMEOUT, "status read timeout", 4);
+    ctx.nowMs = device._measurementReadyMs;
+    ctx.nowUs = ctx.nowMs * 1000u;
     st = device.pollJob(ctx.nowMs, 1, result);
-    TEST_ASSERT_EQUAL(Err::I2C_TIMEOUT, st.code);
+    TEST_ASSERT_EQUAL(Err::TIMEOUT, st.code);
     TEST_ASSERT_TRUE(result.terminal);
-    TEST_ASSERT_EQUAL_UINT32(74u, result.requestId);
-    TEST_ASSERT_EQUAL(JobPhase::ENSURE_STATUS_READ, result.phase);
+    TEST_ASSERT_EQUAL_UINT32(55u, result.requestId);
+    TEST_ASSERT_EQUAL(JobPhase::SINGLE_SHOT_READ, result.phase);
     TEST_ASSERT_EQUAL(JobOutcome::TIMED_OUT, result.outcome);
-    TEST_ASSERT_EQUAL(JobEffect::DEVICE_STATE_CHANGED, result.effect);
+    TEST_ASSERT_EQUAL(JobEffect::NONE, result.effect);
     TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
-    TEST_ASSERT_EQUAL_UINT32(4u, ctx.writes + ctx.reads);
+    TEST_ASSERT_TRUE(device.hardwareStateValid());
+
+    RawSample afterLateRead;
+    st = device.getRawSample(afterLateRead);
+    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+    TEST_ASSERT_EQUAL_HEX16(previous.rawTemperature, afterLateRead.rawTemperature);
+    TEST_ASSERT_EQUAL_HEX16(previous.rawHumidity, afterLateRead.rawHumidity);
   }
 }
 
-void test_ensure_idle_request_cancel_preserves_unread_sample() {
+void test_periodic_not_ready_callback_crossing_deadline_terminates_once() {
   PreciseTimingTransport ctx;
-  ctx.nowMs = 400u;
-  ctx.nowUs = 400000u;
-  ctx.rawTemperature = 0x1234;
-  ctx.rawHumidity = 0x5678;
+  ctx.nowMs = 100u;
+  ctx.nowUs = 100000u;
+  ctx.readAdvanceMs = 2u;
+  ctx.readAdvanceUs = 2000u;
+  ctx.readStatus = Status::Error(Err::I2C_NACK_READ, "frame not ready");
+  Config cfg = makePreciseTimingConfig(ctx);
+  cfg.transportCapabilities = TransportCapability::READ_HEADER_NACK;
   SHT3xDevice device;
-  Status st = device.begin(makePreciseTimingConfig(ctx));
+  Status st = device.bind(cfg);
   TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  JobRequest measurement;
-  measurement.requestId = 408;
-  st = device.requestMeasurement(measurement);
+  device._mode = Mode::PERIODIC;
+  device._periodicActive = true;
+  device._periodMs = 0u;
+  device._periodicStartMs = ctx.nowMs;
+  device._hardwareStateValid = true;
+
+  JobRequest request;
+  request.requestId = 407;
+  request.hasDeadline = true;
+  request.deadlineMs = 102u;
+  st = device.requestMeasurement(request);
   TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
   PollJobResult result;
   st = device.pollJob(ctx.nowMs, 1, result);
   TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  ctx.nowMs = device._measurementReadyMs;
-  ctx.nowUs += device.estimateMeasurementTimeMs() * 1000u;
+  TEST_ASSERT_EQUAL(JobPhase::PERIODIC_READ, device._measurementPhase);
+  advancePreciseTimeMs(ctx, 1u);
   st = device.pollJob(ctx.nowMs, 1, result);
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  TEST_ASSERT_TRUE(device.measurementReady());
+  TEST_ASSERT_EQUAL(Err::TIMEOUT, st.code);
+  TEST_ASSERT_TRUE(result.terminal);
+  TEST_ASSERT_EQUAL_UINT32(407u, result.requestId);
+  TEST_ASSERT_EQUAL(JobPhase::PERIODIC_READ, result.phase);
+  TEST_ASSERT_EQUAL(JobOutcome::TIMED_OUT, result.outcome);
+  TEST_ASSERT_EQUAL(JobEffect::NONE, result.effect);
+  TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
+  TEST_ASSERT_EQUAL_UINT32(1u, device.totalNotReady());
+  TEST_ASSERT_TRUE(device.hardwareStateValid());
 
-  JobRequest ensure;
-  ensure.requestId = 409;
-  st = device.requestEnsureIdle(ensure);
-  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  TEST_ASSERT_TRUE(device.measurementReady());
   const uint32_t callbacks = ctx.writes + ctx.reads;
-  st = device.cancelJob(CancelReason::REQUESTED, result);
-  TEST_ASSERT_EQUAL(Err::CANCELLED, st.code);
-  TEST_ASSERT_EQUAL(JobEffect::NONE, result.effect);
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_EQUAL(Err::TIMEOUT, st.code);
+  TEST_ASSERT_FALSE(result.terminal);
+  TEST_ASSERT_EQUAL_UINT32(0u, result.requestId);
   TEST_ASSERT_EQUAL_UINT32(callbacks, ctx.writes + ctx.reads);
-  TEST_ASSERT_TRUE(device.measurementReady());
-  TEST_ASSERT_TRUE(device.hardwareStateValid());
+}
 
-  Measurement value{-999.0f, -999.0f};
-  st = device.getMeasurement(value);
+void test_request_ensure_idle_is_staged_and_one_callback_bounded() {
+  PreciseTimingTransport ctx;
+  ctx.nowMs = 400;
+  ctx.nowUs = 400000;
+  SHT3xDevice device;
+  Status st = device.bind(makePreciseTimingConfig(ctx));
   TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  TEST_ASSERT_NOT_EQUAL(-999.0f, value.temperatureC);
-  TEST_ASSERT_NOT_EQUAL(-999.0f, value.humidityPct);
 
-  measurement.requestId = 410;
-  st = device.requestMeasurement(measurement);
-  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  st = device.pollJob(ctx.nowMs, 1, result);
+  JobRequest request;
+  request.requestId = 61;
+  st = device.requestEnsureIdle(request);
   TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  ctx.nowMs = device._measurementReadyMs;
-  ctx.nowUs += device.estimateMeasurementTimeMs() * 1000u;
-  st = device.pollJob(ctx.nowMs, 1, result);
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_EQUAL_UINT32(0u, ctx.writes + ctx.reads);
 
-  SettingsSnapshot beforeBreak;
-  st = device.getSettings(beforeBreak);
+  PeriodicRate originalRate = PeriodicRate::MPS_10;
+  st = device.getPeriodicRate(originalRate);
   TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  TEST_ASSERT_TRUE(beforeBreak.measurementReady);
-  const uint32_t sampleReadyMs = beforeBreak.measurementReadyMs;
+  st = device.setPeriodicRate(PeriodicRate::MPS_4);
+  TEST_ASSERT_EQUAL(Err::BUSY, st.code);
+  PeriodicRate retainedRate = PeriodicRate::MPS_10;
+  st = device.getPeriodicRate(retainedRate);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_EQUAL(originalRate, retainedRate);
+  TEST_ASSERT_EQUAL_UINT32(0u, ctx.writes + ctx.reads);
 
-  ensure.requestId = 411;
-  st = device.requestEnsureIdle(ensure);
-  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  st = device.pollJob(ctx.nowMs, 1, result);
+  PollJobResult result;
+  st = device.pollJob(ctx.nowMs, 8, result);
   TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
   TEST_ASSERT_EQUAL(JobPhase::ENSURE_BREAK_COMMAND, result.phase);
   TEST_ASSERT_EQUAL(JobEffect::DEVICE_STATE_CHANGED, result.effect);
+  TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
+  TEST_ASSERT_EQUAL_UINT32(1u, ctx.writes);
+  TEST_ASSERT_EQUAL_UINT32(0u, ctx.reads);
+  TEST_ASSERT_EQUAL_HEX16(cmd::CMD_BREAK, ctx.lastCommand);
 
-  SettingsSnapshot afterBreak;
-  st = device.getSettings(afterBreak);
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  TEST_ASSERT_TRUE(afterBreak.measurementReady);
-  TEST_ASSERT_EQUAL_UINT32(sampleReadyMs, afterBreak.measurementReadyMs);
-
-  const uint32_t callbacksAfterBreak = ctx.writes + ctx.reads;
-  st = device.cancelJob(CancelReason::REQUESTED, result);
-  TEST_ASSERT_EQUAL(Err::CANCELLED, st.code);
-  TEST_ASSERT_EQUAL(JobEffect::DEVICE_STATE_CHANGED, result.effect);
-  TEST_ASSERT_EQUAL_UINT32(callbacksAfterBreak, ctx.writes + ctx.reads);
-  TEST_ASSERT_TRUE(device.measurementReady());
-  st = device.getSettings(afterBreak);
+  SettingsSnapshot duringEnsure;
+  st = device.getSettings(duringEnsure);
   TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  TEST_ASSERT_EQUAL_UINT32(sampleReadyMs, afterBreak.measurementReadyMs);
+  TEST_ASSERT_FALSE(duringEnsure.measurementPending);
+  TEST_ASSERT_FALSE(duringEnsure.measurementReady);
+  TEST_ASSERT_EQUAL_UINT32(0u, duringEnsure.measurementReadyMs);
 
-  value = Measurement{-999.0f, -999.0f};
-  st = device.getMeasurement(value);
+  st = device.pollJob(ctx.nowMs, 8, result);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  TEST_ASSERT_EQUAL(JobPhase::ENSURE_BREAK_WAIT, result.phase);
+  TEST_ASSERT_EQUAL_UINT8(0u, result.instructionsUsed);
+  TEST_ASSERT_EQUAL_UINT32(1u, ctx.writes + ctx.reads);
+
+  advancePreciseTimeMs(ctx, 1);
+  st = device.pollJob(ctx.nowMs, 8, result);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  TEST_ASSERT_EQUAL(JobPhase::ENSURE_BREAK_WAIT, result.phase);
+  TEST_ASSERT_EQUAL_UINT8(0u, result.instructionsUsed);
+  TEST_ASSERT_EQUAL_UINT32(1u, ctx.writes + ctx.reads);
+
+  st = device.pollJob(ctx.nowMs, 8, result);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  TEST_ASSERT_EQUAL(JobPhase::ENSURE_RESET_COMMAND, result.phase);
+  TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
+  TEST_ASSERT_EQUAL_UINT32(2u, ctx.writes);
+  TEST_ASSERT_EQUAL_HEX16(cmd::CMD_SOFT_RESET, ctx.lastCommand);
+
+  st = device.pollJob(ctx.nowMs, 8, result);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  TEST_ASSERT_EQUAL(JobPhase::ENSURE_RESET_WAIT, result.phase);
+  TEST_ASSERT_EQUAL_UINT8(0u, result.instructionsUsed);
+  TEST_ASSERT_EQUAL_UINT32(2u, ctx.writes + ctx.reads);
+
+  advancePreciseTimeMs(ctx, 2);
+  st = device.pollJob(ctx.nowMs, 8, result);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  TEST_ASSERT_EQUAL(JobPhase::ENSURE_RESET_WAIT, result.phase);
+  TEST_ASSERT_EQUAL_UINT8(0u, result.instructionsUsed);
+  TEST_ASSERT_EQUAL_UINT32(2u, ctx.writes + ctx.reads);
+
+  st = device.pollJob(ctx.nowMs, 8, result);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  TEST_ASSERT_EQUAL(JobPhase::ENSURE_STATUS_COMMAND, result.phase);
+  TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
+  TEST_ASSERT_EQUAL_UINT32(3u, ctx.writes);
+  TEST_ASSERT_EQUAL_HEX16(cmd::CMD_READ_STATUS, ctx.lastCommand);
+
+  st = device.pollJob(ctx.nowMs, 8, result);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  TEST_ASSERT_EQUAL(JobPhase::ENSURE_STATUS_READ, result.phase);
+  TEST_ASSERT_EQUAL_UINT8(0u, result.instructionsUsed);
+  TEST_ASSERT_EQUAL_UINT32(3u, ctx.writes + ctx.reads);
+
+  advancePreciseTimeMs(ctx, 1);
+  st = device.pollJob(ctx.nowMs, 8, result);
   TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  TEST_ASSERT_NOT_EQUAL(-999.0f, value.temperatureC);
-  TEST_ASSERT_NOT_EQUAL(-999.0f, value.humidityPct);
+  TEST_ASSERT_TRUE(result.terminal);
+  TEST_ASSERT_FALSE(result.active);
+  TEST_ASSERT_EQUAL_UINT32(61u, result.requestId);
+  TEST_ASSERT_EQUAL(JobType::ENSURE_IDLE, result.type);
+  TEST_ASSERT_EQUAL(JobPhase::ENSURE_STATUS_READ, result.phase);
+  TEST_ASSERT_EQUAL(JobOutcome::SUCCEEDED, result.outcome);
+  TEST_ASSERT_EQUAL(JobEffect::DEVICE_STATE_CHANGED, result.effect);
+  TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
+  TEST_ASSERT_EQUAL_UINT32(3u, ctx.writes);
+  TEST_ASSERT_EQUAL_UINT32(1u, ctx.reads);
+  TEST_ASSERT_TRUE(device.hardwareStateValid());
+  TEST_ASSERT_EQUAL(Mode::SINGLE_SHOT, device.getConfig().mode);
 }
 
-void test_ensure_idle_status_verification_rejects_crc_and_error_flags() {
-  struct VerificationCase {
-    uint16_t statusRaw;
-    bool corruptCrc;
-    Err expected;
-  };
-  static constexpr VerificationCase cases[] = {
-      {0u, true, Err::CRC_MISMATCH},
-      {cmd::STATUS_WRITE_CRC_ERROR, false, Err::WRITE_CRC_ERROR},
-      {cmd::STATUS_COMMAND_ERROR, false, Err::COMMAND_FAILED},
-  };
-
-  uint32_t requestId = 410u;
-  for (const auto& testCase : cases) {
+void test_ensure_idle_stage_failures_report_phase_and_effect() {
+  {
     PreciseTimingTransport ctx;
-    ctx.nowMs = 500u;
-    ctx.nowUs = 500000u;
-    ctx.statusRaw = testCase.statusRaw;
-    ctx.corruptStatusCrc = testCase.corruptCrc;
+    ctx.nowMs = 25;
+    ctx.nowUs = 25000;
     SHT3xDevice device;
     Status st = device.bind(makePreciseTimingConfig(ctx));
     TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
     JobRequest request;
-    request.requestId = requestId++;
+    request.requestId = 75;
     st = device.requestEnsureIdle(request);
     TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
     PollJobResult result;
-    st = runEnsureIdleToStatusResult(device, ctx, result);
-    TEST_ASSERT_EQUAL(testCase.expected, st.code);
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    const uint32_t callbacksAfterBreak = ctx.writes + ctx.reads;
+    st = device.cancelJob(CancelReason::REQUESTED, result);
+    TEST_ASSERT_EQUAL(Err::CANCELLED, st.code);
     TEST_ASSERT_TRUE(result.terminal);
-    TEST_ASSERT_EQUAL(JobPhase::ENSURE_STATUS_READ, result.phase);
-    TEST_ASSERT_EQUAL(JobOutcome::FAILED, result.outcome);
+    TEST_ASSERT_EQUAL_UINT32(75u, result.requestId);
+    TEST_ASSERT_EQUAL(JobType::ENSURE_IDLE, result.type);
+    TEST_ASSERT_EQUAL(JobPhase::ENSURE_BREAK_WAIT, result.phase);
+    TEST_ASSERT_EQUAL(JobOutcome::CANCELLED, result.outcome);
     TEST_ASSERT_EQUAL(JobEffect::DEVICE_STATE_CHANGED, result.effect);
-    TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
-    TEST_ASSERT_EQUAL_UINT32(1u, device.protocolFailures());
-    TEST_ASSERT_FALSE(device.hardwareStateValid());
+    TEST_ASSERT_EQUAL_UINT32(callbacksAfterBreak, ctx.writes + ctx.reads);
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_EQUAL(Err::MEASUREMENT_NOT_READY, st.code);
+    TEST_ASSERT_FALSE(result.terminal);
+    TEST_ASSERT_EQUAL_UINT32(0u, result.requestId);
+    TEST_ASSERT_EQUAL_UINT32(callbacksAfterBreak, ctx.writes + ctx.reads);
   }
-}
-
-void test_latch_health_counts_status_command_read_as_one_logical_failure() {
-  PreciseTimingTransport ctx;
-  ctx.nowMs = 500;
-  ctx.nowUs = 500000;
-  ctx.readStatus = Status::Error(Err::I2C_TIMEOUT, "status timeout", 9);
-  Config cfg = makePreciseTimingConfig(ctx);
-  cfg.offlineThreshold = 3;
-  cfg.healthPolicy = HealthPolicy::LATCH_OFFLINE;
-  SHT3xDevice device;
-  Status st = device.bind(cfg);
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
 
-  StatusRegister reg;
-  for (uint32_t attempt = 1; attempt <= 3; ++attempt) {
-    st = device.readStatus(reg);
-    TEST_ASSERT_EQUAL(Err::I2C_TIMEOUT, st.code);
-    TEST_ASSERT_EQUAL_UINT32(attempt, device.totalFailures());
-    TEST_ASSERT_EQUAL_UINT8(attempt, device.consecutiveFailures());
-    TEST_ASSERT_EQUAL_UINT32(attempt, device.transportSuccess());
-    TEST_ASSERT_EQUAL_UINT32(attempt, device.transportFailures());
-    TEST_ASSERT_EQUAL_UINT32(0u, device.totalSuccess());
-    TEST_ASSERT_EQUAL(attempt == 3 ? DriverState::OFFLINE : DriverState::DEGRADED,
-                      device.state());
+  {
+    PreciseTimingTransport ctx;
+    ctx.nowMs = 50;
+    ctx.nowUs = 50000;
+    SHT3xDevice device;
+    Status st = device.bind(makePreciseTimingConfig(ctx));
+    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+    JobRequest request;
+    request.requestId = 76;
+    request.hasDeadline = true;
+    request.deadlineMs = 51;
+    st = device.requestEnsureIdle(request);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    PollJobResult result;
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    TEST_ASSERT_EQUAL_UINT32(1u, ctx.writes + ctx.reads);
+    advancePreciseTimeMs(ctx, 1);
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_EQUAL(Err::TIMEOUT, st.code);
+    TEST_ASSERT_TRUE(result.terminal);
+    TEST_ASSERT_EQUAL_UINT32(76u, result.requestId);
+    TEST_ASSERT_EQUAL(JobType::ENSURE_IDLE, result.type);
+    TEST_ASSERT_EQUAL(JobPhase::ENSURE_BREAK_WAIT, result.phase);
+    TEST_ASSERT_EQUAL(JobOutcome::TIMED_OUT, result.outcome);
+    TEST_ASSERT_EQUAL(JobEffect::DEVICE_STATE_CHANGED, result.effect);
+    TEST_ASSERT_EQUAL_UINT8(0u, result.instructionsUsed);
+    TEST_ASSERT_EQUAL_UINT32(1u, ctx.writes + ctx.reads);
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_EQUAL(Err::MEASUREMENT_NOT_READY, st.code);
+    TEST_ASSERT_FALSE(result.terminal);
+    TEST_ASSERT_EQUAL_UINT32(0u, result.requestId);
+    TEST_ASSERT_EQUAL_UINT32(1u, ctx.writes + ctx.reads);
   }
 
-  const uint32_t callbacksAtLatch = ctx.writes + ctx.reads;
-  st = device.readStatus(reg);
-  TEST_ASSERT_EQUAL(Err::BUSY, st.code);
-  TEST_ASSERT_EQUAL_UINT32(callbacksAtLatch, ctx.writes + ctx.reads);
-  TEST_ASSERT_EQUAL_UINT32(3u, device.totalFailures());
-  TEST_ASSERT_EQUAL_UINT8(3u, device.consecutiveFailures());
-  TEST_ASSERT_EQUAL(DriverState::OFFLINE, device.state());
-}
-
-void test_observe_only_health_continues_i2c_and_counters_saturate() {
-  PreciseTimingTransport ctx;
-  ctx.nowMs = 600;
-  ctx.nowUs = 600000;
-  ctx.readStatus = Status::Error(Err::I2C_TIMEOUT, "status timeout", 10);
-  Config cfg = makePreciseTimingConfig(ctx);
-  cfg.offlineThreshold = 1;
-  cfg.healthPolicy = HealthPolicy::OBSERVE_ONLY;
-  SHT3xDevice device;
-  Status st = device.bind(cfg);
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  {
+    PreciseTimingTransport ctx;
+    ctx.failCommand = cmd::CMD_BREAK;
+    ctx.failCommandStatus = Status::Error(Err::I2C_TIMEOUT, "break timeout", 1);
+    SHT3xDevice device;
+    Status st = device.bind(makePreciseTimingConfig(ctx));
+    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+    JobRequest request;
+    request.requestId = 71;
+    st = device.requestEnsureIdle(request);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    PollJobResult result;
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_EQUAL(Err::I2C_TIMEOUT, st.code);
+    TEST_ASSERT_TRUE(result.terminal);
+    TEST_ASSERT_EQUAL_UINT32(71u, result.requestId);
+    TEST_ASSERT_EQUAL(JobPhase::ENSURE_BREAK_COMMAND, result.phase);
+    TEST_ASSERT_EQUAL(JobOutcome::TIMED_OUT, result.outcome);
+    TEST_ASSERT_EQUAL(JobEffect::DEVICE_STATE_INDETERMINATE, result.effect);
+    TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
+    TEST_ASSERT_EQUAL_UINT32(1u, ctx.writes + ctx.reads);
 
-  StatusRegister reg;
-  st = device.readStatus(reg);
-  TEST_ASSERT_EQUAL(Err::I2C_TIMEOUT, st.code);
-  TEST_ASSERT_EQUAL(DriverState::OFFLINE, device.state());
-  TEST_ASSERT_EQUAL_UINT32(1u, ctx.writes);
-  TEST_ASSERT_EQUAL_UINT32(1u, ctx.reads);
+    ctx.failCommand = 0;
+    request.requestId = 77;
+    st = device.requestEnsureIdle(request);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    TEST_ASSERT_EQUAL(JobPhase::ENSURE_BREAK_COMMAND, result.phase);
+    TEST_ASSERT_EQUAL_UINT8(0u, result.instructionsUsed);
+    TEST_ASSERT_EQUAL_UINT32(1u, ctx.writes + ctx.reads);
+    advancePreciseTimeMs(ctx, 1);
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
+    TEST_ASSERT_EQUAL_UINT32(2u, ctx.writes + ctx.reads);
+  }
 
-  device._transportFailures = UINT32_MAX;
-  st = device.readStatus(reg);
-  TEST_ASSERT_EQUAL(Err::I2C_TIMEOUT, st.code);
-  TEST_ASSERT_EQUAL(DriverState::OFFLINE, device.state());
-  TEST_ASSERT_EQUAL_UINT32(2u, ctx.writes);
-  TEST_ASSERT_EQUAL_UINT32(2u, ctx.reads);
-  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, device.transportFailures());
-  TEST_ASSERT_EQUAL_UINT32(2u, device.totalFailures());
+  {
+    PreciseTimingTransport ctx;
+    ctx.nowMs = 100;
+    ctx.nowUs = 100000;
+    SHT3xDevice device;
+    Status st = device.bind(makePreciseTimingConfig(ctx));
+    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+    JobRequest request;
+    request.requestId = 72;
+    st = device.requestEnsureIdle(request);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    PollJobResult result;
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    advancePreciseTimeMs(ctx, 1);
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    ctx.failCommand = cmd::CMD_SOFT_RESET;
+    ctx.failCommandStatus = Status::Error(Err::I2C_NACK_DATA, "reset rejected", 2);
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_EQUAL(Err::I2C_NACK_DATA, st.code);
+    TEST_ASSERT_TRUE(result.terminal);
+    TEST_ASSERT_EQUAL_UINT32(72u, result.requestId);
+    TEST_ASSERT_EQUAL(JobPhase::ENSURE_RESET_COMMAND, result.phase);
+    TEST_ASSERT_EQUAL(JobOutcome::FAILED, result.outcome);
+    TEST_ASSERT_EQUAL(JobEffect::DEVICE_STATE_CHANGED, result.effect);
+    TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
+    TEST_ASSERT_EQUAL_UINT32(2u, ctx.writes + ctx.reads);
+  }
 
-  ctx.readStatus = Status::Ok();
-  st = device.readStatus(reg);
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  TEST_ASSERT_EQUAL_UINT32(3u, ctx.writes);
-  TEST_ASSERT_EQUAL_UINT32(3u, ctx.reads);
-  TEST_ASSERT_EQUAL(DriverState::READY, device.state());
-  TEST_ASSERT_EQUAL_UINT8(0u, device.consecutiveFailures());
-  TEST_ASSERT_EQUAL_UINT32(1u, device.totalSuccess());
-  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, device.transportFailures());
+  {
+    PreciseTimingTransport ctx;
+    ctx.nowMs = 200;
+    ctx.nowUs = 200000;
+    SHT3xDevice device;
+    Status st = device.bind(makePreciseTimingConfig(ctx));
+    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+    JobRequest request;
+    request.requestId = 73;
+    st = device.requestEnsureIdle(request);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    PollJobResult result;
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    advancePreciseTimeMs(ctx, 1);
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    advancePreciseTimeMs(ctx, 2);
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    ctx.failCommand = cmd::CMD_READ_STATUS;
+    ctx.failCommandStatus = Status::Error(Err::I2C_BUS, "status command bus error", 3);
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_EQUAL(Err::I2C_BUS, st.code);
+    TEST_ASSERT_TRUE(result.terminal);
+    TEST_ASSERT_EQUAL_UINT32(73u, result.requestId);
+    TEST_ASSERT_EQUAL(JobPhase::ENSURE_STATUS_COMMAND, result.phase);
+    TEST_ASSERT_EQUAL(JobOutcome::FAILED, result.outcome);
+    TEST_ASSERT_EQUAL(JobEffect::DEVICE_STATE_INDETERMINATE, result.effect);
+    TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
+    TEST_ASSERT_EQUAL_UINT32(3u, ctx.writes + ctx.reads);
+  }
+
+  {
+    PreciseTimingTransport ctx;
+    ctx.nowMs = 300;
+    ctx.nowUs = 300000;
+    SHT3xDevice device;
+    Status st = device.bind(makePreciseTimingConfig(ctx));
+    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+    JobRequest request;
+    request.requestId = 74;
+    st = device.requestEnsureIdle(request);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    PollJobResult result;
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    advancePreciseTimeMs(ctx, 1);
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    advancePreciseTimeMs(ctx, 2);
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    advancePreciseTimeMs(ctx, 1);
+    ctx.readStatus = Status::Error(Err::I2C_TIMEOUT, "status read timeout", 4);
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_EQUAL(Err::I2C_TIMEOUT, st.code);
+    TEST_ASSERT_TRUE(result.terminal);
+    TEST_ASSERT_EQUAL_UINT32(74u, result.requestId);
+    TEST_ASSERT_EQUAL(JobPhase::ENSURE_STATUS_READ, result.phase);
+    TEST_ASSERT_EQUAL(JobOutcome::TIMED_OUT, result.outcome);
+    TEST_ASSERT_EQUAL(JobEffect::DEVICE_STATE_CHANGED, result.effect);
+    TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
+    TEST_ASSERT_EQUAL_UINT32(4u, ctx.writes + ctx.reads);
+  }
 }
 
-void test_observe_only_measurement_hot_return_succeeds_without_rebind() {
+void test_ensure_idle_request_cancel_preserves_unread_sample() {
   PreciseTimingTransport ctx;
-  ctx.nowMs = 700u;
-  ctx.nowUs = 700000u;
-  ctx.readStatus = Status::Error(Err::I2C_NACK_ADDR, "sensor removed", -50);
-  Config cfg = makePreciseTimingConfig(ctx);
-  cfg.healthPolicy = HealthPolicy::OBSERVE_ONLY;
-  cfg.offlineThreshold = 1u;
+  ctx.nowMs = 400u;
+  ctx.nowUs = 400000u;
+  ctx.rawTemperature = 0x1234;
+  ctx.rawHumidity = 0x5678;
   SHT3xDevice device;
-  Status st = device.bind(cfg);
+  Status st = device.begin(makePreciseTimingConfig(ctx));
   TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-
-  JobRequest removed;
-  removed.requestId = 413;
-  st = device.requestMeasurement(removed);
+  JobRequest measurement;
+  measurement.requestId = 408;
+  st = device.requestMeasurement(measurement);
   TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
   PollJobResult result;
   st = device.pollJob(ctx.nowMs, 1, result);
@@ -4105,18 +4504,30 @@ void test_observe_only_measurement_hot_return_succeeds_without_rebind() {
   ctx.nowMs = device._measurementReadyMs;
   ctx.nowUs += device.estimateMeasurementTimeMs() * 1000u;
   st = device.pollJob(ctx.nowMs, 1, result);
-  TEST_ASSERT_EQUAL(Err::I2C_NACK_ADDR, st.code);
-  TEST_ASSERT_TRUE(result.terminal);
-  TEST_ASSERT_EQUAL_UINT32(413u, result.requestId);
-  TEST_ASSERT_EQUAL(DriverState::OFFLINE, device.state());
-  TEST_ASSERT_FALSE(device.hasSample());
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_TRUE(device.measurementReady());
 
-  ctx.readStatus = Status::Ok();
-  ctx.rawTemperature = 0xAAAA;
-  ctx.rawHumidity = 0xBBBB;
-  JobRequest returned;
-  returned.requestId = 414;
-  st = device.requestMeasurement(returned);
+  JobRequest ensure;
+  ensure.requestId = 409;
+  st = device.requestEnsureIdle(ensure);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  TEST_ASSERT_TRUE(device.measurementReady());
+  const uint32_t callbacks = ctx.writes + ctx.reads;
+  st = device.cancelJob(CancelReason::REQUESTED, result);
+  TEST_ASSERT_EQUAL(Err::CANCELLED, st.code);
+  TEST_ASSERT_EQUAL(JobEffect::NONE, result.effect);
+  TEST_ASSERT_EQUAL_UINT32(callbacks, ctx.writes + ctx.reads);
+  TEST_ASSERT_TRUE(device.measurementReady());
+  TEST_ASSERT_TRUE(device.hardwareStateValid());
+
+  Measurement value{-999.0f, -999.0f};
+  st = device.getMeasurement(value);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_NOT_EQUAL(-999.0f, value.temperatureC);
+  TEST_ASSERT_NOT_EQUAL(-999.0f, value.humidityPct);
+
+  measurement.requestId = 410;
+  st = device.requestMeasurement(measurement);
   TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
   st = device.pollJob(ctx.nowMs, 1, result);
   TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
@@ -4124,882 +4535,3317 @@ void test_observe_only_measurement_hot_return_succeeds_without_rebind() {
   ctx.nowUs += device.estimateMeasurementTimeMs() * 1000u;
   st = device.pollJob(ctx.nowMs, 1, result);
   TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  TEST_ASSERT_TRUE(result.terminal);
-  TEST_ASSERT_EQUAL_UINT32(414u, result.requestId);
-  TEST_ASSERT_EQUAL(JobOutcome::SUCCEEDED, result.outcome);
-  TEST_ASSERT_EQUAL(DriverState::READY, device.state());
-  TEST_ASSERT_TRUE(device.hasSample());
-  TEST_ASSERT_EQUAL_UINT32(2u, ctx.writes);
-  TEST_ASSERT_EQUAL_UINT32(2u, ctx.reads);
-  TEST_ASSERT_EQUAL_HEX8(cmd::I2C_ADDR_LOW, ctx.lastAddress);
-  RawSample sample;
-  st = device.getRawSample(sample);
+
+  SettingsSnapshot beforeBreak;
+  st = device.getSettings(beforeBreak);
   TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  TEST_ASSERT_EQUAL_HEX16(0xAAAA, sample.rawTemperature);
-  TEST_ASSERT_EQUAL_HEX16(0xBBBB, sample.rawHumidity);
+  TEST_ASSERT_TRUE(beforeBreak.measurementReady);
+  const uint32_t sampleReadyMs = beforeBreak.measurementReadyMs;
+
+  ensure.requestId = 411;
+  st = device.requestEnsureIdle(ensure);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  TEST_ASSERT_EQUAL(JobPhase::ENSURE_BREAK_COMMAND, result.phase);
+  TEST_ASSERT_EQUAL(JobEffect::DEVICE_STATE_CHANGED, result.effect);
+
+  SettingsSnapshot afterBreak;
+  st = device.getSettings(afterBreak);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_TRUE(afterBreak.measurementReady);
+  TEST_ASSERT_EQUAL_UINT32(sampleReadyMs, afterBreak.measurementReadyMs);
+
+  const uint32_t callbacksAfterBreak = ctx.writes + ctx.reads;
+  st = device.cancelJob(CancelReason::REQUESTED, result);
+  TEST_ASSERT_EQUAL(Err::CANCELLED, st.code);
+  TEST_ASSERT_EQUAL(JobEffect::DEVICE_STATE_CHANGED, result.effect);
+  TEST_ASSERT_EQUAL_UINT32(callbacksAfterBreak, ctx.writes + ctx.reads);
+  TEST_ASSERT_TRUE(device.measurementReady());
+  st = device.getSettings(afterBreak);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_EQUAL_UINT32(sampleReadyMs, afterBreak.measurementReadyMs);
+
+  value = Measurement{-999.0f, -999.0f};
+  st = device.getMeasurement(value);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_NOT_EQUAL(-999.0f, value.temperatureC);
+  TEST_ASSERT_NOT_EQUAL(-999.0f, value.humidityPct);
 }
 
-void test_last_error_message_is_stable_after_transient_callback_buffer_changes() {
+void test_ensure_idle_status_verification_rejects_crc_and_error_flags() {
+  struct VerificationCase {
+    uint16_t statusRaw;
+    bool corruptCrc;
+    Err expected;
+  };
+  static constexpr VerificationCase cases[] = {
+      {0u, true, Err::CRC_MISMATCH},
+      {cmd::STATUS_WRITE_CRC_ERROR, false, Err::WRITE_CRC_ERROR},
+      {cmd::STATUS_COMMAND_ERROR, false, Err::COMMAND_FAILED},
+  };
+
+  uint32_t requestId = 410u;
+  for (const auto& testCase : cases) {
+    PreciseTimingTransport ctx;
+    ctx.nowMs = 500u;
+    ctx.nowUs = 500000u;
+    ctx.statusRaw = testCase.statusRaw;
+    ctx.corruptStatusCrc = testCase.corruptCrc;
+    SHT3xDevice device;
+    Status st = device.bind(makePreciseTimingConfig(ctx));
+    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+    JobRequest request;
+    request.requestId = requestId++;
+    st = device.requestEnsureIdle(request);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    PollJobResult result;
+    st = runEnsureIdleToStatusResult(device, ctx, result);
+    TEST_ASSERT_EQUAL(testCase.expected, st.code);
+    TEST_ASSERT_TRUE(result.terminal);
+    TEST_ASSERT_EQUAL(JobPhase::ENSURE_STATUS_READ, result.phase);
+    TEST_ASSERT_EQUAL(JobOutcome::FAILED, result.outcome);
+    TEST_ASSERT_EQUAL(JobEffect::DEVICE_STATE_CHANGED, result.effect);
+    TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
+    TEST_ASSERT_EQUAL_UINT32(1u, device.protocolFailures());
+    TEST_ASSERT_FALSE(device.hardwareStateValid());
+  }
+}
+
+void test_latch_health_counts_status_command_read_as_one_logical_failure() {
   PreciseTimingTransport ctx;
-  ctx.nowMs = 700;
-  ctx.nowUs = 700000;
-  char transientMessage[] = "temporary callback text";
+  ctx.nowMs = 500;
+  ctx.nowUs = 500000;
+  ctx.readStatus = Status::Error(Err::I2C_TIMEOUT, "status timeout", 9);
+  Config cfg = makePreciseTimingConfig(ctx);
+  cfg.offlineThreshold = 3;
+  cfg.healthPolicy = HealthPolicy::LATCH_OFFLINE;
+  SHT3xDevice device;
+  Status st = device.bind(cfg);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+
+  StatusRegister reg;
+  for (uint32_t attempt = 1; attempt <= 3; ++attempt) {
+    st = device.readStatus(reg);
+    TEST_ASSERT_EQUAL(Err::I2C_TIMEOUT, st.code);
+    TEST_ASSERT_EQUAL_UINT32(attempt, device.totalFailures());
+    TEST_ASSERT_EQUAL_UINT8(attempt, device.consecutiveFailures());
+    TEST_ASSERT_EQUAL_UINT32(attempt, device.transportSuccess());
+    TEST_ASSERT_EQUAL_UINT32(attempt, device.transportFailures());
+    TEST_ASSERT_EQUAL_UINT32(0u, device.totalSuccess());
+    TEST_ASSERT_EQUAL(attempt == 3 ? DriverState::OFFLINE : DriverState::DEGRADED,
+                      device.state());
+  }
+
+  const uint32_t callbacksAtLatch = ctx.writes + ctx.reads;
+  st = device.readStatus(reg);
+  TEST_ASSERT_EQUAL(Err::BUSY, st.code);
+  TEST_ASSERT_EQUAL_UINT32(callbacksAtLatch, ctx.writes + ctx.reads);
+  TEST_ASSERT_EQUAL_UINT32(3u, device.totalFailures());
+  TEST_ASSERT_EQUAL_UINT8(3u, device.consecutiveFailures());
+  TEST_ASSERT_EQUAL(DriverState::OFFLINE, device.state());
+}
+
+void test_observe_only_health_continues_i2c_and_counters_saturate() {
+  PreciseTimingTransport ctx;
+  ctx.nowMs = 600;
+  ctx.nowUs = 600000;
+  ctx.readStatus = Status::Error(Err::I2C_TIMEOUT, "status timeout", 10);
+  Config cfg = makePreciseTimingConfig(ctx);
+  cfg.offlineThreshold = 1;
+  cfg.healthPolicy = HealthPolicy::OBSERVE_ONLY;
+  SHT3xDevice device;
+  Status st = device.bind(cfg);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+
+  StatusRegister reg;
+  st = device.readStatus(reg);
+  TEST_ASSERT_EQUAL(Err::I2C_TIMEOUT, st.code);
+  TEST_ASSERT_EQUAL(DriverState::OFFLINE, device.state());
+  TEST_ASSERT_EQUAL_UINT32(1u, ctx.writes);
+  TEST_ASSERT_EQUAL_UINT32(1u, ctx.reads);
+
+  device._transportFailures = UINT32_MAX;
+  st = device.readStatus(reg);
+  TEST_ASSERT_EQUAL(Err::I2C_TIMEOUT, st.code);
+  TEST_ASSERT_EQUAL(DriverState::OFFLINE, device.state());
+  TEST_ASSERT_EQUAL_UINT32(2u, ctx.writes);
+  TEST_ASSERT_EQUAL_UINT32(2u, ctx.reads);
+  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, device.transportFailures());
+  TEST_ASSERT_EQUAL_UINT32(2u, device.totalFailures());
+
+  ctx.readStatus = Status::Ok();
+  st = device.readStatus(reg);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_EQUAL_UINT32(3u, ctx.writes);
+  TEST_ASSERT_EQUAL_UINT32(3u, ctx.reads);
+  TEST_ASSERT_EQUAL(DriverState::READY, device.state());
+  TEST_ASSERT_EQUAL_UINT8(0u, device.consecutiveFailures());
+  TEST_ASSERT_EQUAL_UINT32(1u, device.totalSuccess());
+  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, device.transportFailures());
+}
+
+void test_observe_only_measurement_hot_return_succeeds_without_rebind() {
+  PreciseTimingTransport ctx;
+  ctx.nowMs = 700u;
+  ctx.nowUs = 700000u;
+  ctx.readStatus = Status::Error(Err::I2C_NACK_ADDR, "sensor removed", -50);
+  Config cfg = makePreciseTimingConfig(ctx);
+  cfg.healthPolicy = HealthPolicy::OBSERVE_ONLY;
+  cfg.offlineThreshold = 1u;
+  SHT3xDevice device;
+  Status st = device.bind(cfg);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+
+  JobRequest removed;
+  removed.requestId = 413;
+  st = device.requestMeasurement(removed);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  PollJobResult result;
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  ctx.nowMs = device._measurementReadyMs;
+  ctx.nowUs += device.estimateMeasurementTimeMs() * 1000u;
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_EQUAL(Err::I2C_NACK_ADDR, st.code);
+  TEST_ASSERT_TRUE(result.terminal);
+  TEST_ASSERT_EQUAL_UINT32(413u, result.requestId);
+  TEST_ASSERT_EQUAL(DriverState::OFFLINE, device.state());
+  TEST_ASSERT_FALSE(device.hasSample());
+
+  ctx.readStatus = Status::Ok();
+  ctx.rawTemperature = 0xAAAA;
+  ctx.rawHumidity = 0xBBBB;
+  JobRequest returned;
+  returned.requestId = 414;
+  st = device.requestMeasurement(returned);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  ctx.nowMs = device._measurementReadyMs;
+  ctx.nowUs += device.estimateMeasurementTimeMs() * 1000u;
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_TRUE(result.terminal);
+  TEST_ASSERT_EQUAL_UINT32(414u, result.requestId);
+  TEST_ASSERT_EQUAL(JobOutcome::SUCCEEDED, result.outcome);
+  TEST_ASSERT_EQUAL(DriverState::READY, device.state());
+  TEST_ASSERT_TRUE(device.hasSample());
+  TEST_ASSERT_EQUAL_UINT32(2u, ctx.writes);
+  TEST_ASSERT_EQUAL_UINT32(2u, ctx.reads);
+  TEST_ASSERT_EQUAL_HEX8(cmd::I2C_ADDR_LOW, ctx.lastAddress);
+  RawSample sample;
+  st = device.getRawSample(sample);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_EQUAL_HEX16(0xAAAA, sample.rawTemperature);
+  TEST_ASSERT_EQUAL_HEX16(0xBBBB, sample.rawHumidity);
+}
+
+void test_last_error_message_is_stable_after_transient_callback_buffer_changes() {
+  PreciseTimingTransport ctx;
+  ctx.nowMs = 700;
+  ctx.nowUs = 700000;
+  char transientMessage[] = "temporary callback text";
   ctx.readStatus = Status::Error(Err::I2C_TIMEOUT, transientMessage, -17);
   SHT3xDevice device;
   Status st = device.bind(makePreciseTimingConfig(ctx));
   TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
 
-  StatusRegister reg;
-  st = device.readStatus(reg);
-  TEST_ASSERT_EQUAL(Err::I2C_TIMEOUT, st.code);
-  transientMessage[0] = 'X';
+  StatusRegister reg;
+  st = device.readStatus(reg);
+  TEST_ASSERT_EQUAL(Err::I2C_TIMEOUT, st.code);
+  transientMessage[0] = 'X';
+
+  const Status cached = device.lastError();
+  TEST_ASSERT_EQUAL(Err::I2C_TIMEOUT, cached.code);
+  TEST_ASSERT_EQUAL_INT32(-17, cached.detail);
+  TEST_ASSERT_EQUAL_STRING("I2C timeout", cached.msg);
+}
+
+void test_humidity_crc_failure_does_not_publish_new_frame() {
+  PreciseTimingTransport ctx;
+  ctx.nowMs = 800;
+  ctx.nowUs = 800000;
+  ctx.rawTemperature = 0x1111;
+  ctx.rawHumidity = 0x2222;
+  SHT3xDevice device;
+  Status st = device.begin(makePreciseTimingConfig(ctx));
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_TRUE(device.hardwareStateValid());
+
+  JobRequest good;
+  good.requestId = 81;
+  st = device.requestMeasurement(good);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  PollJobResult result;
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  ctx.nowMs = device._measurementReadyMs;
+  ctx.nowUs = ctx.nowMs * 1000u;
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+
+  RawSample oldSample;
+  st = device.getRawSample(oldSample);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_EQUAL_HEX16(0x1111, oldSample.rawTemperature);
+  TEST_ASSERT_EQUAL_HEX16(0x2222, oldSample.rawHumidity);
+
+  ctx.rawTemperature = 0xAAAA;
+  ctx.rawHumidity = 0xBBBB;
+  ctx.corruptHumidityCrc = true;
+  JobRequest bad;
+  bad.requestId = 82;
+  st = device.requestMeasurement(bad);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  ctx.nowMs = device._measurementReadyMs;
+  ctx.nowUs = ctx.nowMs * 1000u;
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_EQUAL(Err::CRC_MISMATCH, st.code);
+  TEST_ASSERT_EQUAL_STRING("CRC mismatch (humidity)", st.msg);
+  TEST_ASSERT_TRUE(result.terminal);
+  TEST_ASSERT_FALSE(result.completed);
+  TEST_ASSERT_EQUAL_UINT32(82u, result.requestId);
+  TEST_ASSERT_EQUAL(JobPhase::SINGLE_SHOT_READ, result.phase);
+  TEST_ASSERT_EQUAL(JobOutcome::FAILED, result.outcome);
+  TEST_ASSERT_EQUAL(JobEffect::NONE, result.effect);
+  TEST_ASSERT_EQUAL_UINT32(1u, device.protocolFailures());
+  TEST_ASSERT_TRUE(device.hasSample());
+  TEST_ASSERT_FALSE(device.measurementReady());
+  TEST_ASSERT_TRUE(device.hardwareStateValid());
+
+  RawSample afterFailure;
+  st = device.getRawSample(afterFailure);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_EQUAL_HEX16(oldSample.rawTemperature, afterFailure.rawTemperature);
+  TEST_ASSERT_EQUAL_HEX16(oldSample.rawHumidity, afterFailure.rawHumidity);
+
+  device._protocolFailures = UINT32_MAX;
+  bad.requestId = 83;
+  st = device.requestMeasurement(bad);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  ctx.nowMs = device._measurementReadyMs;
+  ctx.nowUs = ctx.nowMs * 1000u;
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_EQUAL(Err::CRC_MISMATCH, st.code);
+  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, device.protocolFailures());
+}
+
+void test_periodic_not_ready_counter_is_separate_and_saturating() {
+  PreciseTimingTransport ctx;
+  ctx.nowMs = 900;
+  ctx.nowUs = 900000;
+  Config cfg = makePreciseTimingConfig(ctx);
+  cfg.transportCapabilities = TransportCapability::READ_HEADER_NACK;
+  SHT3xDevice device;
+  Status st = device.bind(cfg);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  st = device.startPeriodic(PeriodicRate::MPS_1,
+                            Repeatability::HIGH_REPEATABILITY);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+
+  ctx.readStatus = Status::Error(Err::I2C_NACK_READ, "no frame", 23);
+  JobRequest request;
+  request.requestId = 91;
+  st = device.requestMeasurement(request);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  PollJobResult result;
+  ctx.nowMs = device._measurementReadyMs;
+  ctx.nowUs = ctx.nowMs * 1000u;
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  TEST_ASSERT_EQUAL(JobPhase::PERIODIC_FETCH_COMMAND, result.phase);
+  TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
+  advancePreciseTimeMs(ctx, 1);
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  TEST_ASSERT_TRUE(result.active);
+  TEST_ASSERT_FALSE(result.terminal);
+  TEST_ASSERT_EQUAL(JobPhase::PERIODIC_READ, result.phase);
+  TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
+  TEST_ASSERT_EQUAL_UINT32(1u, device.totalNotReady());
+  TEST_ASSERT_EQUAL_UINT32(1u, device.notReadyCount());
+  TEST_ASSERT_EQUAL_UINT32(0u, device.transportFailures());
+  TEST_ASSERT_EQUAL_UINT32(0u, device.protocolFailures());
+
+  device._totalNotReady = UINT32_MAX;
+  ctx.nowMs = device._measurementReadyMs;
+  ctx.nowUs = ctx.nowMs * 1000u;
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
+  advancePreciseTimeMs(ctx, 1);
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, device.totalNotReady());
+  TEST_ASSERT_EQUAL_UINT32(2u, device.notReadyCount());
+  TEST_ASSERT_EQUAL_UINT32(0u, device.transportFailures());
+  TEST_ASSERT_EQUAL_UINT32(0u, device.protocolFailures());
+}
+
+void test_public_status_read_and_clear_are_explicit_operations() {
+  FrameScriptTransport ctx;
+  ctx.statusRaw = static_cast<uint16_t>(cmd::STATUS_HEATER_ON | cmd::STATUS_RESET_DETECTED);
+  SHT3xDevice device;
+  Config cfg = makeFrameConfig(ctx);
+  Status st = device.begin(cfg);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+
+  clearFrameLog(ctx);
+  StatusRegister reg;
+  st = device.readStatus(reg);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_TRUE(reg.heaterOn);
+  TEST_ASSERT_TRUE(reg.resetDetected);
+  TEST_ASSERT_EQUAL(1u, ctx.commandCount);
+  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[0]);
+  TEST_ASSERT_EQUAL_UINT32(1u, ctx.reads);
+
+  clearFrameLog(ctx);
+  st = device.clearStatus();
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_EQUAL(1u, ctx.commandCount);
+  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_CLEAR_STATUS, ctx.commands[0]);
+  TEST_ASSERT_EQUAL_UINT32(0u, ctx.reads);
+}
+
+void test_periodic_start_command_failure_does_not_update_public_mode_or_cache() {
+  FrameScriptTransport ctx;
+  SHT3xDevice device;
+  Config cfg = makeFrameConfig(ctx);
+  Status st = device.begin(cfg);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+
+  const uint16_t startCmd = SHT3xDevice::_commandForPeriodic(
+      Repeatability::MEDIUM_REPEATABILITY, PeriodicRate::MPS_4);
+  ctx.failCommand = startCmd;
+  ctx.failCommandStatus = Status::Error(Err::I2C_NACK_DATA, "periodic start nack", -21);
+  clearFrameLog(ctx);
+
+  st = device.startPeriodic(PeriodicRate::MPS_4, Repeatability::MEDIUM_REPEATABILITY);
+  TEST_ASSERT_EQUAL(Err::I2C_NACK_DATA, st.code);
+  TEST_ASSERT_EQUAL_INT32(-21, st.detail);
+  TEST_ASSERT_FALSE(device.isPeriodicActive());
+  Mode mode = Mode::ART;
+  TEST_ASSERT_TRUE(device.getMode(mode).ok());
+  TEST_ASSERT_EQUAL(Mode::SINGLE_SHOT, mode);
+  CachedSettings cached = device.getCachedSettings();
+  TEST_ASSERT_EQUAL(Mode::SINGLE_SHOT, cached.mode);
+  TEST_ASSERT_EQUAL(1u, ctx.commandCount);
+  TEST_ASSERT_EQUAL_UINT16(startCmd, ctx.commands[0]);
+}
+
+void test_periodic_restart_break_failure_keeps_previous_public_state() {
+  FrameScriptTransport ctx;
+  SHT3xDevice device;
+  Config cfg = makeFrameConfig(ctx);
+  Status st = device.begin(cfg);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  st = device.startPeriodic(PeriodicRate::MPS_1, Repeatability::HIGH_REPEATABILITY);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+
+  ctx.failCommand = cmd::CMD_BREAK;
+  ctx.failCommandStatus = Status::Error(Err::I2C_TIMEOUT, "break timeout", -22);
+  clearFrameLog(ctx);
+
+  st = device.startPeriodic(PeriodicRate::MPS_4, Repeatability::MEDIUM_REPEATABILITY);
+  TEST_ASSERT_EQUAL(Err::I2C_TIMEOUT, st.code);
+  TEST_ASSERT_EQUAL_INT32(-22, st.detail);
+  TEST_ASSERT_TRUE(device.isPeriodicActive());
+  Mode mode = Mode::SINGLE_SHOT;
+  TEST_ASSERT_TRUE(device.getMode(mode).ok());
+  TEST_ASSERT_EQUAL(Mode::PERIODIC, mode);
+  PeriodicRate rate = PeriodicRate::MPS_10;
+  TEST_ASSERT_TRUE(device.getPeriodicRate(rate).ok());
+  TEST_ASSERT_EQUAL(PeriodicRate::MPS_1, rate);
+  TEST_ASSERT_EQUAL(1u, ctx.commandCount);
+  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_BREAK, ctx.commands[0]);
+}
+
+void test_periodic_reconfiguration_start_failure_exposes_stopped_state_and_preserves_cache() {
+  FrameScriptTransport ctx;
+  SHT3xDevice device;
+  Config cfg = makeFrameConfig(ctx);
+  Status st = device.begin(cfg);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  st = device.startPeriodic(PeriodicRate::MPS_1, Repeatability::HIGH_REPEATABILITY);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+
+  const uint16_t restartCmd = SHT3xDevice::_commandForPeriodic(
+      Repeatability::HIGH_REPEATABILITY, PeriodicRate::MPS_4);
+  ctx.failCommand = restartCmd;
+  ctx.failCommandStatus = Status::Error(Err::I2C_NACK_DATA, "restart nack", -26);
+  clearFrameLog(ctx);
+
+  st = device.setPeriodicRate(PeriodicRate::MPS_4);
+  TEST_ASSERT_EQUAL(Err::I2C_NACK_DATA, st.code);
+  TEST_ASSERT_EQUAL_INT32(-26, st.detail);
+  TEST_ASSERT_FALSE(device.isPeriodicActive());
+  Mode mode = Mode::PERIODIC;
+  TEST_ASSERT_TRUE(device.getMode(mode).ok());
+  TEST_ASSERT_EQUAL(Mode::SINGLE_SHOT, mode);
+  PeriodicRate rate = PeriodicRate::MPS_10;
+  TEST_ASSERT_TRUE(device.getPeriodicRate(rate).ok());
+  TEST_ASSERT_EQUAL(PeriodicRate::MPS_1, rate);
+  CachedSettings cached = device.getCachedSettings();
+  TEST_ASSERT_EQUAL(Mode::PERIODIC, cached.mode);
+  TEST_ASSERT_EQUAL(PeriodicRate::MPS_1, cached.periodicRate);
+  TEST_ASSERT_EQUAL(2u, ctx.commandCount);
+  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_BREAK, ctx.commands[0]);
+  TEST_ASSERT_EQUAL_UINT16(restartCmd, ctx.commands[1]);
+}
+
+void test_alert_limit_write_command_failure_does_not_update_cache() {
+  FrameScriptTransport ctx;
+  SHT3xDevice device;
+  Config cfg = makeFrameConfig(ctx);
+  Status st = device.begin(cfg);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+
+  ctx.failCommand = cmd::CMD_ALERT_WRITE_HIGH_SET;
+  ctx.failCommandStatus = Status::Error(Err::I2C_NACK_DATA, "alert write nack", -23);
+  clearFrameLog(ctx);
+
+  st = device.writeAlertLimitRaw(AlertLimitKind::HIGH_SET, 0x2222);
+  TEST_ASSERT_EQUAL(Err::I2C_NACK_DATA, st.code);
+  TEST_ASSERT_EQUAL_INT32(-23, st.detail);
+  CachedSettings cached = device.getCachedSettings();
+  TEST_ASSERT_FALSE(cached.alertValid[static_cast<uint8_t>(AlertLimitKind::HIGH_SET)]);
+  TEST_ASSERT_EQUAL(1u, ctx.commandCount);
+  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_ALERT_WRITE_HIGH_SET, ctx.commands[0]);
+  TEST_ASSERT_EQUAL_UINT32(0u, ctx.reads);
+}
+
+void test_alert_limit_write_status_verification_failure_does_not_update_cache() {
+  FrameScriptTransport ctx;
+  SHT3xDevice device;
+  Config cfg = makeFrameConfig(ctx);
+  Status st = device.begin(cfg);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+
+  ctx.statusRaw = cmd::STATUS_WRITE_CRC_ERROR;
+  clearFrameLog(ctx);
+
+  st = device.writeAlertLimitRaw(AlertLimitKind::HIGH_SET, 0x2222);
+  TEST_ASSERT_EQUAL(Err::WRITE_CRC_ERROR, st.code);
+  TEST_ASSERT_EQUAL_UINT32(1u, device.protocolFailures());
+  CachedSettings cached = device.getCachedSettings();
+  TEST_ASSERT_FALSE(cached.alertValid[static_cast<uint8_t>(AlertLimitKind::HIGH_SET)]);
+  TEST_ASSERT_EQUAL(2u, ctx.commandCount);
+  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_ALERT_WRITE_HIGH_SET, ctx.commands[0]);
+  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[1]);
+  TEST_ASSERT_EQUAL_UINT32(1u, ctx.reads);
+
+  ctx.statusRaw = cmd::STATUS_COMMAND_ERROR;
+  clearFrameLog(ctx);
+  st = device.writeAlertLimitRaw(AlertLimitKind::HIGH_SET, 0x2222);
+  TEST_ASSERT_EQUAL(Err::COMMAND_FAILED, st.code);
+  TEST_ASSERT_EQUAL_UINT32(2u, device.protocolFailures());
+
+  device._protocolFailures = UINT32_MAX;
+  ctx.statusRaw = cmd::STATUS_WRITE_CRC_ERROR;
+  clearFrameLog(ctx);
+  st = device.writeAlertLimitRaw(AlertLimitKind::HIGH_SET, 0x2222);
+  TEST_ASSERT_EQUAL(Err::WRITE_CRC_ERROR, st.code);
+  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, device.protocolFailures());
+}
+
+void test_disable_alerts_second_write_failure_exposes_partial_cache() {
+  FrameScriptTransport ctx;
+  SHT3xDevice device;
+  Config cfg = makeFrameConfig(ctx);
+  Status st = device.begin(cfg);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+
+  ctx.failCommand = cmd::CMD_ALERT_WRITE_LOW_SET;
+  ctx.failCommandStatus = Status::Error(Err::I2C_TIMEOUT, "low set timeout", -27);
+  clearFrameLog(ctx);
+
+  st = device.disableAlerts();
+  TEST_ASSERT_EQUAL(Err::I2C_TIMEOUT, st.code);
+  TEST_ASSERT_EQUAL_INT32(-27, st.detail);
+  CachedSettings cached = device.getCachedSettings();
+  const uint8_t highSet = static_cast<uint8_t>(AlertLimitKind::HIGH_SET);
+  const uint8_t lowSet = static_cast<uint8_t>(AlertLimitKind::LOW_SET);
+  TEST_ASSERT_TRUE(cached.alertValid[highSet]);
+  TEST_ASSERT_EQUAL_UINT16(0x0000, cached.alertRaw[highSet]);
+  TEST_ASSERT_FALSE(cached.alertValid[lowSet]);
+  TEST_ASSERT_EQUAL(3u, ctx.commandCount);
+  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_ALERT_WRITE_HIGH_SET, ctx.commands[0]);
+  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[1]);
+  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_ALERT_WRITE_LOW_SET, ctx.commands[2]);
+  TEST_ASSERT_EQUAL_UINT32(1u, ctx.reads);
+}
+
+void test_public_recover_bus_reset_failure_preserves_precise_status() {
+  FrameScriptTransport ctx;
+  SHT3xDevice device;
+  Config cfg = makeFrameConfig(ctx);
+  cfg.busReset = frameBusResetFail;
+  cfg.recoverUseBusReset = true;
+  cfg.recoverUseSoftReset = false;
+  cfg.recoverUseHardReset = false;
+  Status st = device.begin(cfg);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+
+  ctx.readStatus = Status::Error(Err::I2C_TIMEOUT, "probe timeout", -24);
+  clearFrameLog(ctx);
+
+  st = device.recover();
+  TEST_ASSERT_EQUAL(Err::I2C_BUS, st.code);
+  TEST_ASSERT_EQUAL_INT32(-88, st.detail);
+  TEST_ASSERT_EQUAL(DriverState::DEGRADED, device.state());
+  TEST_ASSERT_EQUAL_UINT32(1u, device.totalFailures());
+  TEST_ASSERT_EQUAL(1u, ctx.commandCount);
+  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[0]);
+  TEST_ASSERT_EQUAL_UINT32(1u, ctx.reads);
+}
+
+void test_recover_unknown_state_requires_reset_proof() {
+  {
+    FrameScriptTransport ctx;
+    SHT3xDevice device;
+    Config cfg = makeFrameConfig(ctx);
+    cfg.recoverUseBusReset = false;
+    cfg.recoverUseSoftReset = true;
+    cfg.recoverUseHardReset = false;
+    cfg.allowGeneralCallReset = false;
+    Status st = device.bind(cfg);
+    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+    TEST_ASSERT_FALSE(device.hardwareStateValid());
+    clearFrameLog(ctx);
+
+    st = device.recover();
+    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+    TEST_ASSERT_TRUE(device.hardwareStateValid());
+    TEST_ASSERT_EQUAL(Mode::SINGLE_SHOT, device._mode);
+    TEST_ASSERT_EQUAL(4u, ctx.commandCount);
+    TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[0]);
+    TEST_ASSERT_EQUAL_UINT16(cmd::CMD_BREAK, ctx.commands[1]);
+    TEST_ASSERT_EQUAL_UINT16(cmd::CMD_SOFT_RESET, ctx.commands[2]);
+    TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[3]);
+    TEST_ASSERT_EQUAL_UINT32(2u, ctx.reads);
+  }
+
+  {
+    FrameScriptTransport ctx;
+    SHT3xDevice device;
+    Config cfg = makeFrameConfig(ctx);
+    cfg.busReset = frameBusResetOk;
+    cfg.recoverUseBusReset = true;
+    cfg.recoverUseSoftReset = false;
+    cfg.recoverUseHardReset = false;
+    cfg.allowGeneralCallReset = false;
+    Status st = device.bind(cfg);
+    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+    clearFrameLog(ctx);
+
+    st = device.recover();
+    TEST_ASSERT_EQUAL(Err::BUSY, st.code);
+    TEST_ASSERT_FALSE(device.hardwareStateValid());
+    TEST_ASSERT_EQUAL(2u, ctx.commandCount);
+    TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[0]);
+    TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[1]);
+    TEST_ASSERT_EQUAL_UINT32(2u, ctx.reads);
+  }
+
+  {
+    FrameScriptTransport ctx;
+    ctx.statusRaw = cmd::STATUS_COMMAND_ERROR;
+    SHT3xDevice device;
+    Config cfg = makeFrameConfig(ctx);
+    cfg.recoverUseBusReset = false;
+    cfg.recoverUseSoftReset = true;
+    cfg.recoverUseHardReset = false;
+    cfg.allowGeneralCallReset = false;
+    Status st = device.bind(cfg);
+    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+    clearFrameLog(ctx);
+
+    st = device.recover();
+    TEST_ASSERT_EQUAL(Err::COMMAND_FAILED, st.code);
+    TEST_ASSERT_FALSE(device.hardwareStateValid());
+    TEST_ASSERT_EQUAL_UINT32(2u, device.protocolFailures());
+    TEST_ASSERT_EQUAL(4u, ctx.commandCount);
+    TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[0]);
+    TEST_ASSERT_EQUAL_UINT16(cmd::CMD_BREAK, ctx.commands[1]);
+    TEST_ASSERT_EQUAL_UINT16(cmd::CMD_SOFT_RESET, ctx.commands[2]);
+    TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[3]);
+    TEST_ASSERT_EQUAL_UINT32(2u, ctx.reads);
+  }
+}
+
+void test_recover_periodic_requires_break_before_success() {
+  FrameScriptTransport ctx;
+  SHT3xDevice device;
+  Config cfg = makeFrameConfig(ctx);
+  cfg.recoverUseBusReset = false;
+  cfg.recoverUseSoftReset = true;
+  cfg.recoverUseHardReset = false;
+  cfg.allowGeneralCallReset = false;
+  Status st = device.begin(cfg);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  st = device.startPeriodic(PeriodicRate::MPS_1, Repeatability::HIGH_REPEATABILITY);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+
+  clearFrameLog(ctx);
+
+  st = device.recover();
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_FALSE(device.isPeriodicActive());
+  TEST_ASSERT_EQUAL(Mode::SINGLE_SHOT, device._mode);
+  TEST_ASSERT_EQUAL(4u, ctx.commandCount);
+  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[0]);
+  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_BREAK, ctx.commands[1]);
+  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_SOFT_RESET, ctx.commands[2]);
+  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[3]);
+  TEST_ASSERT_EQUAL_UINT32(2u, ctx.reads);
+}
+
+void test_stop_periodic_waits_after_break() {
+  FakeTransport bus;
+  SHT3xDevice device;
+  Config cfg = makeConfig(bus);
+  device._config = cfg;
+  device._initialized = true;
+  device._driverState = DriverState::READY;
+  device._periodicActive = true;
+  device._mode = Mode::PERIODIC;
+  device._config.mode = Mode::PERIODIC;
+  device._periodMs = 100;
+  device._lastCommandValid = false;
+  bus.nowMs = 10;
+
+  Status st = device.stopPeriodic();
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_FALSE(device.isPeriodicActive());
+  TEST_ASSERT_TRUE(bus.nowMs >= 11u);
+}
+
+void test_reset_and_restore_partial_alert_restore_failure_preserves_desired_cache() {
+  FrameScriptTransport ctx;
+  SHT3xDevice device;
+  Config cfg = makeFrameConfig(ctx);
+  Status st = device.begin(cfg);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  st = device.setHeater(true);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  st = device.writeAlertLimitRaw(AlertLimitKind::HIGH_SET, 0x2222);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+
+  clearFrameLog(ctx);
+  ctx.failReadIndex = 2;
+  ctx.failReadStatus = Status::Error(Err::I2C_TIMEOUT, "alert verify timeout", -25);
+
+  st = device.resetAndRestore();
+  TEST_ASSERT_EQUAL(Err::I2C_TIMEOUT, st.code);
+  TEST_ASSERT_EQUAL_INT32(-25, st.detail);
+  TEST_ASSERT_TRUE(device.hasCachedSettings());
+  CachedSettings cached = device.getCachedSettings();
+  TEST_ASSERT_TRUE(cached.heaterEnabled);
+  TEST_ASSERT_TRUE(cached.alertValid[static_cast<uint8_t>(AlertLimitKind::HIGH_SET)]);
+  TEST_ASSERT_EQUAL_UINT16(0x2222, cached.alertRaw[static_cast<uint8_t>(AlertLimitKind::HIGH_SET)]);
+  TEST_ASSERT_EQUAL(DriverState::DEGRADED, device.state());
+  TEST_ASSERT_FALSE(device.isPeriodicActive());
+  TEST_ASSERT_EQUAL(4u, ctx.commandCount);
+  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[0]);
+  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_HEATER_ENABLE, ctx.commands[1]);
+  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_ALERT_WRITE_HIGH_SET, ctx.commands[2]);
+  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[3]);
+  TEST_ASSERT_EQUAL_UINT32(2u, ctx.reads);
+}
+
+void test_periodic_fetch_margin_blocks_early_fetch() {
+  CountTransport ctx;
+  SHT3xDevice device;
+  device._config.i2cWrite = countWrite;
+  device._config.i2cWriteRead = countWriteRead;
+  device._config.i2cUser = &ctx;
+  device._config.commandDelayMs = 1;
+  device._config.periodicFetchMarginMs = 0;
+  device._config.transportCapabilities = TransportCapability::NONE;
+  device._initialized = true;
+  device._driverState = DriverState::READY;
+  device._mode = Mode::PERIODIC;
+  device._periodicActive = true;
+  device._periodMs = 100;
+  device._periodicStartMs = 0xFFFFFFF0u;
+  device._lastFetchMs = 0;
+  device._lastFetchValid = true;
+
+  TEST_ASSERT_EQUAL_UINT32(105u, device._periodicReadyMs(1u));
+
+  device._periodicStartMs = 0;
+  device._lastFetchValid = false;
+
+  gMillis = 0;
+  gMicros = 0;
+  gMillisStep = 0;
+  gMicrosStep = 1000;
+
+  Status st = device.requestMeasurement();
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+
+  const uint32_t margin = device._periodicFetchMarginMs();
+  const uint32_t expectedReady =
+      device._periodicStartMs + device.estimateMeasurementTimeMs() + margin;
+  TEST_ASSERT_EQUAL_UINT32(expectedReady, device._measurementReadyMs);
+
+  device.tick(expectedReady - 1);
+  TEST_ASSERT_EQUAL_UINT32(0u, ctx.writes);
+
+  device.tick(expectedReady);
+  TEST_ASSERT_EQUAL_UINT32(1u, ctx.writes);
+}
+
+void test_raw_and_compensated_samples_remain_after_measurement_read() {
+  FakeTransport bus;
+  SHT3xDevice device;
+  Config cfg = makeConfig(bus);
+
+  gMillis = 0;
+  gMicros = 0;
+  gMillisStep = 1;
+  gMicrosStep = 1000;
+
+  Status st = device.begin(cfg);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+
+  RawSample raw;
+  st = device.getRawSample(raw);
+  TEST_ASSERT_EQUAL(Err::MEASUREMENT_NOT_READY, st.code);
+
+  st = device.requestMeasurement();
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  bus.nowMs = device._measurementReadyMs;
+  device.tick(bus.nowMs);
+  bus.nowMs = device._measurementReadyMs;
+  device.tick(bus.nowMs);
+  TEST_ASSERT_TRUE(device.measurementReady());
+
+  Measurement measurement;
+  st = device.getMeasurement(measurement);
+  TEST_ASSERT_TRUE(st.ok());
+  TEST_ASSERT_FALSE(device.measurementReady());
+
+  st = device.getRawSample(raw);
+  TEST_ASSERT_TRUE(st.ok());
+  TEST_ASSERT_EQUAL_UINT16(0u, raw.rawTemperature);
+  TEST_ASSERT_EQUAL_UINT16(0u, raw.rawHumidity);
+
+  CompensatedSample comp;
+  st = device.getCompensatedSample(comp);
+  TEST_ASSERT_TRUE(st.ok());
+  TEST_ASSERT_EQUAL_INT32(-4500, comp.tempC_x100);
+  TEST_ASSERT_EQUAL_UINT32(0u, comp.humidityPct_x100);
+
+  SettingsSnapshot snap;
+  st = device.getSettings(snap);
+  TEST_ASSERT_TRUE(st.ok());
+  TEST_ASSERT_TRUE(snap.hasSample);
+  TEST_ASSERT_FALSE(snap.measurementReady);
+}
+
+void test_zero_timestamp_sample_age_uses_has_sample_flag() {
+  SHT3xDevice device;
+  device._hasSample = false;
+  device._sampleTimestampMs = 0;
+  TEST_ASSERT_EQUAL_UINT32(0u, device.sampleAgeMs(123u));
+
+  device._hasSample = true;
+  TEST_ASSERT_EQUAL_UINT32(123u, device.sampleAgeMs(123u));
+}
+
+void test_offline_request_measurement_does_not_touch_bus_or_schedule() {
+  CountTransport ctx;
+  SHT3xDevice device;
+  device._config.i2cWrite = countWrite;
+  device._config.i2cWriteRead = countWriteRead;
+  device._config.i2cUser = &ctx;
+  device._config.i2cTimeoutMs = 10;
+  installTimingHooks(device);
+  device._initialized = true;
+  device._driverState = DriverState::OFFLINE;
+  device._mode = Mode::SINGLE_SHOT;
+  device._periodicActive = false;
+
+  Status st = device.requestMeasurement();
+  TEST_ASSERT_EQUAL(Err::BUSY, st.code);
+  TEST_ASSERT_EQUAL_STRING("Driver is offline; call recover()", st.msg);
+  TEST_ASSERT_FALSE(device._measurementRequested);
+  TEST_ASSERT_EQUAL_UINT32(0u, ctx.writes);
+  TEST_ASSERT_EQUAL_UINT32(0u, ctx.reads);
+}
+
+void test_recover_transient_failure() {
+  ScriptedTransport ctx;
+  ctx.readScript[0] = Status::Error(Err::I2C_TIMEOUT, "timeout");
+  ctx.readScript[1] = Status::Ok();
+  ctx.readCount = 2;
+
+  auto busReset = [](void* user) -> Status {
+    (void)user;
+    return Status::Ok();
+  };
+
+  SHT3xDevice device;
+  device._config.i2cWrite = scriptedWrite;
+  device._config.i2cWriteRead = scriptedWriteRead;
+  device._config.i2cUser = &ctx;
+  device._config.i2cTimeoutMs = 10;
+  installTimingHooks(device);
+  device._config.recoverBackoffMs = 0;
+  device._config.busReset = busReset;
+  device._config.recoverUseBusReset = true;
+  device._config.recoverUseSoftReset = true;
+  device._initialized = true;
+  device._driverState = DriverState::READY;
+
+  gMillis = 0;
+  gMicros = 0;
+  gMillisStep = 1;
+  gMicrosStep = 1000;
+  Status st = device.recover();
+  TEST_ASSERT_TRUE(st.ok());
+  TEST_ASSERT_EQUAL(Mode::SINGLE_SHOT, device._mode);
+  TEST_ASSERT_FALSE(device._periodicActive);
+}
+
+void test_recover_permanent_offline() {
+  ScriptedTransport ctx;
+  ctx.readScript[0] = Status::Error(Err::I2C_TIMEOUT, "timeout");
+  ctx.readScript[1] = Status::Error(Err::I2C_TIMEOUT, "timeout");
+  ctx.readScript[2] = Status::Error(Err::I2C_TIMEOUT, "timeout");
+  ctx.readCount = 3;
+
+  SHT3xDevice device;
+  device._config.i2cWrite = scriptedWrite;
+  device._config.i2cWriteRead = scriptedWriteRead;
+  device._config.i2cUser = &ctx;
+  device._config.i2cTimeoutMs = 10;
+  installTimingHooks(device);
+  device._config.recoverBackoffMs = 0;
+  device._config.recoverUseBusReset = false;
+  device._config.recoverUseSoftReset = true;
+  device._initialized = true;
+  device._driverState = DriverState::READY;
+
+  gMillis = 0;
+  gMicros = 0;
+  gMillisStep = 1;
+  gMicrosStep = 1000;
+  Status st = device.recover();
+  TEST_ASSERT_FALSE(st.ok());
+  TEST_ASSERT_TRUE(device._consecutiveFailures > 0);
+}
+
+void test_offline_latches_read_status_without_i2c() {
+  CountTransport ctx;
+  SHT3xDevice device;
+  device._config.i2cWrite = countWrite;
+  device._config.i2cWriteRead = countWriteRead;
+  device._config.i2cUser = &ctx;
+  device._config.i2cTimeoutMs = 10;
+  installTimingHooks(device);
+  device._config.offlineThreshold = 1;
+  device._initialized = true;
+  device._driverState = DriverState::READY;
+
+  (void)device._updateHealth(Status::Error(Err::I2C_TIMEOUT, "forced offline"));
+  TEST_ASSERT_EQUAL(DriverState::OFFLINE, device._driverState);
+
+  uint16_t statusRaw = 0;
+  Status st = device.readStatus(statusRaw);
+  TEST_ASSERT_EQUAL(Err::BUSY, st.code);
+  TEST_ASSERT_EQUAL_STRING("Driver is offline; call recover()", st.msg);
+  TEST_ASSERT_EQUAL_UINT32(0u, ctx.reads);
+  TEST_ASSERT_EQUAL_UINT32(0u, ctx.writes);
+}
+
+void test_read_settings_returns_offline_busy_without_i2c() {
+  CountTransport ctx;
+  SHT3xDevice device;
+  device._config.i2cWrite = countWrite;
+  device._config.i2cWriteRead = countWriteRead;
+  device._config.i2cUser = &ctx;
+  device._config.i2cTimeoutMs = 10;
+  installTimingHooks(device);
+  device._config.offlineThreshold = 1;
+  device._initialized = true;
+  device._driverState = DriverState::OFFLINE;
+  device._consecutiveFailures = 1;
+
+  SettingsSnapshot snap;
+  Status st = device.readSettings(snap);
+  TEST_ASSERT_EQUAL(Err::BUSY, st.code);
+  TEST_ASSERT_EQUAL_STRING("Driver is offline; call recover()", st.msg);
+  TEST_ASSERT_EQUAL_UINT32(0u, ctx.reads);
+  TEST_ASSERT_EQUAL_UINT32(0u, ctx.writes);
+  TEST_ASSERT_EQUAL(DriverState::OFFLINE, device._driverState);
+}
+
+void test_failed_recover_from_offline_keeps_latch_after_intermediate_success() {
+  ScriptedTransport ctx;
+  ctx.readScript[0] = Status::Error(Err::I2C_TIMEOUT, "initial probe timeout");
+  ctx.readScript[1] = Status::Error(Err::I2C_TIMEOUT, "post-reset timeout");
+  ctx.readCount = 2;
+
+  SHT3xDevice device;
+  device._config.i2cWrite = scriptedWrite;
+  device._config.i2cWriteRead = scriptedWriteRead;
+  device._config.i2cUser = &ctx;
+  device._config.i2cTimeoutMs = 10;
+  installTimingHooks(device);
+  device._config.offlineThreshold = 3;
+  device._config.recoverBackoffMs = 0;
+  device._config.recoverUseBusReset = false;
+  device._config.recoverUseSoftReset = true;
+  device._config.recoverUseHardReset = false;
+  device._config.allowGeneralCallReset = false;
+  device._initialized = true;
+  device._driverState = DriverState::OFFLINE;
+  device._consecutiveFailures = device._config.offlineThreshold;
+
+  gMillis = 0;
+  gMicros = 0;
+  gMillisStep = 1;
+  gMicrosStep = 1000;
+  Status st = device.recover();
+  TEST_ASSERT_EQUAL(Err::I2C_TIMEOUT, st.code);
+  TEST_ASSERT_EQUAL(DriverState::OFFLINE, device._driverState);
+  TEST_ASSERT_TRUE(device._consecutiveFailures >= device._config.offlineThreshold);
+}
+
+void test_recover_backoff_enforced_at_zero_ms() {
+  ScriptedTransport ctx;
+  ctx.readScript[0] = Status::Error(Err::I2C_TIMEOUT, "timeout");
+  ctx.readCount = 1;
+
+  SHT3xDevice device;
+  device._config.i2cWrite = scriptedWrite;
+  device._config.i2cWriteRead = scriptedWriteRead;
+  device._config.i2cUser = &ctx;
+  device._config.i2cTimeoutMs = 10;
+  installTimingHooks(device);
+  device._config.recoverBackoffMs = 100;
+  device._config.recoverUseBusReset = false;
+  device._config.recoverUseSoftReset = false;
+  device._config.recoverUseHardReset = false;
+  device._config.allowGeneralCallReset = false;
+  device._initialized = true;
+  device._driverState = DriverState::READY;
+
+  gMillis = 0;
+  gMicros = 0;
+  gMillisStep = 0;
+  gMicrosStep = 1000;
+
+  Status st = device.recover();
+  TEST_ASSERT_EQUAL(Err::I2C_TIMEOUT, st.code);
+
+  st = device.recover();
+  TEST_ASSERT_EQUAL(Err::BUSY, st.code);
+}
+
+void test_periodic_fetch_margin_is_clamped() {
+  SHT3xDevice device;
+  device._periodMs = 100;
+  device._config.periodicFetchMarginMs = 1000;
+  TEST_ASSERT_EQUAL_UINT32(100u, device._periodicFetchMarginMs());
+}
+
+void test_end_clears_runtime_state() {
+  SHT3xDevice device;
+  device._initialized = true;
+  device._driverState = DriverState::READY;
+  device._measurementRequested = true;
+  device._measurementReady = true;
+  device._measurementReadyMs = 123;
+  device._jobWakeMs = 321;
+  device._periodicActive = true;
+  device._periodicStartMs = 456;
+  device._lastFetchMs = 789;
+  device._lastFetchValid = true;
+  device._periodMs = 100;
+  device._sampleTimestampMs = 111;
+  device._missedSamples = 12;
+  device._notReadyStartMs = 222;
+  device._notReadyStartValid = true;
+  device._notReadyCount = 333;
+  device._lastRecoverMs = 444;
+  device._lastRecoverValid = true;
+  device._lastCommandValid = true;
+
+  device.end();
 
-  const Status cached = device.lastError();
-  TEST_ASSERT_EQUAL(Err::I2C_TIMEOUT, cached.code);
-  TEST_ASSERT_EQUAL_INT32(-17, cached.detail);
-  TEST_ASSERT_EQUAL_STRING("I2C timeout", cached.msg);
+  TEST_ASSERT_FALSE(device._initialized);
+  TEST_ASSERT_EQUAL(DriverState::UNINIT, device._driverState);
+  TEST_ASSERT_FALSE(device._measurementRequested);
+  TEST_ASSERT_FALSE(device._measurementReady);
+  TEST_ASSERT_FALSE(device._hasSample);
+  TEST_ASSERT_EQUAL_UINT32(0u, device._measurementReadyMs);
+  TEST_ASSERT_EQUAL_UINT32(0u, device._jobWakeMs);
+  TEST_ASSERT_FALSE(device._periodicActive);
+  TEST_ASSERT_EQUAL_UINT32(0u, device._periodicStartMs);
+  TEST_ASSERT_EQUAL_UINT32(0u, device._lastFetchMs);
+  TEST_ASSERT_FALSE(device._lastFetchValid);
+  TEST_ASSERT_EQUAL_UINT32(0u, device._periodMs);
+  TEST_ASSERT_EQUAL_UINT32(0u, device._sampleTimestampMs);
+  TEST_ASSERT_EQUAL_UINT32(0u, device._missedSamples);
+  TEST_ASSERT_EQUAL_UINT32(0u, device._notReadyStartMs);
+  TEST_ASSERT_FALSE(device._notReadyStartValid);
+  TEST_ASSERT_EQUAL_UINT32(0u, device._notReadyCount);
+  TEST_ASSERT_EQUAL_UINT32(0u, device._lastRecoverMs);
+  TEST_ASSERT_FALSE(device._lastRecoverValid);
+  TEST_ASSERT_FALSE(device._lastCommandValid);
 }
 
-void test_humidity_crc_failure_does_not_publish_new_frame() {
-  PreciseTimingTransport ctx;
-  ctx.nowMs = 800;
-  ctx.nowUs = 800000;
-  ctx.rawTemperature = 0x1111;
-  ctx.rawHumidity = 0x2222;
+static void prepareTelemetryDevice(SHT3xDevice& device, FakeTransport& bus) {
+  Config cfg = makeConfig(bus);
+  cfg.repeatability = Repeatability::MEDIUM_REPEATABILITY;
+  cfg.periodicRate = PeriodicRate::MPS_10;
+  TEST_ASSERT_TRUE(device.bind(cfg).ok());
+  device._rawSample.rawTemperature = 0x6666;
+  device._rawSample.rawHumidity = 0x8000;
+  device._hasSample = true;
+  device._sampleTimestampMs = 0x00ABCDEF;
+  device._driverState = DriverState::DEGRADED;
+  device._consecutiveFailures = 2;
+  device._lastError = Status::Error(Err::I2C_NACK_DATA, "nack");
+  device._lastOkMs = 0x11111111;
+  device._lastErrorMs = 0x22222222;
+  device._totalSuccess = 1000;
+  device._totalFailures = 7;
+  device._transportSuccess = 2001;
+  device._transportFailures = 9;
+  device._protocolFailures = 3;
+  device._totalNotReady = 4;
+  device._missedSamples = 5;
+}
+
+void test_telemetry_frame_roundtrips_health_and_raw_sample() {
+  static const uint8_t kCheck[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  TEST_ASSERT_EQUAL_HEX16(0x29B1, telemetryCrc16(kCheck, sizeof(kCheck)));
+
+  FakeTransport bus;
   SHT3xDevice device;
-  Status st = device.begin(makePreciseTimingConfig(ctx));
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  TEST_ASSERT_TRUE(device.hardwareStateValid());
+  prepareTelemetryDevice(device, bus);
 
-  JobRequest good;
-  good.requestId = 81;
-  st = device.requestMeasurement(good);
-  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  PollJobResult result;
-  st = device.pollJob(ctx.nowMs, 1, result);
-  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  ctx.nowMs = device._measurementReadyMs;
-  ctx.nowUs = ctx.nowMs * 1000u;
-  st = device.pollJob(ctx.nowMs, 1, result);
+  uint8_t frame[TELEMETRY_FRAME_LEN + 4];
+  memset(frame, 0xEE, sizeof(frame));
+  size_t written = 0;
+  Status st = encodeTelemetryFrame(device, 0x01020304, 0x1234, frame, sizeof(frame), written);
   TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-
-  RawSample oldSample;
-  st = device.getRawSample(oldSample);
+  TEST_ASSERT_EQUAL_UINT32(TELEMETRY_FRAME_LEN, written);
+  TEST_ASSERT_EQUAL_HEX8(0xEE, frame[TELEMETRY_FRAME_LEN]);
+
+  TEST_ASSERT_EQUAL_HEX8(TELEMETRY_MAGIC, frame[0]);
+  TEST_ASSERT_EQUAL_HEX8(TELEMETRY_VERSION, frame[1]);
+  TEST_ASSERT_EQUAL_HEX8(0x34, frame[2]);
+  TEST_ASSERT_EQUAL_HEX8(0x12, frame[3]);
+  TEST_ASSERT_EQUAL_HEX8(static_cast<uint8_t>(Err::I2C_NACK_DATA), frame[5]);
+  TEST_ASSERT_EQUAL_HEX8(0x66, frame[10]);
+  TEST_ASSERT_EQUAL_HEX8(0x04, frame[16]);
+  TEST_ASSERT_EQUAL_HEX8(0x01, frame[19]);
+  TEST_ASSERT_EQUAL_HEX16(telemetryCrc16(frame, TELEMETRY_FRAME_LEN - 2),
+                          static_cast<uint16_t>(frame[60] | (frame[61] << 8)));
+
+  TelemetryFrame decoded;
+  st = decodeTelemetryFrame(frame, written, decoded);
   TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  TEST_ASSERT_EQUAL_HEX16(0x1111, oldSample.rawTemperature);
-  TEST_ASSERT_EQUAL_HEX16(0x2222, oldSample.rawHumidity);
+  TEST_ASSERT_EQUAL_UINT16(0x1234, decoded.sequence);
+  TEST_ASSERT_EQUAL(DriverState::DEGRADED, decoded.state);
+  TEST_ASSERT_EQUAL(Err::I2C_NACK_DATA, decoded.lastError);
+  TEST_ASSERT_EQUAL(Err::MEASUREMENT_NOT_READY, decoded.lastMeasurement);
+  TEST_ASSERT_EQUAL_HEX8(TELEMETRY_FLAG_INITIALIZED | TELEMETRY_FLAG_HAS_SAMPLE,
+                         decoded.flags);
+  TEST_ASSERT_EQUAL_UINT8(2, decoded.consecutiveFailures);
+  TEST_ASSERT_EQUAL(Mode::SINGLE_SHOT, decoded.mode);
+  TEST_ASSERT_EQUAL(Repeatability::MEDIUM_REPEATABILITY, decoded.repeatability);
+  TEST_ASSERT_EQUAL(PeriodicRate::MPS_10, decoded.periodicRate);
+  TEST_ASSERT_EQUAL_HEX16(0x6666, decoded.sample.rawTemperature);
+  TEST_ASSERT_EQUAL_HEX16(0x8000, decoded.sample.rawHumidity);
+  TEST_ASSERT_EQUAL_HEX32(0x01020304, decoded.frameTimestampMs);
+  TEST_ASSERT_EQUAL_HEX32(0x00ABCDEF, decoded.sampleTimestampMs);
+  TEST_ASSERT_EQUAL_HEX32(0x11111111, decoded.lastOkMs);
+  TEST_ASSERT_EQUAL_HEX32(0x22222222, decoded.lastErrorMs);
+  TEST_ASSERT_EQUAL_UINT32(1000, decoded.totalSuccess);
+  TEST_ASSERT_EQUAL_UINT32(7, decoded.totalFailures);
+  TEST_ASSERT_EQUAL_UINT32(2001, decoded.transportSuccess);
+  TEST_ASSERT_EQUAL_UINT32(9, decoded.transportFailures);
+  TEST_ASSERT_EQUAL_UINT32(3, decoded.protocolFailures);
+  TEST_ASSERT_EQUAL_UINT32(4, decoded.totalNotReady);
+  TEST_ASSERT_EQUAL_UINT32(5, decoded.missedSamples);
+}
+
+void test_telemetry_frame_rejects_short_buffers_and_corruption() {
+  FakeTransport bus;
+  SHT3xDevice device;
+  prepareTelemetryDevice(device, bus);
 
-  ctx.rawTemperature = 0xAAAA;
-  ctx.rawHumidity = 0xBBBB;
-  ctx.corruptHumidityCrc = true;
-  JobRequest bad;
-  bad.requestId = 82;
-  st = device.requestMeasurement(bad);
-  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  st = device.pollJob(ctx.nowMs, 1, result);
-  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  ctx.nowMs = device._measurementReadyMs;
-  ctx.nowUs = ctx.nowMs * 1000u;
-  st = device.pollJob(ctx.nowMs, 1, result);
-  TEST_ASSERT_EQUAL(Err::CRC_MISMATCH, st.code);
-  TEST_ASSERT_EQUAL_STRING("CRC mismatch (humidity)", st.msg);
-  TEST_ASSERT_TRUE(result.terminal);
-  TEST_ASSERT_FALSE(result.completed);
-  TEST_ASSERT_EQUAL_UINT32(82u, result.requestId);
-  TEST_ASSERT_EQUAL(JobPhase::SINGLE_SHOT_READ, result.phase);
-  TEST_ASSERT_EQUAL(JobOutcome::FAILED, result.outcome);
-  TEST_ASSERT_EQUAL(JobEffect::NONE, result.effect);
-  TEST_ASSERT_EQUAL_UINT32(1u, device.protocolFailures());
-  TEST_ASSERT_TRUE(device.hasSample());
-  TEST_ASSERT_FALSE(device.measurementReady());
-  TEST_ASSERT_TRUE(device.hardwareStateValid());
+  uint8_t frame[TELEMETRY_FRAME_LEN];
+  size_t written = 99;
+  Status st = encodeTelemetryFrame(device, 0, 0, frame, sizeof(frame) - 1, written);
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, st.code);
+  TEST_ASSERT_EQUAL_UINT32(0, written);
+  st = encodeTelemetryFrame(device, 0, 0, nullptr, sizeof(frame), written);
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, st.code);
 
-  RawSample afterFailure;
-  st = device.getRawSample(afterFailure);
+  st = encodeTelemetryFrame(device, 0, 0, frame, sizeof(frame), written);
   TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  TEST_ASSERT_EQUAL_HEX16(oldSample.rawTemperature, afterFailure.rawTemperature);
-  TEST_ASSERT_EQUAL_HEX16(oldSample.rawHumidity, afterFailure.rawHumidity);
-
-  device._protocolFailures = UINT32_MAX;
-  bad.requestId = 83;
-  st = device.requestMeasurement(bad);
-  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  st = device.pollJob(ctx.nowMs, 1, result);
-  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  ctx.nowMs = device._measurementReadyMs;
-  ctx.nowUs = ctx.nowMs * 1000u;
-  st = device.pollJob(ctx.nowMs, 1, result);
-  TEST_ASSERT_EQUAL(Err::CRC_MISMATCH, st.code);
-  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, device.protocolFailures());
-}
+  TelemetryFrame decoded;
+  decoded.sequence = 0xBEEF;
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM,
+                    decodeTelemetryFrame(frame, sizeof(frame) - 1, decoded).code);
+
+  frame[32] ^= 0x01;
+  TEST_ASSERT_EQUAL(Err::CRC_MISMATCH, decodeTelemetryFrame(frame, sizeof(frame), decoded).code);
+  TEST_ASSERT_EQUAL_UINT16(0xBEEF, decoded.sequence);
+  frame[32] ^= 0x01;
+
+  frame[1] = TELEMETRY_VERSION + 1;
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, decodeTelemetryFrame(frame, sizeof(frame), decoded).code);
+  frame[1] = TELEMETRY_VERSION;
+  frame[0] = 0x00;
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, decodeTelemetryFrame(frame, sizeof(frame), decoded).code);
+  TEST_ASSERT_EQUAL_UINT16(0xBEEF, decoded.sequence);
+}
+
+void test_telemetry_frame_matches_host_decoder_vector() {
+  // Same bytes as SELF_TEST_FRAME in tools/decode_sht3x_telemetry.py.
+  static const uint8_t kVector[TELEMETRY_FRAME_LEN] = {
+      0x53, 0x01, 0x2a, 0x00, 0x01, 0x00, 0x00, 0x07, 0x00, 0x18, 0x66, 0x66, 0x00,
+      0x80, 0x00, 0x00, 0xfb, 0x03, 0x00, 0x00, 0xfa, 0x03, 0x00, 0x00, 0xfa, 0x03,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2b, 0x0a};
 
-void test_periodic_not_ready_counter_is_separate_and_saturating() {
-  PreciseTimingTransport ctx;
-  ctx.nowMs = 900;
-  ctx.nowUs = 900000;
-  Config cfg = makePreciseTimingConfig(ctx);
-  cfg.transportCapabilities = TransportCapability::READ_HEADER_NACK;
+  FakeTransport bus;
   SHT3xDevice device;
-  Status st = device.bind(cfg);
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  st = device.startPeriodic(PeriodicRate::MPS_1,
-                            Repeatability::HIGH_REPEATABILITY);
+  TEST_ASSERT_TRUE(device.bind(makeConfig(bus)).ok());
+  device._rawSample.rawTemperature = 0x6666;
+  device._rawSample.rawHumidity = 0x8000;
+  device._hasSample = true;
+  device._measurementReady = true;
+  device._lastMeasurementStatus = Status::Ok();
+  device._sampleTimestampMs = 1018;
+  device._lastOkMs = 1018;
+  device._totalSuccess = 1;
+  device._transportSuccess = 2;
+
+  uint8_t frame[TELEMETRY_FRAME_LEN];
+  size_t written = 0;
+  Status st = encodeTelemetryFrame(device, 1019, 42, frame, sizeof(frame), written);
   TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(kVector, frame, TELEMETRY_FRAME_LEN);
+}
 
-  ctx.readStatus = Status::Error(Err::I2C_NACK_READ, "no frame", 23);
-  JobRequest request;
-  request.requestId = 91;
-  st = device.requestMeasurement(request);
-  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  PollJobResult result;
-  ctx.nowMs = device._measurementReadyMs;
-  ctx.nowUs = ctx.nowMs * 1000u;
-  st = device.pollJob(ctx.nowMs, 1, result);
-  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  TEST_ASSERT_EQUAL(JobPhase::PERIODIC_FETCH_COMMAND, result.phase);
-  TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
-  advancePreciseTimeMs(ctx, 1);
-  st = device.pollJob(ctx.nowMs, 1, result);
-  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  TEST_ASSERT_TRUE(result.active);
-  TEST_ASSERT_FALSE(result.terminal);
-  TEST_ASSERT_EQUAL(JobPhase::PERIODIC_READ, result.phase);
-  TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
-  TEST_ASSERT_EQUAL_UINT32(1u, device.totalNotReady());
-  TEST_ASSERT_EQUAL_UINT32(1u, device.notReadyCount());
-  TEST_ASSERT_EQUAL_UINT32(0u, device.transportFailures());
-  TEST_ASSERT_EQUAL_UINT32(0u, device.protocolFailures());
-
-  device._totalNotReady = UINT32_MAX;
-  ctx.nowMs = device._measurementReadyMs;
-  ctx.nowUs = ctx.nowMs * 1000u;
-  st = device.pollJob(ctx.nowMs, 1, result);
-  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
-  advancePreciseTimeMs(ctx, 1);
-  st = device.pollJob(ctx.nowMs, 1, result);
-  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, device.totalNotReady());
-  TEST_ASSERT_EQUAL_UINT32(2u, device.notReadyCount());
-  TEST_ASSERT_EQUAL_UINT32(0u, device.transportFailures());
-  TEST_ASSERT_EQUAL_UINT32(0u, device.protocolFailures());
+static void setPreciseTime(PreciseTimingTransport& ctx, uint32_t nowMs) {
+  ctx.nowMs = nowMs;
+  ctx.nowUs = nowMs * 1000u;
 }
 
-void test_public_status_read_and_clear_are_explicit_operations() {
-  FrameScriptTransport ctx;
-  ctx.statusRaw = static_cast<uint16_t>(cmd::STATUS_HEATER_ON | cmd::STATUS_RESET_DETECTED);
+void test_job_wake_ms_reports_next_due_step_for_sleeping_owners() {
+  sim::Clock clock;
+  clock.virtualTime = true;
+  clock.virtualUs = 1000000;
+  sim::VirtualSht3x sensor;
+  Config cfg;
+  sim::attach(cfg, sensor, clock);
   SHT3xDevice device;
-  Config cfg = makeFrameConfig(ctx);
-  Status st = device.begin(cfg);
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_TRUE(device.bind(cfg).ok());
+  uint32_t wakeMs = 0;
+  TEST_ASSERT_FALSE(device.jobWakeMs(sim::clockNowMs(&clock), wakeMs));
+
+  // Ensure-idle: after the Break the job sleeps exactly through the settle.
+  JobRequest request{1, 0, false};
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.requestEnsureIdle(request).code);
+  TEST_ASSERT_FALSE(device.jobWakeMs(sim::clockNowMs(&clock), wakeMs));
+  PollJobResult result;
+  (void)device.pollJob(sim::clockNowMs(&clock), 1, result);
+  TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
+  TEST_ASSERT_TRUE(device.jobWakeMs(sim::clockNowMs(&clock), wakeMs));
+  TEST_ASSERT_EQUAL_UINT32(sim::clockNowMs(&clock) + 1U, wakeMs);
+  for (int i = 0; i < 20 && !result.terminal; ++i) {
+    (void)device.pollJob(sim::clockNowMs(&clock), 1, result);
+    if (device.jobWakeMs(sim::clockNowMs(&clock), wakeMs)) {
+      clock.advanceUs(static_cast<uint64_t>(wakeMs - sim::clockNowMs(&clock)) * 1000ULL);
+    } else {
+      clock.advanceUs(cfg.commandDelayMs * 1000ULL);
+    }
+  }
+  TEST_ASSERT_EQUAL(JobOutcome::SUCCEEDED, result.outcome);
 
-  clearFrameLog(ctx);
-  StatusRegister reg;
-  st = device.readStatus(reg);
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  TEST_ASSERT_TRUE(reg.heaterOn);
-  TEST_ASSERT_TRUE(reg.resetDetected);
-  TEST_ASSERT_EQUAL(1u, ctx.commandCount);
-  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[0]);
-  TEST_ASSERT_EQUAL_UINT32(1u, ctx.reads);
+  // Measurement: command, sleep to the ready time, read; no idle polls.
+  request.requestId = 2;
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.requestMeasurement(request).code);
+  (void)device.pollJob(sim::clockNowMs(&clock), 1, result);
+  TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
+  TEST_ASSERT_TRUE(device.jobWakeMs(sim::clockNowMs(&clock), wakeMs));
+  TEST_ASSERT_EQUAL_UINT32(device._measurementReadyMs, wakeMs);
+  clock.advanceUs(static_cast<uint64_t>(wakeMs - sim::clockNowMs(&clock) - 1U) * 1000ULL);
+  (void)device.pollJob(sim::clockNowMs(&clock), 1, result);
+  TEST_ASSERT_EQUAL_UINT8(0u, result.instructionsUsed);
+  clock.advanceUs(1000);
+  (void)device.pollJob(sim::clockNowMs(&clock), 1, result);
+  TEST_ASSERT_TRUE(result.terminal && result.completed);
+  TEST_ASSERT_FALSE(device.jobWakeMs(sim::clockNowMs(&clock), wakeMs));
+
+  // A deadline before the conversion ends wakes the owner at the deadline.
+  const uint32_t startMs = sim::clockNowMs(&clock);
+  request = JobRequest{3, startMs + 5U, true};
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.requestMeasurement(request).code);
+  (void)device.pollJob(sim::clockNowMs(&clock), 1, result);
+  TEST_ASSERT_TRUE(device.jobWakeMs(sim::clockNowMs(&clock), wakeMs));
+  TEST_ASSERT_EQUAL_UINT32(startMs + 5U, wakeMs);
+  clock.advanceUs(static_cast<uint64_t>(wakeMs - sim::clockNowMs(&clock)) * 1000ULL);
+  TEST_ASSERT_FALSE(device.jobWakeMs(sim::clockNowMs(&clock), wakeMs));
+  (void)device.pollJob(sim::clockNowMs(&clock), 1, result);
+  TEST_ASSERT_TRUE(result.terminal);
+  TEST_ASSERT_EQUAL(JobOutcome::TIMED_OUT, result.outcome);
 
-  clearFrameLog(ctx);
-  st = device.clearStatus();
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  TEST_ASSERT_EQUAL(1u, ctx.commandCount);
-  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_CLEAR_STATUS, ctx.commands[0]);
-  TEST_ASSERT_EQUAL_UINT32(0u, ctx.reads);
+  // Cadence: the owner sleeps until the first slot.
+  CadenceRequest cadence;
+  cadence.requestId = 4;
+  cadence.periodMs = 100;
+  cadence.firstSlotMs = sim::clockNowMs(&clock) + 40U;
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.requestCadence(cadence).code);
+  TEST_ASSERT_TRUE(device.jobWakeMs(sim::clockNowMs(&clock), wakeMs));
+  TEST_ASSERT_EQUAL_UINT32(cadence.firstSlotMs, wakeMs);
+  TEST_ASSERT_EQUAL(Err::CANCELLED, device.cancelJob(CancelReason::REQUESTED, result).code);
+  TEST_ASSERT_FALSE(device.jobWakeMs(sim::clockNowMs(&clock), wakeMs));
 }
 
-void test_periodic_start_command_failure_does_not_update_public_mode_or_cache() {
-  FrameScriptTransport ctx;
+void test_cadence_job_rearms_on_absolute_slots_across_wrap() {
+  PreciseTimingTransport ctx;
+  const uint32_t firstSlotMs = 0xFFFFFF90u;
+  setPreciseTime(ctx, firstSlotMs - 16u);
+  ctx.rawTemperature = 0x6000;
+  ctx.rawHumidity = 0x7000;
   SHT3xDevice device;
-  Config cfg = makeFrameConfig(ctx);
-  Status st = device.begin(cfg);
+  Status st = device.bind(makePreciseTimingConfig(ctx));
   TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
 
-  const uint16_t startCmd = SHT3xDevice::_commandForPeriodic(
-      Repeatability::MEDIUM_REPEATABILITY, PeriodicRate::MPS_4);
-  ctx.failCommand = startCmd;
-  ctx.failCommandStatus = Status::Error(Err::I2C_NACK_DATA, "periodic start nack", -21);
-  clearFrameLog(ctx);
+  CadenceRequest request;
+  request.requestId = 7;
+  request.periodMs = 50;
+  request.firstSlotMs = firstSlotMs;
+  st = device.requestCadence(request);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  TEST_ASSERT_EQUAL_UINT32(0u, ctx.writes + ctx.reads);
 
-  st = device.startPeriodic(PeriodicRate::MPS_4, Repeatability::MEDIUM_REPEATABILITY);
-  TEST_ASSERT_EQUAL(Err::I2C_NACK_DATA, st.code);
-  TEST_ASSERT_EQUAL_INT32(-21, st.detail);
-  TEST_ASSERT_FALSE(device.isPeriodicActive());
-  Mode mode = Mode::ART;
-  TEST_ASSERT_TRUE(device.getMode(mode).ok());
-  TEST_ASSERT_EQUAL(Mode::SINGLE_SHOT, mode);
-  CachedSettings cached = device.getCachedSettings();
-  TEST_ASSERT_EQUAL(Mode::SINGLE_SHOT, cached.mode);
-  TEST_ASSERT_EQUAL(1u, ctx.commandCount);
-  TEST_ASSERT_EQUAL_UINT16(startCmd, ctx.commands[0]);
-}
+  static const uint32_t kLatenessMs[] = {0, 3, 1, 7, 0};
+  PollJobResult result;
+  for (uint32_t slot = 0; slot < 5; ++slot) {
+    const uint32_t slotMs = firstSlotMs + slot * 50u;
+    setPreciseTime(ctx, slotMs - 1u);
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    TEST_ASSERT_EQUAL_UINT8(0u, result.instructionsUsed);
 
-void test_periodic_restart_break_failure_keeps_previous_public_state() {
-  FrameScriptTransport ctx;
-  SHT3xDevice device;
-  Config cfg = makeFrameConfig(ctx);
-  Status st = device.begin(cfg);
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  st = device.startPeriodic(PeriodicRate::MPS_1, Repeatability::HIGH_REPEATABILITY);
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+    setPreciseTime(ctx, slotMs + kLatenessMs[slot]);
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
+    TEST_ASSERT_EQUAL_UINT16(cmd::CMD_SINGLE_SHOT_NO_STRETCH_HIGH, ctx.lastCommand);
 
-  ctx.failCommand = cmd::CMD_BREAK;
-  ctx.failCommandStatus = Status::Error(Err::I2C_TIMEOUT, "break timeout", -22);
-  clearFrameLog(ctx);
+    ctx.rawTemperature = static_cast<uint16_t>(0x6000u + slot);
+    setPreciseTime(ctx, device._measurementReadyMs);
+    st = device.pollJob(ctx.nowMs, 1, result);
+    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+    TEST_ASSERT_TRUE(result.completed);
+    TEST_ASSERT_TRUE(result.active);
+    TEST_ASSERT_FALSE(result.terminal);
+    TEST_ASSERT_EQUAL_UINT32(7u, result.requestId);
+    TEST_ASSERT_EQUAL(JobType::MEASUREMENT, result.type);
+    TEST_ASSERT_EQUAL(JobPhase::SINGLE_SHOT_READ, result.phase);
+    TEST_ASSERT_EQUAL(JobOutcome::ACTIVE, result.outcome);
+
+    RawSample raw;
+    TEST_ASSERT_TRUE(device.getRawSample(raw).ok());
+    TEST_ASSERT_EQUAL_HEX16(0x6000u + slot, raw.rawTemperature);
+    CadenceStats stats;
+    TEST_ASSERT_TRUE(device.getCadenceStats(stats).ok());
+    TEST_ASSERT_TRUE(stats.active);
+    TEST_ASSERT_EQUAL_UINT32(slot, stats.lastSlot);
+    TEST_ASSERT_EQUAL_UINT32(slot + 1u, stats.samples);
+    TEST_ASSERT_EQUAL_UINT32(kLatenessMs[slot], stats.lastScheduleErrorMs);
+    TEST_ASSERT_EQUAL_UINT32(slotMs + 50u, stats.nextSlotMs);
+    TEST_ASSERT_EQUAL_UINT32(0u, stats.skippedSlots);
+  }
+  TEST_ASSERT_EQUAL_UINT32(10u, ctx.writes + ctx.reads);
+
+  st = device.cancelJob(CancelReason::REQUESTED, result);
+  TEST_ASSERT_EQUAL(Err::CANCELLED, st.code);
+  TEST_ASSERT_TRUE(result.terminal);
+  TEST_ASSERT_EQUAL_UINT32(7u, result.requestId);
+  TEST_ASSERT_EQUAL(JobOutcome::CANCELLED, result.outcome);
+  TEST_ASSERT_EQUAL(JobEffect::NONE, result.effect);
+  CadenceStats stats;
+  TEST_ASSERT_TRUE(device.getCadenceStats(stats).ok());
+  TEST_ASSERT_FALSE(stats.active);
+  TEST_ASSERT_EQUAL_UINT32(5u, stats.samples);
+  TEST_ASSERT_EQUAL_UINT32(7u, stats.maxScheduleErrorMs);
+  TEST_ASSERT_TRUE(device.hasSample());
 
-  st = device.startPeriodic(PeriodicRate::MPS_4, Repeatability::MEDIUM_REPEATABILITY);
-  TEST_ASSERT_EQUAL(Err::I2C_TIMEOUT, st.code);
-  TEST_ASSERT_EQUAL_INT32(-22, st.detail);
-  TEST_ASSERT_TRUE(device.isPeriodicActive());
-  Mode mode = Mode::SINGLE_SHOT;
-  TEST_ASSERT_TRUE(device.getMode(mode).ok());
-  TEST_ASSERT_EQUAL(Mode::PERIODIC, mode);
-  PeriodicRate rate = PeriodicRate::MPS_10;
-  TEST_ASSERT_TRUE(device.getPeriodicRate(rate).ok());
-  TEST_ASSERT_EQUAL(PeriodicRate::MPS_1, rate);
-  TEST_ASSERT_EQUAL(1u, ctx.commandCount);
-  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_BREAK, ctx.commands[0]);
+  st = device.pollJob(ctx.nowMs + 100u, 1, result);
+  TEST_ASSERT_FALSE(result.active);
+  TEST_ASSERT_FALSE(result.terminal);
+  TEST_ASSERT_EQUAL_UINT32(10u, ctx.writes + ctx.reads);
 }
 
-void test_periodic_reconfiguration_start_failure_exposes_stopped_state_and_preserves_cache() {
-  FrameScriptTransport ctx;
+void test_cadence_job_skips_and_counts_overdue_slots() {
+  PreciseTimingTransport ctx;
+  setPreciseTime(ctx, 100);
   SHT3xDevice device;
-  Config cfg = makeFrameConfig(ctx);
-  Status st = device.begin(cfg);
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  st = device.startPeriodic(PeriodicRate::MPS_1, Repeatability::HIGH_REPEATABILITY);
+  Status st = device.bind(makePreciseTimingConfig(ctx));
   TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
 
-  const uint16_t restartCmd = SHT3xDevice::_commandForPeriodic(
-      Repeatability::HIGH_REPEATABILITY, PeriodicRate::MPS_4);
-  ctx.failCommand = restartCmd;
-  ctx.failCommandStatus = Status::Error(Err::I2C_NACK_DATA, "restart nack", -26);
-  clearFrameLog(ctx);
+  CadenceRequest request;
+  request.requestId = 9;
+  request.periodMs = 20;
+  request.firstSlotMs = 100;
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.requestCadence(request).code);
 
-  st = device.setPeriodicRate(PeriodicRate::MPS_4);
-  TEST_ASSERT_EQUAL(Err::I2C_NACK_DATA, st.code);
-  TEST_ASSERT_EQUAL_INT32(-26, st.detail);
-  TEST_ASSERT_FALSE(device.isPeriodicActive());
-  Mode mode = Mode::PERIODIC;
-  TEST_ASSERT_TRUE(device.getMode(mode).ok());
-  TEST_ASSERT_EQUAL(Mode::SINGLE_SHOT, mode);
-  PeriodicRate rate = PeriodicRate::MPS_10;
-  TEST_ASSERT_TRUE(device.getPeriodicRate(rate).ok());
-  TEST_ASSERT_EQUAL(PeriodicRate::MPS_1, rate);
-  CachedSettings cached = device.getCachedSettings();
-  TEST_ASSERT_EQUAL(Mode::PERIODIC, cached.mode);
-  TEST_ASSERT_EQUAL(PeriodicRate::MPS_1, cached.periodicRate);
-  TEST_ASSERT_EQUAL(2u, ctx.commandCount);
-  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_BREAK, ctx.commands[0]);
-  TEST_ASSERT_EQUAL_UINT16(restartCmd, ctx.commands[1]);
-}
+  PollJobResult result;
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.pollJob(ctx.nowMs, 1, result).code);
+  setPreciseTime(ctx, device._measurementReadyMs);
+  TEST_ASSERT_TRUE(device.pollJob(ctx.nowMs, 1, result).ok());
+  TEST_ASSERT_TRUE(result.completed);
 
-void test_alert_limit_write_command_failure_does_not_update_cache() {
-  FrameScriptTransport ctx;
+  // Slots 1..4 (120..180 ms) can no longer finish a 16 ms conversion before
+  // their successors start; slot 5 at 200 ms is the next usable one.
+  const uint32_t callbacks = ctx.writes + ctx.reads;
+  setPreciseTime(ctx, 190);
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+  TEST_ASSERT_EQUAL_UINT8(0u, result.instructionsUsed);
+  TEST_ASSERT_EQUAL_UINT32(callbacks, ctx.writes + ctx.reads);
+  CadenceStats stats;
+  TEST_ASSERT_TRUE(device.getCadenceStats(stats).ok());
+  TEST_ASSERT_EQUAL_UINT32(4u, stats.skippedSlots);
+  TEST_ASSERT_EQUAL_UINT32(5u, stats.nextSlot);
+  TEST_ASSERT_EQUAL_UINT32(200u, stats.nextSlotMs);
+
+  setPreciseTime(ctx, 202);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.pollJob(ctx.nowMs, 1, result).code);
+  TEST_ASSERT_EQUAL_UINT8(1u, result.instructionsUsed);
+  setPreciseTime(ctx, device._measurementReadyMs);
+  TEST_ASSERT_TRUE(device.pollJob(ctx.nowMs, 1, result).ok());
+  TEST_ASSERT_TRUE(result.completed);
+  TEST_ASSERT_FALSE(result.terminal);
+  TEST_ASSERT_TRUE(device.getCadenceStats(stats).ok());
+  TEST_ASSERT_EQUAL_UINT32(5u, stats.lastSlot);
+  TEST_ASSERT_EQUAL_UINT32(2u, stats.samples);
+  TEST_ASSERT_EQUAL_UINT32(2u, stats.lastScheduleErrorMs);
+  TEST_ASSERT_EQUAL_UINT32(4u, stats.skippedSlots);
+  TEST_ASSERT_EQUAL_UINT32(220u, stats.nextSlotMs);
+  TEST_ASSERT_EQUAL_UINT32(6u, device.sampleSequence());
+  TEST_ASSERT_EQUAL_UINT32(4u, device.lostSamples());
+  SampleGap gap;
+  size_t gapCount = 0;
+  TEST_ASSERT_TRUE(device.getSampleGaps(&gap, 1, gapCount).ok());
+  TEST_ASSERT_EQUAL_UINT32(1u, gapCount);
+  TEST_ASSERT_EQUAL_UINT32(2u, gap.firstMissing);
+  TEST_ASSERT_EQUAL_UINT32(4u, gap.count);
+}
+
+void test_cadence_request_validation_and_failure_is_terminal() {
+  PreciseTimingTransport ctx;
+  setPreciseTime(ctx, 100);
   SHT3xDevice device;
-  Config cfg = makeFrameConfig(ctx);
-  Status st = device.begin(cfg);
+  CadenceRequest request;
+  request.requestId = 3;
+  request.periodMs = 100;
+  request.firstSlotMs = 100;
+  TEST_ASSERT_EQUAL(Err::NOT_INITIALIZED, device.requestCadence(request).code);
+  Status st = device.bind(makePreciseTimingConfig(ctx));
   TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
 
-  ctx.failCommand = cmd::CMD_ALERT_WRITE_HIGH_SET;
-  ctx.failCommandStatus = Status::Error(Err::I2C_NACK_DATA, "alert write nack", -23);
-  clearFrameLog(ctx);
+  CadenceRequest invalid = request;
+  invalid.requestId = 0;
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, device.requestCadence(invalid).code);
+  invalid = request;
+  invalid.periodMs = device.estimateMeasurementTimeMs();
+  st = device.requestCadence(invalid);
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, st.code);
+  TEST_ASSERT_EQUAL_INT32(static_cast<int32_t>(device.estimateMeasurementTimeMs() + 1u),
+                          st.detail);
+  invalid.periodMs = 86400001u;
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, device.requestCadence(invalid).code);
+  device._mode = Mode::PERIODIC;
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, device.requestCadence(request).code);
+  device._mode = Mode::SINGLE_SHOT;
+  TEST_ASSERT_EQUAL_UINT32(0u, ctx.writes + ctx.reads);
 
-  st = device.writeAlertLimitRaw(AlertLimitKind::HIGH_SET, 0x2222);
-  TEST_ASSERT_EQUAL(Err::I2C_NACK_DATA, st.code);
-  TEST_ASSERT_EQUAL_INT32(-23, st.detail);
-  CachedSettings cached = device.getCachedSettings();
-  TEST_ASSERT_FALSE(cached.alertValid[static_cast<uint8_t>(AlertLimitKind::HIGH_SET)]);
-  TEST_ASSERT_EQUAL(1u, ctx.commandCount);
-  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_ALERT_WRITE_HIGH_SET, ctx.commands[0]);
-  TEST_ASSERT_EQUAL_UINT32(0u, ctx.reads);
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.requestCadence(request).code);
+  TEST_ASSERT_EQUAL(Err::BUSY, device.requestCadence(request).code);
+  JobRequest single;
+  single.requestId = 4;
+  TEST_ASSERT_EQUAL(Err::BUSY, device.requestMeasurement(single).code);
+
+  ctx.writeStatus = Status::Error(Err::I2C_NACK_ADDR, "nack");
+  PollJobResult result;
+  st = device.pollJob(ctx.nowMs, 1, result);
+  TEST_ASSERT_EQUAL(Err::I2C_NACK_ADDR, st.code);
+  TEST_ASSERT_TRUE(result.terminal);
+  TEST_ASSERT_EQUAL_UINT32(3u, result.requestId);
+  TEST_ASSERT_EQUAL(JobOutcome::FAILED, result.outcome);
+  CadenceStats stats;
+  TEST_ASSERT_TRUE(device.getCadenceStats(stats).ok());
+  TEST_ASSERT_FALSE(stats.active);
+  TEST_ASSERT_EQUAL_UINT32(0u, stats.samples);
+
+  ctx.writeStatus = Status::Ok();
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.requestMeasurement(single).code);
 }
 
-void test_alert_limit_write_status_verification_failure_does_not_update_cache() {
-  FrameScriptTransport ctx;
+void test_continuous_periodic_job_emits_one_result_per_period_until_cancelled() {
+  PreciseTimingTransport ctx;
+  setPreciseTime(ctx, 1000);
   SHT3xDevice device;
-  Config cfg = makeFrameConfig(ctx);
-  Status st = device.begin(cfg);
+  Status st = device.bind(makePreciseTimingConfig(ctx));
   TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
 
-  ctx.statusRaw = cmd::STATUS_WRITE_CRC_ERROR;
-  clearFrameLog(ctx);
+  JobRequest request;
+  request.requestId = 11;
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, device.requestContinuous(request).code);
+  st = device.startPeriodic(PeriodicRate::MPS_10, Repeatability::HIGH_REPEATABILITY);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  request.requestId = 0;
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, device.requestContinuous(request).code);
+  request.requestId = 11;
+  const uint32_t callbacksBefore = ctx.writes + ctx.reads;
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.requestContinuous(request).code);
+  TEST_ASSERT_EQUAL(Err::BUSY, device.requestContinuous(request).code);
+  TEST_ASSERT_EQUAL_UINT32(callbacksBefore, ctx.writes + ctx.reads);
 
-  st = device.writeAlertLimitRaw(AlertLimitKind::HIGH_SET, 0x2222);
-  TEST_ASSERT_EQUAL(Err::WRITE_CRC_ERROR, st.code);
-  TEST_ASSERT_EQUAL_UINT32(1u, device.protocolFailures());
-  CachedSettings cached = device.getCachedSettings();
-  TEST_ASSERT_FALSE(cached.alertValid[static_cast<uint8_t>(AlertLimitKind::HIGH_SET)]);
-  TEST_ASSERT_EQUAL(2u, ctx.commandCount);
-  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_ALERT_WRITE_HIGH_SET, ctx.commands[0]);
-  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[1]);
-  TEST_ASSERT_EQUAL_UINT32(1u, ctx.reads);
+  PollJobResult result;
+  uint32_t completed = 0;
+  uint32_t lastSampleMs = 0;
+  for (uint32_t step = 0; step < 400 && completed < 3; ++step) {
+    advancePreciseTimeMs(ctx, 1);
+    st = device.pollJob(ctx.nowMs, 4, result);
+    TEST_ASSERT_TRUE(result.instructionsUsed <= 1u);
+    TEST_ASSERT_TRUE(result.active);
+    TEST_ASSERT_FALSE(result.terminal);
+    TEST_ASSERT_EQUAL_UINT32(11u, result.requestId);
+    if (result.completed) {
+      TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+      TEST_ASSERT_EQUAL(JobOutcome::ACTIVE, result.outcome);
+      TEST_ASSERT_EQUAL(JobPhase::PERIODIC_READ, result.phase);
+      TEST_ASSERT_EQUAL(JobPhase::PERIODIC_FETCH_COMMAND, device._measurementPhase);
+      if (completed > 0) {
+        TEST_ASSERT_UINT32_WITHIN(2u, 105u, ctx.nowMs - lastSampleMs);
+      }
+      lastSampleMs = ctx.nowMs;
+      completed++;
+    } else {
+      TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT32(3u, completed);
+  TEST_ASSERT_EQUAL_UINT32(callbacksBefore + 6u, ctx.writes + ctx.reads);
 
-  ctx.statusRaw = cmd::STATUS_COMMAND_ERROR;
-  clearFrameLog(ctx);
-  st = device.writeAlertLimitRaw(AlertLimitKind::HIGH_SET, 0x2222);
-  TEST_ASSERT_EQUAL(Err::COMMAND_FAILED, st.code);
-  TEST_ASSERT_EQUAL_UINT32(2u, device.protocolFailures());
+  st = device.cancelJob(CancelReason::REQUESTED, result);
+  TEST_ASSERT_EQUAL(Err::CANCELLED, st.code);
+  TEST_ASSERT_TRUE(result.terminal);
+  TEST_ASSERT_EQUAL_UINT32(11u, result.requestId);
+  TEST_ASSERT_FALSE(device._jobContinuous);
+  st = device.cancelJob(CancelReason::REQUESTED, result);
+  TEST_ASSERT_FALSE(result.terminal);
+  TEST_ASSERT_TRUE(device.hasSample());
 
-  device._protocolFailures = UINT32_MAX;
-  ctx.statusRaw = cmd::STATUS_WRITE_CRC_ERROR;
-  clearFrameLog(ctx);
-  st = device.writeAlertLimitRaw(AlertLimitKind::HIGH_SET, 0x2222);
-  TEST_ASSERT_EQUAL(Err::WRITE_CRC_ERROR, st.code);
-  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, device.protocolFailures());
+  request.requestId = 12;
+  request.deadlineMs = ctx.nowMs + 150u;
+  request.hasDeadline = true;
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.requestContinuous(request).code);
+  completed = 0;
+  for (uint32_t step = 0; step < 400 && !result.terminal; ++step) {
+    advancePreciseTimeMs(ctx, 1);
+    (void)device.pollJob(ctx.nowMs, 1, result);
+    completed += result.completed ? 1u : 0u;
+  }
+  TEST_ASSERT_TRUE(result.terminal);
+  TEST_ASSERT_EQUAL(JobOutcome::TIMED_OUT, result.outcome);
+  TEST_ASSERT_EQUAL_UINT32(12u, result.requestId);
+  TEST_ASSERT_EQUAL_UINT32(1u, completed);
 }
 
-void test_disable_alerts_second_write_failure_exposes_partial_cache() {
-  FrameScriptTransport ctx;
+void test_periodic_sample_sequence_counts_overwritten_slots() {
+  PreciseTimingTransport ctx;
+  setPreciseTime(ctx, 1000);
   SHT3xDevice device;
-  Config cfg = makeFrameConfig(ctx);
-  Status st = device.begin(cfg);
+  Status st = device.bind(makePreciseTimingConfig(ctx));
   TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_EQUAL_UINT32(0u, device.sampleSequence());
+  st = device.startPeriodic(PeriodicRate::MPS_10, Repeatability::HIGH_REPEATABILITY);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  JobRequest request;
+  request.requestId = 21;
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.requestContinuous(request).code);
 
-  ctx.failCommand = cmd::CMD_ALERT_WRITE_LOW_SET;
-  ctx.failCommandStatus = Status::Error(Err::I2C_TIMEOUT, "low set timeout", -27);
-  clearFrameLog(ctx);
-
-  st = device.disableAlerts();
-  TEST_ASSERT_EQUAL(Err::I2C_TIMEOUT, st.code);
-  TEST_ASSERT_EQUAL_INT32(-27, st.detail);
-  CachedSettings cached = device.getCachedSettings();
-  const uint8_t highSet = static_cast<uint8_t>(AlertLimitKind::HIGH_SET);
-  const uint8_t lowSet = static_cast<uint8_t>(AlertLimitKind::LOW_SET);
-  TEST_ASSERT_TRUE(cached.alertValid[highSet]);
-  TEST_ASSERT_EQUAL_UINT16(0x0000, cached.alertRaw[highSet]);
-  TEST_ASSERT_FALSE(cached.alertValid[lowSet]);
-  TEST_ASSERT_EQUAL(3u, ctx.commandCount);
-  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_ALERT_WRITE_HIGH_SET, ctx.commands[0]);
-  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[1]);
-  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_ALERT_WRITE_LOW_SET, ctx.commands[2]);
-  TEST_ASSERT_EQUAL_UINT32(1u, ctx.reads);
+  // Fetches land period + margin apart, so the phase drifts until one fetch
+  // finds the sensor has already overwritten a slot.
+  PollJobResult result;
+  uint32_t completed = 0;
+  uint32_t gapAtSample = 0;
+  for (uint32_t step = 0; step < 3000 && completed < 25; ++step) {
+    advancePreciseTimeMs(ctx, 1);
+    (void)device.pollJob(ctx.nowMs, 1, result);
+    if (!result.completed) {
+      continue;
+    }
+    completed++;
+    if (gapAtSample == 0 && device.lostSamples() != 0) {
+      gapAtSample = completed;
+    }
+    TEST_ASSERT_EQUAL_UINT32(completed + device.lostSamples(), device.sampleSequence());
+  }
+  TEST_ASSERT_EQUAL_UINT32(25u, completed);
+  TEST_ASSERT_EQUAL_UINT32(17u, gapAtSample);
+  TEST_ASSERT_EQUAL_UINT32(1u, device.lostSamples());
+  TEST_ASSERT_EQUAL_UINT32(1u, device.sampleGapCount());
+  SampleGap gaps[SAMPLE_GAP_HISTORY];
+  size_t count = 0;
+  TEST_ASSERT_TRUE(device.getSampleGaps(gaps, SAMPLE_GAP_HISTORY, count).ok());
+  TEST_ASSERT_EQUAL_UINT32(1u, count);
+  TEST_ASSERT_EQUAL_UINT32(gapAtSample, gaps[0].firstMissing);
+  TEST_ASSERT_EQUAL_UINT32(1u, gaps[0].count);
+
+  // A fetch held back by several periods loses every slot in between.
+  const uint32_t before = device.sampleSequence();
+  advancePreciseTimeMs(ctx, 350);
+  PollJobResult late;
+  for (uint32_t step = 0; step < 200 && !late.completed; ++step) {
+    (void)device.pollJob(ctx.nowMs, 1, late);
+    advancePreciseTimeMs(ctx, 1);
+  }
+  TEST_ASSERT_TRUE(late.completed);
+  TEST_ASSERT_EQUAL_UINT32(before + 1u + 3u, device.sampleSequence());
+  TEST_ASSERT_EQUAL_UINT32(2u, device.sampleGapCount());
+  TEST_ASSERT_TRUE(device.getSampleGaps(gaps, SAMPLE_GAP_HISTORY, count).ok());
+  TEST_ASSERT_EQUAL_UINT32(2u, count);
+  TEST_ASSERT_EQUAL_UINT32(before + 1u, gaps[1].firstMissing);
+  TEST_ASSERT_EQUAL_UINT32(3u, gaps[1].count);
 }
 
-void test_public_recover_bus_reset_failure_preserves_precise_status() {
-  FrameScriptTransport ctx;
+void test_periodic_sequence_relearns_phase_from_not_ready_and_gap_ring_wraps() {
+  PreciseTimingTransport ctx;
+  setPreciseTime(ctx, 1000);
   SHT3xDevice device;
-  Config cfg = makeFrameConfig(ctx);
-  cfg.busReset = frameBusResetFail;
-  cfg.recoverUseBusReset = true;
-  cfg.recoverUseSoftReset = false;
-  cfg.recoverUseHardReset = false;
-  Status st = device.begin(cfg);
+  Config cfg = makePreciseTimingConfig(ctx);
+  cfg.transportCapabilities = TransportCapability::READ_HEADER_NACK;
+  Status st = device.bind(cfg);
   TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  st = device.startPeriodic(PeriodicRate::MPS_10, Repeatability::HIGH_REPEATABILITY);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  JobRequest request;
+  request.requestId = 22;
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.requestContinuous(request).code);
 
-  ctx.readStatus = Status::Error(Err::I2C_TIMEOUT, "probe timeout", -24);
-  clearFrameLog(ctx);
+  // The first fetch is NACKed: slot 0 is later than assumed, so the next
+  // fetch one period on holds slot 0's successor and slot 0 is reported lost.
+  PollJobResult result;
+  ctx.readStatus = Status::Error(Err::I2C_NACK_READ, "not ready");
+  for (uint32_t step = 0; step < 100 && device.totalNotReady() == 0; ++step) {
+    advancePreciseTimeMs(ctx, 1);
+    (void)device.pollJob(ctx.nowMs, 1, result);
+  }
+  TEST_ASSERT_EQUAL_UINT32(1u, device.totalNotReady());
+  TEST_ASSERT_EQUAL_UINT32(0u, device.sampleSequence());
+  const uint32_t originAfterNack = device._slotOriginMs;
+  TEST_ASSERT_EQUAL_UINT32(ctx.nowMs + 1u, originAfterNack);
+  ctx.readStatus = Status::Ok();
+  for (uint32_t step = 0; step < 200 && !result.completed; ++step) {
+    advancePreciseTimeMs(ctx, 1);
+    (void)device.pollJob(ctx.nowMs, 1, result);
+  }
+  TEST_ASSERT_TRUE(result.completed);
+  TEST_ASSERT_EQUAL_UINT32(2u, device.sampleSequence());
+  TEST_ASSERT_EQUAL_UINT32(1u, device.lostSamples());
 
-  st = device.recover();
-  TEST_ASSERT_EQUAL(Err::I2C_BUS, st.code);
-  TEST_ASSERT_EQUAL_INT32(-88, st.detail);
-  TEST_ASSERT_EQUAL(DriverState::DEGRADED, device.state());
-  TEST_ASSERT_EQUAL_UINT32(1u, device.totalFailures());
-  TEST_ASSERT_EQUAL(1u, ctx.commandCount);
-  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[0]);
-  TEST_ASSERT_EQUAL_UINT32(1u, ctx.reads);
+  // Only the newest SAMPLE_GAP_HISTORY gaps are kept, oldest first.
+  for (uint32_t i = 0; i < SAMPLE_GAP_HISTORY + 2u; ++i) {
+    device._recordSampleSequence(i + 2u);
+  }
+  TEST_ASSERT_EQUAL_UINT32(SAMPLE_GAP_HISTORY + 3u, device.sampleGapCount());
+  SampleGap gaps[3];
+  size_t count = 0;
+  TEST_ASSERT_TRUE(device.getSampleGaps(gaps, 3, count).ok());
+  TEST_ASSERT_EQUAL_UINT32(3u, count);
+  TEST_ASSERT_EQUAL_UINT32(SAMPLE_GAP_HISTORY, gaps[0].count);
+  TEST_ASSERT_EQUAL_UINT32(SAMPLE_GAP_HISTORY + 2u, gaps[2].count);
+  TEST_ASSERT_EQUAL_UINT32(device.sampleSequence() - gaps[2].count, gaps[2].firstMissing);
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, device.getSampleGaps(nullptr, 1, count).code);
+  TEST_ASSERT_EQUAL_UINT32(0u, count);
+  TEST_ASSERT_TRUE(device.getSampleGaps(nullptr, 0, count).ok());
+
+  device.end();
+  TEST_ASSERT_EQUAL_UINT32(0u, device.sampleSequence());
+  TEST_ASSERT_EQUAL_UINT32(0u, device.lostSamples());
+  TEST_ASSERT_EQUAL_UINT32(0u, device.sampleGapCount());
 }
 
-void test_recover_unknown_state_requires_reset_proof() {
-  {
-    FrameScriptTransport ctx;
+// Runs a continuous job on a sleeping owner until `samples` are captured.
+static void runPeriodicOwner(sim::Clock& clock, SHT3xDevice& device, uint32_t samples) {
+  JobRequest request;
+  request.requestId = 23;
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.requestContinuous(request).code);
+  PollJobResult result;
+  for (uint32_t step = 0; step < 20u * samples && device.sampleSequence() < samples; ++step) {
+    (void)device.pollJob(sim::clockNowMs(&clock), 1, result);
+    TEST_ASSERT_FALSE(result.terminal);
+    uint32_t wakeMs = 0;
+    if (device.jobWakeMs(sim::clockNowMs(&clock), wakeMs) &&
+        wakeMs != sim::clockNowMs(&clock)) {
+      clock.advanceUs(static_cast<uint64_t>(wakeMs - sim::clockNowMs(&clock)) * 1000ULL);
+    } else {
+      clock.advanceUs(1000);
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT32(samples, device.sampleSequence());
+}
+
+void test_periodic_sequence_learns_slow_oscillator_period() {
+  // A slow oscillator must neither lose slots to a fetch schedule built on
+  // the nominal period nor be reported as losing them.
+  const int32_t errorsPpm[] = {0, 30000, 50000};
+  for (int32_t errorPpm : errorsPpm) {
+    sim::Clock clock;
+    clock.virtualTime = true;
+    clock.virtualUs = 1000000;
+    sim::VirtualSht3x sensor;
+    sensor.periodErrorPpm = errorPpm;
+    Config cfg;
+    sim::attach(cfg, sensor, clock);
     SHT3xDevice device;
-    Config cfg = makeFrameConfig(ctx);
-    cfg.recoverUseBusReset = false;
-    cfg.recoverUseSoftReset = true;
-    cfg.recoverUseHardReset = false;
-    cfg.allowGeneralCallReset = false;
-    Status st = device.bind(cfg);
+    TEST_ASSERT_TRUE(device.begin(cfg).ok());
+    Status st = device.startPeriodic(PeriodicRate::MPS_10, Repeatability::HIGH_REPEATABILITY);
     TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-    TEST_ASSERT_FALSE(device.hardwareStateValid());
-    clearFrameLog(ctx);
+    runPeriodicOwner(clock, device, 300);
+
+    char message[64];
+    std::snprintf(message, sizeof(message), "period error %ld ppm", static_cast<long>(errorPpm));
+    TEST_ASSERT_EQUAL_MESSAGE(0u, device.lostSamples(), message);
+    TEST_ASSERT_EQUAL_MESSAGE(0u, sensor.overwrittenSlots, message);
+    // Learned period within 1 % of the sensor's own, so early fetches stay rare.
+    TEST_ASSERT_TRUE_MESSAGE(sensor.readNacks <= 10u, message);
+    const uint32_t truePeriodQ8 =
+        static_cast<uint32_t>(25600 + static_cast<int64_t>(25600) * errorPpm / 1000000);
+    TEST_ASSERT_UINT32_WITHIN(256u, truePeriodQ8, device._slotPeriodQ8);
+  }
+}
 
-    st = device.recover();
+void test_allan_deviation_matches_direct_overlapping_estimate() {
+  static AllanDeviation allan;
+  allan.reset();
+  AllanPoint point;
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, allan.getPoint(ALLAN_OCTAVES, point).code);
+  TEST_ASSERT_EQUAL(Err::MEASUREMENT_NOT_READY, allan.getPoint(0, point).code);
+
+  // Deterministic noisy series with a slow drift, longer than the history.
+  static uint16_t temperature[600];
+  static uint16_t humidity[600];
+  uint32_t lcg = 12345u;
+  for (size_t i = 0; i < 600; ++i) {
+    lcg = lcg * 1103515245u + 12345u;
+    temperature[i] = static_cast<uint16_t>(26000u + i / 8u + ((lcg >> 16) & 0x0Fu));
+    humidity[i] = static_cast<uint16_t>(30000u + ((lcg >> 20) & 0x3Fu));
+    RawSample sample;
+    sample.rawTemperature = temperature[i];
+    sample.rawHumidity = humidity[i];
+    allan.add(sample);
+  }
+  TEST_ASSERT_EQUAL_UINT32(600u, allan.samples());
+
+  for (uint8_t octave = 0; octave < ALLAN_OCTAVES; ++octave) {
+    const uint32_t m = 1u << octave;
+    double sumT = 0.0;
+    double sumRh = 0.0;
+    uint32_t terms = 0;
+    for (size_t i = 0; i + 2u * m <= 600u; ++i) {
+      double a = 0.0;
+      double b = 0.0;
+      double c = 0.0;
+      double d = 0.0;
+      for (uint32_t j = 0; j < m; ++j) {
+        a += temperature[i + j];
+        b += temperature[i + m + j];
+        c += humidity[i + j];
+        d += humidity[i + m + j];
+      }
+      sumT += (b - a) * (b - a) / (static_cast<double>(m) * m);
+      sumRh += (d - c) * (d - c) / (static_cast<double>(m) * m);
+      terms++;
+    }
+    const float expectedT =
+        static_cast<float>(std::sqrt(sumT / (2.0 * terms)) * 175.0 / 65535.0);
+    const float expectedRh =
+        static_cast<float>(std::sqrt(sumRh / (2.0 * terms)) * 100.0 / 65535.0);
+    Status st = allan.getPoint(octave, point);
     TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-    TEST_ASSERT_TRUE(device.hardwareStateValid());
-    TEST_ASSERT_EQUAL(Mode::SINGLE_SHOT, device._mode);
-    TEST_ASSERT_EQUAL(4u, ctx.commandCount);
-    TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[0]);
-    TEST_ASSERT_EQUAL_UINT16(cmd::CMD_BREAK, ctx.commands[1]);
-    TEST_ASSERT_EQUAL_UINT16(cmd::CMD_SOFT_RESET, ctx.commands[2]);
-    TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[3]);
-    TEST_ASSERT_EQUAL_UINT32(2u, ctx.reads);
+    TEST_ASSERT_EQUAL_UINT32(m, point.averagingFactor);
+    TEST_ASSERT_EQUAL_UINT32(terms, point.terms);
+    TEST_ASSERT_FLOAT_WITHIN(expectedT * 1e-4f, expectedT, point.temperatureC);
+    TEST_ASSERT_FLOAT_WITHIN(expectedRh * 1e-4f, expectedRh, point.humidityPct);
   }
+}
 
-  {
-    FrameScriptTransport ctx;
-    SHT3xDevice device;
-    Config cfg = makeFrameConfig(ctx);
-    cfg.busReset = frameBusResetOk;
-    cfg.recoverUseBusReset = true;
-    cfg.recoverUseSoftReset = false;
-    cfg.recoverUseHardReset = false;
-    cfg.allowGeneralCallReset = false;
-    Status st = device.bind(cfg);
-    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-    clearFrameLog(ctx);
+void test_allan_deviation_alternating_series_and_reset() {
+  static AllanDeviation allan;
+  allan.reset();
+  RawSample sample;
+  for (uint32_t i = 0; i < 64; ++i) {
+    sample.rawTemperature = (i & 1u) ? 1002u : 1000u;
+    sample.rawHumidity = 5000u;
+    allan.add(sample);
+  }
+  // m = 1: every adjacent difference is 2 counts, sigma^2 = 4 / 2. Larger
+  // even windows hold equal sums, so their deviation is exactly zero.
+  AllanPoint point;
+  TEST_ASSERT_TRUE(allan.getPoint(0, point).ok());
+  TEST_ASSERT_EQUAL_UINT32(63u, point.terms);
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.41421356f * 175.0f / 65535.0f, point.temperatureC);
+  TEST_ASSERT_FLOAT_WITHIN(0.0f, 0.0f, point.humidityPct);
+  TEST_ASSERT_TRUE(allan.getPoint(3, point).ok());
+  TEST_ASSERT_EQUAL_UINT32(49u, point.terms);
+  TEST_ASSERT_FLOAT_WITHIN(0.0f, 0.0f, point.temperatureC);
+  TEST_ASSERT_EQUAL(Err::MEASUREMENT_NOT_READY, allan.getPoint(6, point).code);
+  TEST_ASSERT_EQUAL_UINT32(64u, point.averagingFactor);
+
+  allan.reset();
+  TEST_ASSERT_EQUAL_UINT32(0u, allan.samples());
+  TEST_ASSERT_EQUAL(Err::MEASUREMENT_NOT_READY, allan.getPoint(0, point).code);
+}
+
+// Double-precision constant-velocity Kalman filter with the same model as
+// KalmanFilter, for checking the fixed-point implementation.
+struct KalmanReference {
+  double level = 0.0;
+  double rate = 0.0;
+  double p00 = 0.0;
+  double p01 = 0.0;
+  double p11 = 0.0;
+
+  void start(double z, double r) {
+    level = z;
+    rate = 0.0;
+    p00 = r;
+    p01 = 0.0;
+    p11 = 1e6;
+  }
 
-    st = device.recover();
-    TEST_ASSERT_EQUAL(Err::BUSY, st.code);
-    TEST_ASSERT_FALSE(device.hardwareStateValid());
-    TEST_ASSERT_EQUAL(2u, ctx.commandCount);
-    TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[0]);
-    TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[1]);
-    TEST_ASSERT_EQUAL_UINT32(2u, ctx.reads);
+  void step(double z, double r, double q, double dt) {
+    level += rate * dt;
+    p00 += dt * (2.0 * p01 + dt * p11) + q * dt * dt * dt / 3.0;
+    p01 += dt * p11 + q * dt * dt / 2.0;
+    p11 += q * dt;
+    const double s = p00 + r;
+    const double k0 = p00 / s;
+    const double k1 = p01 / s;
+    const double y = z - level;
+    level += k0 * y;
+    rate += k1 * y;
+    p11 -= k1 * p01;
+    p01 -= k0 * p01;
+    p00 -= k0 * p00;
+  }
+};
+
+static uint16_t rawFromMilliCelsius(int32_t milli) {
+  return static_cast<uint16_t>((static_cast<int64_t>(milli) + 45000) * 65535 / 175000);
+}
+
+void test_kalman_filter_tracks_ramp_like_double_reference() {
+  static KalmanFilter filter;
+  KalmanConfig config;
+  config.temperatureAccelMilliCelsiusPerS2 = 0;
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, filter.configure(config).code);
+  config.temperatureAccelMilliCelsiusPerS2 = KALMAN_MAX_ACCEL + 1u;
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, filter.configure(config).code);
+  config.temperatureAccelMilliCelsiusPerS2 = 1000;
+  config.repeatability = Repeatability::HIGH_REPEATABILITY;
+  TEST_ASSERT_TRUE(filter.configure(config).ok());
+  KalmanEstimate estimate;
+  TEST_ASSERT_EQUAL(Err::MEASUREMENT_NOT_READY, filter.getEstimate(estimate).code);
+
+  // 20 C, then a door opens: -2 C/s for 4 s, sampled at irregular 60-140 ms
+  // intervals with +/-20 m C noise.
+  KalmanReference reference;
+  const double noise = 178.0;
+  const double q = 1000.0 * 1000.0;
+  uint32_t lcg = 99u;
+  uint32_t nowMs = 1000u;
+  uint32_t lastMs = nowMs;
+  double worstLevelError = 0.0;
+  double worstRateError = 0.0;
+  for (int i = 0; i < 120; ++i) {
+    lcg = lcg * 1103515245u + 12345u;
+    const uint32_t stepMs = 60u + ((lcg >> 16) % 81u);
+    if (i > 0) {
+      nowMs += stepMs;
+    }
+    const double t = (nowMs - 1000u) / 1000.0;
+    const double truth = (t < 4.0) ? 20000.0 : 20000.0 - 2000.0 * ((t < 8.0) ? t - 4.0 : 4.0);
+    const int32_t jitter = static_cast<int32_t>((lcg >> 8) % 41u) - 20;
+    RawSample sample;
+    sample.rawTemperature = rawFromMilliCelsius(static_cast<int32_t>(truth) + jitter);
+    sample.rawHumidity = 0x8000;
+    filter.update(sample, nowMs);
+
+    const double z = SHT3xDevice::convertTemperatureMilliCelsius(sample.rawTemperature);
+    if (i == 0) {
+      reference.start(z, noise);
+    } else {
+      reference.step(z, noise, q, (nowMs - lastMs) / 1000.0);
+    }
+    lastMs = nowMs;
+    TEST_ASSERT_TRUE(filter.getEstimate(estimate).ok());
+    const double levelError = std::fabs(estimate.temperatureMilliCelsius - reference.level);
+    const double rateError =
+        std::fabs(estimate.temperatureRateMilliCelsiusPerS - reference.rate);
+    worstLevelError = levelError > worstLevelError ? levelError : worstLevelError;
+    worstRateError = rateError > worstRateError ? rateError : worstRateError;
   }
+  TEST_ASSERT_TRUE(worstLevelError <= 2.0);
+  TEST_ASSERT_TRUE(worstRateError <= 5.0);
+  TEST_ASSERT_EQUAL_UINT32(120u, estimate.samples);
+  TEST_ASSERT_EQUAL_UINT32(nowMs, estimate.timestampMs);
+  TEST_ASSERT_INT32_WITHIN(60, 12000, estimate.temperatureMilliCelsius);
+  TEST_ASSERT_INT32_WITHIN(250, 0, estimate.temperatureRateMilliCelsiusPerS);
+  TEST_ASSERT_INT32_WITHIN(60, 50000, estimate.humidityMilliPercent);
+  TEST_ASSERT_TRUE(estimate.temperatureStdDevMilliCelsius > 0u);
+  TEST_ASSERT_TRUE(estimate.temperatureStdDevMilliCelsius < 14u);
+}
+
+void test_kalman_filter_restarts_on_gaps_and_skips_consumed_device_samples() {
+  static KalmanFilter filter;
+  TEST_ASSERT_TRUE(filter.configure(KalmanConfig{}).ok());
+  RawSample sample;
+  sample.rawTemperature = rawFromMilliCelsius(25000);
+  sample.rawHumidity = 0x8000;
+  filter.update(sample, 5000u);
+  filter.update(sample, 5100u);
+  KalmanEstimate estimate;
+  TEST_ASSERT_TRUE(filter.getEstimate(estimate).ok());
+  TEST_ASSERT_EQUAL_UINT32(2u, estimate.samples);
+
+  // A gap beyond KALMAN_MAX_GAP_MS and a backwards timestamp both restart
+  // at the new sample with zero rate.
+  sample.rawTemperature = rawFromMilliCelsius(30000);
+  filter.update(sample, 5100u + KALMAN_MAX_GAP_MS + 1u);
+  TEST_ASSERT_TRUE(filter.getEstimate(estimate).ok());
+  TEST_ASSERT_EQUAL_UINT32(1u, estimate.samples);
+  TEST_ASSERT_INT32_WITHIN(3, 30000, estimate.temperatureMilliCelsius);
+  TEST_ASSERT_EQUAL_INT32(0, estimate.temperatureRateMilliCelsiusPerS);
+  TEST_ASSERT_EQUAL_UINT32(13u, estimate.temperatureStdDevMilliCelsius);
+  filter.update(sample, 100u);
+  TEST_ASSERT_TRUE(filter.getEstimate(estimate).ok());
+  TEST_ASSERT_EQUAL_UINT32(1u, estimate.samples);
+  TEST_ASSERT_EQUAL_UINT32(100u, estimate.timestampMs);
 
-  {
-    FrameScriptTransport ctx;
-    ctx.statusRaw = cmd::STATUS_COMMAND_ERROR;
-    SHT3xDevice device;
-    Config cfg = makeFrameConfig(ctx);
-    cfg.recoverUseBusReset = false;
-    cfg.recoverUseSoftReset = true;
-    cfg.recoverUseHardReset = false;
-    cfg.allowGeneralCallReset = false;
-    Status st = device.bind(cfg);
+  SHT3xDevice device;
+  TEST_ASSERT_EQUAL(Err::NOT_INITIALIZED, filter.update(device).code);
+  device._initialized = true;
+  device._config.repeatability = Repeatability::LOW_REPEATABILITY;
+  device._rawSample = sample;
+  device._hasSample = true;
+  device._sampleSequence = 7;
+  device._sampleTimestampMs = 200;
+  filter.reset();
+  TEST_ASSERT_TRUE(filter.update(device).ok());
+  TEST_ASSERT_TRUE(filter.update(device).ok());
+  TEST_ASSERT_TRUE(filter.getEstimate(estimate).ok());
+  TEST_ASSERT_EQUAL_UINT32(1u, estimate.samples);
+  TEST_ASSERT_EQUAL_UINT32(50u, estimate.temperatureStdDevMilliCelsius);
+  device._sampleSequence = 8;
+  device._sampleTimestampMs = 300;
+  TEST_ASSERT_TRUE(filter.update(device).ok());
+  TEST_ASSERT_TRUE(filter.getEstimate(estimate).ok());
+  TEST_ASSERT_EQUAL_UINT32(2u, estimate.samples);
+}
+
+void test_alarm_engine_debounce_hysteresis_and_holdoff_emit_only_transitions() {
+  static AlarmEngine engine;
+  AlarmRule rule;
+  uint16_t index = 0;
+  rule.metric = static_cast<AlarmMetric>(3);
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, engine.addRule(rule, index).code);
+  rule.metric = AlarmMetric::HUMIDITY;
+  rule.hysteresisMilli = -1;
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, engine.addRule(rule, index).code);
+
+  // RH > 85 % for 1 s, clearing under 83 %.
+  rule.thresholdMilli = 85000;
+  rule.hysteresisMilli = 2000;
+  rule.debounceMs = 1000;
+  TEST_ASSERT_TRUE(engine.addRule(rule, index).ok());
+  TEST_ASSERT_EQUAL_UINT16(0, index);
+  // T < 0 C, immediate, at most one transition per 5 s.
+  rule = AlarmRule{};
+  rule.direction = AlarmDirection::BELOW;
+  rule.hysteresisMilli = 500;
+  rule.holdOffMs = 5000;
+  TEST_ASSERT_TRUE(engine.addRule(rule, index).ok());
+  TEST_ASSERT_EQUAL_UINT16(1, index);
+  TEST_ASSERT_EQUAL_UINT32(2u, engine.rules());
+
+  MeasurementMilli batch[2] = {{20000, 90000}, {20000, 50000}};
+  AlarmTransition out[4];
+  size_t written = 99;
+  auto evaluateAt = [&](uint32_t nowMs) {
+    const Status st = engine.evaluate(nowMs, batch, 2, out, 4, written);
     TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-    clearFrameLog(ctx);
+    return written;
+  };
 
-    st = device.recover();
-    TEST_ASSERT_EQUAL(Err::COMMAND_FAILED, st.code);
-    TEST_ASSERT_FALSE(device.hardwareStateValid());
-    TEST_ASSERT_EQUAL_UINT32(2u, device.protocolFailures());
-    TEST_ASSERT_EQUAL(4u, ctx.commandCount);
-    TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[0]);
-    TEST_ASSERT_EQUAL_UINT16(cmd::CMD_BREAK, ctx.commands[1]);
-    TEST_ASSERT_EQUAL_UINT16(cmd::CMD_SOFT_RESET, ctx.commands[2]);
-    TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[3]);
-    TEST_ASSERT_EQUAL_UINT32(2u, ctx.reads);
+  TEST_ASSERT_EQUAL_UINT32(0u, evaluateAt(0));
+  TEST_ASSERT_EQUAL_UINT32(0u, evaluateAt(999));
+  TEST_ASSERT_EQUAL_UINT32(1u, evaluateAt(1000));
+  TEST_ASSERT_EQUAL_UINT16(0, out[0].rule);
+  TEST_ASSERT_EQUAL_UINT16(0, out[0].sensor);
+  TEST_ASSERT_TRUE(out[0].active);
+  TEST_ASSERT_EQUAL_INT32(90000, out[0].valueMilli);
+  TEST_ASSERT_EQUAL_UINT32(1000u, out[0].timeMs);
+  TEST_ASSERT_EQUAL_UINT32(0u, evaluateAt(1500));
+  TEST_ASSERT_TRUE(engine.isActive(0, 0));
+
+  // Inside the hysteresis band the alarm holds; a dip that recovers before
+  // the debounce restarts the clear timer.
+  batch[0].humidityMilliPercent = 84000;
+  TEST_ASSERT_EQUAL_UINT32(0u, evaluateAt(2000));
+  batch[0].humidityMilliPercent = 82000;
+  TEST_ASSERT_EQUAL_UINT32(0u, evaluateAt(2500));
+  batch[0].humidityMilliPercent = 84000;
+  TEST_ASSERT_EQUAL_UINT32(0u, evaluateAt(3000));
+  batch[0].humidityMilliPercent = 82000;
+  TEST_ASSERT_EQUAL_UINT32(0u, evaluateAt(3200));
+  TEST_ASSERT_EQUAL_UINT32(0u, evaluateAt(4199));
+  TEST_ASSERT_EQUAL_UINT32(1u, evaluateAt(4200));
+  TEST_ASSERT_FALSE(out[0].active);
+  TEST_ASSERT_FALSE(engine.isActive(0, 0));
+
+  // The first transition is immediate; the clear waits out the hold-off.
+  batch[1].temperatureMilliCelsius = -100;
+  TEST_ASSERT_EQUAL_UINT32(1u, evaluateAt(5000));
+  TEST_ASSERT_EQUAL_UINT16(1, out[0].rule);
+  TEST_ASSERT_EQUAL_UINT16(1, out[0].sensor);
+  TEST_ASSERT_TRUE(out[0].active);
+  batch[1].temperatureMilliCelsius = 400;
+  TEST_ASSERT_EQUAL_UINT32(0u, evaluateAt(5100));
+  batch[1].temperatureMilliCelsius = 600;
+  TEST_ASSERT_EQUAL_UINT32(0u, evaluateAt(9999));
+  TEST_ASSERT_EQUAL_UINT32(1u, evaluateAt(10000));
+  TEST_ASSERT_FALSE(out[0].active);
+  TEST_ASSERT_EQUAL_INT32(600, out[0].valueMilli);
+
+  engine.resetState();
+  TEST_ASSERT_EQUAL_UINT32(2u, engine.rules());
+  batch[1].temperatureMilliCelsius = -100;
+  TEST_ASSERT_EQUAL_UINT32(1u, evaluateAt(10001));
+  engine.clear();
+  TEST_ASSERT_EQUAL_UINT32(0u, engine.rules());
+  TEST_ASSERT_FALSE(engine.isActive(1, 1));
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM,
+                    engine.evaluate(0, batch, ALARM_MAX_SENSORS + 1, out, 4, written).code);
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, engine.evaluate(0, nullptr, 2, out, 4, written).code);
+}
+
+// Branching per-pair alarm state machine, for checking the vectorized sweep.
+struct AlarmReference {
+  bool active = false;
+  bool pending = false;
+  bool changed = false;
+  uint32_t sinceMs = 0;
+  uint32_t changedMs = 0;
+
+  bool step(const AlarmRule& rule, int32_t value, uint32_t nowMs) {
+    bool condition;
+    if (rule.direction == AlarmDirection::ABOVE) {
+      condition = active ? value > rule.thresholdMilli - rule.hysteresisMilli
+                         : value > rule.thresholdMilli;
+    } else {
+      condition = active ? value < rule.thresholdMilli + rule.hysteresisMilli
+                         : value < rule.thresholdMilli;
+    }
+    if (condition == active) {
+      pending = false;
+      return false;
+    }
+    if (!pending) {
+      pending = true;
+      sinceMs = nowMs;
+    }
+    if (nowMs - sinceMs < rule.debounceMs) {
+      return false;
+    }
+    if (changed && nowMs - changedMs < rule.holdOffMs) {
+      return false;
+    }
+    active = !active;
+    pending = false;
+    changed = true;
+    changedMs = nowMs;
+    return true;
   }
-}
+};
 
-void test_recover_periodic_requires_break_before_success() {
-  FrameScriptTransport ctx;
-  SHT3xDevice device;
-  Config cfg = makeFrameConfig(ctx);
-  cfg.recoverUseBusReset = false;
-  cfg.recoverUseSoftReset = true;
-  cfg.recoverUseHardReset = false;
-  cfg.allowGeneralCallReset = false;
-  Status st = device.begin(cfg);
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  st = device.startPeriodic(PeriodicRate::MPS_1, Repeatability::HIGH_REPEATABILITY);
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+void test_alarm_engine_matches_scalar_reference_and_reports_dropped_transitions() {
+  static AlarmEngine engine;
+  AlarmRule rules[3];
+  rules[0].metric = AlarmMetric::HUMIDITY;
+  rules[0].thresholdMilli = 60000;
+  rules[0].hysteresisMilli = 3000;
+  rules[0].debounceMs = 300;
+  rules[1].direction = AlarmDirection::BELOW;
+  rules[1].thresholdMilli = 22000;
+  rules[1].hysteresisMilli = 1000;
+  rules[1].holdOffMs = 700;
+  rules[2].metric = AlarmMetric::DEW_POINT_MARGIN;
+  rules[2].direction = AlarmDirection::BELOW;
+  rules[2].thresholdMilli = 2000;
+  rules[2].hysteresisMilli = 500;
+  rules[2].debounceMs = 200;
+  rules[2].holdOffMs = 400;
+  for (uint16_t r = 0; r < 3; ++r) {
+    uint16_t index = 0;
+    TEST_ASSERT_TRUE(engine.addRule(rules[r], index).ok());
+  }
 
-  clearFrameLog(ctx);
+  // T = 10 C at 95 %RH has a Magnus dew point of 9.235 C.
+  MeasurementMilli one = {10000, 95000};
+  AlarmTransition out[3 * ALARM_MAX_SENSORS];
+  size_t written = 0;
+  TEST_ASSERT_TRUE(engine.evaluate(0, &one, 1, out, 3, written).ok());
+  TEST_ASSERT_EQUAL_UINT32(1u, written);
+  TEST_ASSERT_EQUAL_UINT16(1, out[0].rule);
+  TEST_ASSERT_TRUE(engine.evaluate(300, &one, 1, out, 3, written).ok());
+  TEST_ASSERT_EQUAL_UINT32(2u, written);
+  TEST_ASSERT_EQUAL_UINT16(0, out[0].rule);
+  TEST_ASSERT_EQUAL_UINT16(2, out[1].rule);
+  TEST_ASSERT_INT32_WITHIN(10, 765, out[1].valueMilli);
+  engine.resetState();
+
+  static AlarmReference reference[3][ALARM_MAX_SENSORS];
+  MeasurementMilli batch[ALARM_MAX_SENSORS];
+  uint32_t seed = 12345;
+  uint32_t nowMs = 0xFFFFF000u; // wraps mid-run
+  size_t total = 0;
+  for (uint32_t round = 0; round < 400; ++round) {
+    for (size_t s = 0; s < ALARM_MAX_SENSORS; ++s) {
+      seed = seed * 1664525u + 1013904223u;
+      batch[s].temperatureMilliCelsius = 15000 + static_cast<int32_t>((seed >> 8) % 12000);
+      batch[s].humidityMilliPercent = 50000 + static_cast<int32_t>((seed >> 16) % 20000);
+    }
+    nowMs += 50u + (seed >> 28) * 10u;
+    const Status st = engine.evaluate(nowMs, batch, ALARM_MAX_SENSORS, out,
+                                      3 * ALARM_MAX_SENSORS, written);
+    TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
 
-  st = device.recover();
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  TEST_ASSERT_FALSE(device.isPeriodicActive());
-  TEST_ASSERT_EQUAL(Mode::SINGLE_SHOT, device._mode);
-  TEST_ASSERT_EQUAL(4u, ctx.commandCount);
-  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[0]);
-  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_BREAK, ctx.commands[1]);
-  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_SOFT_RESET, ctx.commands[2]);
-  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[3]);
-  TEST_ASSERT_EQUAL_UINT32(2u, ctx.reads);
-}
+    size_t expected = 0;
+    for (uint16_t r = 0; r < 3; ++r) {
+      for (uint16_t s = 0; s < ALARM_MAX_SENSORS; ++s) {
+        int32_t value = batch[s].humidityMilliPercent;
+        if (rules[r].metric == AlarmMetric::TEMPERATURE) {
+          value = batch[s].temperatureMilliCelsius;
+        } else if (rules[r].metric == AlarmMetric::DEW_POINT_MARGIN) {
+          const double t = batch[s].temperatureMilliCelsius / 1000.0;
+          const double gamma =
+              std::log(batch[s].humidityMilliPercent / 100000.0) + 17.62 * t / (243.12 + t);
+          const double margin = (t - 243.12 * gamma / (17.62 - gamma)) * 1000.0;
+          // Skip pairs whose float margin lands too near a level to compare.
+          if (std::fabs(margin - 2000.0) < 2.0 || std::fabs(margin - 2500.0) < 2.0) {
+            continue;
+          }
+          value = static_cast<int32_t>(margin);
+        }
+        if (reference[r][s].step(rules[r], value, nowMs)) {
+          TEST_ASSERT_TRUE(expected < written);
+          TEST_ASSERT_EQUAL_UINT16(r, out[expected].rule);
+          TEST_ASSERT_EQUAL_UINT16(s, out[expected].sensor);
+          TEST_ASSERT_EQUAL(reference[r][s].active, out[expected].active);
+          expected++;
+        }
+        TEST_ASSERT_EQUAL(reference[r][s].active, engine.isActive(r, s));
+      }
+    }
+    TEST_ASSERT_EQUAL_UINT32(expected, written);
+    total += written;
+  }
+  TEST_ASSERT_TRUE(total > 100u);
 
-void test_stop_periodic_waits_after_break() {
-  FakeTransport bus;
+  // A full buffer keeps the first transitions, counts the rest, and still
+  // advances the state.
+  engine.resetState();
+  for (size_t s = 0; s < ALARM_MAX_SENSORS; ++s) {
+    batch[s] = MeasurementMilli{20000, 65000};
+  }
+  const Status st = engine.evaluate(0, batch, ALARM_MAX_SENSORS, out, 5, written);
+  TEST_ASSERT_EQUAL(Err::BUSY, st.code);
+  TEST_ASSERT_EQUAL_INT32(static_cast<int32_t>(ALARM_MAX_SENSORS) - 5, st.detail);
+  TEST_ASSERT_EQUAL_UINT32(5u, written);
+  TEST_ASSERT_EQUAL_UINT16(4, out[4].sensor);
+  TEST_ASSERT_TRUE(
+      engine.evaluate(1000, batch, ALARM_MAX_SENSORS, out, ALARM_MAX_SENSORS, written).ok());
+  TEST_ASSERT_EQUAL_UINT32(ALARM_MAX_SENSORS, written);
+  TEST_ASSERT_EQUAL_UINT16(0, out[0].rule);
+  TEST_ASSERT_TRUE(engine.isActive(0, ALARM_MAX_SENSORS - 1));
+  TEST_ASSERT_TRUE(engine.isActive(1, ALARM_MAX_SENSORS - 1));
+}
+
+void test_soft_alert_mirrors_set_clear_hysteresis_and_latches_flags() {
+  SoftAlertThreshold thresholds[5];
+  thresholds[0].setMilli = 30000; // T high 30 C, release below 28 C
+  thresholds[0].clearMilli = 28000;
+  thresholds[1].setMilli = 40000; // T high 40 C, no hysteresis
+  thresholds[1].clearMilli = 40000;
+  thresholds[2].kind = SoftAlertKind::LOW_ALERT; // T low 5 C, release above 6 C
+  thresholds[2].setMilli = 5000;
+  thresholds[2].clearMilli = 6000;
+  thresholds[3].channel = SoftAlertChannel::HUMIDITY; // RH high 70 %, release below 65 %
+  thresholds[3].setMilli = 70000;
+  thresholds[3].clearMilli = 65000;
+  thresholds[4] = thresholds[3]; // disabled duplicate
+  thresholds[4].enabled = false;
+
+  SoftAlert alert;
+  thresholds[2].clearMilli = 4000;
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, alert.configure(thresholds, 5).code);
+  thresholds[2].clearMilli = 6000;
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, alert.configure(nullptr, 1).code);
+  thresholds[0].active = true;
+  TEST_ASSERT_TRUE(alert.configure(thresholds, 5).ok());
+  TEST_ASSERT_FALSE(thresholds[0].active);
+
+  SoftAlertEvent events[5];
+  size_t written = 99;
+  MeasurementMilli sample = {25000, 50000};
+  TEST_ASSERT_TRUE(alert.update(sample, 100, events, 5, written).ok());
+  TEST_ASSERT_EQUAL_UINT32(0u, written);
+  TEST_ASSERT_FALSE(alert.status().alertPending);
+
+  sample = {30000, 71000}; // set level itself does not raise; RH does
+  TEST_ASSERT_TRUE(alert.update(sample, 200, events, 5, written).ok());
+  TEST_ASSERT_EQUAL_UINT32(1u, written);
+  TEST_ASSERT_EQUAL_UINT32(3u, events[0].threshold);
+  TEST_ASSERT_TRUE(events[0].active);
+  TEST_ASSERT_EQUAL_INT32(71000, events[0].valueMilli);
+  TEST_ASSERT_EQUAL_UINT32(200u, events[0].timestampMs);
+  SoftAlertStatus status = alert.status();
+  TEST_ASSERT_TRUE(status.alertPending);
+  TEST_ASSERT_TRUE(status.rhAlert);
+  TEST_ASSERT_FALSE(status.tAlert);
+  TEST_ASSERT_TRUE(status.rhActive);
+  TEST_ASSERT_FALSE(thresholds[4].active);
+
+  sample = {30001, 66000};
+  TEST_ASSERT_TRUE(alert.update(sample, 300, events, 5, written).ok());
+  TEST_ASSERT_EQUAL_UINT32(1u, written);
+  TEST_ASSERT_EQUAL_UINT32(0u, events[0].threshold);
+  sample = {28000, 65000}; // both at their clear levels: still raised
+  TEST_ASSERT_TRUE(alert.update(sample, 400, events, 5, written).ok());
+  TEST_ASSERT_EQUAL_UINT32(0u, written);
+  sample = {27999, 64999};
+  TEST_ASSERT_TRUE(alert.update(sample, 500, events, 5, written).ok());
+  TEST_ASSERT_EQUAL_UINT32(2u, written);
+  TEST_ASSERT_FALSE(events[0].active);
+  TEST_ASSERT_EQUAL_UINT32(0u, events[0].threshold);
+  TEST_ASSERT_EQUAL_UINT32(3u, events[1].threshold);
+
+  // Flags stay latched after release until clearStatus().
+  status = alert.status();
+  TEST_ASSERT_TRUE(status.tAlert);
+  TEST_ASSERT_TRUE(status.rhAlert);
+  TEST_ASSERT_FALSE(status.tActive);
+  TEST_ASSERT_FALSE(status.rhActive);
+  TEST_ASSERT_EQUAL_UINT32(4u, status.events);
+  alert.clearStatus();
+  status = alert.status();
+  TEST_ASSERT_FALSE(status.alertPending || status.tAlert || status.rhAlert);
+
+  // Events beyond the buffer are counted; the state still advances.
+  sample = {41000, 80000};
+  Status st = alert.update(sample, 600, events, 1, written);
+  TEST_ASSERT_EQUAL(Err::BUSY, st.code);
+  TEST_ASSERT_EQUAL_INT32(2, st.detail);
+  TEST_ASSERT_EQUAL_UINT32(1u, written);
+  TEST_ASSERT_TRUE(thresholds[0].active && thresholds[1].active && thresholds[3].active);
+  sample = {4000, 50000};
+  st = alert.update(sample, 700, nullptr, 0, written);
+  TEST_ASSERT_EQUAL(Err::BUSY, st.code);
+  TEST_ASSERT_EQUAL_INT32(4, st.detail);
+  TEST_ASSERT_TRUE(thresholds[2].active);
+  TEST_ASSERT_TRUE(alert.status().tActive);
+  alert.reset();
+  TEST_ASSERT_FALSE(thresholds[2].active);
+  TEST_ASSERT_EQUAL_UINT32(0u, alert.status().events);
+}
+
+void test_soft_alert_from_hardware_limits_and_device_samples() {
+  const uint16_t defaults[4] = {0xCD33, 0xC92D, 0x3869, 0x3466};
+  SoftAlertThreshold thresholds[4];
+  SoftAlert::fromAlertLimits(defaults, thresholds);
+  // Limit words hold T9/RH7 steps (0.34 C, 0.78 %RH), truncated.
+  TEST_ASSERT_EQUAL(SoftAlertChannel::TEMPERATURE, thresholds[0].channel);
+  TEST_ASSERT_EQUAL(SoftAlertKind::HIGH_ALERT, thresholds[0].kind);
+  TEST_ASSERT_INT32_WITHIN(350, 60000, thresholds[0].setMilli);
+  TEST_ASSERT_INT32_WITHIN(350, 58000, thresholds[0].clearMilli);
+  TEST_ASSERT_EQUAL(SoftAlertChannel::HUMIDITY, thresholds[1].channel);
+  TEST_ASSERT_INT32_WITHIN(1000, 80000, thresholds[1].setMilli);
+  TEST_ASSERT_INT32_WITHIN(1000, 79000, thresholds[1].clearMilli);
+  TEST_ASSERT_EQUAL(SoftAlertKind::LOW_ALERT, thresholds[2].kind);
+  TEST_ASSERT_INT32_WITHIN(350, -10000, thresholds[2].setMilli);
+  TEST_ASSERT_INT32_WITHIN(350, -9000, thresholds[2].clearMilli);
+  TEST_ASSERT_INT32_WITHIN(1000, 20000, thresholds[3].setMilli);
+  TEST_ASSERT_INT32_WITHIN(1000, 22000, thresholds[3].clearMilli);
+  for (size_t i = 0; i < 4; ++i) {
+    TEST_ASSERT_TRUE(thresholds[i].enabled);
+  }
+
+  SoftAlert alert;
+  TEST_ASSERT_TRUE(alert.configure(thresholds, 4).ok());
+  SoftAlertEvent events[4];
+  size_t written = 0;
   SHT3xDevice device;
-  Config cfg = makeConfig(bus);
-  device._config = cfg;
+  TEST_ASSERT_EQUAL(Err::NOT_INITIALIZED, alert.update(device, events, 4, written).code);
   device._initialized = true;
-  device._driverState = DriverState::READY;
-  device._periodicActive = true;
-  device._mode = Mode::PERIODIC;
-  device._config.mode = Mode::PERIODIC;
-  device._periodMs = 100;
-  device._lastCommandValid = false;
-  bus.nowMs = 10;
-
-  Status st = device.stopPeriodic();
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  TEST_ASSERT_FALSE(device.isPeriodicActive());
-  TEST_ASSERT_TRUE(bus.nowMs >= 11u);
-}
+  device._rawSample.rawTemperature = rawFromMilliCelsius(65000);
+  device._rawSample.rawHumidity = 0x8000;
+  device._hasSample = true;
+  device._sampleSequence = 3;
+  device._sampleTimestampMs = 1234;
+  TEST_ASSERT_TRUE(alert.update(device, events, 4, written).ok());
+  TEST_ASSERT_EQUAL_UINT32(1u, written);
+  TEST_ASSERT_EQUAL_UINT32(1234u, events[0].timestampMs);
+  TEST_ASSERT_TRUE(alert.status().tAlert);
+  alert.clearStatus();
+  // The same sample is not evaluated twice.
+  TEST_ASSERT_TRUE(alert.update(device, events, 4, written).ok());
+  TEST_ASSERT_EQUAL_UINT32(0u, written);
+  device._rawSample.rawTemperature = rawFromMilliCelsius(20000);
+  device._sampleSequence = 4;
+  TEST_ASSERT_TRUE(alert.update(device, events, 4, written).ok());
+  TEST_ASSERT_EQUAL_UINT32(1u, written);
+  TEST_ASSERT_FALSE(events[0].active);
+  TEST_ASSERT_FALSE(alert.status().tAlert);
+
+  // disableAlerts() words leave both channels disabled.
+  const uint16_t disabled[4] = {0x0000, 0xC92D, 0x3869, 0xFFFF};
+  SoftAlert::fromAlertLimits(disabled, thresholds);
+  for (size_t i = 0; i < 4; ++i) {
+    TEST_ASSERT_FALSE(thresholds[i].enabled);
+  }
+  TEST_ASSERT_TRUE(alert.configure(thresholds, 4).ok());
+  const MeasurementMilli hot = {125000, 100000};
+  TEST_ASSERT_TRUE(alert.update(hot, 0, events, 4, written).ok());
+  TEST_ASSERT_EQUAL_UINT32(0u, written);
+}
+
+void test_dead_band_reports_only_changes_beyond_band_and_heartbeats() {
+  DeadBand band;
+  DeadBandConfig config;
+  config.temperatureMilliCelsius = -1;
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, band.configure(config).code);
+  config.temperatureMilliCelsius = 100;
+  config.humidityMilliPercent = 500;
+  config.maxSilenceMs = 10000;
+  TEST_ASSERT_TRUE(band.configure(config).ok());
+
+  MeasurementMilli last;
+  uint32_t lastMs = 0;
+  TEST_ASSERT_EQUAL(Err::MEASUREMENT_NOT_READY, band.getLastReport(last, lastMs).code);
+  TEST_ASSERT_EQUAL(DeadBandReason::FIRST, band.update({22000, 45000}, 1000));
+  // Exactly one band away is still inside; the reference is the last report,
+  // so small steps accumulate until they leave the band.
+  TEST_ASSERT_EQUAL(DeadBandReason::SUPPRESSED, band.update({22100, 45500}, 2000));
+  TEST_ASSERT_EQUAL(DeadBandReason::SUPPRESSED, band.update({21900, 44500}, 3000));
+  TEST_ASSERT_EQUAL(DeadBandReason::CHANGE, band.update({22101, 45000}, 4000));
+  TEST_ASSERT_TRUE(band.getLastReport(last, lastMs).ok());
+  TEST_ASSERT_EQUAL_INT32(22101, last.temperatureMilliCelsius);
+  TEST_ASSERT_EQUAL_UINT32(4000u, lastMs);
+  TEST_ASSERT_EQUAL(DeadBandReason::CHANGE, band.update({22101, 44499}, 5000));
+  TEST_ASSERT_EQUAL(DeadBandReason::CHANGE, band.update({21000, 46000}, 6000));
+
+  // Heartbeat fires on the first quiet sample at or after maxSilenceMs.
+  TEST_ASSERT_EQUAL(DeadBandReason::SUPPRESSED, band.update({21000, 46000}, 15999));
+  TEST_ASSERT_EQUAL(DeadBandReason::HEARTBEAT, band.update({21050, 46000}, 16000));
+  TEST_ASSERT_TRUE(band.getLastReport(last, lastMs).ok());
+  TEST_ASSERT_EQUAL_INT32(21050, last.temperatureMilliCelsius);
+
+  DeadBandStats stats = band.stats();
+  TEST_ASSERT_EQUAL_UINT32(8u, stats.samples);
+  TEST_ASSERT_EQUAL_UINT32(5u, stats.reported);
+  TEST_ASSERT_EQUAL_UINT32(3u, stats.suppressed);
+  TEST_ASSERT_EQUAL_UINT32(2u, stats.temperatureChanges);
+  TEST_ASSERT_EQUAL_UINT32(2u, stats.humidityChanges);
+  TEST_ASSERT_EQUAL_UINT32(1u, stats.heartbeats);
+
+  // The heartbeat survives millisecond wrap.
+  band.reset();
+  TEST_ASSERT_EQUAL_UINT32(0u, band.stats().samples);
+  TEST_ASSERT_EQUAL(DeadBandReason::FIRST, band.update({0, 0}, UINT32_MAX - 999));
+  TEST_ASSERT_EQUAL(DeadBandReason::SUPPRESSED, band.update({0, 0}, 8999));
+  TEST_ASSERT_EQUAL(DeadBandReason::HEARTBEAT, band.update({0, 0}, 9000));
+
+  // No heartbeat when disabled; a zero band reports any change; extreme
+  // values do not overflow the difference.
+  config.temperatureMilliCelsius = 0;
+  config.humidityMilliPercent = INT32_MAX;
+  config.maxSilenceMs = 0;
+  TEST_ASSERT_TRUE(band.configure(config).ok());
+  TEST_ASSERT_EQUAL(DeadBandReason::FIRST, band.update({INT32_MIN, INT32_MIN}, 0));
+  TEST_ASSERT_EQUAL(DeadBandReason::SUPPRESSED, band.update({INT32_MIN, -1}, 4000000000u));
+  TEST_ASSERT_EQUAL(DeadBandReason::CHANGE, band.update({INT32_MAX, -1}, 4000000001u));
+  TEST_ASSERT_EQUAL_UINT32(0u, band.stats().humidityChanges);
+}
+
+void test_dead_band_skips_consumed_device_samples_and_cuts_quiet_traffic() {
+  DeadBand band;
+  DeadBandReason reason = DeadBandReason::SUPPRESSED;
+  SHT3xDevice device;
+  TEST_ASSERT_EQUAL(Err::NOT_INITIALIZED, band.update(device, reason).code);
+  TEST_ASSERT_EQUAL(DeadBandReason::DUPLICATE, reason);
+  device._initialized = true;
+  device._rawSample.rawTemperature = rawFromMilliCelsius(22000);
+  device._rawSample.rawHumidity = 0x8000;
+  device._hasSample = true;
+  device._sampleSequence = 7;
+  device._sampleTimestampMs = 500;
+  TEST_ASSERT_TRUE(band.update(device, reason).ok());
+  TEST_ASSERT_EQUAL(DeadBandReason::FIRST, reason);
+  TEST_ASSERT_TRUE(band.update(device, reason).ok());
+  TEST_ASSERT_EQUAL(DeadBandReason::DUPLICATE, reason);
+  TEST_ASSERT_EQUAL_UINT32(1u, band.stats().samples);
+  device._rawSample.rawTemperature = rawFromMilliCelsius(23000);
+  device._sampleSequence = 8;
+  device._sampleTimestampMs = 1500;
+  TEST_ASSERT_TRUE(band.update(device, reason).ok());
+  TEST_ASSERT_EQUAL(DeadBandReason::CHANGE, reason);
+
+  // One quiet hour at 1 Hz (diurnal drift plus high-repeatability noise):
+  // the defaults (0.1 C, 0.5 %RH, 60 s heartbeat) forward a small fraction,
+  // and every held-back sample stays within the band of the last report.
+  sim::ScenarioConfig scenario;
+  scenario.seed = 3;
+  sim::ScenarioGenerator generator(scenario);
+  TEST_ASSERT_TRUE(band.configure(DeadBandConfig{}).ok());
+  uint32_t maxGapMs = 0;
+  uint32_t previousMs = 0;
+  for (uint32_t i = 0; i < 3600; ++i) {
+    const uint32_t nowMs = i * 1000U;
+    const sim::ScenarioSample s =
+        generator.sample(static_cast<uint64_t>(nowMs) * 1000ULL, Repeatability::HIGH_REPEATABILITY);
+    const MeasurementMilli sample = {SHT3xDevice::convertTemperatureMilliCelsius(s.rawTemperature),
+                                     SHT3xDevice::convertHumidityMilliPercent(s.rawHumidity)};
+    MeasurementMilli last;
+    uint32_t lastMs = 0;
+    if (band.update(sample, nowMs) == DeadBandReason::SUPPRESSED) {
+      TEST_ASSERT_TRUE(band.getLastReport(last, lastMs).ok());
+      TEST_ASSERT_INT32_WITHIN(100, last.temperatureMilliCelsius, sample.temperatureMilliCelsius);
+      TEST_ASSERT_INT32_WITHIN(500, last.humidityMilliPercent, sample.humidityMilliPercent);
+    } else {
+      maxGapMs = (i > 0 && nowMs - previousMs > maxGapMs) ? nowMs - previousMs : maxGapMs;
+      previousMs = nowMs;
+    }
+  }
+  const DeadBandStats stats = band.stats();
+  TEST_ASSERT_EQUAL_UINT32(3600u, stats.samples);
+  TEST_ASSERT_EQUAL_UINT32(3600u, stats.reported + stats.suppressed);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(60000u, maxGapMs);
+  TEST_ASSERT_GREATER_THAN_UINT32(0u, stats.heartbeats);
+  TEST_ASSERT_LESS_THAN_UINT32(3600u / 10u, stats.reported);
+}
+
+void test_scenario_generator_is_deterministic_and_feeds_virtual_sensor() {
+  sim::DoorEvent door;
+  door.startUs = 3600000000ULL;
+  door.openMs = 60000;
+  door.deltaTemperatureMilli = -4000;
+  door.recoveryTauMs = 0;
+  sim::CondensationEvent wet;
+  wet.startUs = 7200000000ULL;
+  wet.rampMs = 1000;
+  wet.holdMs = 10000;
+  sim::ScenarioConfig config;
+  config.seed = 42;
+  config.doors = &door;
+  config.doorCount = 1;
+  config.condensation = &wet;
+  config.condensationCount = 1;
+  sim::ScenarioGenerator generator(config);
+
+  // Same configuration and time give the same codes; another seed does not.
+  sim::ScenarioConfig reseeded = config;
+  reseeded.seed = 43;
+  sim::ScenarioGenerator other(reseeded);
+  uint32_t differing = 0;
+  for (uint64_t i = 0; i < 16; ++i) {
+    const uint64_t atUs = 1000000ULL * i;
+    const sim::ScenarioSample a = generator.sample(atUs, Repeatability::HIGH_REPEATABILITY);
+    const sim::ScenarioSample b = generator.sample(atUs, Repeatability::HIGH_REPEATABILITY);
+    TEST_ASSERT_EQUAL_UINT16(a.rawTemperature, b.rawTemperature);
+    TEST_ASSERT_EQUAL_UINT16(a.rawHumidity, b.rawHumidity);
+    const sim::ScenarioSample c = other.sample(atUs, Repeatability::HIGH_REPEATABILITY);
+    differing += (c.rawTemperature != a.rawTemperature) ? 1U : 0U;
+  }
+  TEST_ASSERT_GREATER_THAN_UINT32(8, differing);
+
+  // Noise matches the datasheet repeatability (3 sigma): 0.04 C high, 0.15 C low.
+  double sumHigh = 0.0;
+  double sumLow = 0.0;
+  const int n = 4000;
+  for (int i = 0; i < n; ++i) {
+    const uint64_t atUs = 1000ULL * static_cast<uint64_t>(i);
+    int32_t truthT = 0;
+    int32_t truthRh = 0;
+    generator.truth(atUs, truthT, truthRh);
+    const double high =
+        generator.sample(atUs, Repeatability::HIGH_REPEATABILITY).temperatureMilliCelsius - truthT;
+    const double low =
+        generator.sample(atUs, Repeatability::LOW_REPEATABILITY).temperatureMilliCelsius - truthT;
+    sumHigh += high * high;
+    sumLow += low * low;
+  }
+  TEST_ASSERT_FLOAT_WITHIN(2.0f, 40.0f / 3.0f, static_cast<float>(std::sqrt(sumHigh / n)));
+  TEST_ASSERT_FLOAT_WITHIN(5.0f, 150.0f / 3.0f, static_cast<float>(std::sqrt(sumLow / n)));
+
+  // Door step applies at once and (with no recovery) ends when it closes.
+  sim::ScenarioConfig noDoor = config;
+  noDoor.doorCount = 0;
+  sim::ScenarioGenerator baseline(noDoor);
+  int32_t open = 0;
+  int32_t closed = 0;
+  int32_t reference = 0;
+  int32_t rh = 0;
+  generator.truth(door.startUs + 1, open, rh);
+  baseline.truth(door.startUs + 1, reference, rh);
+  TEST_ASSERT_EQUAL_INT32(reference - 4000, open);
+  generator.truth(door.startUs + 60000001ULL, closed, rh);
+  baseline.truth(door.startUs + 60000001ULL, reference, rh);
+  TEST_ASSERT_EQUAL_INT32(reference, closed);
+
+  // Condensation saturates humidity; the sensor code clips at full scale.
+  sim::ScenarioConfig quiet = config;
+  quiet.noise = false;
+  sim::ScenarioGenerator saturated(quiet);
+  int32_t t = 0;
+  saturated.truth(wet.startUs + 5000000ULL, t, rh);
+  TEST_ASSERT_EQUAL_INT32(100000, rh);
+  TEST_ASSERT_EQUAL_UINT16(
+      65535, saturated.sample(wet.startUs + 5000000ULL, Repeatability::LOW_REPEATABILITY).rawHumidity);
+
+  // Attached to a virtual sensor, a conversion returns the scenario frame at
+  // its completion time with the repeatability of the command that started it.
+  sim::Clock clock;
+  clock.virtualTime = true;
+  clock.virtualUs = 5000000ULL;
+  sim::VirtualSht3x device;
+  device.clock = &clock;
+  generator.attach(device);
+  const uint8_t lowCommand[2] = {0x24, 0x16};
+  TEST_ASSERT_TRUE(device.write(device.address, lowCommand, 2).ok());
+  TEST_ASSERT_EQUAL(static_cast<int>(Repeatability::LOW_REPEATABILITY),
+                    static_cast<int>(device.repeatability));
+  clock.advanceUs(3000);
+  uint8_t frame[6] = {};
+  TEST_ASSERT_TRUE(device.read(device.address, frame, sizeof(frame)).ok());
+  uint8_t expected[6] = {};
+  generator.frame(5000000ULL + 2500ULL, Repeatability::LOW_REPEATABILITY, expected);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, frame, 6);
+  TEST_ASSERT_EQUAL_UINT8(sim::crc8(&frame[3], 2), frame[5]);
+}
+
+struct BurstScript {
+  uint16_t temperature[4];
+  uint16_t humidity[4];
+  uint32_t next;
+};
 
-void test_reset_and_restore_partial_alert_restore_failure_preserves_desired_cache() {
-  FrameScriptTransport ctx;
+static void burstScriptSource(uint64_t, uint16_t& rawTemperature, uint16_t& rawHumidity,
+                              void* user) {
+  auto* script = static_cast<BurstScript*>(user);
+  rawTemperature = script->temperature[script->next % 4U];
+  rawHumidity = script->humidity[script->next % 4U];
+  script->next++;
+}
+
+/// Poll like an event-driven owner: sleep for the conversion after a command,
+/// for tIDLE after other bus work, and one tick when nothing was due. Fails if
+/// a poll issues more than maxCallbacks transport callbacks.
+static PollJobResult pollBurstOwner(SHT3xDevice& device, sim::Clock& clock,
+                                    uint32_t& wakeups, uint8_t maxCallbacks = 1) {
+  for (int i = 0; i < 1000; ++i) {
+    PollJobResult result;
+    (void)device.pollJob(sim::clockNowMs(&clock), 2, result);
+    wakeups++;
+    TEST_ASSERT_TRUE(result.instructionsUsed <= maxCallbacks);
+    if (result.terminal) {
+      return result;
+    }
+    TEST_ASSERT_FALSE(result.completed);
+    if (result.instructionsUsed == 0) {
+      clock.advanceUs(1000);
+    } else if (result.phase == JobPhase::SINGLE_SHOT_COMMAND) {
+      clock.advanceUs(device.estimateMeasurementTimeMs() * 1000ULL);
+    } else {
+      clock.advanceUs(device.getConfig().commandDelayMs * 1000ULL);
+    }
+  }
+  TEST_FAIL_MESSAGE("burst owner did not finish");
+  return PollJobResult{};
+}
+
+void test_burst_job_averages_conversions_in_one_identity() {
+  BurstScript script = {{26000, 26004, 26008, 26020}, {32000, 32000, 32000, 32004}, 0};
+  sim::Clock clock;
+  clock.virtualTime = true;
+  clock.virtualUs = 1000000;
+  sim::VirtualSht3x sensor;
+  sensor.source = burstScriptSource;
+  sensor.sourceUser = &script;
+  Config cfg;
+  sim::attach(cfg, sensor, clock);
+  cfg.rejectInfeasibleDeadlines = true;
   SHT3xDevice device;
-  Config cfg = makeFrameConfig(ctx);
-  Status st = device.begin(cfg);
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  st = device.setHeater(true);
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
-  st = device.writeAlertLimitRaw(AlertLimitKind::HIGH_SET, 0x2222);
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_TRUE(device.begin(cfg).ok());
+  clock.advanceUs(10000);
+
+  BurstRequest request;
+  request.requestId = 41;
+  request.count = 1;
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, device.requestBurst(request).code);
+  request.count = MAX_BURST_COUNT + 1U;
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, device.requestBurst(request).code);
+  request.count = 4;
+  request.requestId = 0;
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, device.requestBurst(request).code);
+  request.requestId = 41;
+  // Four high-repeatability conversions need 64 ms; one job's worth is not enough.
+  request.hasDeadline = true;
+  request.deadlineMs = sim::clockNowMs(&clock) + 20U;
+  TEST_ASSERT_EQUAL(Err::DEADLINE_INFEASIBLE, device.requestBurst(request).code);
+  request.deadlineMs = sim::clockNowMs(&clock) + 200U;
+
+  const uint32_t callsBefore = sensor.writes + sensor.reads + sensor.readNacks;
+  const uint32_t sequenceBefore = device.sampleSequence();
+  TEST_ASSERT_TRUE(device.requestBurst(request).inProgress());
+  TEST_ASSERT_EQUAL(Err::BUSY, device.requestBurst(request).code);
+  uint32_t burstWakeups = 0;
+  const PollJobResult result = pollBurstOwner(device, clock, burstWakeups);
+  TEST_ASSERT_TRUE(result.completed);
+  TEST_ASSERT_EQUAL_UINT32(41u, result.requestId);
+  TEST_ASSERT_EQUAL(JobOutcome::SUCCEEDED, result.outcome);
+  TEST_ASSERT_EQUAL_UINT32(8u, sensor.writes + sensor.reads + sensor.readNacks - callsBefore);
+  TEST_ASSERT_EQUAL_UINT32(4u, sensor.conversions);
+  TEST_ASSERT_EQUAL_UINT32(sequenceBefore + 1U, device.sampleSequence());
+  // A command poll and a read poll per conversion, one callback each.
+  TEST_ASSERT_EQUAL_UINT32(8u, burstWakeups);
+
+  BurstStats stats;
+  TEST_ASSERT_TRUE(device.getBurstStats(stats).ok());
+  TEST_ASSERT_TRUE(stats.valid);
+  TEST_ASSERT_EQUAL_UINT8(4, stats.count);
+  TEST_ASSERT_EQUAL_UINT16(26008, stats.mean.rawTemperature);  // 104032 / 4
+  TEST_ASSERT_EQUAL_UINT16(32001, stats.mean.rawHumidity);     // 128004 / 4, rounded
+  TEST_ASSERT_EQUAL_UINT16(26000, stats.min.rawTemperature);
+  TEST_ASSERT_EQUAL_UINT16(26020, stats.max.rawTemperature);
+  TEST_ASSERT_EQUAL_UINT16(32000, stats.min.rawHumidity);
+  TEST_ASSERT_EQUAL_UINT16(32004, stats.max.rawHumidity);
+  RawSample published;
+  TEST_ASSERT_TRUE(device.getRawSample(published).ok());
+  TEST_ASSERT_EQUAL_UINT16(stats.mean.rawTemperature, published.rawTemperature);
+  TEST_ASSERT_EQUAL_UINT16(stats.mean.rawHumidity, published.rawHumidity);
+  // Range 20 codes = 53.4 mC; population sigma of {0, 4, 8, 20} is
+  // sqrt(56) = 7.48 codes = 20.0 mC. Humidity: 4 codes, sigma sqrt(3) codes.
+  TEST_ASSERT_INT32_WITHIN(1, 53, stats.spreadMilli.temperatureMilliCelsius);
+  TEST_ASSERT_INT32_WITHIN(1, 20, stats.stdDevMilli.temperatureMilliCelsius);
+  TEST_ASSERT_INT32_WITHIN(1, 6, stats.spreadMilli.humidityMilliPercent);
+  TEST_ASSERT_INT32_WITHIN(1, 3, stats.stdDevMilli.humidityMilliPercent);
+
+  // The same four conversions as separate jobs: four results and the same
+  // 2N wakeups; the burst differs only in its single identity and result.
+  clock.advanceUs(10000);
+  uint32_t separateWakeups = 0;
+  for (uint32_t k = 0; k < 4; ++k) {
+    JobRequest single;
+    single.requestId = 100U + k;
+    TEST_ASSERT_TRUE(device.requestMeasurement(single).inProgress());
+    TEST_ASSERT_TRUE(pollBurstOwner(device, clock, separateWakeups).completed);
+  }
+  TEST_ASSERT_EQUAL_UINT32(burstWakeups, separateWakeups);
+
+  // Opting into chaining lets each read poll also send the next command:
+  // command, three read+command polls, final read, over the same bus traffic.
+  clock.advanceUs(10000);
+  request.hasDeadline = false;
+  request.requestId = 43;
+  request.chainCommands = true;
+  const uint32_t chainedCallsBefore = sensor.writes + sensor.reads + sensor.readNacks;
+  TEST_ASSERT_TRUE(device.requestBurst(request).inProgress());
+  uint32_t chainedWakeups = 0;
+  const PollJobResult chained = pollBurstOwner(device, clock, chainedWakeups, 2);
+  TEST_ASSERT_EQUAL(JobOutcome::SUCCEEDED, chained.outcome);
+  TEST_ASSERT_EQUAL_UINT32(43u, chained.requestId);
+  TEST_ASSERT_EQUAL_UINT32(5u, chainedWakeups);
+  TEST_ASSERT_EQUAL_UINT32(8u,
+                           sensor.writes + sensor.reads + sensor.readNacks - chainedCallsBefore);
+  TEST_ASSERT_TRUE(device.getBurstStats(stats).ok());
+  TEST_ASSERT_EQUAL_UINT16(26008, stats.mean.rawTemperature);
+  request.chainCommands = false;
+
+  // Cancellation mid-burst is the usual terminal and publishes nothing.
+  clock.advanceUs(10000);
+  request.requestId = 42;
+  TEST_ASSERT_TRUE(device.requestBurst(request).inProgress());
+  TEST_ASSERT_TRUE(device.getBurstStats(stats).ok());
+  TEST_ASSERT_FALSE(stats.valid);
+  PollJobResult step;
+  (void)device.pollJob(sim::clockNowMs(&clock), 2, step);
+  clock.advanceUs(20000);
+  (void)device.pollJob(sim::clockNowMs(&clock), 2, step);
+  TEST_ASSERT_FALSE(step.terminal);
+  TEST_ASSERT_EQUAL(Err::CANCELLED, device.cancelJob(CancelReason::REQUESTED, step).code);
+  TEST_ASSERT_TRUE(step.terminal);
+  TEST_ASSERT_EQUAL_UINT32(42u, step.requestId);
+  TEST_ASSERT_FALSE(device._burstActive);
+  TEST_ASSERT_TRUE(device.getBurstStats(stats).ok());
+  TEST_ASSERT_FALSE(stats.valid);
+
+  // Bursts need idle single-shot mode.
+  TEST_ASSERT_TRUE(device.startPeriodic(PeriodicRate::MPS_1,
+                                        Repeatability::HIGH_REPEATABILITY).ok());
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, device.requestBurst(request).code);
+}
+
+// ----------------------------------------------------------------------------
+// Transport-callback budget
+//
+// Every public API and cooperative job runs once against a virtual SHT3x on a
+// virtual clock, from a bus that has been idle longer than tIDLE. Callbacks
+// (write, write-read, bus reset, hard reset), bytes each way, and virtual time
+// spent inside the driver call are compared exactly with kTransportBudget, so
+// a change that adds or removes bus traffic or blocking must update the table
+// in the same commit. Job rows sum every pollJob() of the job; time between
+// polls belongs to the owner and is not counted.
+// ----------------------------------------------------------------------------
+
+struct BudgetRig {
+  sim::Clock clock;
+  sim::VirtualSht3x device;
+  SHT3xDevice driver;
+  Config config;
+  uint32_t callbacks = 0;
+  uint32_t bytesOut = 0;
+  uint32_t bytesIn = 0;
+  uint64_t waitUs = 0;
+  uint32_t maxPollCallbacks = 0;  ///< Most callbacks seen in one pollJob() call
+};
 
-  clearFrameLog(ctx);
-  ctx.failReadIndex = 2;
-  ctx.failReadStatus = Status::Error(Err::I2C_TIMEOUT, "alert verify timeout", -25);
+static Status budgetWrite(uint8_t addr, const uint8_t* data, size_t len,
+                          uint32_t, void* user) {
+  auto* rig = static_cast<BudgetRig*>(user);
+  rig->callbacks++;
+  rig->bytesOut += static_cast<uint32_t>(len);
+  if (addr == cmd::GENERAL_CALL_ADDR) {
+    // The virtual device models general-call reset as its soft reset.
+    const uint8_t reset[2] = {static_cast<uint8_t>(cmd::CMD_SOFT_RESET >> 8),
+                              static_cast<uint8_t>(cmd::CMD_SOFT_RESET & 0xFFU)};
+    return rig->device.write(rig->device.address, reset, sizeof(reset));
+  }
+  return rig->device.write(addr, data, len);
+}
 
-  st = device.resetAndRestore();
-  TEST_ASSERT_EQUAL(Err::I2C_TIMEOUT, st.code);
-  TEST_ASSERT_EQUAL_INT32(-25, st.detail);
-  TEST_ASSERT_TRUE(device.hasCachedSettings());
-  CachedSettings cached = device.getCachedSettings();
-  TEST_ASSERT_TRUE(cached.heaterEnabled);
-  TEST_ASSERT_TRUE(cached.alertValid[static_cast<uint8_t>(AlertLimitKind::HIGH_SET)]);
-  TEST_ASSERT_EQUAL_UINT16(0x2222, cached.alertRaw[static_cast<uint8_t>(AlertLimitKind::HIGH_SET)]);
-  TEST_ASSERT_EQUAL(DriverState::DEGRADED, device.state());
-  TEST_ASSERT_FALSE(device.isPeriodicActive());
-  TEST_ASSERT_EQUAL(4u, ctx.commandCount);
-  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[0]);
-  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_HEATER_ENABLE, ctx.commands[1]);
-  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_ALERT_WRITE_HIGH_SET, ctx.commands[2]);
-  TEST_ASSERT_EQUAL_UINT16(cmd::CMD_READ_STATUS, ctx.commands[3]);
-  TEST_ASSERT_EQUAL_UINT32(2u, ctx.reads);
+static Status budgetWriteRead(uint8_t addr, const uint8_t* txData, size_t txLen,
+                              uint8_t* rxData, size_t rxLen, uint32_t timeoutMs,
+                              void* user) {
+  auto* rig = static_cast<BudgetRig*>(user);
+  rig->callbacks++;
+  rig->bytesOut += static_cast<uint32_t>(txLen);
+  rig->bytesIn += static_cast<uint32_t>(rxLen);
+  return sim::virtualWriteRead(addr, txData, txLen, rxData, rxLen, timeoutMs,
+                               &rig->device);
 }
 
-void test_periodic_fetch_margin_blocks_early_fetch() {
-  CountTransport ctx;
-  SHT3xDevice device;
-  device._config.i2cWrite = countWrite;
-  device._config.i2cWriteRead = countWriteRead;
-  device._config.i2cUser = &ctx;
-  device._config.commandDelayMs = 1;
-  device._config.periodicFetchMarginMs = 0;
-  device._config.transportCapabilities = TransportCapability::NONE;
-  device._initialized = true;
-  device._driverState = DriverState::READY;
-  device._mode = Mode::PERIODIC;
-  device._periodicActive = true;
-  device._periodMs = 100;
-  device._periodicStartMs = 0xFFFFFFF0u;
-  device._lastFetchMs = 0;
-  device._lastFetchValid = true;
+static Status budgetBusReset(void* user) {
+  static_cast<BudgetRig*>(user)->callbacks++;
+  return Status::Ok();
+}
 
-  TEST_ASSERT_EQUAL_UINT32(105u, device._periodicReadyMs(1u));
+static Status budgetHardReset(void* user) {
+  auto* rig = static_cast<BudgetRig*>(user);
+  rig->callbacks++;
+  const uint8_t reset[2] = {static_cast<uint8_t>(cmd::CMD_SOFT_RESET >> 8),
+                            static_cast<uint8_t>(cmd::CMD_SOFT_RESET & 0xFFU)};
+  return rig->device.write(rig->device.address, reset, sizeof(reset));
+}
 
-  device._periodicStartMs = 0;
-  device._lastFetchValid = false;
+static void budgetConfigure(BudgetRig& rig) {
+  rig.clock.virtualTime = true;
+  rig.clock.virtualUs = 1000000;
+  sim::attach(rig.config, rig.device, rig.clock);
+  rig.config.i2cWrite = budgetWrite;
+  rig.config.i2cWriteRead = budgetWriteRead;
+  rig.config.i2cUser = &rig;
+  rig.config.busReset = budgetBusReset;
+  rig.config.hardReset = budgetHardReset;
+  rig.config.allowGeneralCallReset = true;
+}
 
-  gMillis = 0;
-  gMicros = 0;
-  gMillisStep = 0;
-  gMicrosStep = 1000;
+/// Let tIDLE and recovery backoff lapse, then zero the counters.
+static void budgetMark(BudgetRig& rig) {
+  rig.clock.advanceUs(500000);
+  rig.callbacks = 0;
+  rig.bytesOut = 0;
+  rig.bytesIn = 0;
+  rig.waitUs = 0;
+}
 
-  Status st = device.requestMeasurement();
-  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
+template <typename Fn>
+static void budgetCall(BudgetRig& rig, Fn fn) {
+  const uint64_t startUs = rig.clock.nowUs();
+  const Status st = fn();
+  rig.waitUs += rig.clock.nowUs() - startUs;
+  TEST_ASSERT_TRUE_MESSAGE(st.ok() || st.inProgress(), st.msg);
+}
 
-  const uint32_t margin = device._periodicFetchMarginMs();
-  const uint32_t expectedReady =
-      device._periodicStartMs + device.estimateMeasurementTimeMs() + margin;
-  TEST_ASSERT_EQUAL_UINT32(expectedReady, device._measurementReadyMs);
+/// begin() in single-shot mode, then the counters are zeroed.
+static void budgetReady(BudgetRig& rig) {
+  budgetConfigure(rig);
+  TEST_ASSERT_TRUE(rig.driver.begin(rig.config).ok());
+  budgetMark(rig);
+}
 
-  device.tick(expectedReady - 1);
-  TEST_ASSERT_EQUAL_UINT32(0u, ctx.writes);
+static void budgetPeriodic(BudgetRig& rig) {
+  budgetConfigure(rig);
+  rig.config.mode = Mode::PERIODIC;
+  TEST_ASSERT_TRUE(rig.driver.begin(rig.config).ok());
+  budgetMark(rig);
+}
 
-  device.tick(expectedReady);
-  TEST_ASSERT_EQUAL_UINT32(1u, ctx.writes);
+/// Poll a job to its terminal result, or until it completes a sample when
+/// untilSample is set, advancing the owner's clock between polls. Records the
+/// most callbacks any single poll issued.
+static void budgetRunJob(BudgetRig& rig, bool untilSample, uint8_t maxInstructions = 1) {
+  for (int i = 0; i < 20000; ++i) {
+    PollJobResult result;
+    const uint32_t callbacksBefore = rig.callbacks;
+    budgetCall(rig, [&] {
+      (void)rig.driver.pollJob(sim::clockNowMs(&rig.clock), maxInstructions, result);
+      return result.status;
+    });
+    const uint32_t pollCallbacks = rig.callbacks - callbacksBefore;
+    if (pollCallbacks > rig.maxPollCallbacks) {
+      rig.maxPollCallbacks = pollCallbacks;
+    }
+    if (untilSample && result.completed) {
+      return;
+    }
+    if (result.terminal) {
+      TEST_ASSERT_EQUAL(JobOutcome::SUCCEEDED, result.outcome);
+      return;
+    }
+    rig.clock.advanceUs(250);
+  }
+  TEST_FAIL_MESSAGE("job did not finish");
 }
 
-void test_raw_and_compensated_samples_remain_after_measurement_read() {
-  FakeTransport bus;
-  SHT3xDevice device;
-  Config cfg = makeConfig(bus);
+static void budgetBind(BudgetRig& rig) {
+  budgetConfigure(rig);
+  budgetMark(rig);
+  budgetCall(rig, [&] { return rig.driver.bind(rig.config); });
+}
 
-  gMillis = 0;
-  gMicros = 0;
-  gMillisStep = 1;
-  gMicrosStep = 1000;
+static void budgetBeginSingleShot(BudgetRig& rig) {
+  budgetConfigure(rig);
+  budgetMark(rig);
+  budgetCall(rig, [&] { return rig.driver.begin(rig.config); });
+}
 
-  Status st = device.begin(cfg);
-  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+static void budgetBeginPeriodic(BudgetRig& rig) {
+  budgetConfigure(rig);
+  rig.config.mode = Mode::PERIODIC;
+  budgetMark(rig);
+  budgetCall(rig, [&] { return rig.driver.begin(rig.config); });
+}
 
-  RawSample raw;
-  st = device.getRawSample(raw);
-  TEST_ASSERT_EQUAL(Err::MEASUREMENT_NOT_READY, st.code);
+static void budgetScheduleAndCancel(BudgetRig& rig) {
+  budgetReady(rig);
+  JobRequest request;
+  request.requestId = 1;
+  budgetCall(rig, [&] { return rig.driver.requestMeasurement(request); });
+  PollJobResult result;
+  budgetCall(rig, [&] {
+    (void)rig.driver.pollJob(sim::clockNowMs(&rig.clock), 0, result);
+    return result.status;
+  });
+  budgetCall(rig, [&] {
+    (void)rig.driver.cancelJob(CancelReason::REQUESTED, result);
+    return result.terminal ? Status::Ok() : result.status;
+  });
+}
+
+static void budgetSingleShotJob(BudgetRig& rig) {
+  budgetReady(rig);
+  JobRequest request;
+  request.requestId = 1;
+  budgetCall(rig, [&] { return rig.driver.requestMeasurement(request); });
+  budgetRunJob(rig, false);
+}
 
-  st = device.requestMeasurement();
-  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, st.code);
-  bus.nowMs = device._measurementReadyMs;
-  device.tick(bus.nowMs);
-  bus.nowMs = device._measurementReadyMs;
-  device.tick(bus.nowMs);
-  TEST_ASSERT_TRUE(device.measurementReady());
+static void budgetPeriodicFetchJob(BudgetRig& rig) {
+  budgetPeriodic(rig);
+  JobRequest request;
+  request.requestId = 1;
+  budgetCall(rig, [&] { return rig.driver.requestMeasurement(request); });
+  budgetRunJob(rig, false);
+}
 
-  Measurement measurement;
-  st = device.getMeasurement(measurement);
-  TEST_ASSERT_TRUE(st.ok());
-  TEST_ASSERT_FALSE(device.measurementReady());
+static void budgetContinuousJob(BudgetRig& rig) {
+  budgetPeriodic(rig);
+  JobRequest request;
+  request.requestId = 1;
+  budgetCall(rig, [&] { return rig.driver.requestContinuous(request); });
+  budgetRunJob(rig, true);
+}
+
+static void budgetCadenceJob(BudgetRig& rig) {
+  budgetReady(rig);
+  CadenceRequest request;
+  request.requestId = 1;
+  request.periodMs = 1000;
+  request.firstSlotMs = sim::clockNowMs(&rig.clock) + 1;
+  budgetCall(rig, [&] { return rig.driver.requestCadence(request); });
+  budgetRunJob(rig, true);
+}
+
+static void budgetBurstJob(BudgetRig& rig) {
+  budgetReady(rig);
+  BurstRequest request;
+  request.requestId = 1;
+  request.count = 4;
+  budgetCall(rig, [&] { return rig.driver.requestBurst(request); });
+  budgetRunJob(rig, false);
+}
+
+static void budgetBurstChainedJob(BudgetRig& rig) {
+  budgetReady(rig);
+  BurstRequest request;
+  request.requestId = 1;
+  request.count = 4;
+  request.chainCommands = true;
+  budgetCall(rig, [&] { return rig.driver.requestBurst(request); });
+  budgetRunJob(rig, false, 2);
+}
+
+static void budgetEnsureIdleJob(BudgetRig& rig) {
+  budgetPeriodic(rig);
+  JobRequest request;
+  request.requestId = 1;
+  budgetCall(rig, [&] { return rig.driver.requestEnsureIdle(request); });
+  budgetRunJob(rig, false);
+}
+
+static void budgetTickSingleShot(BudgetRig& rig) {
+  budgetReady(rig);
+  budgetCall(rig, [&] { return rig.driver.requestMeasurement(); });
+  for (int i = 0; i < 20000 && !rig.driver.measurementReady(); ++i) {
+    budgetCall(rig, [&] {
+      rig.driver.tick(sim::clockNowMs(&rig.clock));
+      return Status::Ok();
+    });
+    rig.clock.advanceUs(250);
+  }
+  TEST_ASSERT_TRUE(rig.driver.measurementReady());
+}
 
-  st = device.getRawSample(raw);
-  TEST_ASSERT_TRUE(st.ok());
-  TEST_ASSERT_EQUAL_UINT16(0u, raw.rawTemperature);
-  TEST_ASSERT_EQUAL_UINT16(0u, raw.rawHumidity);
+static void budgetProbe(BudgetRig& rig) {
+  budgetReady(rig);
+  budgetCall(rig, [&] { return rig.driver.probe(); });
+}
 
-  CompensatedSample comp;
-  st = device.getCompensatedSample(comp);
-  TEST_ASSERT_TRUE(st.ok());
-  TEST_ASSERT_EQUAL_INT32(-4500, comp.tempC_x100);
-  TEST_ASSERT_EQUAL_UINT32(0u, comp.humidityPct_x100);
+static void budgetReadStatus(BudgetRig& rig) {
+  budgetReady(rig);
+  uint16_t raw = 0;
+  budgetCall(rig, [&] { return rig.driver.readStatus(raw); });
+}
 
-  SettingsSnapshot snap;
-  st = device.getSettings(snap);
-  TEST_ASSERT_TRUE(st.ok());
-  TEST_ASSERT_TRUE(snap.hasSample);
-  TEST_ASSERT_FALSE(snap.measurementReady);
+static void budgetReadHeaterStatus(BudgetRig& rig) {
+  budgetReady(rig);
+  bool enabled = false;
+  budgetCall(rig, [&] { return rig.driver.readHeaterStatus(enabled); });
 }
 
-void test_zero_timestamp_sample_age_uses_has_sample_flag() {
-  SHT3xDevice device;
-  device._hasSample = false;
-  device._sampleTimestampMs = 0;
-  TEST_ASSERT_EQUAL_UINT32(0u, device.sampleAgeMs(123u));
+static void budgetReadStatusWithModeRestore(BudgetRig& rig) {
+  budgetPeriodic(rig);
+  StatusReadSnapshot snapshot;
+  budgetCall(rig, [&] { return rig.driver.readStatusWithModeRestore(snapshot); });
+}
 
-  device._hasSample = true;
-  TEST_ASSERT_EQUAL_UINT32(123u, device.sampleAgeMs(123u));
+static void budgetReadSettings(BudgetRig& rig) {
+  budgetReady(rig);
+  SettingsSnapshot snapshot;
+  budgetCall(rig, [&] { return rig.driver.readSettings(snapshot); });
+}
+
+static void budgetClearStatus(BudgetRig& rig) {
+  budgetReady(rig);
+  budgetCall(rig, [&] { return rig.driver.clearStatus(); });
 }
 
-void test_offline_request_measurement_does_not_touch_bus_or_schedule() {
-  CountTransport ctx;
-  SHT3xDevice device;
-  device._config.i2cWrite = countWrite;
-  device._config.i2cWriteRead = countWriteRead;
-  device._config.i2cUser = &ctx;
-  device._config.i2cTimeoutMs = 10;
-  installTimingHooks(device);
-  device._initialized = true;
-  device._driverState = DriverState::OFFLINE;
-  device._mode = Mode::SINGLE_SHOT;
-  device._periodicActive = false;
+static void budgetSetHeater(BudgetRig& rig) {
+  budgetReady(rig);
+  budgetCall(rig, [&] { return rig.driver.setHeater(true); });
+}
 
-  Status st = device.requestMeasurement();
-  TEST_ASSERT_EQUAL(Err::BUSY, st.code);
-  TEST_ASSERT_EQUAL_STRING("Driver is offline; call recover()", st.msg);
-  TEST_ASSERT_FALSE(device._measurementRequested);
-  TEST_ASSERT_EQUAL_UINT32(0u, ctx.writes);
-  TEST_ASSERT_EQUAL_UINT32(0u, ctx.reads);
+static void budgetReadSerialNumber(BudgetRig& rig) {
+  budgetReady(rig);
+  uint32_t serial = 0;
+  budgetCall(rig, [&] { return rig.driver.readSerialNumber(serial); });
 }
 
-void test_recover_transient_failure() {
-  ScriptedTransport ctx;
-  ctx.readScript[0] = Status::Error(Err::I2C_TIMEOUT, "timeout");
-  ctx.readScript[1] = Status::Ok();
-  ctx.readCount = 2;
+static void budgetReadAlertLimit(BudgetRig& rig) {
+  budgetReady(rig);
+  uint16_t value = 0;
+  budgetCall(rig, [&] { return rig.driver.readAlertLimitRaw(AlertLimitKind::HIGH_SET, value); });
+}
 
-  auto busReset = [](void* user) -> Status {
-    (void)user;
-    return Status::Ok();
-  };
+static void budgetWriteAlertLimit(BudgetRig& rig) {
+  budgetReady(rig);
+  budgetCall(rig, [&] {
+    return rig.driver.writeAlertLimitRaw(AlertLimitKind::HIGH_SET, 0xCD33);
+  });
+}
 
-  SHT3xDevice device;
-  device._config.i2cWrite = scriptedWrite;
-  device._config.i2cWriteRead = scriptedWriteRead;
-  device._config.i2cUser = &ctx;
-  device._config.i2cTimeoutMs = 10;
-  installTimingHooks(device);
-  device._config.recoverBackoffMs = 0;
-  device._config.busReset = busReset;
-  device._config.recoverUseBusReset = true;
-  device._config.recoverUseSoftReset = true;
-  device._initialized = true;
-  device._driverState = DriverState::READY;
+static void budgetDisableAlerts(BudgetRig& rig) {
+  budgetReady(rig);
+  budgetCall(rig, [&] { return rig.driver.disableAlerts(); });
+}
 
-  gMillis = 0;
-  gMicros = 0;
-  gMillisStep = 1;
-  gMicrosStep = 1000;
-  Status st = device.recover();
-  TEST_ASSERT_TRUE(st.ok());
-  TEST_ASSERT_EQUAL(Mode::SINGLE_SHOT, device._mode);
-  TEST_ASSERT_FALSE(device._periodicActive);
+static void budgetWriteCommand(BudgetRig& rig) {
+  budgetReady(rig);
+  budgetCall(rig, [&] { return rig.driver.writeCommand(cmd::CMD_CLEAR_STATUS); });
 }
 
-void test_recover_permanent_offline() {
-  ScriptedTransport ctx;
-  ctx.readScript[0] = Status::Error(Err::I2C_TIMEOUT, "timeout");
-  ctx.readScript[1] = Status::Error(Err::I2C_TIMEOUT, "timeout");
-  ctx.readScript[2] = Status::Error(Err::I2C_TIMEOUT, "timeout");
-  ctx.readCount = 3;
+static void budgetWriteCommandWithData(BudgetRig& rig) {
+  budgetReady(rig);
+  budgetCall(rig, [&] {
+    return rig.driver.writeCommandWithData(cmd::CMD_ALERT_WRITE_HIGH_SET, 0xCD33);
+  });
+}
 
-  SHT3xDevice device;
-  device._config.i2cWrite = scriptedWrite;
-  device._config.i2cWriteRead = scriptedWriteRead;
-  device._config.i2cUser = &ctx;
-  device._config.i2cTimeoutMs = 10;
-  installTimingHooks(device);
-  device._config.recoverBackoffMs = 0;
-  device._config.recoverUseBusReset = false;
-  device._config.recoverUseSoftReset = true;
-  device._initialized = true;
-  device._driverState = DriverState::READY;
+static void budgetReadCommand(BudgetRig& rig) {
+  budgetReady(rig);
+  uint8_t frame[3] = {};
+  budgetCall(rig, [&] {
+    return rig.driver.readCommand(cmd::CMD_READ_STATUS, frame, sizeof(frame));
+  });
+}
 
-  gMillis = 0;
-  gMicros = 0;
-  gMillisStep = 1;
-  gMicrosStep = 1000;
-  Status st = device.recover();
-  TEST_ASSERT_FALSE(st.ok());
-  TEST_ASSERT_TRUE(device._consecutiveFailures > 0);
+static void budgetStartPeriodic(BudgetRig& rig) {
+  budgetReady(rig);
+  budgetCall(rig, [&] {
+    return rig.driver.startPeriodic(PeriodicRate::MPS_1, Repeatability::HIGH_REPEATABILITY);
+  });
 }
 
-void test_offline_latches_read_status_without_i2c() {
-  CountTransport ctx;
-  SHT3xDevice device;
-  device._config.i2cWrite = countWrite;
-  device._config.i2cWriteRead = countWriteRead;
-  device._config.i2cUser = &ctx;
-  device._config.i2cTimeoutMs = 10;
-  installTimingHooks(device);
-  device._config.offlineThreshold = 1;
-  device._initialized = true;
-  device._driverState = DriverState::READY;
+static void budgetRestartPeriodic(BudgetRig& rig) {
+  budgetPeriodic(rig);
+  budgetCall(rig, [&] {
+    return rig.driver.startPeriodic(PeriodicRate::MPS_2, Repeatability::HIGH_REPEATABILITY);
+  });
+}
 
-  (void)device._updateHealth(Status::Error(Err::I2C_TIMEOUT, "forced offline"));
-  TEST_ASSERT_EQUAL(DriverState::OFFLINE, device._driverState);
+static void budgetStartArt(BudgetRig& rig) {
+  budgetReady(rig);
+  budgetCall(rig, [&] { return rig.driver.startArt(); });
+}
 
-  uint16_t statusRaw = 0;
-  Status st = device.readStatus(statusRaw);
-  TEST_ASSERT_EQUAL(Err::BUSY, st.code);
-  TEST_ASSERT_EQUAL_STRING("Driver is offline; call recover()", st.msg);
-  TEST_ASSERT_EQUAL_UINT32(0u, ctx.reads);
-  TEST_ASSERT_EQUAL_UINT32(0u, ctx.writes);
+static void budgetStopPeriodic(BudgetRig& rig) {
+  budgetPeriodic(rig);
+  budgetCall(rig, [&] { return rig.driver.stopPeriodic(); });
 }
 
-void test_read_settings_returns_offline_busy_without_i2c() {
-  CountTransport ctx;
-  SHT3xDevice device;
-  device._config.i2cWrite = countWrite;
-  device._config.i2cWriteRead = countWriteRead;
-  device._config.i2cUser = &ctx;
-  device._config.i2cTimeoutMs = 10;
-  installTimingHooks(device);
-  device._config.offlineThreshold = 1;
-  device._initialized = true;
-  device._driverState = DriverState::OFFLINE;
-  device._consecutiveFailures = 1;
+static void budgetSetModeSingleShot(BudgetRig& rig) {
+  budgetPeriodic(rig);
+  budgetCall(rig, [&] { return rig.driver.setMode(Mode::SINGLE_SHOT); });
+}
 
-  SettingsSnapshot snap;
-  Status st = device.readSettings(snap);
-  TEST_ASSERT_EQUAL(Err::BUSY, st.code);
-  TEST_ASSERT_EQUAL_STRING("Driver is offline; call recover()", st.msg);
-  TEST_ASSERT_EQUAL_UINT32(0u, ctx.reads);
-  TEST_ASSERT_EQUAL_UINT32(0u, ctx.writes);
-  TEST_ASSERT_EQUAL(DriverState::OFFLINE, device._driverState);
+static void budgetSetRepeatabilityPeriodic(BudgetRig& rig) {
+  budgetPeriodic(rig);
+  budgetCall(rig, [&] { return rig.driver.setRepeatability(Repeatability::LOW_REPEATABILITY); });
 }
 
-void test_failed_recover_from_offline_keeps_latch_after_intermediate_success() {
-  ScriptedTransport ctx;
-  ctx.readScript[0] = Status::Error(Err::I2C_TIMEOUT, "initial probe timeout");
-  ctx.readScript[1] = Status::Error(Err::I2C_TIMEOUT, "post-reset timeout");
-  ctx.readCount = 2;
+static void budgetSetPeriodicRatePeriodic(BudgetRig& rig) {
+  budgetPeriodic(rig);
+  budgetCall(rig, [&] { return rig.driver.setPeriodicRate(PeriodicRate::MPS_2); });
+}
 
-  SHT3xDevice device;
-  device._config.i2cWrite = scriptedWrite;
-  device._config.i2cWriteRead = scriptedWriteRead;
-  device._config.i2cUser = &ctx;
-  device._config.i2cTimeoutMs = 10;
-  installTimingHooks(device);
-  device._config.offlineThreshold = 3;
-  device._config.recoverBackoffMs = 0;
-  device._config.recoverUseBusReset = false;
-  device._config.recoverUseSoftReset = true;
-  device._config.recoverUseHardReset = false;
-  device._config.allowGeneralCallReset = false;
-  device._initialized = true;
-  device._driverState = DriverState::OFFLINE;
-  device._consecutiveFailures = device._config.offlineThreshold;
+static void budgetSoftReset(BudgetRig& rig) {
+  budgetReady(rig);
+  budgetCall(rig, [&] { return rig.driver.softReset(); });
+}
 
-  gMillis = 0;
-  gMicros = 0;
-  gMillisStep = 1;
-  gMicrosStep = 1000;
-  Status st = device.recover();
-  TEST_ASSERT_EQUAL(Err::I2C_TIMEOUT, st.code);
-  TEST_ASSERT_EQUAL(DriverState::OFFLINE, device._driverState);
-  TEST_ASSERT_TRUE(device._consecutiveFailures >= device._config.offlineThreshold);
+static void budgetInterfaceReset(BudgetRig& rig) {
+  budgetReady(rig);
+  budgetCall(rig, [&] { return rig.driver.interfaceReset(); });
 }
 
-void test_recover_backoff_enforced_at_zero_ms() {
-  ScriptedTransport ctx;
-  ctx.readScript[0] = Status::Error(Err::I2C_TIMEOUT, "timeout");
-  ctx.readCount = 1;
+static void budgetGeneralCallReset(BudgetRig& rig) {
+  budgetReady(rig);
+  budgetCall(rig, [&] { return rig.driver.generalCallReset(); });
+}
 
-  SHT3xDevice device;
-  device._config.i2cWrite = scriptedWrite;
-  device._config.i2cWriteRead = scriptedWriteRead;
-  device._config.i2cUser = &ctx;
-  device._config.i2cTimeoutMs = 10;
-  installTimingHooks(device);
-  device._config.recoverBackoffMs = 100;
-  device._config.recoverUseBusReset = false;
-  device._config.recoverUseSoftReset = false;
-  device._config.recoverUseHardReset = false;
-  device._config.allowGeneralCallReset = false;
-  device._initialized = true;
-  device._driverState = DriverState::READY;
+static void budgetRecoverVerified(BudgetRig& rig) {
+  budgetReady(rig);
+  budgetCall(rig, [&] { return rig.driver.recover(); });
+}
 
-  gMillis = 0;
-  gMicros = 0;
-  gMillisStep = 0;
-  gMicrosStep = 1000;
+static void budgetRecoverUnknown(BudgetRig& rig) {
+  budgetConfigure(rig);
+  TEST_ASSERT_TRUE(rig.driver.bind(rig.config).ok());
+  budgetMark(rig);
+  budgetCall(rig, [&] { return rig.driver.recover(); });
+}
 
-  Status st = device.recover();
-  TEST_ASSERT_EQUAL(Err::I2C_TIMEOUT, st.code);
+static void budgetResetToDefaults(BudgetRig& rig) {
+  budgetReady(rig);
+  budgetCall(rig, [&] { return rig.driver.resetToDefaults(); });
+}
 
-  st = device.recover();
-  TEST_ASSERT_EQUAL(Err::BUSY, st.code);
+static void budgetResetAndRestore(BudgetRig& rig) {
+  budgetReady(rig);
+  TEST_ASSERT_TRUE(rig.driver.setHeater(true).ok());
+  TEST_ASSERT_TRUE(rig.driver.writeAlertLimitRaw(AlertLimitKind::HIGH_SET, 0xCD33).ok());
+  TEST_ASSERT_TRUE(
+      rig.driver.startPeriodic(PeriodicRate::MPS_1, Repeatability::HIGH_REPEATABILITY).ok());
+  budgetMark(rig);
+  budgetCall(rig, [&] { return rig.driver.resetAndRestore(); });
 }
 
-void test_periodic_fetch_margin_is_clamped() {
-  SHT3xDevice device;
-  device._periodMs = 100;
-  device._config.periodicFetchMarginMs = 1000;
-  TEST_ASSERT_EQUAL_UINT32(100u, device._periodicFetchMarginMs());
+struct TransportBudgetRow {
+  const char* name;
+  void (*run)(BudgetRig&);
+  uint32_t callbacks;
+  uint32_t bytesOut;
+  uint32_t bytesIn;
+  uint32_t waitUs;
+  uint32_t pollCallbacks;  ///< Most callbacks in one pollJob(); 0 when none
+};
+
+// Checked-in budget. Update it deliberately, in the commit that changes the
+// traffic, and keep README "Public API Transaction and Latency Summary" true.
+static const TransportBudgetRow kTransportBudget[] = {
+    // name                                   run                                cb  out   in  waitUs  poll
+    {"bind()",                                budgetBind,                         0,   0,   0,      0,    0},
+    {"schedule + pollJob(0) + cancelJob()",   budgetScheduleAndCancel,            0,   0,   0,      0,    0},
+    {"begin() single-shot",                   budgetBeginSingleShot,              4,   6,   3,   4000,    0},
+    {"begin() periodic",                      budgetBeginPeriodic,                5,   8,   3,   4000,    0},
+    {"single-shot job",                       budgetSingleShotJob,                2,   2,   6,      0,    1},
+    {"periodic fetch job",                    budgetPeriodicFetchJob,             2,   2,   6,      0,    1},
+    {"continuous job, first sample",          budgetContinuousJob,                2,   2,   6,      0,    1},
+    {"cadence job, first slot",               budgetCadenceJob,                   2,   2,   6,      0,    1},
+    {"burst job, 4 conversions",              budgetBurstJob,                     8,   8,  24,      0,    1},
+    {"burst job, 4 conversions, chained",     budgetBurstChainedJob,              8,   8,  24,      0,    2},
+    {"ensure-idle job",                       budgetEnsureIdleJob,                4,   6,   3,      0,    1},
+    {"requestMeasurement() + tick()",         budgetTickSingleShot,               2,   2,   6,      0,    0},
+    {"probe()",                               budgetProbe,                        2,   2,   3,   1000,    0},
+    {"readStatus()",                          budgetReadStatus,                   2,   2,   3,   1000,    0},
+    {"readHeaterStatus()",                    budgetReadHeaterStatus,             2,   2,   3,   1000,    0},
+    {"readStatusWithModeRestore()",           budgetReadStatusWithModeRestore,    4,   6,   3,   2000,    0},
+    {"readSettings()",                        budgetReadSettings,                 2,   2,   3,   1000,    0},
+    {"clearStatus()",                         budgetClearStatus,                  1,   2,   0,      0,    0},
+    {"setHeater()",                           budgetSetHeater,                    1,   2,   0,      0,    0},
+    {"readSerialNumber()",                    budgetReadSerialNumber,             2,   2,   6,   1000,    0},
+    {"readAlertLimitRaw()",                   budgetReadAlertLimit,               2,   2,   3,   1000,    0},
+    {"writeAlertLimitRaw()",                  budgetWriteAlertLimit,              3,   7,   3,   2000,    0},
+    {"disableAlerts()",                       budgetDisableAlerts,                6,  14,   6,   4000,    0},
+    {"writeCommand()",                        budgetWriteCommand,                 1,   2,   0,      0,    0},
+    {"writeCommandWithData()",                budgetWriteCommandWithData,         1,   5,   0,      0,    0},
+    {"readCommand()",                         budgetReadCommand,                  2,   2,   3,   1000,    0},
+    {"startPeriodic() from idle",             budgetStartPeriodic,                1,   2,   0,      0,    0},
+    {"startPeriodic() while periodic",        budgetRestartPeriodic,              2,   4,   0,   1000,    0},
+    {"startArt()",                            budgetStartArt,                     1,   2,   0,      0,    0},
+    {"stopPeriodic()",                        budgetStopPeriodic,                 1,   2,   0,   1000,    0},
+    {"setMode(SINGLE_SHOT) while periodic",   budgetSetModeSingleShot,            1,   2,   0,   1000,    0},
+    {"setRepeatability() while periodic",     budgetSetRepeatabilityPeriodic,     2,   4,   0,   1000,    0},
+    {"setPeriodicRate() while periodic",      budgetSetPeriodicRatePeriodic,      2,   4,   0,   1000,    0},
+    {"softReset()",                           budgetSoftReset,                    1,   2,   0,   2000,    0},
+    {"interfaceReset()",                      budgetInterfaceReset,               1,   0,   0,      0,    0},
+    {"generalCallReset()",                    budgetGeneralCallReset,             1,   1,   0,   2000,    0},
+    {"recover() verified idle",               budgetRecoverVerified,              2,   2,   3,   1000,    0},
+    {"recover() unknown state",               budgetRecoverUnknown,               9,  10,   9,   7000,    0},
+    {"resetToDefaults()",                     budgetResetToDefaults,              2,   2,   3,   1000,    0},
+    {"resetAndRestore()",                     budgetResetAndRestore,             14,  21,  12,  10000,    0},
+};
+
+void test_transport_callback_budget_matches_checked_in_table() {
+  for (const TransportBudgetRow& row : kTransportBudget) {
+    BudgetRig rig;
+    row.run(rig);
+    char message[160];
+    std::snprintf(message, sizeof(message), "%s measured {%u, %u, %u, %u, %u}", row.name,
+                  static_cast<unsigned>(rig.callbacks), static_cast<unsigned>(rig.bytesOut),
+                  static_cast<unsigned>(rig.bytesIn), static_cast<unsigned>(rig.waitUs),
+                  static_cast<unsigned>(rig.maxPollCallbacks));
+    TEST_ASSERT_EQUAL_MESSAGE(row.callbacks, rig.callbacks, message);
+    TEST_ASSERT_EQUAL_MESSAGE(row.bytesOut, rig.bytesOut, message);
+    TEST_ASSERT_EQUAL_MESSAGE(row.bytesIn, rig.bytesIn, message);
+    TEST_ASSERT_EQUAL_MESSAGE(row.waitUs, static_cast<uint32_t>(rig.waitUs), message);
+    TEST_ASSERT_EQUAL_MESSAGE(row.pollCallbacks, rig.maxPollCallbacks, message);
+  }
 }
 
-void test_end_clears_runtime_state() {
+void test_activity_counters_track_conversions_periodic_uptime_and_heater() {
+  PreciseTimingTransport ctx;
+  setPreciseTime(ctx, 1000);
   SHT3xDevice device;
-  device._initialized = true;
-  device._driverState = DriverState::READY;
-  device._measurementRequested = true;
-  device._measurementReady = true;
-  device._measurementReadyMs = 123;
-  device._jobWakeMs = 321;
-  device._periodicActive = true;
-  device._periodicStartMs = 456;
-  device._lastFetchMs = 789;
-  device._lastFetchValid = true;
-  device._periodMs = 100;
-  device._sampleTimestampMs = 111;
-  device._missedSamples = 12;
-  device._notReadyStartMs = 222;
-  device._notReadyStartValid = true;
-  device._notReadyCount = 333;
-  device._lastRecoverMs = 444;
-  device._lastRecoverValid = true;
-  device._lastCommandValid = true;
+  ActivityCounters activity;
+  TEST_ASSERT_EQUAL(Err::NOT_INITIALIZED, device.getActivity(ctx.nowMs, activity).code);
+  Status st = device.bind(makePreciseTimingConfig(ctx));
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
 
-  device.end();
+  PollJobResult result;
+  for (uint32_t i = 0; i < 2; ++i) {
+    JobRequest request;
+    request.requestId = 30u + i;
+    TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.requestMeasurement(request).code);
+    result = PollJobResult{};
+    for (uint32_t step = 0; step < 100 && !result.terminal; ++step) {
+      advancePreciseTimeMs(ctx, 1);
+      (void)device.pollJob(ctx.nowMs, 1, result);
+    }
+    TEST_ASSERT_EQUAL(JobOutcome::SUCCEEDED, result.outcome);
+  }
 
-  TEST_ASSERT_FALSE(device._initialized);
-  TEST_ASSERT_EQUAL(DriverState::UNINIT, device._driverState);
-  TEST_ASSERT_FALSE(device._measurementRequested);
-  TEST_ASSERT_FALSE(device._measurementReady);
-  TEST_ASSERT_FALSE(device._hasSample);
-  TEST_ASSERT_EQUAL_UINT32(0u, device._measurementReadyMs);
-  TEST_ASSERT_EQUAL_UINT32(0u, device._jobWakeMs);
-  TEST_ASSERT_FALSE(device._periodicActive);
-  TEST_ASSERT_EQUAL_UINT32(0u, device._periodicStartMs);
-  TEST_ASSERT_EQUAL_UINT32(0u, device._lastFetchMs);
-  TEST_ASSERT_FALSE(device._lastFetchValid);
-  TEST_ASSERT_EQUAL_UINT32(0u, device._periodMs);
-  TEST_ASSERT_EQUAL_UINT32(0u, device._sampleTimestampMs);
-  TEST_ASSERT_EQUAL_UINT32(0u, device._missedSamples);
-  TEST_ASSERT_EQUAL_UINT32(0u, device._notReadyStartMs);
-  TEST_ASSERT_FALSE(device._notReadyStartValid);
-  TEST_ASSERT_EQUAL_UINT32(0u, device._notReadyCount);
-  TEST_ASSERT_EQUAL_UINT32(0u, device._lastRecoverMs);
-  TEST_ASSERT_FALSE(device._lastRecoverValid);
-  TEST_ASSERT_FALSE(device._lastCommandValid);
+  TEST_ASSERT_TRUE(device.setHeater(true).ok());
+  const uint32_t heaterOnMs = ctx.nowMs;
+  advancePreciseTimeMs(ctx, 500);
+  TEST_ASSERT_TRUE(device.getActivity(ctx.nowMs, activity).ok());
+  TEST_ASSERT_EQUAL_UINT32(500u, activity.heaterOnMs);
+  TEST_ASSERT_TRUE(device.setHeater(false).ok());
+  const uint32_t heaterMs = ctx.nowMs - heaterOnMs;
+
+  st = device.startPeriodic(PeriodicRate::MPS_10, Repeatability::LOW_REPEATABILITY);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  const uint32_t periodicStartMs = device._periodicStartMs;
+  advancePreciseTimeMs(ctx, 1050);
+  TEST_ASSERT_TRUE(device.getActivity(ctx.nowMs, activity).ok());
+  TEST_ASSERT_EQUAL_UINT32(ctx.nowMs - periodicStartMs, activity.periodicUptimeMs);
+  TEST_ASSERT_EQUAL_UINT32(10u, activity.periodicConversions[0]);
+  st = device.stopPeriodic();
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  const uint32_t uptimeMs = device._periodicUptimeMs;
+  advancePreciseTimeMs(ctx, 200);
+
+  TEST_ASSERT_TRUE(device.getActivity(ctx.nowMs, activity).ok());
+  TEST_ASSERT_EQUAL_UINT32(ctx.nowMs - 1000u, activity.elapsedMs);
+  TEST_ASSERT_EQUAL_UINT32(0u, activity.singleShotConversions[0]);
+  TEST_ASSERT_EQUAL_UINT32(2u, activity.singleShotConversions[2]);
+  TEST_ASSERT_EQUAL_UINT32(uptimeMs, activity.periodicUptimeMs);
+  TEST_ASSERT_TRUE(uptimeMs >= 1050u);
+  TEST_ASSERT_EQUAL_UINT32(uptimeMs / 100u, activity.periodicConversions[0]);
+  TEST_ASSERT_EQUAL_UINT32(0u, activity.periodicConversions[2]);
+  TEST_ASSERT_EQUAL_UINT32(heaterMs, activity.heaterOnMs);
+  TEST_ASSERT_EQUAL_UINT32(device.transportSuccess() + device.transportFailures(),
+                           activity.transportCallbacks);
+  TEST_ASSERT_EQUAL_UINT32(2u, activity.samples);
+}
+
+void test_heater_on_time_stops_at_reset_and_resumes_on_restore() {
+  PreciseTimingTransport ctx;
+  setPreciseTime(ctx, 1000);
+  SHT3xDevice device;
+  Status st = device.bind(makePreciseTimingConfig(ctx));
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  ActivityCounters activity;
+
+  // Soft reset turns the physical heater off; the restore plan keeps it on.
+  TEST_ASSERT_TRUE(device.setHeater(true).ok());
+  uint32_t onMs = ctx.nowMs;
+  advancePreciseTimeMs(ctx, 300);
+  const uint32_t resetMs = ctx.nowMs;
+  st = device.softReset();
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_TRUE(device._cachedSettings.heaterEnabled);
+  advancePreciseTimeMs(ctx, 1000);
+  TEST_ASSERT_TRUE(device.getActivity(ctx.nowMs, activity).ok());
+  const uint32_t afterSoftReset = activity.heaterOnMs;
+  TEST_ASSERT_TRUE(afterSoftReset >= resetMs - onMs);
+  TEST_ASSERT_TRUE(afterSoftReset <= resetMs - onMs + 2u);
+
+  // The ensure-idle job's reset stops it too.
+  TEST_ASSERT_TRUE(device.setHeater(true).ok());
+  onMs = ctx.nowMs;
+  advancePreciseTimeMs(ctx, 200);
+  JobRequest request;
+  request.requestId = 9;
+  TEST_ASSERT_EQUAL(Err::IN_PROGRESS, device.requestEnsureIdle(request).code);
+  PollJobResult result;
+  uint32_t jobResetMs = 0;
+  for (uint32_t step = 0; step < 100 && !result.terminal; ++step) {
+    (void)device.pollJob(ctx.nowMs, 1, result);
+    if (jobResetMs == 0 && ctx.lastCommand == cmd::CMD_SOFT_RESET) {
+      jobResetMs = ctx.nowMs;
+    }
+    advancePreciseTimeMs(ctx, 1);
+  }
+  TEST_ASSERT_EQUAL(JobOutcome::SUCCEEDED, result.outcome);
+  advancePreciseTimeMs(ctx, 1000);
+  TEST_ASSERT_TRUE(device.getActivity(ctx.nowMs, activity).ok());
+  const uint32_t afterEnsureIdle = activity.heaterOnMs;
+  TEST_ASSERT_EQUAL_UINT32(afterSoftReset + (jobResetMs - onMs), afterEnsureIdle);
+
+  // resetAndRestore() re-applies the heater, so on-time accrues again.
+  st = device.resetAndRestore();
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  TEST_ASSERT_TRUE(device._heaterOn);
+  advancePreciseTimeMs(ctx, 400);
+  TEST_ASSERT_TRUE(device.getActivity(ctx.nowMs, activity).ok());
+  TEST_ASSERT_TRUE(activity.heaterOnMs >= afterEnsureIdle + 400u);
+  TEST_ASSERT_TRUE(activity.heaterOnMs <= afterEnsureIdle + 420u);
+}
+
+void test_energy_estimate_combines_activity_with_supply_model() {
+  ActivityCounters activity;
+  activity.elapsedMs = 10000;
+  activity.singleShotConversions[2] = 10;
+  activity.periodicConversions[0] = 20;
+  activity.periodicUptimeMs = 2000;
+  activity.heaterOnMs = 100;
+  activity.transportCallbacks = 50;
+  activity.samples = 30;
+
+  EnergyModel model;
+  EnergyEstimate estimate;
+  Status st = estimateEnergy(activity, model, estimate);
+  TEST_ASSERT_TRUE_MESSAGE(st.ok(), st.msg);
+  // Idle: (0.2 uA * 8 s + 45 uA * 2 s) * 3.3 V = 302.28 uJ.
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 302.28f, estimate.idleMicrojoules);
+  // Conversions: 600 uA * 3.3 V * (10 * 12.5 ms + 20 * 2.5 ms) = 346.5 uJ.
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 346.5f, estimate.conversionMicrojoules);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 1000.0f, estimate.heaterMicrojoules);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 150.0f, estimate.busMicrojoules);
+  TEST_ASSERT_FLOAT_WITHIN(0.05f, 1798.78f, estimate.totalMicrojoules);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 1798.78f / 30.0f, estimate.microjoulesPerSample);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 1798.78f / (3.3f * 10.0f), estimate.averageMicroamps);
+  TEST_ASSERT_EQUAL_UINT32(30u, estimate.samples);
+
+  activity.samples = 0;
+  activity.elapsedMs = 0;
+  TEST_ASSERT_TRUE(estimateEnergy(activity, model, estimate).ok());
+  TEST_ASSERT_FLOAT_WITHIN(0.0f, 0.0f, estimate.microjoulesPerSample);
+  TEST_ASSERT_FLOAT_WITHIN(0.0f, 0.0f, estimate.averageMicroamps);
+  model.supplyMillivolts = 0;
+  TEST_ASSERT_EQUAL(Err::INVALID_PARAM, estimateEnergy(activity, model, estimate).code);
+
+  SHT3xDevice unbound;
+  model = EnergyModel{};
+  TEST_ASSERT_EQUAL(Err::NOT_INITIALIZED, estimateEnergy(unbound, 0, model, estimate).code);
 }
 
 // ============================================================================
@@ -5091,6 +7937,16 @@ int main(int argc, char** argv) {
   RUN_TEST(test_cancel_before_and_after_command_is_zero_i2c_and_preserves_sample);
   RUN_TEST(test_cancel_periodic_read_is_zero_i2c_and_preserves_cached_sample);
   RUN_TEST(test_job_deadlines_before_work_inside_callback_and_across_wrap);
+  RUN_TEST(test_nowms64_hook_drives_64bit_deadlines_and_sample_timestamps);
+  RUN_TEST(test_32bit_clock_extends_sample_timestamps_across_wrap);
+  RUN_TEST(test_deadline_admission_rejects_infeasible_jobs_without_i2c);
+  RUN_TEST(test_job_queue_runs_requests_back_to_back_with_own_identity);
+  RUN_TEST(test_job_queue_reports_unstartable_jobs_and_rejects_behind_continuous);
+  RUN_TEST(test_job_queue_blocks_rebind_until_queued_jobs_finish);
+  RUN_TEST(test_end_drops_queued_jobs_without_terminal_results);
+  RUN_TEST(test_poll_with_caller_time_reads_hooks_only_after_transport_callbacks);
+  RUN_TEST(test_poll_replays_waiting_result_until_wake_or_deadline);
+  RUN_TEST(test_sleep_hook_blocks_synchronous_waits_to_exact_targets);
   RUN_TEST(test_periodic_not_ready_callback_crossing_deadline_terminates_once);
   RUN_TEST(test_request_ensure_idle_is_staged_and_one_callback_bounded);
   RUN_TEST(test_ensure_idle_stage_failures_report_phase_and_effect);
@@ -5127,5 +7983,32 @@ int main(int argc, char** argv) {
   RUN_TEST(test_recover_backoff_enforced_at_zero_ms);
   RUN_TEST(test_periodic_fetch_margin_is_clamped);
   RUN_TEST(test_end_clears_runtime_state);
+  RUN_TEST(test_telemetry_frame_roundtrips_health_and_raw_sample);
+  RUN_TEST(test_telemetry_frame_rejects_short_buffers_and_corruption);
+  RUN_TEST(test_telemetry_frame_matches_host_decoder_vector);
+  RUN_TEST(test_job_wake_ms_reports_next_due_step_for_sleeping_owners);
+  RUN_TEST(test_cadence_job_rearms_on_absolute_slots_across_wrap);
+  RUN_TEST(test_cadence_job_skips_and_counts_overdue_slots);
+  RUN_TEST(test_cadence_request_validation_and_failure_is_terminal);
+  RUN_TEST(test_continuous_periodic_job_emits_one_result_per_period_until_cancelled);
+  RUN_TEST(test_periodic_sample_sequence_counts_overwritten_slots);
+  RUN_TEST(test_periodic_sequence_relearns_phase_from_not_ready_and_gap_ring_wraps);
+  RUN_TEST(test_periodic_sequence_learns_slow_oscillator_period);
+  RUN_TEST(test_allan_deviation_matches_direct_overlapping_estimate);
+  RUN_TEST(test_allan_deviation_alternating_series_and_reset);
+  RUN_TEST(test_kalman_filter_tracks_ramp_like_double_reference);
+  RUN_TEST(test_kalman_filter_restarts_on_gaps_and_skips_consumed_device_samples);
+  RUN_TEST(test_alarm_engine_debounce_hysteresis_and_holdoff_emit_only_transitions);
+  RUN_TEST(test_alarm_engine_matches_scalar_reference_and_reports_dropped_transitions);
+  RUN_TEST(test_soft_alert_mirrors_set_clear_hysteresis_and_latches_flags);
+  RUN_TEST(test_soft_alert_from_hardware_limits_and_device_samples);
+  RUN_TEST(test_dead_band_reports_only_changes_beyond_band_and_heartbeats);
+  RUN_TEST(test_dead_band_skips_consumed_device_samples_and_cuts_quiet_traffic);
+  RUN_TEST(test_scenario_generator_is_deterministic_and_feeds_virtual_sensor);
+  RUN_TEST(test_burst_job_averages_conversions_in_one_identity);
+  RUN_TEST(test_transport_callback_budget_matches_checked_in_table);
+  RUN_TEST(test_activity_counters_track_conversions_periodic_uptime_and_heater);
+  RUN_TEST(test_heater_on_time_stops_at_reset_and_resumes_on_restore);
+  RUN_TEST(test_energy_estimate_combines_activity_with_supply_model);
   return UNITY_END();
 }
@@ -92,6 +92,9 @@ def main() -> int:
     idf_cmake = ROOT / "examples" / "idf" / "basic" / "main" / "CMakeLists.txt"
     idf_transport = ROOT / "examples" / "idf" / "basic" / "main" / "IdfI2cTransport.cpp"
     idf_transport_h = ROOT / "examples" / "idf" / "basic" / "main" / "IdfI2cTransport.h"
+    dual_main = ROOT / "examples" / "idf" / "dual_bus" / "main" / "main.cpp"
+    dual_project = ROOT / "examples" / "idf" / "dual_bus" / "CMakeLists.txt"
+    dual_cmake = ROOT / "examples" / "idf" / "dual_bus" / "main" / "CMakeLists.txt"
     root_cmake = ROOT / "CMakeLists.txt"
     idf_manifest = ROOT / "idf_component.yml"
 
@@ -102,6 +105,9 @@ def main() -> int:
         idf_cmake,
         idf_transport,
         idf_transport_h,
+        dual_main,
+        dual_project,
+        dual_cmake,
         root_cmake,
         idf_manifest,
     ):
@@ -114,6 +120,8 @@ def main() -> int:
         idf_project,
         idf_cmake,
         *collect_files(ROOT / "examples" / "idf" / "basic" / "main", VALID_IDF_SUFFIXES),
+        dual_project,
+        *collect_files(ROOT / "examples" / "idf" / "dual_bus" / "main", VALID_IDF_SUFFIXES),
     ]
     combined_idf = "\n".join(
         path.read_text(encoding="utf-8", errors="replace") for path in idf_files
@@ -156,6 +164,21 @@ def main() -> int:
     require_text(idf_transport, "i2c_master_receive")
     require_text(idf_project, 'set(EXTRA_COMPONENT_DIRS "../../../")')
     require_text(idf_project, "project(sht3x_idf_basic)")
+    for needle in (
+        'extern "C" void app_main(void)',
+        "driver/i2c_master.h",
+        "I2C_NUM_0",
+        "I2C_NUM_1",
+        "xTaskCreatePinnedToCore",
+        "requestEnsureIdle",
+        "requestMeasurement(request)",
+        "pollJob(",
+    ):
+        require_text(dual_main, needle)
+    require_text(dual_cmake, '"../../basic/main/IdfI2cTransport.cpp"')
+    require_text(dual_cmake, '"../../../../include"')
+    require_text(dual_project, 'set(EXTRA_COMPONENT_DIRS "../../../")')
+    require_text(dual_project, "project(sht3x_idf_dual_bus)")
     require_text(root_cmake, "idf_component_register")
     require_text(root_cmake, 'SRCS "src/SHT3x.cpp"')
     require_text(root_cmake, 'INCLUDE_DIRS "include"')
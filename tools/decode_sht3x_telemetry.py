@@ -0,0 +1,188 @@
+#!/usr/bin/env python3
+"""Decode SHT3x binary telemetry frames (include/SHT3x/Telemetry.h, version 1).
+
+Input is one frame per line as hex (spaces allowed), from arguments, files, or
+stdin. Use --raw FILE to decode back-to-back binary frames instead.
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import struct
+import sys
+from pathlib import Path
+
+MAGIC = 0x53
+VERSION = 1
+FRAME_LEN = 62
+# magic, version, seq, state, lastErr, lastMeas, flags, consecutive, settings,
+# rawT, rawRH, reserved, then eleven u32 fields, then CRC-16.
+LAYOUT = struct.Struct("<BBHBBBBBBHHH11IH")
+assert LAYOUT.size == FRAME_LEN
+
+STATES = ["UNINIT", "READY", "DEGRADED", "OFFLINE"]
+ERRORS = [
+    "OK", "NOT_INITIALIZED", "INVALID_CONFIG", "I2C_ERROR", "TIMEOUT",
+    "INVALID_PARAM", "DEVICE_NOT_FOUND", "CRC_MISMATCH", "MEASUREMENT_NOT_READY",
+    "BUSY", "IN_PROGRESS", "COMMAND_FAILED", "WRITE_CRC_ERROR", "UNSUPPORTED",
+    "I2C_NACK_ADDR", "I2C_NACK_DATA", "I2C_NACK_READ", "I2C_TIMEOUT", "I2C_BUS",
+    "CANCELLED", "DEADLINE_INFEASIBLE",
+]
+MODES = ["SINGLE_SHOT", "PERIODIC", "ART"]
+REPEATABILITY = ["LOW", "MEDIUM", "HIGH"]
+RATES = ["0.5", "1", "2", "4", "10"]
+FLAGS = [
+    "initialized", "has_sample", "sample_ready", "periodic_active",
+    "hw_state_valid", "measurement_pending",
+]
+COUNTERS = [
+    "frame_ms", "sample_ms", "last_ok_ms", "last_error_ms", "total_success",
+    "total_failures", "transport_success", "transport_failures",
+    "protocol_failures", "total_not_ready", "missed_samples",
+]
+
+# Encoded by the C++ encoder for a driver after one completed single-shot job;
+# also pinned by the native test suite.
+SELF_TEST_FRAME = (
+    "53012a00010000070018666600800000fb030000fa030000fa030000000000000100"
+    "00000000000002000000000000000000000000000000000000002b0a"
+)
+
+
+class FrameError(ValueError):
+    pass
+
+
+def crc16(data: bytes) -> int:
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def _name(table: list[str], index: int) -> str:
+    return table[index] if 0 <= index < len(table) else f"UNKNOWN({index})"
+
+
+def decode(frame: bytes) -> dict:
+    if len(frame) < FRAME_LEN:
+        raise FrameError(f"frame too short: {len(frame)} < {FRAME_LEN}")
+    frame = frame[:FRAME_LEN]
+    fields = LAYOUT.unpack(frame)
+    if fields[0] != MAGIC:
+        raise FrameError(f"magic mismatch: 0x{fields[0]:02x}")
+    if fields[1] != VERSION:
+        raise FrameError(f"unsupported version: {fields[1]}")
+    if crc16(frame[:-2]) != fields[-1]:
+        raise FrameError("CRC mismatch")
+
+    settings = fields[8]
+    flags = fields[6]
+    raw_t, raw_rh = fields[9], fields[10]
+    out = {
+        "version": fields[1],
+        "sequence": fields[2],
+        "state": _name(STATES, fields[3]),
+        "last_error": _name(ERRORS, fields[4]),
+        "last_measurement": _name(ERRORS, fields[5]),
+        "flags": [name for bit, name in enumerate(FLAGS) if flags & (1 << bit)],
+        "consecutive_failures": fields[7],
+        "mode": _name(MODES, settings & 0x03),
+        "repeatability": _name(REPEATABILITY, (settings >> 2) & 0x03),
+        "periodic_rate_mps": _name(RATES, (settings >> 4) & 0x07),
+        "raw_temperature": raw_t,
+        "raw_humidity": raw_rh,
+    }
+    if flags & 0x02:
+        out["temperature_c"] = round(-45.0 + 175.0 * raw_t / 65535.0, 3)
+        out["humidity_pct"] = round(100.0 * raw_rh / 65535.0, 3)
+    out.update(zip(COUNTERS, fields[12:23]))
+    return out
+
+
+def parse_hex_line(line: str) -> bytes | None:
+    text = "".join(line.split())
+    if not text or text.startswith("#"):
+        return None
+    return bytes.fromhex(text)
+
+
+def self_test() -> int:
+    decoded = decode(bytes.fromhex(SELF_TEST_FRAME))
+    expected = {
+        "sequence": 42,
+        "state": "READY",
+        "last_error": "OK",
+        "flags": ["initialized", "has_sample", "sample_ready"],
+        "repeatability": "HIGH",
+        "periodic_rate_mps": "1",
+        "raw_temperature": 0x6666,
+        "raw_humidity": 0x8000,
+        "sample_ms": 1018,
+        "total_success": 1,
+        "transport_success": 2,
+    }
+    for key, value in expected.items():
+        if decoded[key] != value:
+            print(f"telemetry self-test FAILED: {key}={decoded[key]!r}, expected {value!r}")
+            return 1
+    corrupted = bytearray.fromhex(SELF_TEST_FRAME)
+    corrupted[32] ^= 1
+    try:
+        decode(bytes(corrupted))
+    except FrameError:
+        pass
+    else:
+        print("telemetry self-test FAILED: corrupted frame accepted")
+        return 1
+    if crc16(b"123456789") != 0x29B1:
+        print("telemetry self-test FAILED: CRC-16 check value")
+        return 1
+    print("Telemetry decoder self-test PASSED")
+    return 0
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("frames", nargs="*", help="hex frames or files of hex lines")
+    parser.add_argument("--raw", type=Path, help="file of concatenated binary frames")
+    parser.add_argument("--self-test", action="store_true", help="decode the pinned vector")
+    args = parser.parse_args()
+
+    if args.self_test:
+        return self_test()
+
+    frames: list[bytes] = []
+    if args.raw is not None:
+        blob = args.raw.read_bytes()
+        frames.extend(blob[i:i + FRAME_LEN] for i in range(0, len(blob), FRAME_LEN))
+    sources = args.frames or ([] if args.raw is not None else ["-"])
+    for source in sources:
+        path = Path(source)
+        if source == "-":
+            lines = sys.stdin.read().splitlines()
+        elif path.is_file():
+            lines = path.read_text(encoding="utf-8").splitlines()
+        else:
+            lines = [source]
+        for line in lines:
+            frame = parse_hex_line(line)
+            if frame is not None:
+                frames.append(frame)
+
+    status = 0
+    for frame in frames:
+        try:
+            print(json.dumps(decode(frame)))
+        except FrameError as exc:
+            print(json.dumps({"error": str(exc)}))
+            status = 1
+    return status
+
+
+if __name__ == "__main__":
+    sys.exit(main())
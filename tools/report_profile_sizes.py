@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+"""Compile the core driver once per build profile and print its section sizes.
+
+Native:    python tools/report_profile_sizes.py
+ESP32-S3:  python tools/report_profile_sizes.py --cxx xtensa-esp32s3-elf-g++ \
+               --size xtensa-esp32s3-elf-size --flag=-mlongcalls
+"""
+from __future__ import annotations
+
+import argparse
+import pathlib
+import subprocess
+import sys
+import tempfile
+
+ROOT = pathlib.Path(__file__).resolve().parents[1]
+SOURCE = ROOT / "src" / "SHT3x.cpp"
+
+PROFILES = (
+    ("full", []),
+    ("minimal", ["-DSHT3X_MINIMAL=1"]),
+    ("minimal + sync", ["-DSHT3X_MINIMAL=1", "-DSHT3X_ENABLE_SYNC_API=1"]),
+    ("minimal + sync + recovery",
+     ["-DSHT3X_MINIMAL=1", "-DSHT3X_ENABLE_SYNC_API=1", "-DSHT3X_ENABLE_RECOVERY=1"]),
+    ("minimal + alerts", ["-DSHT3X_MINIMAL=1", "-DSHT3X_ENABLE_ALERTS=1"]),
+    ("minimal + raw commands", ["-DSHT3X_MINIMAL=1", "-DSHT3X_ENABLE_RAW_COMMANDS=1"]),
+)
+
+
+def section_sizes(size_tool: str, obj: pathlib.Path) -> tuple[int, int, int]:
+    out = subprocess.run([size_tool, str(obj)], check=True, capture_output=True, text=True).stdout
+    fields = out.strip().splitlines()[-1].split()
+    return int(fields[0]), int(fields[1]), int(fields[2])
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--cxx", default="g++", help="C++ compiler (default: g++)")
+    parser.add_argument("--size", default="size", help="size tool (default: size)")
+    parser.add_argument("--opt", default="-Os", help="optimization flag (default: -Os)")
+    parser.add_argument("--flag", action="append", default=[], help="extra compiler flag")
+    args = parser.parse_args()
+
+    base = [args.cxx, "-std=c++17", args.opt, "-ffunction-sections", "-fdata-sections",
+            "-Wall", "-Wextra", "-Werror", f"-I{ROOT / 'include'}", *args.flag, "-c", str(SOURCE)]
+    rows = []
+    with tempfile.TemporaryDirectory() as tmp:
+        obj = pathlib.Path(tmp) / "SHT3x.o"
+        for name, defines in PROFILES:
+            result = subprocess.run([*base, *defines, "-o", str(obj)], capture_output=True, text=True)
+            if result.returncode != 0:
+                sys.stderr.write(result.stderr)
+                print(f"FAIL: profile '{name}' did not compile", file=sys.stderr)
+                return 1
+            rows.append((name, *section_sizes(args.size, obj)))
+
+    full_text = rows[0][1]
+    print(f"{args.cxx} {args.opt} {' '.join(args.flag)}".rstrip())
+    print("| Profile | text | data | bss | text vs full |")
+    print("| --- | ---: | ---: | ---: | ---: |")
+    for name, text, data, bss in rows:
+        print(f"| {name} | {text} | {data} | {bss} | {text - full_text:+d} |")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())